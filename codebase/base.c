@@ -7,6 +7,52 @@
 #include <locale.h>
 #include <wchar.h>
 #include <stdbool.h>
+#include <errno.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+#if defined(_MSC_VER)
+#pragma comment(lib, "Synchronization.lib")
+#endif
+#if defined(_M_AMD64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define CPU_X86 1
+#if !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define CPU_ARM64 1
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+#endif
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+#if defined(_MSC_VER)
+#define TARGET_AVX2
+#define TARGET_AVX512
+#define TARGET_BMI2
+#else
+#define TARGET_AVX2   __attribute__((target("avx2,fma")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#define TARGET_BMI2   __attribute__((target("bmi,bmi2")))
+#endif
 
 
 //////////////////////////////////////////////////////
@@ -39,29 +85,25 @@ function Architecture get_architecture(void) {
 }
 
 function Month get_current_month(void) {
-    time_t now = time(NULL);
-    struct tm* local_time = localtime(&now);
-    switch (local_time->tm_mon) {
-    case 0: return Month_Jan;
-    case 1: return Month_Feb;
-    case 2: return Month_Mar;
-    case 3: return Month_Apr;
-    case 4: return Month_May;
-    case 5: return Month_Jun;
-    case 6: return Month_Jul;
-    case 7: return Month_Aug;
-    case 8: return Month_Sep;
-    case 9: return Month_Oct;
-    case 10: return Month_Nov;
-    case 11: return Month_Dec;
+    switch (clock_snapshot().month) {
+    case 1: return Month_Jan;
+    case 2: return Month_Feb;
+    case 3: return Month_Mar;
+    case 4: return Month_Apr;
+    case 5: return Month_May;
+    case 6: return Month_Jun;
+    case 7: return Month_Jul;
+    case 8: return Month_Aug;
+    case 9: return Month_Sep;
+    case 10: return Month_Oct;
+    case 11: return Month_Nov;
+    case 12: return Month_Dec;
     default: return Month_Jan; 
     }
 }
 
 function DayOfWeek get_current_day_of_week(void) {
-    time_t now = time(NULL);
-    struct tm* local_time = localtime(&now);
-    switch (local_time->tm_wday) {
+    switch (clock_snapshot().day_of_week) {
     case 0: return DayOfWeek_Sunday;
     case 1: return DayOfWeek_Monday;
     case 2: return DayOfWeek_Tuesday;
@@ -100,6 +142,7 @@ function void printint(int val) {
 function int myprintf(const char* format, ...) {
     va_list args;
     va_start(args, format);
+    PROFILE_FUNCTION_BEGIN();
     int printed_chars = 0;
 
     for (int i = 0; format[i] != '\0'; i++) {
@@ -109,7 +152,7 @@ function int myprintf(const char* format, ...) {
                 int val = va_arg(args, int);
                 printint(val);
             }else if (format[i] == 'c') {
-                char val = va_arg(args, char);
+                char val = (char)va_arg(args, int);
                 putchar(val);
             }else if (format[i] == 's') {
                 char* val = va_arg(args, char*);
@@ -127,6 +170,7 @@ function int myprintf(const char* format, ...) {
         }
     }
     va_end(args);
+    PROFILE_END();
     return printed_chars;
 }
 
@@ -137,6 +181,7 @@ function int myprintf(const char* format, ...) {
 
 
 function Arena arena_create(size_t size) {
+    PROFILE_FUNCTION_BEGIN();
     Arena arena;
     arena.base = malloc(size); 
     if (!arena.base) {
@@ -145,10 +190,12 @@ function Arena arena_create(size_t size) {
     }
     arena.size = size;
     arena.used = 0;
+    PROFILE_END();
     return arena;
 }
 
 function Arena64 arena64_create(uint64_t size) {
+    PROFILE_FUNCTION_BEGIN();
     Arena64 arena;
     arena.base = malloc(size); 
     if (!arena.base) {
@@ -157,27 +204,10 @@ function Arena64 arena64_create(uint64_t size) {
     }
     arena.size = size;
     arena.used = 0;
+    PROFILE_END();
     return arena;
 }
 
-function void* arena_alloc(Arena* arena, size_t alloc_size) {
-    if (arena->used + alloc_size > arena->size) {
-        return NULL; 
-    }
-    void* result = arena->base + arena->used;
-    arena->used += alloc_size;
-    return result;
-}
-
-function void* arena64_alloc(Arena64* arena, uint64_t alloc_size) {
-    if (arena->used + alloc_size > arena->size) {
-        return NULL; 
-    }
-    void* result = arena->base + arena->used;
-    arena->used += alloc_size;
-    return result;
-}
-
 function void arena_reset(Arena* arena) {
     arena->used = 0;
 }
@@ -187,21 +217,28 @@ function void arena64_reset(Arena64* arena) {
 }
 
 function void arena_destroy(Arena* arena) {
+    PROFILE_FUNCTION_BEGIN();
     if (arena->base) {
         free(arena->base);
         arena->base = NULL;
         arena->size = 0;
         arena->used = 0;
     }
+    PROFILE_END();
 }
 
 function void arena64_destroy(Arena64* arena) {
+    PROFILE_FUNCTION_BEGIN();
     free(arena->base);
     arena->base = NULL;
     arena->size = 0;
     arena->used = 0;
+    PROFILE_END();
 }
 
+Arena g_string_arena;
+Arena g_utf_string_arena;
+
 function void initialize_string_arena(size_t size) {
     g_string_arena = arena_create(size);
 }
@@ -218,13 +255,131 @@ function void destroy_string_arena() {
     arena_destroy(&g_string_arena);
 }
 
+function void* array_grow(Arena* arena, void* data, uint64_t count, uint64_t capacity,
+                          uint64_t new_capacity, uint64_t element_size) {
+    if (arena) {
+        char* opl = (char*)data + capacity * element_size;
+        uint64_t extra = (new_capacity - capacity) * element_size;
+        if (data && opl == arena->base + arena->used && arena->used + extra <= arena->size) {
+            arena->used += extra;
+            return data;
+        }
+        void* result = arena_alloc_aligned(arena, new_capacity * element_size, 16);
+        if (result && count) {
+            MemoryCopy(result, data, count * element_size);
+        }
+        return result;
+    }
+    void* result = BASE_ALLOC(new_capacity * element_size);
+    if (result && count) {
+        MemoryCopy(result, data, count * element_size);
+    }
+    if (result && data) {
+        BASE_FREE(data);
+    }
+    return result;
+}
+
+function uint64_t os_allocation_granularity(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+#else
+    return (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+// NOTE(ryl1k): Maps the same pages twice back to back, so base[i] and
+// base[size + i] alias. Windows has no atomic way to place both views, so
+// a free range is found first and the mapping retried if another thread
+// grabs it in between.
+function void* os_reserve_mirrored(uint64_t size) {
+#if defined(_WIN32)
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                        (DWORD)(size >> 32), (DWORD)size, NULL);
+    if (!mapping) {
+        return NULL;
+    }
+    void* result = NULL;
+    for (int attempt = 0; attempt < 16 && !result; attempt++) {
+        void* base = VirtualAlloc(NULL, 2 * size, MEM_RESERVE, PAGE_NOACCESS);
+        if (!base) {
+            break;
+        }
+        VirtualFree(base, 0, MEM_RELEASE);
+        void* first = MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size, base);
+        void* second = MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size, (char*)base + size);
+        if (first && second) {
+            result = base;
+        }
+        else {
+            if (first) {
+                UnmapViewOfFile(first);
+            }
+            if (second) {
+                UnmapViewOfFile(second);
+            }
+        }
+    }
+    CloseHandle(mapping);
+    return result;
+#else
+    static volatile uint64_t counter;
+    char name[64];
+    int fd = -1;
+    for (int attempt = 0; attempt < 16 && fd < 0; attempt++) {
+        snprintf(name, sizeof(name), "/base_mirror_%d_%llu", (int)getpid(),
+                 (unsigned long long)atomic_fetch_add_U64(&counter, 1));
+        fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    }
+    if (fd < 0) {
+        return NULL;
+    }
+    shm_unlink(name);
+    void* result = NULL;
+    if (ftruncate(fd, (off_t)size) == 0) {
+        char* base = mmap(NULL, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base != MAP_FAILED) {
+            void* first = mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+            void* second = mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+            if (first == base && second == base + size) {
+                result = base;
+            }
+            else {
+                munmap(base, 2 * size);
+            }
+        }
+    }
+    close(fd);
+    return result;
+#endif
+}
+
+function void os_release_mirrored(void* base, uint64_t size) {
+#if defined(_WIN32)
+    UnmapViewOfFile(base);
+    UnmapViewOfFile((char*)base + size);
+#else
+    munmap(base, 2 * size);
+#endif
+}
+
 //////////////////////////////////////////////////////
 // NOTE(ryl1k): String And UTF Functions
 
 function char* utf8_to_utf16(const char* utf8) {
+    PROFILE_FUNCTION_BEGIN();
     size_t wlen = 0;
 
+    // NOTE(ryl1k): The _s conversions are MSVC-only; elsewhere the plain
+    // ones report failure as (size_t)-1 and leave out the terminator.
+#if defined(_MSC_VER)
     if (mbstowcs_s(&wlen, NULL, 0, utf8, _TRUNCATE) != 0) {
+#else
+    wlen = mbstowcs(NULL, utf8, 0) + 1;
+    if (wlen == 0) {
+#endif
         fprintf(stderr, "Failed to calculate UTF-16 string length\n");
         exit(EXIT_FAILURE);
     }
@@ -235,21 +390,35 @@ function char* utf8_to_utf16(const char* utf8) {
         exit(EXIT_FAILURE);
     }
 
+#if defined(_MSC_VER)
     if (mbstowcs_s(NULL, utf16, wlen, utf8, _TRUNCATE) != 0) {
+#else
+    if (mbstowcs(utf16, utf8, wlen) == (size_t)-1) {
+#endif
         fprintf(stderr, "UTF-8 to UTF-16 conversion failed\n");
         free(utf16);
         exit(EXIT_FAILURE);
     }
 
+    PROFILE_END();
     return (char*)utf16;
 }
 
 function char* utf16_to_utf8(const wchar_t* utf16) {
+    PROFILE_FUNCTION_BEGIN();
 
-    setlocale(LC_ALL, "en_US.UTF-8");
+    // NOTE(ryl1k): Minimal Linux installs often ship only C.UTF-8.
+    if (!setlocale(LC_ALL, "en_US.UTF-8")) {
+        setlocale(LC_ALL, "C.UTF-8");
+    }
 
     size_t slen = 0;
-    errno_t err = wcstombs_s(&slen, NULL, 0, utf16, _TRUNCATE);
+#if defined(_MSC_VER)
+    int err = wcstombs_s(&slen, NULL, 0, utf16, _TRUNCATE);
+#else
+    slen = wcstombs(NULL, utf16, 0) + 1;
+    int err = slen == 0 ? errno : 0;
+#endif
     if (err != 0) {
         fprintf(stderr, "Failed to calculate UTF-8 string length: %d\n", err);
         exit(EXIT_FAILURE);
@@ -261,22 +430,29 @@ function char* utf16_to_utf8(const wchar_t* utf16) {
         exit(EXIT_FAILURE);
     }
 
+#if defined(_MSC_VER)
     err = wcstombs_s(NULL, utf8, slen, utf16, _TRUNCATE);
+#else
+    err = wcstombs(utf8, utf16, slen) == (size_t)-1 ? errno : 0;
+#endif
     if (err != 0) {
         fprintf(stderr, "UTF-16 to UTF-8 conversion failed: %d\n", err);
         free(utf8);
         exit(EXIT_FAILURE);
     }
 
+    PROFILE_END();
     return utf8;
 }
 
 function int utf8_strlen(const char* utf8) {
+    PROFILE_FUNCTION_BEGIN();
     int count = 0;
     while (*utf8) {
         count += (*utf8 & 0xC0) != 0x80;
         utf8++;
     }
+    PROFILE_END();
     return count;
 }
 
@@ -285,6 +461,7 @@ function int utf16_strlen(const wchar_t* utf16) {
 }
 
 function String utf8_create_literal(const char* utf8) {
+    PROFILE_FUNCTION_BEGIN();
     if (g_utf_string_arena.size == 0) {
         initialize_utf_string_arena(1024 * 1024);
     }
@@ -295,18 +472,16 @@ function String utf8_create_literal(const char* utf8) {
         exit(EXIT_FAILURE);
     }
 
-    
-    if (strcpy_s(allocated_memory, length + 1, utf8) != 0) {
-        fprintf(stderr, "Failed to copy UTF-8 string\n");
-        exit(EXIT_FAILURE);
-    }
+    MemoryCopy(allocated_memory, utf8, length + 1);
 
     String result = { allocated_memory, length };
+    PROFILE_END();
     return result;
 }
 
 
 function String utf16_create_literal(const char* utf8) {
+    PROFILE_FUNCTION_BEGIN();
     char* utf16 = utf8_to_utf16(utf8); 
     if (!utf16) {
         fprintf(stderr, "UTF-8 to UTF-16 conversion failed\n");
@@ -317,7 +492,7 @@ function String utf16_create_literal(const char* utf8) {
         initialize_utf_string_arena(1024 * 1024);
     }
 
-    int length = utf16_strlen(utf16);
+    int length = utf16_strlen((const wchar_t*)utf16);
     char* allocated_memory = arena_alloc(&g_utf_string_arena, (length + 1) * sizeof(wchar_t));
     if (!allocated_memory) {
         fprintf(stderr, "Failed to allocate memory for UTF-16 string\n");
@@ -329,12 +504,14 @@ function String utf16_create_literal(const char* utf8) {
     free(utf16); 
 
     String result = { allocated_memory, length };
+    PROFILE_END();
     return result;
 }
 
 
 
 function String string_create_literal(const char* literal) {
+    PROFILE_FUNCTION_BEGIN();
     int length = strlen(literal);
 
     
@@ -348,16 +525,18 @@ function String string_create_literal(const char* literal) {
         exit(EXIT_FAILURE);
     }
 
-    strcpy_s(allocated_memory, length + 1, literal);
+    MemoryCopy(allocated_memory, literal, length + 1);
 
     String result;
     result.data = allocated_memory;
     result.length = length;
     result.encoding = Encoding_UTF8;
+    PROFILE_END();
     return result;
 }
 
 function String string_create(Arena* arena, const char* literal) {
+    PROFILE_FUNCTION_BEGIN();
     int length = strlen(literal);
     char* allocated_memory = arena_alloc(arena, length + 1); 
 
@@ -366,332 +545,9429 @@ function String string_create(Arena* arena, const char* literal) {
         exit(EXIT_FAILURE);
     }
 
-    strcpy_s(allocated_memory, length+1, literal); 
+    MemoryCopy(allocated_memory, literal, length + 1);
 
     String result;
     result.data = allocated_memory;
     result.length = length;
+    PROFILE_END();
     return result;
 }
 
 //////////////////////////////////////////////////////
-// NOTE(ryl1k): Hashtable Functions
+// NOTE(ryl1k): String Parsing
 
+// NOTE(ryl1k): Eight ASCII digits are validated and converted at once by
+// treating them as one little-endian U64 (SWAR).
+function U64 parse_read_U64(const U8* p) {
+    U64 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
 
-//////////////////////////////////////////////////////
-// NOTE(ryl1k): Float Constant Functions
-
-function F32 inf_F32(void) {
-    union { F32 f; U32 u; } r;
-    r.u = 0x7f800000;
-    return(r.f);
+function B32 parse_is_eight_digits(U64 v) {
+    return (((v & 0xF0F0F0F0F0F0F0F0llu) |
+             (((v + 0x0606060606060606llu) & 0xF0F0F0F0F0F0F0F0llu) >> 4)) ==
+            0x3333333333333333llu);
 }
 
-function F32 neg_inf_F32(void) {
-    union { F32 f; U32 u; } r;
-    r.u = 0xff800000;
-    return(r.f);
+function U32 parse_eight_digits(U64 v) {
+    const U64 mask = 0x000000FF000000FFllu;
+    const U64 mul1 = 0x000F424000000064llu; // 100 + (1000000 << 32)
+    const U64 mul2 = 0x0000271000000001llu; // 1 + (10000 << 32)
+    v -= 0x3030303030303030llu;
+    v = (v * 10) + (v >> 8);
+    v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+    return (U32)v;
 }
 
-function F64 inf_F64(void) {
-    union { F64 f; U64 u; } r;
-    r.u = 0x7ff0000000000000;
-    return(r.f);
+function B32 parse_is_digit(U8 c) {
+    return (U8)(c - '0') < 10;
 }
 
-function F64 neg_inf_F64(void) {
-    union { F64 f; U64 u; } r;
-    r.u = 0xfff0000000000000;
-    return(r.f);
+// NOTE(ryl1k): Accumulates a run of digits into *value (wrapping on
+// overflow) and returns the first byte past the run.
+function const U8* parse_digit_run(const U8* at, const U8* opl, U64* value) {
+    U64 v = *value;
+    while (opl - at >= 8) {
+        U64 chunk = parse_read_U64(at);
+        if (!parse_is_eight_digits(chunk)) {
+            break;
+        }
+        v = v * 100000000llu + parse_eight_digits(chunk);
+        at += 8;
+    }
+    while (at < opl && parse_is_digit(*at)) {
+        v = v * 10 + (U64)(*at - '0');
+        at++;
+    }
+    *value = v;
+    return at;
 }
 
-//////////////////////////////////////////////////////
-// NOTE(ryl1k): Math Functions
+function ParseError parse_integer(String s, B32 allow_negative, U64 max_positive, U64 max_negative,
+                                  U64* magnitude, B32* negative, int* consumed) {
+    const U8* start = (const U8*)s.data;
+    const U8* opl = start + s.length;
+    const U8* at = start;
+    *magnitude = 0;
+    *negative = 0;
+    *consumed = 0;
+    if (at < opl && (*at == '+' || (allow_negative && *at == '-'))) {
+        *negative = (*at == '-');
+        at++;
+    }
+    const U8* digits = at;
+    while (at < opl && *at == '0') {
+        at++;
+    }
+    const U8* significant = at;
+    U64 v = 0;
+    at = parse_digit_run(at, opl, &v);
+    if (at == digits) {
+        return ParseError_NoDigits;
+    }
+    *consumed = (int)(at - start);
 
-function F32 abs_F32(F32 x) {
-    union { F32 f; U32 u; } r;
-    r.f = x;
-    r.u &= 0x7fffffff;
-    return r.f;
+    // NOTE(ryl1k): 19 digits always fit in a U64, only a 20th can wrap.
+    S64 count = at - significant;
+    B32 overflow = (count > 20);
+    if (count == 20) {
+        U64 head = 0;
+        parse_digit_run(significant, significant + 19, &head);
+        U64 last = (U64)(significant[19] - '0');
+        overflow = (head > (max_U64 - last) / 10);
+    }
+    U64 limit = *negative ? max_negative : max_positive;
+    if (overflow || v > limit) {
+        *magnitude = limit;
+        return ParseError_Overflow;
+    }
+    *magnitude = v;
+    return ParseError_None;
 }
 
-function F64 abs_F64(F64 x) {
-    union{F64 f; U64 u;} r;
-    r.f = x;
-    r.u &= 0x7fffffff;
-    return r.f;
+function ParseS32 parse_S32(String s) {
+    ParseS32 r;
+    U64 m;
+    B32 neg;
+    r.error = parse_integer(s, 1, (U64)max_S32, (U64)max_S32 + 1, &m, &neg, &r.consumed);
+    r.value = neg ? (S32)(0 - (U32)m) : (S32)m;
+    return r;
 }
 
-#include <math.h>
-
-function F32 sqrt_F32(F32 x) {
-    return(sqrtf(x));
+function ParseS64 parse_S64(String s) {
+    ParseS64 r;
+    U64 m;
+    B32 neg;
+    r.error = parse_integer(s, 1, (U64)max_S64, (U64)max_S64 + 1, &m, &neg, &r.consumed);
+    r.value = neg ? (S64)(0 - m) : (S64)m;
+    return r;
 }
 
-function F32 sin_F32(F32 x) {
-    return(sinf(x));
+function ParseU32 parse_U32(String s) {
+    ParseU32 r;
+    U64 m;
+    B32 neg;
+    r.error = parse_integer(s, 0, max_U32, 0, &m, &neg, &r.consumed);
+    r.value = (U32)m;
+    return r;
 }
 
-function F32 cos_F32(F32 x) {
-    return(cosf(x));
+function ParseU64 parse_U64(String s) {
+    ParseU64 r;
+    U64 m;
+    B32 neg;
+    r.error = parse_integer(s, 0, max_U64, 0, &m, &neg, &r.consumed);
+    r.value = m;
+    return r;
 }
 
-function F32 tan_F32(F32 x) {
-    return(tanf(x));
-}
+typedef enum {
+    ParseDecimalKind_Finite,
+    ParseDecimalKind_Inf,
+    ParseDecimalKind_NaN,
+} ParseDecimalKind;
 
-function F32 ln_F32(F32 x) {
-    return(logf(x));
-}
+typedef struct {
+    U64 mantissa;
+    S64 exponent;
+    B32 negative;
+    B32 too_many_digits;
+    ParseDecimalKind kind;
+    int consumed;
+} ParseDecimal;
 
-function F32 lerp_F32(F32 a, F32 b, F32 t) {
-    return(a + t * (b - a));
-}
-function F32 unlerp_F32(F32 a, F32 b, F32 x) {
-    return((x - a) / (b - a));
+function B32 parse_match_nocase(const U8* at, const U8* opl, const char* word) {
+    for (; *word; word++, at++) {
+        if (at >= opl || (*at | 0x20) != (U8)*word) {
+            return 0;
+        }
+    }
+    return 1;
 }
 
+// NOTE(ryl1k): Splits the input into a decimal mantissa of at most 19
+// significant digits and a power of ten, as in fast_float.
+function ParseDecimal parse_decimal(String s) {
+    ParseDecimal d = { 0 };
+    const U8* start = (const U8*)s.data;
+    const U8* opl = start + s.length;
+    const U8* at = start;
+    if (at < opl && (*at == '-' || *at == '+')) {
+        d.negative = (*at == '-');
+        at++;
+    }
 
+    if (parse_match_nocase(at, opl, "inf")) {
+        d.kind = ParseDecimalKind_Inf;
+        at += parse_match_nocase(at, opl, "infinity") ? 8 : 3;
+        d.consumed = (int)(at - start);
+        return d;
+    }
+    if (parse_match_nocase(at, opl, "nan")) {
+        d.kind = ParseDecimalKind_NaN;
+        d.consumed = (int)(at + 3 - start);
+        return d;
+    }
 
+    U64 w = 0;
+    const U8* int_first = at;
+    at = parse_digit_run(at, opl, &w);
+    const U8* int_opl = at;
+    const U8* frac_first = at;
+    const U8* frac_opl = at;
+    S64 digit_count = int_opl - int_first;
+    S64 exponent = 0;
+    if (at < opl && *at == '.') {
+        at++;
+        frac_first = at;
+        at = parse_digit_run(at, opl, &w);
+        frac_opl = at;
+        exponent = -(frac_opl - frac_first);
+        digit_count += frac_opl - frac_first;
+    }
+    if (digit_count == 0) {
+        return d;
+    }
 
-function F64 sqrt_F64(F64 x) {
-    return(sqrtf(x));
-}
+    S64 exp_number = 0;
+    if (at < opl && (*at == 'e' || *at == 'E')) {
+        const U8* e = at + 1;
+        B32 exp_negative = 0;
+        if (e < opl && (*e == '-' || *e == '+')) {
+            exp_negative = (*e == '-');
+            e++;
+        }
+        if (e < opl && parse_is_digit(*e)) {
+            while (e < opl && parse_is_digit(*e)) {
+                if (exp_number < 0x10000) {
+                    exp_number = exp_number * 10 + (*e - '0');
+                }
+                e++;
+            }
+            if (exp_negative) {
+                exp_number = -exp_number;
+            }
+            at = e;
+        }
+    }
+    exponent += exp_number;
+    d.consumed = (int)(at - start);
 
-function F64 sin_F64(F64 x) {
-    return(sinf(x));
+    if (digit_count > 19) {
+        const U8* p = int_first;
+        while (p < frac_opl && (*p == '0' || *p == '.')) {
+            digit_count -= (*p == '0');
+            p++;
+        }
+        if (digit_count > 19) {
+            const U64 min_nineteen_digits = 1000000000000000000llu;
+            d.too_many_digits = 1;
+            w = 0;
+            p = int_first;
+            while (w < min_nineteen_digits && p < int_opl) {
+                w = w * 10 + (U64)(*p - '0');
+                p++;
+            }
+            if (w >= min_nineteen_digits) {
+                exponent = (int_opl - p) + exp_number;
+            }
+            else {
+                p = frac_first;
+                while (w < min_nineteen_digits && p < frac_opl) {
+                    w = w * 10 + (U64)(*p - '0');
+                    p++;
+                }
+                exponent = (frac_first - p) + exp_number;
+            }
+        }
+    }
+    d.mantissa = w;
+    d.exponent = exponent;
+    return d;
 }
 
-function F64 cos_F64(F64 x) {
-    return(cosf(x));
-}
+// NOTE(ryl1k): Eisel-Lemire. 128-bit truncated approximations of 5^q for
+// q in [-342, 308], normalized so the top bit is set.
+global U64 power_of_five_128[651 * 2] = {
+    0xeef453d6923bd65allu, 0x113faa2906a13b3fllu,
+    0x9558b4661b6565f8llu, 0x4ac7ca59a424c507llu,
+    0xbaaee17fa23ebf76llu, 0x5d79bcf00d2df649llu,
+    0xe95a99df8ace6f53llu, 0xf4d82c2c107973dcllu,
+    0x91d8a02bb6c10594llu, 0x79071b9b8a4be869llu,
+    0xb64ec836a47146f9llu, 0x9748e2826cdee284llu,
+    0xe3e27a444d8d98b7llu, 0xfd1b1b2308169b25llu,
+    0x8e6d8c6ab0787f72llu, 0xfe30f0f5e50e20f7llu,
+    0xb208ef855c969f4fllu, 0xbdbd2d335e51a935llu,
+    0xde8b2b66b3bc4723llu, 0xad2c788035e61382llu,
+    0x8b16fb203055ac76llu, 0x4c3bcb5021afcc31llu,
+    0xaddcb9e83c6b1793llu, 0xdf4abe242a1bbf3dllu,
+    0xd953e8624b85dd78llu, 0xd71d6dad34a2af0dllu,
+    0x87d4713d6f33aa6bllu, 0x8672648c40e5ad68llu,
+    0xa9c98d8ccb009506llu, 0x680efdaf511f18c2llu,
+    0xd43bf0effdc0ba48llu, 0x0212bd1b2566def2llu,
+    0x84a57695fe98746dllu, 0x014bb630f7604b57llu,
+    0xa5ced43b7e3e9188llu, 0x419ea3bd35385e2dllu,
+    0xcf42894a5dce35eallu, 0x52064cac828675b9llu,
+    0x818995ce7aa0e1b2llu, 0x7343efebd1940993llu,
+    0xa1ebfb4219491a1fllu, 0x1014ebe6c5f90bf8llu,
+    0xca66fa129f9b60a6llu, 0xd41a26e077774ef6llu,
+    0xfd00b897478238d0llu, 0x8920b098955522b4llu,
+    0x9e20735e8cb16382llu, 0x55b46e5f5d5535b0llu,
+    0xc5a890362fddbc62llu, 0xeb2189f734aa831dllu,
+    0xf712b443bbd52b7bllu, 0xa5e9ec7501d523e4llu,
+    0x9a6bb0aa55653b2dllu, 0x47b233c92125366ellu,
+    0xc1069cd4eabe89f8llu, 0x999ec0bb696e840allu,
+    0xf148440a256e2c76llu, 0xc00670ea43ca250dllu,
+    0x96cd2a865764dbcallu, 0x380406926a5e5728llu,
+    0xbc807527ed3e12bcllu, 0xc605083704f5ecf2llu,
+    0xeba09271e88d976bllu, 0xf7864a44c633682ellu,
+    0x93445b8731587ea3llu, 0x7ab3ee6afbe0211dllu,
+    0xb8157268fdae9e4cllu, 0x5960ea05bad82964llu,
+    0xe61acf033d1a45dfllu, 0x6fb92487298e33bdllu,
+    0x8fd0c16206306babllu, 0xa5d3b6d479f8e056llu,
+    0xb3c4f1ba87bc8696llu, 0x8f48a4899877186cllu,
+    0xe0b62e2929aba83cllu, 0x331acdabfe94de87llu,
+    0x8c71dcd9ba0b4925llu, 0x9ff0c08b7f1d0b14llu,
+    0xaf8e5410288e1b6fllu, 0x07ecf0ae5ee44dd9llu,
+    0xdb71e91432b1a24allu, 0xc9e82cd9f69d6150llu,
+    0x892731ac9faf056ellu, 0xbe311c083a225cd2llu,
+    0xab70fe17c79ac6callu, 0x6dbd630a48aaf406llu,
+    0xd64d3d9db981787dllu, 0x092cbbccdad5b108llu,
+    0x85f0468293f0eb4ellu, 0x25bbf56008c58ea5llu,
+    0xa76c582338ed2621llu, 0xaf2af2b80af6f24ellu,
+    0xd1476e2c07286faallu, 0x1af5af660db4aee1llu,
+    0x82cca4db847945callu, 0x50d98d9fc890ed4dllu,
+    0xa37fce126597973cllu, 0xe50ff107bab528a0llu,
+    0xcc5fc196fefd7d0cllu, 0x1e53ed49a96272c8llu,
+    0xff77b1fcbebcdc4fllu, 0x25e8e89c13bb0f7allu,
+    0x9faacf3df73609b1llu, 0x77b191618c54e9acllu,
+    0xc795830d75038c1dllu, 0xd59df5b9ef6a2417llu,
+    0xf97ae3d0d2446f25llu, 0x4b0573286b44ad1dllu,
+    0x9becce62836ac577llu, 0x4ee367f9430aec32llu,
+    0xc2e801fb244576d5llu, 0x229c41f793cda73fllu,
+    0xf3a20279ed56d48allu, 0x6b43527578c1110fllu,
+    0x9845418c345644d6llu, 0x830a13896b78aaa9llu,
+    0xbe5691ef416bd60cllu, 0x23cc986bc656d553llu,
+    0xedec366b11c6cb8fllu, 0x2cbfbe86b7ec8aa8llu,
+    0x94b3a202eb1c3f39llu, 0x7bf7d71432f3d6a9llu,
+    0xb9e08a83a5e34f07llu, 0xdaf5ccd93fb0cc53llu,
+    0xe858ad248f5c22c9llu, 0xd1b3400f8f9cff68llu,
+    0x91376c36d99995bellu, 0x23100809b9c21fa1llu,
+    0xb58547448ffffb2dllu, 0xabd40a0c2832a78allu,
+    0xe2e69915b3fff9f9llu, 0x16c90c8f323f516cllu,
+    0x8dd01fad907ffc3bllu, 0xae3da7d97f6792e3llu,
+    0xb1442798f49ffb4allu, 0x99cd11cfdf41779cllu,
+    0xdd95317f31c7fa1dllu, 0x40405643d711d583llu,
+    0x8a7d3eef7f1cfc52llu, 0x482835ea666b2572llu,
+    0xad1c8eab5ee43b66llu, 0xda3243650005eecfllu,
+    0xd863b256369d4a40llu, 0x90bed43e40076a82llu,
+    0x873e4f75e2224e68llu, 0x5a7744a6e804a291llu,
+    0xa90de3535aaae202llu, 0x711515d0a205cb36llu,
+    0xd3515c2831559a83llu, 0x0d5a5b44ca873e03llu,
+    0x8412d9991ed58091llu, 0xe858790afe9486c2llu,
+    0xa5178fff668ae0b6llu, 0x626e974dbe39a872llu,
+    0xce5d73ff402d98e3llu, 0xfb0a3d212dc8128fllu,
+    0x80fa687f881c7f8ellu, 0x7ce66634bc9d0b99llu,
+    0xa139029f6a239f72llu, 0x1c1fffc1ebc44e80llu,
+    0xc987434744ac874ellu, 0xa327ffb266b56220llu,
+    0xfbe9141915d7a922llu, 0x4bf1ff9f0062baa8llu,
+    0x9d71ac8fada6c9b5llu, 0x6f773fc3603db4a9llu,
+    0xc4ce17b399107c22llu, 0xcb550fb4384d21d3llu,
+    0xf6019da07f549b2bllu, 0x7e2a53a146606a48llu,
+    0x99c102844f94e0fbllu, 0x2eda7444cbfc426dllu,
+    0xc0314325637a1939llu, 0xfa911155fefb5308llu,
+    0xf03d93eebc589f88llu, 0x793555ab7eba27callu,
+    0x96267c7535b763b5llu, 0x4bc1558b2f3458dellu,
+    0xbbb01b9283253ca2llu, 0x9eb1aaedfb016f16llu,
+    0xea9c227723ee8bcbllu, 0x465e15a979c1cadcllu,
+    0x92a1958a7675175fllu, 0x0bfacd89ec191ec9llu,
+    0xb749faed14125d36llu, 0xcef980ec671f667bllu,
+    0xe51c79a85916f484llu, 0x82b7e12780e7401allu,
+    0x8f31cc0937ae58d2llu, 0xd1b2ecb8b0908810llu,
+    0xb2fe3f0b8599ef07llu, 0x861fa7e6dcb4aa15llu,
+    0xdfbdcece67006ac9llu, 0x67a791e093e1d49allu,
+    0x8bd6a141006042bdllu, 0xe0c8bb2c5c6d24e0llu,
+    0xaecc49914078536dllu, 0x58fae9f773886e18llu,
+    0xda7f5bf590966848llu, 0xaf39a475506a899ellu,
+    0x888f99797a5e012dllu, 0x6d8406c952429603llu,
+    0xaab37fd7d8f58178llu, 0xc8e5087ba6d33b83llu,
+    0xd5605fcdcf32e1d6llu, 0xfb1e4a9a90880a64llu,
+    0x855c3be0a17fcd26llu, 0x5cf2eea09a55067fllu,
+    0xa6b34ad8c9dfc06fllu, 0xf42faa48c0ea481ellu,
+    0xd0601d8efc57b08bllu, 0xf13b94daf124da26llu,
+    0x823c12795db6ce57llu, 0x76c53d08d6b70858llu,
+    0xa2cb1717b52481edllu, 0x54768c4b0c64ca6ellu,
+    0xcb7ddcdda26da268llu, 0xa9942f5dcf7dfd09llu,
+    0xfe5d54150b090b02llu, 0xd3f93b35435d7c4cllu,
+    0x9efa548d26e5a6e1llu, 0xc47bc5014a1a6dafllu,
+    0xc6b8e9b0709f109allu, 0x359ab6419ca1091bllu,
+    0xf867241c8cc6d4c0llu, 0xc30163d203c94b62llu,
+    0x9b407691d7fc44f8llu, 0x79e0de63425dcf1dllu,
+    0xc21094364dfb5636llu, 0x985915fc12f542e4llu,
+    0xf294b943e17a2bc4llu, 0x3e6f5b7b17b2939dllu,
+    0x979cf3ca6cec5b5allu, 0xa705992ceecf9c42llu,
+    0xbd8430bd08277231llu, 0x50c6ff782a838353llu,
+    0xece53cec4a314ebdllu, 0xa4f8bf5635246428llu,
+    0x940f4613ae5ed136llu, 0x871b7795e136be99llu,
+    0xb913179899f68584llu, 0x28e2557b59846e3fllu,
+    0xe757dd7ec07426e5llu, 0x331aeada2fe589cfllu,
+    0x9096ea6f3848984fllu, 0x3ff0d2c85def7621llu,
+    0xb4bca50b065abe63llu, 0x0fed077a756b53a9llu,
+    0xe1ebce4dc7f16dfbllu, 0xd3e8495912c62894llu,
+    0x8d3360f09cf6e4bdllu, 0x64712dd7abbbd95cllu,
+    0xb080392cc4349decllu, 0xbd8d794d96aacfb3llu,
+    0xdca04777f541c567llu, 0xecf0d7a0fc5583a0llu,
+    0x89e42caaf9491b60llu, 0xf41686c49db57244llu,
+    0xac5d37d5b79b6239llu, 0x311c2875c522ced5llu,
+    0xd77485cb25823ac7llu, 0x7d633293366b828bllu,
+    0x86a8d39ef77164bcllu, 0xae5dff9c02033197llu,
+    0xa8530886b54dbdebllu, 0xd9f57f830283fdfcllu,
+    0xd267caa862a12d66llu, 0xd072df63c324fd7bllu,
+    0x8380dea93da4bc60llu, 0x4247cb9e59f71e6dllu,
+    0xa46116538d0deb78llu, 0x52d9be85f074e608llu,
+    0xcd795be870516656llu, 0x67902e276c921f8bllu,
+    0x806bd9714632dff6llu, 0x00ba1cd8a3db53b6llu,
+    0xa086cfcd97bf97f3llu, 0x80e8a40eccd228a4llu,
+    0xc8a883c0fdaf7df0llu, 0x6122cd128006b2cdllu,
+    0xfad2a4b13d1b5d6cllu, 0x796b805720085f81llu,
+    0x9cc3a6eec6311a63llu, 0xcbe3303674053bb0llu,
+    0xc3f490aa77bd60fcllu, 0xbedbfc4411068a9cllu,
+    0xf4f1b4d515acb93bllu, 0xee92fb5515482d44llu,
+    0x991711052d8bf3c5llu, 0x751bdd152d4d1c4allu,
+    0xbf5cd54678eef0b6llu, 0xd262d45a78a0635dllu,
+    0xef340a98172aace4llu, 0x86fb897116c87c34llu,
+    0x9580869f0e7aac0ellu, 0xd45d35e6ae3d4da0llu,
+    0xbae0a846d2195712llu, 0x8974836059cca109llu,
+    0xe998d258869facd7llu, 0x2bd1a438703fc94bllu,
+    0x91ff83775423cc06llu, 0x7b6306a34627ddcfllu,
+    0xb67f6455292cbf08llu, 0x1a3bc84c17b1d542llu,
+    0xe41f3d6a7377eecallu, 0x20caba5f1d9e4a93llu,
+    0x8e938662882af53ellu, 0x547eb47b7282ee9cllu,
+    0xb23867fb2a35b28dllu, 0xe99e619a4f23aa43llu,
+    0xdec681f9f4c31f31llu, 0x6405fa00e2ec94d4llu,
+    0x8b3c113c38f9f37ellu, 0xde83bc408dd3dd04llu,
+    0xae0b158b4738705ellu, 0x9624ab50b148d445llu,
+    0xd98ddaee19068c76llu, 0x3badd624dd9b0957llu,
+    0x87f8a8d4cfa417c9llu, 0xe54ca5d70a80e5d6llu,
+    0xa9f6d30a038d1dbcllu, 0x5e9fcf4ccd211f4cllu,
+    0xd47487cc8470652bllu, 0x7647c3200069671fllu,
+    0x84c8d4dfd2c63f3bllu, 0x29ecd9f40041e073llu,
+    0xa5fb0a17c777cf09llu, 0xf468107100525890llu,
+    0xcf79cc9db955c2ccllu, 0x7182148d4066eeb4llu,
+    0x81ac1fe293d599bfllu, 0xc6f14cd848405530llu,
+    0xa21727db38cb002fllu, 0xb8ada00e5a506a7cllu,
+    0xca9cf1d206fdc03bllu, 0xa6d90811f0e4851cllu,
+    0xfd442e4688bd304allu, 0x908f4a166d1da663llu,
+    0x9e4a9cec15763e2ellu, 0x9a598e4e043287fellu,
+    0xc5dd44271ad3cdballu, 0x40eff1e1853f29fdllu,
+    0xf7549530e188c128llu, 0xd12bee59e68ef47cllu,
+    0x9a94dd3e8cf578b9llu, 0x82bb74f8301958cellu,
+    0xc13a148e3032d6e7llu, 0xe36a52363c1faf01llu,
+    0xf18899b1bc3f8ca1llu, 0xdc44e6c3cb279ac1llu,
+    0x96f5600f15a7b7e5llu, 0x29ab103a5ef8c0b9llu,
+    0xbcb2b812db11a5dellu, 0x7415d448f6b6f0e7llu,
+    0xebdf661791d60f56llu, 0x111b495b3464ad21llu,
+    0x936b9fcebb25c995llu, 0xcab10dd900beec34llu,
+    0xb84687c269ef3bfbllu, 0x3d5d514f40eea742llu,
+    0xe65829b3046b0afallu, 0x0cb4a5a3112a5112llu,
+    0x8ff71a0fe2c2e6dcllu, 0x47f0e785eaba72abllu,
+    0xb3f4e093db73a093llu, 0x59ed216765690f56llu,
+    0xe0f218b8d25088b8llu, 0x306869c13ec3532cllu,
+    0x8c974f7383725573llu, 0x1e414218c73a13fbllu,
+    0xafbd2350644eeacfllu, 0xe5d1929ef90898fallu,
+    0xdbac6c247d62a583llu, 0xdf45f746b74abf39llu,
+    0x894bc396ce5da772llu, 0x6b8bba8c328eb783llu,
+    0xab9eb47c81f5114fllu, 0x066ea92f3f326564llu,
+    0xd686619ba27255a2llu, 0xc80a537b0efefebdllu,
+    0x8613fd0145877585llu, 0xbd06742ce95f5f36llu,
+    0xa798fc4196e952e7llu, 0x2c48113823b73704llu,
+    0xd17f3b51fca3a7a0llu, 0xf75a15862ca504c5llu,
+    0x82ef85133de648c4llu, 0x9a984d73dbe722fbllu,
+    0xa3ab66580d5fdaf5llu, 0xc13e60d0d2e0ebballu,
+    0xcc963fee10b7d1b3llu, 0x318df905079926a8llu,
+    0xffbbcfe994e5c61fllu, 0xfdf17746497f7052llu,
+    0x9fd561f1fd0f9bd3llu, 0xfeb6ea8bedefa633llu,
+    0xc7caba6e7c5382c8llu, 0xfe64a52ee96b8fc0llu,
+    0xf9bd690a1b68637bllu, 0x3dfdce7aa3c673b0llu,
+    0x9c1661a651213e2dllu, 0x06bea10ca65c084ellu,
+    0xc31bfa0fe5698db8llu, 0x486e494fcff30a62llu,
+    0xf3e2f893dec3f126llu, 0x5a89dba3c3efccfallu,
+    0x986ddb5c6b3a76b7llu, 0xf89629465a75e01cllu,
+    0xbe89523386091465llu, 0xf6bbb397f1135823llu,
+    0xee2ba6c0678b597fllu, 0x746aa07ded582e2cllu,
+    0x94db483840b717efllu, 0xa8c2a44eb4571cdcllu,
+    0xba121a4650e4ddebllu, 0x92f34d62616ce413llu,
+    0xe896a0d7e51e1566llu, 0x77b020baf9c81d17llu,
+    0x915e2486ef32cd60llu, 0x0ace1474dc1d122ellu,
+    0xb5b5ada8aaff80b8llu, 0x0d819992132456ballu,
+    0xe3231912d5bf60e6llu, 0x10e1fff697ed6c69llu,
+    0x8df5efabc5979c8fllu, 0xca8d3ffa1ef463c1llu,
+    0xb1736b96b6fd83b3llu, 0xbd308ff8a6b17cb2llu,
+    0xddd0467c64bce4a0llu, 0xac7cb3f6d05ddbdellu,
+    0x8aa22c0dbef60ee4llu, 0x6bcdf07a423aa96bllu,
+    0xad4ab7112eb3929dllu, 0x86c16c98d2c953c6llu,
+    0xd89d64d57a607744llu, 0xe871c7bf077ba8b7llu,
+    0x87625f056c7c4a8bllu, 0x11471cd764ad4972llu,
+    0xa93af6c6c79b5d2dllu, 0xd598e40d3dd89bcfllu,
+    0xd389b47879823479llu, 0x4aff1d108d4ec2c3llu,
+    0x843610cb4bf160cbllu, 0xcedf722a585139ballu,
+    0xa54394fe1eedb8fellu, 0xc2974eb4ee658828llu,
+    0xce947a3da6a9273ellu, 0x733d226229feea32llu,
+    0x811ccc668829b887llu, 0x0806357d5a3f525fllu,
+    0xa163ff802a3426a8llu, 0xca07c2dcb0cf26f7llu,
+    0xc9bcff6034c13052llu, 0xfc89b393dd02f0b5llu,
+    0xfc2c3f3841f17c67llu, 0xbbac2078d443ace2llu,
+    0x9d9ba7832936edc0llu, 0xd54b944b84aa4c0dllu,
+    0xc5029163f384a931llu, 0x0a9e795e65d4df11llu,
+    0xf64335bcf065d37dllu, 0x4d4617b5ff4a16d5llu,
+    0x99ea0196163fa42ellu, 0x504bced1bf8e4e45llu,
+    0xc06481fb9bcf8d39llu, 0xe45ec2862f71e1d6llu,
+    0xf07da27a82c37088llu, 0x5d767327bb4e5a4cllu,
+    0x964e858c91ba2655llu, 0x3a6a07f8d510f86fllu,
+    0xbbe226efb628afeallu, 0x890489f70a55368bllu,
+    0xeadab0aba3b2dbe5llu, 0x2b45ac74ccea842ellu,
+    0x92c8ae6b464fc96fllu, 0x3b0b8bc90012929dllu,
+    0xb77ada0617e3bbcbllu, 0x09ce6ebb40173744llu,
+    0xe55990879ddcaabdllu, 0xcc420a6a101d0515llu,
+    0x8f57fa54c2a9eab6llu, 0x9fa946824a12232dllu,
+    0xb32df8e9f3546564llu, 0x47939822dc96abf9llu,
+    0xdff9772470297ebdllu, 0x59787e2b93bc56f7llu,
+    0x8bfbea76c619ef36llu, 0x57eb4edb3c55b65allu,
+    0xaefae51477a06b03llu, 0xede622920b6b23f1llu,
+    0xdab99e59958885c4llu, 0xe95fab368e45ecedllu,
+    0x88b402f7fd75539bllu, 0x11dbcb0218ebb414llu,
+    0xaae103b5fcd2a881llu, 0xd652bdc29f26a119llu,
+    0xd59944a37c0752a2llu, 0x4be76d3346f0495fllu,
+    0x857fcae62d8493a5llu, 0x6f70a4400c562ddbllu,
+    0xa6dfbd9fb8e5b88ellu, 0xcb4ccd500f6bb952llu,
+    0xd097ad07a71f26b2llu, 0x7e2000a41346a7a7llu,
+    0x825ecc24c873782fllu, 0x8ed400668c0c28c8llu,
+    0xa2f67f2dfa90563bllu, 0x728900802f0f32fallu,
+    0xcbb41ef979346bcallu, 0x4f2b40a03ad2ffb9llu,
+    0xfea126b7d78186bcllu, 0xe2f610c84987bfa8llu,
+    0x9f24b832e6b0f436llu, 0x0dd9ca7d2df4d7c9llu,
+    0xc6ede63fa05d3143llu, 0x91503d1c79720dbbllu,
+    0xf8a95fcf88747d94llu, 0x75a44c6397ce912allu,
+    0x9b69dbe1b548ce7cllu, 0xc986afbe3ee11aballu,
+    0xc24452da229b021bllu, 0xfbe85badce996168llu,
+    0xf2d56790ab41c2a2llu, 0xfae27299423fb9c3llu,
+    0x97c560ba6b0919a5llu, 0xdccd879fc967d41allu,
+    0xbdb6b8e905cb600fllu, 0x5400e987bbc1c920llu,
+    0xed246723473e3813llu, 0x290123e9aab23b68llu,
+    0x9436c0760c86e30bllu, 0xf9a0b6720aaf6521llu,
+    0xb94470938fa89bcellu, 0xf808e40e8d5b3e69llu,
+    0xe7958cb87392c2c2llu, 0xb60b1d1230b20e04llu,
+    0x90bd77f3483bb9b9llu, 0xb1c6f22b5e6f48c2llu,
+    0xb4ecd5f01a4aa828llu, 0x1e38aeb6360b1af3llu,
+    0xe2280b6c20dd5232llu, 0x25c6da63c38de1b0llu,
+    0x8d590723948a535fllu, 0x579c487e5a38ad0ellu,
+    0xb0af48ec79ace837llu, 0x2d835a9df0c6d851llu,
+    0xdcdb1b2798182244llu, 0xf8e431456cf88e65llu,
+    0x8a08f0f8bf0f156bllu, 0x1b8e9ecb641b58ffllu,
+    0xac8b2d36eed2dac5llu, 0xe272467e3d222f3fllu,
+    0xd7adf884aa879177llu, 0x5b0ed81dcc6abb0fllu,
+    0x86ccbb52ea94baeallu, 0x98e947129fc2b4e9llu,
+    0xa87fea27a539e9a5llu, 0x3f2398d747b36224llu,
+    0xd29fe4b18e88640ellu, 0x8eec7f0d19a03aadllu,
+    0x83a3eeeef9153e89llu, 0x1953cf68300424acllu,
+    0xa48ceaaab75a8e2bllu, 0x5fa8c3423c052dd7llu,
+    0xcdb02555653131b6llu, 0x3792f412cb06794dllu,
+    0x808e17555f3ebf11llu, 0xe2bbd88bbee40bd0llu,
+    0xa0b19d2ab70e6ed6llu, 0x5b6aceaeae9d0ec4llu,
+    0xc8de047564d20a8bllu, 0xf245825a5a445275llu,
+    0xfb158592be068d2ellu, 0xeed6e2f0f0d56712llu,
+    0x9ced737bb6c4183dllu, 0x55464dd69685606bllu,
+    0xc428d05aa4751e4cllu, 0xaa97e14c3c26b886llu,
+    0xf53304714d9265dfllu, 0xd53dd99f4b3066a8llu,
+    0x993fe2c6d07b7fabllu, 0xe546a8038efe4029llu,
+    0xbf8fdb78849a5f96llu, 0xde98520472bdd033llu,
+    0xef73d256a5c0f77cllu, 0x963e66858f6d4440llu,
+    0x95a8637627989aadllu, 0xdde7001379a44aa8llu,
+    0xbb127c53b17ec159llu, 0x5560c018580d5d52llu,
+    0xe9d71b689dde71afllu, 0xaab8f01e6e10b4a6llu,
+    0x9226712162ab070dllu, 0xcab3961304ca70e8llu,
+    0xb6b00d69bb55c8d1llu, 0x3d607b97c5fd0d22llu,
+    0xe45c10c42a2b3b05llu, 0x8cb89a7db77c506allu,
+    0x8eb98a7a9a5b04e3llu, 0x77f3608e92adb242llu,
+    0xb267ed1940f1c61cllu, 0x55f038b237591ed3llu,
+    0xdf01e85f912e37a3llu, 0x6b6c46dec52f6688llu,
+    0x8b61313bbabce2c6llu, 0x2323ac4b3b3da015llu,
+    0xae397d8aa96c1b77llu, 0xabec975e0a0d081allu,
+    0xd9c7dced53c72255llu, 0x96e7bd358c904a21llu,
+    0x881cea14545c7575llu, 0x7e50d64177da2e54llu,
+    0xaa242499697392d2llu, 0xdde50bd1d5d0b9e9llu,
+    0xd4ad2dbfc3d07787llu, 0x955e4ec64b44e864llu,
+    0x84ec3c97da624ab4llu, 0xbd5af13bef0b113ellu,
+    0xa6274bbdd0fadd61llu, 0xecb1ad8aeacdd58ellu,
+    0xcfb11ead453994ballu, 0x67de18eda5814af2llu,
+    0x81ceb32c4b43fcf4llu, 0x80eacf948770ced7llu,
+    0xa2425ff75e14fc31llu, 0xa1258379a94d028dllu,
+    0xcad2f7f5359a3b3ellu, 0x096ee45813a04330llu,
+    0xfd87b5f28300ca0dllu, 0x8bca9d6e188853fcllu,
+    0x9e74d1b791e07e48llu, 0x775ea264cf55347ellu,
+    0xc612062576589ddallu, 0x95364afe032a819ellu,
+    0xf79687aed3eec551llu, 0x3a83ddbd83f52205llu,
+    0x9abe14cd44753b52llu, 0xc4926a9672793543llu,
+    0xc16d9a0095928a27llu, 0x75b7053c0f178294llu,
+    0xf1c90080baf72cb1llu, 0x5324c68b12dd6339llu,
+    0x971da05074da7beellu, 0xd3f6fc16ebca5e04llu,
+    0xbce5086492111aeallu, 0x88f4bb1ca6bcf585llu,
+    0xec1e4a7db69561a5llu, 0x2b31e9e3d06c32e6llu,
+    0x9392ee8e921d5d07llu, 0x3aff322e62439fd0llu,
+    0xb877aa3236a4b449llu, 0x09befeb9fad487c3llu,
+    0xe69594bec44de15bllu, 0x4c2ebe687989a9b4llu,
+    0x901d7cf73ab0acd9llu, 0x0f9d37014bf60a11llu,
+    0xb424dc35095cd80fllu, 0x538484c19ef38c95llu,
+    0xe12e13424bb40e13llu, 0x2865a5f206b06fballu,
+    0x8cbccc096f5088cbllu, 0xf93f87b7442e45d4llu,
+    0xafebff0bcb24aafellu, 0xf78f69a51539d749llu,
+    0xdbe6fecebdedd5bellu, 0xb573440e5a884d1cllu,
+    0x89705f4136b4a597llu, 0x31680a88f8953031llu,
+    0xabcc77118461cefcllu, 0xfdc20d2b36ba7c3ellu,
+    0xd6bf94d5e57a42bcllu, 0x3d32907604691b4dllu,
+    0x8637bd05af6c69b5llu, 0xa63f9a49c2c1b110llu,
+    0xa7c5ac471b478423llu, 0x0fcf80dc33721d54llu,
+    0xd1b71758e219652bllu, 0xd3c36113404ea4a9llu,
+    0x83126e978d4fdf3bllu, 0x645a1cac083126eallu,
+    0xa3d70a3d70a3d70allu, 0x3d70a3d70a3d70a4llu,
+    0xccccccccccccccccllu, 0xcccccccccccccccdllu,
+    0x8000000000000000llu, 0x0000000000000000llu,
+    0xa000000000000000llu, 0x0000000000000000llu,
+    0xc800000000000000llu, 0x0000000000000000llu,
+    0xfa00000000000000llu, 0x0000000000000000llu,
+    0x9c40000000000000llu, 0x0000000000000000llu,
+    0xc350000000000000llu, 0x0000000000000000llu,
+    0xf424000000000000llu, 0x0000000000000000llu,
+    0x9896800000000000llu, 0x0000000000000000llu,
+    0xbebc200000000000llu, 0x0000000000000000llu,
+    0xee6b280000000000llu, 0x0000000000000000llu,
+    0x9502f90000000000llu, 0x0000000000000000llu,
+    0xba43b74000000000llu, 0x0000000000000000llu,
+    0xe8d4a51000000000llu, 0x0000000000000000llu,
+    0x9184e72a00000000llu, 0x0000000000000000llu,
+    0xb5e620f480000000llu, 0x0000000000000000llu,
+    0xe35fa931a0000000llu, 0x0000000000000000llu,
+    0x8e1bc9bf04000000llu, 0x0000000000000000llu,
+    0xb1a2bc2ec5000000llu, 0x0000000000000000llu,
+    0xde0b6b3a76400000llu, 0x0000000000000000llu,
+    0x8ac7230489e80000llu, 0x0000000000000000llu,
+    0xad78ebc5ac620000llu, 0x0000000000000000llu,
+    0xd8d726b7177a8000llu, 0x0000000000000000llu,
+    0x878678326eac9000llu, 0x0000000000000000llu,
+    0xa968163f0a57b400llu, 0x0000000000000000llu,
+    0xd3c21bcecceda100llu, 0x0000000000000000llu,
+    0x84595161401484a0llu, 0x0000000000000000llu,
+    0xa56fa5b99019a5c8llu, 0x0000000000000000llu,
+    0xcecb8f27f4200f3allu, 0x0000000000000000llu,
+    0x813f3978f8940984llu, 0x4000000000000000llu,
+    0xa18f07d736b90be5llu, 0x5000000000000000llu,
+    0xc9f2c9cd04674edellu, 0xa400000000000000llu,
+    0xfc6f7c4045812296llu, 0x4d00000000000000llu,
+    0x9dc5ada82b70b59dllu, 0xf020000000000000llu,
+    0xc5371912364ce305llu, 0x6c28000000000000llu,
+    0xf684df56c3e01bc6llu, 0xc732000000000000llu,
+    0x9a130b963a6c115cllu, 0x3c7f400000000000llu,
+    0xc097ce7bc90715b3llu, 0x4b9f100000000000llu,
+    0xf0bdc21abb48db20llu, 0x1e86d40000000000llu,
+    0x96769950b50d88f4llu, 0x1314448000000000llu,
+    0xbc143fa4e250eb31llu, 0x17d955a000000000llu,
+    0xeb194f8e1ae525fdllu, 0x5dcfab0800000000llu,
+    0x92efd1b8d0cf37bellu, 0x5aa1cae500000000llu,
+    0xb7abc627050305adllu, 0xf14a3d9e40000000llu,
+    0xe596b7b0c643c719llu, 0x6d9ccd05d0000000llu,
+    0x8f7e32ce7bea5c6fllu, 0xe4820023a2000000llu,
+    0xb35dbf821ae4f38bllu, 0xdda2802c8a800000llu,
+    0xe0352f62a19e306ellu, 0xd50b2037ad200000llu,
+    0x8c213d9da502de45llu, 0x4526f422cc340000llu,
+    0xaf298d050e4395d6llu, 0x9670b12b7f410000llu,
+    0xdaf3f04651d47b4cllu, 0x3c0cdd765f114000llu,
+    0x88d8762bf324cd0fllu, 0xa5880a69fb6ac800llu,
+    0xab0e93b6efee0053llu, 0x8eea0d047a457a00llu,
+    0xd5d238a4abe98068llu, 0x72a4904598d6d880llu,
+    0x85a36366eb71f041llu, 0x47a6da2b7f864750llu,
+    0xa70c3c40a64e6c51llu, 0x999090b65f67d924llu,
+    0xd0cf4b50cfe20765llu, 0xfff4b4e3f741cf6dllu,
+    0x82818f1281ed449fllu, 0xbff8f10e7a8921a4llu,
+    0xa321f2d7226895c7llu, 0xaff72d52192b6a0dllu,
+    0xcbea6f8ceb02bb39llu, 0x9bf4f8a69f764490llu,
+    0xfee50b7025c36a08llu, 0x02f236d04753d5b4llu,
+    0x9f4f2726179a2245llu, 0x01d762422c946590llu,
+    0xc722f0ef9d80aad6llu, 0x424d3ad2b7b97ef5llu,
+    0xf8ebad2b84e0d58bllu, 0xd2e0898765a7deb2llu,
+    0x9b934c3b330c8577llu, 0x63cc55f49f88eb2fllu,
+    0xc2781f49ffcfa6d5llu, 0x3cbf6b71c76b25fbllu,
+    0xf316271c7fc3908allu, 0x8bef464e3945ef7allu,
+    0x97edd871cfda3a56llu, 0x97758bf0e3cbb5acllu,
+    0xbde94e8e43d0c8ecllu, 0x3d52eeed1cbea317llu,
+    0xed63a231d4c4fb27llu, 0x4ca7aaa863ee4bddllu,
+    0x945e455f24fb1cf8llu, 0x8fe8caa93e74ef6allu,
+    0xb975d6b6ee39e436llu, 0xb3e2fd538e122b44llu,
+    0xe7d34c64a9c85d44llu, 0x60dbbca87196b616llu,
+    0x90e40fbeea1d3a4allu, 0xbc8955e946fe31cdllu,
+    0xb51d13aea4a488ddllu, 0x6babab6398bdbe41llu,
+    0xe264589a4dcdab14llu, 0xc696963c7eed2dd1llu,
+    0x8d7eb76070a08aecllu, 0xfc1e1de5cf543ca2llu,
+    0xb0de65388cc8ada8llu, 0x3b25a55f43294bcbllu,
+    0xdd15fe86affad912llu, 0x49ef0eb713f39ebellu,
+    0x8a2dbf142dfcc7abllu, 0x6e3569326c784337llu,
+    0xacb92ed9397bf996llu, 0x49c2c37f07965404llu,
+    0xd7e77a8f87daf7fbllu, 0xdc33745ec97be906llu,
+    0x86f0ac99b4e8dafdllu, 0x69a028bb3ded71a3llu,
+    0xa8acd7c0222311bcllu, 0xc40832ea0d68ce0cllu,
+    0xd2d80db02aabd62bllu, 0xf50a3fa490c30190llu,
+    0x83c7088e1aab65dbllu, 0x792667c6da79e0fallu,
+    0xa4b8cab1a1563f52llu, 0x577001b891185938llu,
+    0xcde6fd5e09abcf26llu, 0xed4c0226b55e6f86llu,
+    0x80b05e5ac60b6178llu, 0x544f8158315b05b4llu,
+    0xa0dc75f1778e39d6llu, 0x696361ae3db1c721llu,
+    0xc913936dd571c84cllu, 0x03bc3a19cd1e38e9llu,
+    0xfb5878494ace3a5fllu, 0x04ab48a04065c723llu,
+    0x9d174b2dcec0e47bllu, 0x62eb0d64283f9c76llu,
+    0xc45d1df942711d9allu, 0x3ba5d0bd324f8394llu,
+    0xf5746577930d6500llu, 0xca8f44ec7ee36479llu,
+    0x9968bf6abbe85f20llu, 0x7e998b13cf4e1ecbllu,
+    0xbfc2ef456ae276e8llu, 0x9e3fedd8c321a67ellu,
+    0xefb3ab16c59b14a2llu, 0xc5cfe94ef3ea101ellu,
+    0x95d04aee3b80ece5llu, 0xbba1f1d158724a12llu,
+    0xbb445da9ca61281fllu, 0x2a8a6e45ae8edc97llu,
+    0xea1575143cf97226llu, 0xf52d09d71a3293bdllu,
+    0x924d692ca61be758llu, 0x593c2626705f9c56llu,
+    0xb6e0c377cfa2e12ellu, 0x6f8b2fb00c77836cllu,
+    0xe498f455c38b997allu, 0x0b6dfb9c0f956447llu,
+    0x8edf98b59a373fecllu, 0x4724bd4189bd5eacllu,
+    0xb2977ee300c50fe7llu, 0x58edec91ec2cb657llu,
+    0xdf3d5e9bc0f653e1llu, 0x2f2967b66737e3edllu,
+    0x8b865b215899f46cllu, 0xbd79e0d20082ee74llu,
+    0xae67f1e9aec07187llu, 0xecd8590680a3aa11llu,
+    0xda01ee641a708de9llu, 0xe80e6f4820cc9495llu,
+    0x884134fe908658b2llu, 0x3109058d147fdcddllu,
+    0xaa51823e34a7eedellu, 0xbd4b46f0599fd415llu,
+    0xd4e5e2cdc1d1ea96llu, 0x6c9e18ac7007c91allu,
+    0x850fadc09923329ellu, 0x03e2cf6bc604ddb0llu,
+    0xa6539930bf6bff45llu, 0x84db8346b786151cllu,
+    0xcfe87f7cef46ff16llu, 0xe612641865679a63llu,
+    0x81f14fae158c5f6ellu, 0x4fcb7e8f3f60c07ellu,
+    0xa26da3999aef7749llu, 0xe3be5e330f38f09dllu,
+    0xcb090c8001ab551cllu, 0x5cadf5bfd3072cc5llu,
+    0xfdcb4fa002162a63llu, 0x73d9732fc7c8f7f6llu,
+    0x9e9f11c4014dda7ellu, 0x2867e7fddcdd9afallu,
+    0xc646d63501a1511dllu, 0xb281e1fd541501b8llu,
+    0xf7d88bc24209a565llu, 0x1f225a7ca91a4226llu,
+    0x9ae757596946075fllu, 0x3375788de9b06958llu,
+    0xc1a12d2fc3978937llu, 0x0052d6b1641c83aellu,
+    0xf209787bb47d6b84llu, 0xc0678c5dbd23a49allu,
+    0x9745eb4d50ce6332llu, 0xf840b7ba963646e0llu,
+    0xbd176620a501fbffllu, 0xb650e5a93bc3d898llu,
+    0xec5d3fa8ce427affllu, 0xa3e51f138ab4cebellu,
+    0x93ba47c980e98cdfllu, 0xc66f336c36b10137llu,
+    0xb8a8d9bbe123f017llu, 0xb80b0047445d4184llu,
+    0xe6d3102ad96cec1dllu, 0xa60dc059157491e5llu,
+    0x9043ea1ac7e41392llu, 0x87c89837ad68db2fllu,
+    0xb454e4a179dd1877llu, 0x29babe4598c311fbllu,
+    0xe16a1dc9d8545e94llu, 0xf4296dd6fef3d67allu,
+    0x8ce2529e2734bb1dllu, 0x1899e4a65f58660cllu,
+    0xb01ae745b101e9e4llu, 0x5ec05dcff72e7f8fllu,
+    0xdc21a1171d42645dllu, 0x76707543f4fa1f73llu,
+    0x899504ae72497eballu, 0x6a06494a791c53a8llu,
+    0xabfa45da0edbde69llu, 0x0487db9d17636892llu,
+    0xd6f8d7509292d603llu, 0x45a9d2845d3c42b6llu,
+    0x865b86925b9bc5c2llu, 0x0b8a2392ba45a9b2llu,
+    0xa7f26836f282b732llu, 0x8e6cac7768d7141ellu,
+    0xd1ef0244af2364ffllu, 0x3207d795430cd926llu,
+    0x8335616aed761f1fllu, 0x7f44e6bd49e807b8llu,
+    0xa402b9c5a8d3a6e7llu, 0x5f16206c9c6209a6llu,
+    0xcd036837130890a1llu, 0x36dba887c37a8c0fllu,
+    0x802221226be55a64llu, 0xc2494954da2c9789llu,
+    0xa02aa96b06deb0fdllu, 0xf2db9baa10b7bd6cllu,
+    0xc83553c5c8965d3dllu, 0x6f92829494e5acc7llu,
+    0xfa42a8b73abbf48cllu, 0xcb772339ba1f17f9llu,
+    0x9c69a97284b578d7llu, 0xff2a760414536efbllu,
+    0xc38413cf25e2d70dllu, 0xfef5138519684aballu,
+    0xf46518c2ef5b8cd1llu, 0x7eb258665fc25d69llu,
+    0x98bf2f79d5993802llu, 0xef2f773ffbd97a61llu,
+    0xbeeefb584aff8603llu, 0xaafb550ffacfd8fallu,
+    0xeeaaba2e5dbf6784llu, 0x95ba2a53f983cf38llu,
+    0x952ab45cfa97a0b2llu, 0xdd945a747bf26183llu,
+    0xba756174393d88dfllu, 0x94f971119aeef9e4llu,
+    0xe912b9d1478ceb17llu, 0x7a37cd5601aab85dllu,
+    0x91abb422ccb812eellu, 0xac62e055c10ab33allu,
+    0xb616a12b7fe617aallu, 0x577b986b314d6009llu,
+    0xe39c49765fdf9d94llu, 0xed5a7e85fda0b80bllu,
+    0x8e41ade9fbebc27dllu, 0x14588f13be847307llu,
+    0xb1d219647ae6b31cllu, 0x596eb2d8ae258fc8llu,
+    0xde469fbd99a05fe3llu, 0x6fca5f8ed9aef3bbllu,
+    0x8aec23d680043beellu, 0x25de7bb9480d5854llu,
+    0xada72ccc20054ae9llu, 0xaf561aa79a10ae6allu,
+    0xd910f7ff28069da4llu, 0x1b2ba1518094da04llu,
+    0x87aa9aff79042286llu, 0x90fb44d2f05d0842llu,
+    0xa99541bf57452b28llu, 0x353a1607ac744a53llu,
+    0xd3fa922f2d1675f2llu, 0x42889b8997915ce8llu,
+    0x847c9b5d7c2e09b7llu, 0x69956135febada11llu,
+    0xa59bc234db398c25llu, 0x43fab9837e699095llu,
+    0xcf02b2c21207ef2ellu, 0x94f967e45e03f4bbllu,
+    0x8161afb94b44f57dllu, 0x1d1be0eebac278f5llu,
+    0xa1ba1ba79e1632dcllu, 0x6462d92a69731732llu,
+    0xca28a291859bbf93llu, 0x7d7b8f7503cfdcfellu,
+    0xfcb2cb35e702af78llu, 0x5cda735244c3d43ellu,
+    0x9defbf01b061adabllu, 0x3a0888136afa64a7llu,
+    0xc56baec21c7a1916llu, 0x088aaa1845b8fdd0llu,
+    0xf6c69a72a3989f5bllu, 0x8aad549e57273d45llu,
+    0x9a3c2087a63f6399llu, 0x36ac54e2f678864bllu,
+    0xc0cb28a98fcf3c7fllu, 0x84576a1bb416a7ddllu,
+    0xf0fdf2d3f3c30b9fllu, 0x656d44a2a11c51d5llu,
+    0x969eb7c47859e743llu, 0x9f644ae5a4b1b325llu,
+    0xbc4665b596706114llu, 0x873d5d9f0dde1feellu,
+    0xeb57ff22fc0c7959llu, 0xa90cb506d155a7eallu,
+    0x9316ff75dd87cbd8llu, 0x09a7f12442d588f2llu,
+    0xb7dcbf5354e9becellu, 0x0c11ed6d538aeb2fllu,
+    0xe5d3ef282a242e81llu, 0x8f1668c8a86da5fallu,
+    0x8fa475791a569d10llu, 0xf96e017d694487bcllu,
+    0xb38d92d760ec4455llu, 0x37c981dcc395a9acllu,
+    0xe070f78d3927556allu, 0x85bbe253f47b1417llu,
+    0x8c469ab843b89562llu, 0x93956d7478ccec8ellu,
+    0xaf58416654a6babbllu, 0x387ac8d1970027b2llu,
+    0xdb2e51bfe9d0696allu, 0x06997b05fcc0319ellu,
+    0x88fcf317f22241e2llu, 0x441fece3bdf81f03llu,
+    0xab3c2fddeeaad25allu, 0xd527e81cad7626c3llu,
+    0xd60b3bd56a5586f1llu, 0x8a71e223d8d3b074llu,
+    0x85c7056562757456llu, 0xf6872d5667844e49llu,
+    0xa738c6bebb12d16cllu, 0xb428f8ac016561dbllu,
+    0xd106f86e69d785c7llu, 0xe13336d701beba52llu,
+    0x82a45b450226b39cllu, 0xecc0024661173473llu,
+    0xa34d721642b06084llu, 0x27f002d7f95d0190llu,
+    0xcc20ce9bd35c78a5llu, 0x31ec038df7b441f4llu,
+    0xff290242c83396cellu, 0x7e67047175a15271llu,
+    0x9f79a169bd203e41llu, 0x0f0062c6e984d386llu,
+    0xc75809c42c684dd1llu, 0x52c07b78a3e60868llu,
+    0xf92e0c3537826145llu, 0xa7709a56ccdf8a82llu,
+    0x9bbcc7a142b17ccbllu, 0x88a66076400bb691llu,
+    0xc2abf989935ddbfellu, 0x6acff893d00ea435llu,
+    0xf356f7ebf83552fellu, 0x0583f6b8c4124d43llu,
+    0x98165af37b2153dellu, 0xc3727a337a8b704allu,
+    0xbe1bf1b059e9a8d6llu, 0x744f18c0592e4c5cllu,
+    0xeda2ee1c7064130cllu, 0x1162def06f79df73llu,
+    0x9485d4d1c63e8be7llu, 0x8addcb5645ac2ba8llu,
+    0xb9a74a0637ce2ee1llu, 0x6d953e2bd7173692llu,
+    0xe8111c87c5c1ba99llu, 0xc8fa8db6ccdd0437llu,
+    0x910ab1d4db9914a0llu, 0x1d9c9892400a22a2llu,
+    0xb54d5e4a127f59c8llu, 0x2503beb6d00cab4bllu,
+    0xe2a0b5dc971f303allu, 0x2e44ae64840fd61dllu,
+    0x8da471a9de737e24llu, 0x5ceaecfed289e5d2llu,
+    0xb10d8e1456105dadllu, 0x7425a83e872c5f47llu,
+    0xdd50f1996b947518llu, 0xd12f124e28f77719llu,
+    0x8a5296ffe33cc92fllu, 0x82bd6b70d99aaa6fllu,
+    0xace73cbfdc0bfb7bllu, 0x636cc64d1001550bllu,
+    0xd8210befd30efa5allu, 0x3c47f7e05401aa4ellu,
+    0x8714a775e3e95c78llu, 0x65acfaec34810a71llu,
+    0xa8d9d1535ce3b396llu, 0x7f1839a741a14d0dllu,
+    0xd31045a8341ca07cllu, 0x1ede48111209a050llu,
+    0x83ea2b892091e44dllu, 0x934aed0aab460432llu,
+    0xa4e4b66b68b65d60llu, 0xf81da84d5617853fllu,
+    0xce1de40642e3f4b9llu, 0x36251260ab9d668ellu,
+    0x80d2ae83e9ce78f3llu, 0xc1d72b7c6b426019llu,
+    0xa1075a24e4421730llu, 0xb24cf65b8612f81fllu,
+    0xc94930ae1d529cfcllu, 0xdee033f26797b627llu,
+    0xfb9b7cd9a4a7443cllu, 0x169840ef017da3b1llu,
+    0x9d412e0806e88aa5llu, 0x8e1f289560ee864ellu,
+    0xc491798a08a2ad4ellu, 0xf1a6f2bab92a27e2llu,
+    0xf5b5d7ec8acb58a2llu, 0xae10af696774b1dbllu,
+    0x9991a6f3d6bf1765llu, 0xacca6da1e0a8ef29llu,
+    0xbff610b0cc6edd3fllu, 0x17fd090a58d32af3llu,
+    0xeff394dcff8a948ellu, 0xddfc4b4cef07f5b0llu,
+    0x95f83d0a1fb69cd9llu, 0x4abdaf101564f98ellu,
+    0xbb764c4ca7a4440fllu, 0x9d6d1ad41abe37f1llu,
+    0xea53df5fd18d5513llu, 0x84c86189216dc5edllu,
+    0x92746b9be2f8552cllu, 0x32fd3cf5b4e49bb4llu,
+    0xb7118682dbb66a77llu, 0x3fbc8c33221dc2a1llu,
+    0xe4d5e82392a40515llu, 0x0fabaf3feaa5334allu,
+    0x8f05b1163ba6832dllu, 0x29cb4d87f2a7400ellu,
+    0xb2c71d5bca9023f8llu, 0x743e20e9ef511012llu,
+    0xdf78e4b2bd342cf6llu, 0x914da9246b255416llu,
+    0x8bab8eefb6409c1allu, 0x1ad089b6c2f7548ellu,
+    0xae9672aba3d0c320llu, 0xa184ac2473b529b1llu,
+    0xda3c0f568cc4f3e8llu, 0xc9e5d72d90a2741ellu,
+    0x8865899617fb1871llu, 0x7e2fa67c7a658892llu,
+    0xaa7eebfb9df9de8dllu, 0xddbb901b98feeab7llu,
+    0xd51ea6fa85785631llu, 0x552a74227f3ea565llu,
+    0x8533285c936b35dellu, 0xd53a88958f87275fllu,
+    0xa67ff273b8460356llu, 0x8a892abaf368f137llu,
+    0xd01fef10a657842cllu, 0x2d2b7569b0432d85llu,
+    0x8213f56a67f6b29bllu, 0x9c3b29620e29fc73llu,
+    0xa298f2c501f45f42llu, 0x8349f3ba91b47b8fllu,
+    0xcb3f2f7642717713llu, 0x241c70a936219a73llu,
+    0xfe0efb53d30dd4d7llu, 0xed238cd383aa0110llu,
+    0x9ec95d1463e8a506llu, 0xf4363804324a40aallu,
+    0xc67bb4597ce2ce48llu, 0xb143c6053edcd0d5llu,
+    0xf81aa16fdc1b81dallu, 0xdd94b7868e94050allu,
+    0x9b10a4e5e9913128llu, 0xca7cf2b4191c8326llu,
+    0xc1d4ce1f63f57d72llu, 0xfd1c2f611f63a3f0llu,
+    0xf24a01a73cf2dccfllu, 0xbc633b39673c8cecllu,
+    0x976e41088617ca01llu, 0xd5be0503e085d813llu,
+    0xbd49d14aa79dbc82llu, 0x4b2d8644d8a74e18llu,
+    0xec9c459d51852ba2llu, 0xddf8e7d60ed1219ellu,
+    0x93e1ab8252f33b45llu, 0xcabb90e5c942b503llu,
+    0xb8da1662e7b00a17llu, 0x3d6a751f3b936243llu,
+    0xe7109bfba19c0c9dllu, 0x0cc512670a783ad4llu,
+    0x906a617d450187e2llu, 0x27fb2b80668b24c5llu,
+    0xb484f9dc9641e9dallu, 0xb1f9f660802dedf6llu,
+    0xe1a63853bbd26451llu, 0x5e7873f8a0396973llu,
+    0x8d07e33455637eb2llu, 0xdb0b487b6423e1e8llu,
+    0xb049dc016abc5e5fllu, 0x91ce1a9a3d2cda62llu,
+    0xdc5c5301c56b75f7llu, 0x7641a140cc7810fbllu,
+    0x89b9b3e11b6329ballu, 0xa9e904c87fcb0a9dllu,
+    0xac2820d9623bf429llu, 0x546345fa9fbdcd44llu,
+    0xd732290fbacaf133llu, 0xa97c177947ad4095llu,
+    0x867f59a9d4bed6c0llu, 0x49ed8eabcccc485dllu,
+    0xa81f301449ee8c70llu, 0x5c68f256bfff5a74llu,
+    0xd226fc195c6a2f8cllu, 0x73832eec6fff3111llu,
+    0x83585d8fd9c25db7llu, 0xc831fd53c5ff7eabllu,
+    0xa42e74f3d032f525llu, 0xba3e7ca8b77f5e55llu,
+    0xcd3a1230c43fb26fllu, 0x28ce1bd2e55f35ebllu,
+    0x80444b5e7aa7cf85llu, 0x7980d163cf5b81b3llu,
+    0xa0555e361951c366llu, 0xd7e105bcc332621fllu,
+    0xc86ab5c39fa63440llu, 0x8dd9472bf3fefaa7llu,
+    0xfa856334878fc150llu, 0xb14f98f6f0feb951llu,
+    0x9c935e00d4b9d8d2llu, 0x6ed1bf9a569f33d3llu,
+    0xc3b8358109e84f07llu, 0x0a862f80ec4700c8llu,
+    0xf4a642e14c6262c8llu, 0xcd27bb612758c0fallu,
+    0x98e7e9cccfbd7dbdllu, 0x8038d51cb897789cllu,
+    0xbf21e44003acdd2cllu, 0xe0470a63e6bd56c3llu,
+    0xeeea5d5004981478llu, 0x1858ccfce06cac74llu,
+    0x95527a5202df0ccbllu, 0x0f37801e0c43ebc8llu,
+    0xbaa718e68396cffdllu, 0xd30560258f54e6ballu,
+    0xe950df20247c83fdllu, 0x47c6b82ef32a2069llu,
+    0x91d28b7416cdd27ellu, 0x4cdc331d57fa5441llu,
+    0xb6472e511c81471dllu, 0xe0133fe4adf8e952llu,
+    0xe3d8f9e563a198e5llu, 0x58180fddd97723a6llu,
+    0x8e679c2f5e44ff8fllu, 0x570f09eaa7ea7648llu,
+};
 
-function F64 tan_F64(F64 x) {
-    return(tanf(x));
-}
+typedef struct {
+    int mantissa_bits;
+    int minimum_exponent;
+    int infinite_power;
+    int smallest_power_of_ten;
+    int largest_power_of_ten;
+    int min_exponent_round_to_even;
+    int max_exponent_round_to_even;
+} ParseFloatFormat;
 
-function F64 ln_F64(F64 x) {
-    return(logf(x));
-}
+global ParseFloatFormat parse_format_F32 = { 23, -127, 0xFF, -65, 38, -17, 10 };
+global ParseFloatFormat parse_format_F64 = { 52, -1023, 0x7FF, -342, 308, -4, 23 };
 
-//////////////////////////////////////////////////////
-// NOTE(ryl1k): Compound Type Functions
+typedef struct {
+    U64 mantissa;
+    S32 power2;
+} ParseAdjustedMantissa;
 
-function V2S32 v2s32(S32 x, S32 y) {
-    V2S32 r = { x,y };
-    return (r);
-}
+function ParseAdjustedMantissa parse_compute_float(const ParseFloatFormat* f, S64 q, U64 w) {
+    ParseAdjustedMantissa r = { 0, 0 };
+    if (w == 0 || q < f->smallest_power_of_ten) {
+        return r;
+    }
+    if (q > f->largest_power_of_ten) {
+        r.power2 = f->infinite_power;
+        return r;
+    }
 
-function V2F32 v2f32(F32 x, F32 y) {
-    V2F32 r = { x,y };
-    return (r);
-}
-function V3F32 v3f32(F32 x, F32 y, F32 z) {
-    V3F32 r = { x,y,z };
-    return (r);
-}
-function V4F32 v4f32(F32 x, F32 y, F32 z, F32 w) {
-    V4F32 r = { x,y,z,w };
-    return (r);
-}
+    U32 lz = clz_U64(w);
+    w <<= lz;
 
-function I1F32 i1f32(F32 min, F32 max) {
-    I1F32 r = { min, max };
-    if (max < min) {
-        r.min = max;
-        r.max = min;
+    int index = 2 * (int)(q + 342);
+    U64 precision_mask = 0xFFFFFFFFFFFFFFFFllu >> (f->mantissa_bits + 3);
+    U64 lo;
+    U64 hi = mul_U64_hi_lo(w, power_of_five_128[index], &lo);
+    if ((hi & precision_mask) == precision_mask) {
+        U64 lo2;
+        U64 hi2 = mul_U64_hi_lo(w, power_of_five_128[index + 1], &lo2);
+        lo += hi2;
+        if (hi2 > lo) {
+            hi++;
+        }
     }
-    return(r);
-}
-function I1U64 i1u64(U64 min, U64 max) {
-    I1U64 r = {min, max};
-    if (max < min) {
-        r.min = max;
-        r.max = min;
+
+    int upperbit = (int)(hi >> 63);
+    int shift = upperbit + 64 - f->mantissa_bits - 3;
+    r.mantissa = hi >> shift;
+    S32 power = (S32)((((152170 + 65536) * (S32)q) >> 16) + 63);
+    r.power2 = power + upperbit - (S32)lz - f->minimum_exponent;
+    if (r.power2 <= 0) {
+        if (-r.power2 + 1 >= 64) {
+            r.mantissa = 0;
+            r.power2 = 0;
+            return r;
+        }
+        r.mantissa >>= -r.power2 + 1;
+        r.mantissa += (r.mantissa & 1);
+        r.mantissa >>= 1;
+        r.power2 = (r.mantissa < (1llu << f->mantissa_bits)) ? 0 : 1;
+        return r;
     }
-    return(r);
-}
 
-function I2S32 i2s32(S32 x0, S32 y0, S32 x1, S32 y1) {
-    I2S32 r = { x0,y0,x1,y1 };
-    if (x1 < x0) {
-        r.x0 = x1;
-        r.x1 = x0;
+    // NOTE(ryl1k): Exactly halfway between two floats, round to even.
+    if (lo <= 1 && q >= f->min_exponent_round_to_even && q <= f->max_exponent_round_to_even &&
+        (r.mantissa & 3) == 1) {
+        if ((r.mantissa << shift) == hi) {
+            r.mantissa &= ~1llu;
+        }
     }
-    if (y1 < y0) {
-        r.y1 = y0;
-        r.y0 = y1;
+    r.mantissa += (r.mantissa & 1);
+    r.mantissa >>= 1;
+    if (r.mantissa >= (2llu << f->mantissa_bits)) {
+        r.mantissa = (1llu << f->mantissa_bits);
+        r.power2++;
     }
-    return(r);
+    r.mantissa &= ~(1llu << f->mantissa_bits);
+    if (r.power2 >= f->infinite_power) {
+        r.power2 = f->infinite_power;
+        r.mantissa = 0;
+    }
+    return r;
 }
-function I2S32 i2s32_vec(V2S32 min, V2S32 max) {
-    I2S32 r = i2s32(min.x, min.y, max.x, max.y);
-    return(r);
+
+// NOTE(ryl1k): Returns 0 when the truncated mantissa leaves the result
+// ambiguous and the caller must fall back to exact conversion.
+function B32 parse_decimal_to_bits(const ParseFloatFormat* f, const ParseDecimal* d, U64* bits) {
+    ParseAdjustedMantissa am = parse_compute_float(f, d->exponent, d->mantissa);
+    if (d->too_many_digits) {
+        ParseAdjustedMantissa am1 = parse_compute_float(f, d->exponent, d->mantissa + 1);
+        if (am.mantissa != am1.mantissa || am.power2 != am1.power2) {
+            return 0;
+        }
+    }
+    *bits = am.mantissa | ((U64)am.power2 << f->mantissa_bits);
+    return 1;
 }
 
-function I2F32 i2f32(F32 x0, F32 y0, F32 x1, F32 y1) {
-    I2F32 r = { x0,y0,x1,y1 };
-    if (x1 < x0) {
-        r.x0 = x1;
-        r.x1 = x0;
+// NOTE(ryl1k): Rare slow path for inputs with more than 19 significant
+// digits sitting right on a rounding boundary. The copy swaps in the
+// locale's decimal point so strtod sees the number we saw.
+function F64 parse_fallback(const U8* at, int length, B32 single) {
+    char local_buffer[128];
+    char* buffer = local_buffer;
+    if (length + 1 > (int)sizeof(local_buffer)) {
+        buffer = BASE_ALLOC(length + 1);
+        if (!buffer) {
+            fprintf(stderr, "Failed to allocate memory for number parsing\n");
+            exit(EXIT_FAILURE);
+        }
     }
-    if (y1 < y0) {
-        r.y1 = y0;
-        r.y0 = y1;
+    char decimal_point = localeconv()->decimal_point[0];
+    for (int i = 0; i < length; i++) {
+        buffer[i] = (at[i] == '.') ? decimal_point : (char)at[i];
     }
-    return(r);
-}
-function I2F32 i2f32_vec(V2F32 min, V2F32 max) {
-    I2F32 r = i2f32(min.x, min.y, max.x, max.y);
-    return(r);
-}
-function I2F32 i2f32_range(I1F32 x, I1F32 y) {
-    I2F32 r = i2f32(x.min, y.min, x.max, y.max);
-    return(r);
+    buffer[length] = 0;
+    F64 result = single ? (F64)strtof(buffer, NULL) : strtod(buffer, NULL);
+    if (buffer != local_buffer) {
+        BASE_FREE(buffer);
+    }
+    return result;
 }
 
-function V2S32 add_V2S32(const V2S32 *a, const V2S32 *b) {
-    V2S32 r = { a->x + b->x, a->y + b->y };
-    return(r);
-}
-function V2F32 add_V2F32(const V2F32 *a, const V2F32 *b) {
-    V2F32 r = { a->x + b->x, a->y + b->y };
-    return(r);
-}
-function V3F32 add_V3F32(const V3F32 *a, const V3F32 *b) {
-    V3F32 r = { a->x + b->x, a->y + b->y, a->z + b->z };
-    return(r);
-}
-function V4F32 add_V4F32(const V4F32 *a, const V4F32 *b) {
-    V4F32 r = { a->x + b->x, a->y + b->y, a->z + b->z, a->w + b->w };
-    return(r);
-}
+// NOTE(ryl1k): Clinger's fast path is only exact without excess precision.
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD == 0
+#define PARSE_CLINGER_FAST_PATH 1
+#else
+#define PARSE_CLINGER_FAST_PATH 0
+#endif
 
-function V2S32 subtract_V2S32(const V2S32 *a, const V2S32 *b) {
-    V2S32 r = { a->x - b->x, a->y - b->y };
-    return(r);
-}
-function V2F32 subtract_V2F32(const V2F32 *a, const V2F32 *b) {
-    V2F32 r = { a->x - b->x, a->y - b->y };
-    return(r);
-}
-function V3F32 subtract_V3F32(const V3F32 *a, const V3F32 *b) {
-    V3F32 r = { a->x - b->x, a->y - b->y, a->z - b->z };
-    return(r);
-}
-function V4F32 subtract_V4F32(const V4F32 *a, const V4F32 *b) {
-    V4F32 r = { a->x - b->x, a->y - b->y, a->z - b->z, a->w - b->w };
-    return(r);
-}
+global F64 parse_powers_of_ten_F64[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+global F32 parse_powers_of_ten_F32[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+};
+
+function ParseF64 parse_F64(String s) {
+    ParseF64 r = { 0 };
+    ParseDecimal d = parse_decimal(s);
+    r.consumed = d.consumed;
+    if (d.consumed == 0) {
+        r.error = ParseError_NoDigits;
+        return r;
+    }
+    if (d.kind != ParseDecimalKind_Finite) {
+        F64 v = (d.kind == ParseDecimalKind_Inf) ? inf_F64() : nan_F64();
+        r.value = d.negative ? -v : v;
+        return r;
+    }
 
+    if (PARSE_CLINGER_FAST_PATH && !d.too_many_digits &&
+        d.exponent >= -22 && d.exponent <= 22 && d.mantissa <= (1llu << 53)) {
+        F64 v = (F64)d.mantissa;
+        if (d.exponent < 0) {
+            v = v / parse_powers_of_ten_F64[-d.exponent];
+        }
+        else {
+            v = v * parse_powers_of_ten_F64[d.exponent];
+        }
+        r.value = d.negative ? -v : v;
+        return r;
+    }
 
-function V2S32 multiply_V2S32(const V2S32 *v, const S32 *s) {
-    V2S32 r = { v->x * (*s), v->y * (*s) };
-    return(r);
+    U64 bits;
+    if (parse_decimal_to_bits(&parse_format_F64, &d, &bits)) {
+        union { F64 f; U64 u; } u;
+        u.u = bits | ((U64)d.negative << 63);
+        r.value = u.f;
+    }
+    else {
+        r.value = parse_fallback((const U8*)s.data, d.consumed, 0);
+    }
+    if (r.value == inf_F64() || r.value == neg_inf_F64()) {
+        r.error = ParseError_Overflow;
+    }
+    return r;
 }
-function V2F32 multiply_V2F32(const V2F32 *v, const F32 *s) {
-    V2F32 r = { v->x * (*s), v->y * (*s) };
-    return(r);
+
+function ParseF32 parse_F32(String s) {
+    ParseF32 r = { 0 };
+    ParseDecimal d = parse_decimal(s);
+    r.consumed = d.consumed;
+    if (d.consumed == 0) {
+        r.error = ParseError_NoDigits;
+        return r;
+    }
+    if (d.kind != ParseDecimalKind_Finite) {
+        F32 v = (d.kind == ParseDecimalKind_Inf) ? inf_F32() : nan_F32();
+        r.value = d.negative ? -v : v;
+        return r;
+    }
+
+    if (PARSE_CLINGER_FAST_PATH && !d.too_many_digits &&
+        d.exponent >= -10 && d.exponent <= 10 && d.mantissa <= (1llu << 24)) {
+        F32 v = (F32)d.mantissa;
+        if (d.exponent < 0) {
+            v = v / parse_powers_of_ten_F32[-d.exponent];
+        }
+        else {
+            v = v * parse_powers_of_ten_F32[d.exponent];
+        }
+        r.value = d.negative ? -v : v;
+        return r;
+    }
+
+    U64 bits;
+    if (parse_decimal_to_bits(&parse_format_F32, &d, &bits)) {
+        union { F32 f; U32 u; } u;
+        u.u = (U32)bits | ((U32)d.negative << 31);
+        r.value = u.f;
+    }
+    else {
+        r.value = (F32)parse_fallback((const U8*)s.data, d.consumed, 1);
+    }
+    if (r.value == inf_F32() || r.value == neg_inf_F32()) {
+        r.error = ParseError_Overflow;
+    }
+    return r;
 }
-function V3F32 multiply_V3F32(const V3F32 *v, const F32 *s) {
-    V3F32 r = { v->x * (*s), v->y * (*s), v->z * (*s) };
-    return(r);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Hashtable Functions
+
+// NOTE(ryl1k): Swiss table. Control bytes live in their own array and are
+// probed one 16-byte group at a time; a full slot stores the low 7 bits of
+// its hash (H2), the rest of the hash (H1) picks the first group.
+#if defined(__SSE2__) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HASH_GROUP_SSE2 1
+#define HASH_GROUP_SHIFT 0
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define HASH_GROUP_NEON 1
+#define HASH_GROUP_SHIFT 2
+#else
+#define HASH_GROUP_SHIFT 0
+#endif
+
+#define HASH_GROUP_WIDTH  16
+#define HASH_CTRL_EMPTY   ((U8)0x80)
+#define HASH_CTRL_DELETED ((U8)0xFE)
+
+#if defined(HASH_GROUP_NEON)
+function U64 hash_group_neon_mask(uint8x16_t eq) {
+    uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888llu;
 }
-function V4F32 multiply_V4F32(const V4F32 *v, const F32 *s) {
-    V4F32 r = { v->x * (*s), v->y * (*s), v->z * (*s), v->w * (*s) };
-    return(r);
+#endif
+
+function U64 hash_group_match(const U8* ctrl, U8 h2) {
+#if defined(HASH_GROUP_SSE2)
+    __m128i group = _mm_load_si128((const __m128i*)ctrl);
+    return (U64)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)h2)));
+#elif defined(HASH_GROUP_NEON)
+    return hash_group_neon_mask(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(h2)));
+#else
+    U64 mask = 0;
+    for (U32 i = 0; i < HASH_GROUP_WIDTH; i++) {
+        mask |= (U64)(ctrl[i] == h2) << i;
+    }
+    return mask;
+#endif
 }
 
+function U64 hash_group_match_empty(const U8* ctrl) {
+    return hash_group_match(ctrl, HASH_CTRL_EMPTY);
+}
 
-function V2F32 V2F32_hadamard(V2F32 a, V2F32 b) {
-    V2F32 r = { a.x * b.x, a.y * b.y };
-    return (r);
+function U64 hash_group_match_empty_or_deleted(const U8* ctrl) {
+#if defined(HASH_GROUP_SSE2)
+    return (U64)_mm_movemask_epi8(_mm_load_si128((const __m128i*)ctrl));
+#elif defined(HASH_GROUP_NEON)
+    int8x16_t group = vreinterpretq_s8_u8(vld1q_u8(ctrl));
+    return hash_group_neon_mask(vcltq_s8(group, vdupq_n_s8(0)));
+#else
+    U64 mask = 0;
+    for (U32 i = 0; i < HASH_GROUP_WIDTH; i++) {
+        mask |= (U64)(ctrl[i] >> 7) << i;
+    }
+    return mask;
+#endif
 }
-function V3F32 V3F32_hadamard(V3F32 a, V3F32 b) {
-    V3F32 r = { a.x * b.x, a.y * b.y, a.z * b.z };
-    return (r);
+
+function U64 hash_group_match_full(const U8* ctrl) {
+#if defined(HASH_GROUP_NEON)
+    return hash_group_match_empty_or_deleted(ctrl) ^ 0x8888888888888888llu;
+#else
+    return hash_group_match_empty_or_deleted(ctrl) ^ 0xFFFFllu;
+#endif
 }
-function V4F32 V4F32_hadamard(V4F32 a, V4F32 b){
-    V4F32 r = { a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w };
-    return (r);
+
+function U32 hash_group_lane(U64 mask) {
+    return ctz_U64(mask) >> HASH_GROUP_SHIFT;
 }
 
-function V2F32 V2F32_dot(V2F32 a, V2F32 b) {
-    V2F32 r = { a.x * b.x, a.y * b.y };
-    return (r);
+function U64 hash_mix(U64 a, U64 b) {
+    U64 lo;
+    U64 hi = mul_U64_hi_lo(a, b, &lo);
+    return hi ^ lo;
 }
-function V3F32 V3F32_dot(V3F32 a, V3F32 b) {
-    V3F32 r = { a.x * b.x, a.y * b.y , a.z * b.z };
-    return (r);
+
+function U64 hash_U64(U64 x) {
+    return hash_mix(x ^ 0x9E3779B97F4A7C15llu, 0xBF58476D1CE4E5B9llu);
 }
-function V4F32 V4F32_dot(V4F32 a, V4F32 b) {
-    V4F32 r = { a.x * b.x, a.y * b.y , a.z * b.z, a.w * b.w };
-    return (r);
+
+function U64 hash_bytes(const void* data, U64 size) {
+    const U8* p = (const U8*)data;
+    U64 h = 0x9E3779B97F4A7C15llu ^ size;
+    while (size >= 8) {
+        U64 v;
+        memcpy(&v, p, 8);
+        h = hash_mix(h ^ v, 0xBF58476D1CE4E5B9llu);
+        p += 8;
+        size -= 8;
+    }
+    if (size > 0) {
+        U64 v = 0;
+        memcpy(&v, p, size);
+        h = hash_mix(h ^ v, 0x94D049BB133111EBllu);
+    }
+    return hash_mix(h, 0xBF58476D1CE4E5B9llu);
 }
 
-function B32 I1F32_overlaps(I1F32 a, I1F32 b) {
-    B32 result = ( b.min < a.max && a.min < b.max );
-    return (result);
+function U64 hash_table_hash_U32(const void* key) {
+    return hash_U64(*(const U32*)key);
 }
-function B32 I1F32_contains(I1F32 r, F32 x) {
-    B32 result = (r.min <= x && x < r.max);
-    return result;
+function B32 hash_table_equal_U32(const void* a, const void* b) {
+    return *(const U32*)a == *(const U32*)b;
 }
-function B32 I2F32_contains(I2F32 r, V2F32 x) {
-    return (r.min.x <= x.x && x.x <= r.max.x &&
-        r.min.y <= x.y && x.y <= r.max.y); 
+function U64 hash_table_hash_U64(const void* key) {
+    return hash_U64(*(const U64*)key);
 }
-function B32 I2F32_overlaps(I2F32 a, I2F32 b) {
-    return (b.min.x <= a.max.x && a.min.x <= b.max.x &&
-        b.min.y <= a.max.y && a.min.y <= b.max.y); 
+function B32 hash_table_equal_U64(const void* a, const void* b) {
+    return *(const U64*)a == *(const U64*)b;
 }
-function B32 I2S32_overlaps(I2S32 a, I2S32 b) {
-    B32 result = (b.min.x < a.max.x && a.min.x < b.max.x &&
-                  b.min.y < a.max.y && a.min.y < b.max.y);
-    return result;
+function U64 hash_table_hash_String(const void* key) {
+    const String* s = (const String*)key;
+    return hash_bytes(s->data, (U64)s->length);
 }
-function B32 I2S32_contains(I2S32 r, V2S32 x) {
-    B32 result = (r.min.x <= x.x && x.x < r.max.x &&
-                  r.min.y <= x.y && x.y < r.max.y);
-    return result;
+function B32 hash_table_equal_String(const void* a, const void* b) {
+    const String* x = (const String*)a;
+    const String* y = (const String*)b;
+    return x->length == y->length && MemoryCompare(x->data, y->data, (size_t)x->length);
 }
 
-function F32 I1F32_dim(I1F32 r) {
-    if (r.max == FLT_MAX && r.min == -FLT_MAX) {
-        return FLT_MAX; 
+function U32 hash_table_alignment(U32 size) {
+    U32 align = 1;
+    while (align < 8 && align < size) {
+        align <<= 1;
     }
-    return r.max - r.min;
+    return align;
 }
 
-function U64 I1U64_dim(I1U64 r) {
-    U64 result = r.max - r.min;
-    return(result);
+function HashTable hash_table_create(Arena* arena, U32 key_size, U32 value_size,
+                                     HashFunc* hash, HashEqualFunc* equal, U64 capacity) {
+    HashTable table;
+    MemoryZeroStruct(&table);
+    U32 key_align = hash_table_alignment(key_size);
+    U32 value_align = hash_table_alignment(value_size);
+    U32 slot_align = Max(key_align, value_align);
+    table.key_size = key_size;
+    table.value_size = value_size;
+    table.value_offset = (key_size + value_align - 1) & ~(value_align - 1);
+    table.slot_size = (table.value_offset + value_size + slot_align - 1) & ~(slot_align - 1);
+    table.hash = hash;
+    table.equal = equal;
+    table.arena = arena;
+    if (capacity > 0) {
+        hash_table_reserve(&table, capacity);
+    }
+    return table;
 }
-function V2F32 I2F32_dim(I2F32 r) {
-    V2F32 result = { r.x1 - r.x0, r.y1 - r.y0 };
-    return(result);
+
+function U8* hash_table_slot(HashTable* table, U64 index) {
+    return table->slots + index * table->slot_size;
 }
-function V2S32 I2S32_dim(I2S32 r) {
-    V2S32 result = {r.x1 - r.x0, r.y1 - r.y0};
-    return(result);
+
+// NOTE(ryl1k): Returns the index of the first empty or deleted slot along
+// the probe sequence of hash. The table must have room.
+function U64 hash_table_find_free(HashTable* table, U64 hash) {
+    U64 group_mask = (table->capacity / HASH_GROUP_WIDTH) - 1;
+    U64 group = (hash >> 7) & group_mask;
+    for (U64 step = 1;; step++) {
+        U64 mask = hash_group_match_empty_or_deleted(table->ctrl + group * HASH_GROUP_WIDTH);
+        if (mask) {
+            return group * HASH_GROUP_WIDTH + hash_group_lane(mask);
+        }
+        group = (group + step) & group_mask;
+    }
 }
 
-function F32 I1F32_center(I1F32 r) {
-    F32 result = (r.min + r.max) * 0.5f;
-    return(result);
+function B32 hash_table_rehash(HashTable* table, U64 new_capacity) {
+    U64 bytes = new_capacity + new_capacity * table->slot_size + HASH_GROUP_WIDTH;
+    void* memory = table->arena ? arena_alloc(table->arena, bytes) : BASE_ALLOC(bytes);
+    if (!memory) {
+        return 0;
+    }
+
+    HashTable old = *table;
+    table->memory = memory;
+    table->ctrl = ALIGN_PTR(memory, HASH_GROUP_WIDTH);
+    table->slots = table->ctrl + new_capacity;
+    table->capacity = new_capacity;
+    table->growth_left = new_capacity - new_capacity / 8 - old.count;
+    memset(table->ctrl, HASH_CTRL_EMPTY, new_capacity);
+
+    for (U64 group = 0; group < old.capacity; group += HASH_GROUP_WIDTH) {
+        U64 mask = hash_group_match_full(old.ctrl + group);
+        while (mask) {
+            U64 index = group + hash_group_lane(mask);
+            U8* slot = hash_table_slot(&old, index);
+            U64 hash = table->hash(slot);
+            U64 target = hash_table_find_free(table, hash);
+            table->ctrl[target] = (U8)(hash & 0x7F);
+            MemoryCopy(hash_table_slot(table, target), slot, table->slot_size);
+            mask &= mask - 1;
+        }
+    }
+
+    if (!old.arena && old.memory) {
+        BASE_FREE(old.memory);
+    }
+    return 1;
 }
-function V2F32 I2F32_center(I2F32 r) {
-    V2F32 result = {
-        .x = (r.min.x + r.max.x) * 0.5f,
-        .y = (r.min.y + r.max.y) * 0.5f
-    };
-    return result;
+
+function B32 hash_table_reserve(HashTable* table, U64 count) {
+    U64 capacity = HASH_GROUP_WIDTH;
+    while (capacity - capacity / 8 < count) {
+        capacity <<= 1;
+    }
+    if (capacity <= table->capacity) {
+        return 1;
+    }
+    return hash_table_rehash(table, capacity);
 }
 
-function I1F32 I1F32_axis(I2F32 r, Axis axis) {
-    I1F32 result = {
-        .min = r.min.v[axis],
-        .max = r.max.v[axis]
-    };
-    return result;
-}
\ No newline at end of file
+function void* hash_table_find(HashTable* table, const void* key, U64 hash) {
+    if (table->count == 0) {
+        return NULL;
+    }
+    U8 h2 = (U8)(hash & 0x7F);
+    U64 group_mask = (table->capacity / HASH_GROUP_WIDTH) - 1;
+    U64 group = (hash >> 7) & group_mask;
+    for (U64 step = 1;; step++) {
+        const U8* ctrl = table->ctrl + group * HASH_GROUP_WIDTH;
+        U64 mask = hash_group_match(ctrl, h2);
+        while (mask) {
+            U8* slot = hash_table_slot(table, group * HASH_GROUP_WIDTH + hash_group_lane(mask));
+            if (table->equal(slot, key)) {
+                return slot + table->value_offset;
+            }
+            mask &= mask - 1;
+        }
+        if (hash_group_match_empty(ctrl)) {
+            return NULL;
+        }
+        group = (group + step) & group_mask;
+    }
+}
+
+function void* hash_table_lookup(HashTable* table, const void* key) {
+    if (table->count == 0) {
+        return NULL;
+    }
+    return hash_table_find(table, key, table->hash(key));
+}
+
+function void* hash_table_insert(HashTable* table, const void* key, const void* value) {
+    U64 hash = table->hash(key);
+    void* existing = hash_table_find(table, key, hash);
+    if (existing) {
+        if (value) {
+            MemoryCopy(existing, value, table->value_size);
+        }
+        return existing;
+    }
+
+    U64 index = 0;
+    if (table->capacity > 0) {
+        index = hash_table_find_free(table, hash);
+    }
+    if (table->capacity == 0 || (table->growth_left == 0 && table->ctrl[index] == HASH_CTRL_EMPTY)) {
+        // NOTE(ryl1k): Mostly tombstones: rebuild at the same size instead of growing.
+        U64 capacity = table->capacity ? table->capacity : HASH_GROUP_WIDTH;
+        if (table->count + 1 > (capacity - capacity / 8) / 2) {
+            capacity *= 2;
+        }
+        if (!hash_table_rehash(table, capacity)) {
+            return NULL;
+        }
+        index = hash_table_find_free(table, hash);
+    }
+
+    table->growth_left -= (table->ctrl[index] == HASH_CTRL_EMPTY);
+    table->ctrl[index] = (U8)(hash & 0x7F);
+    table->count++;
+    U8* slot = hash_table_slot(table, index);
+    MemoryCopy(slot, key, table->key_size);
+    if (value) {
+        MemoryCopy(slot + table->value_offset, value, table->value_size);
+    }
+    else {
+        MemoryZero(slot + table->value_offset, table->value_size);
+    }
+    return slot + table->value_offset;
+}
+
+function B32 hash_table_erase(HashTable* table, const void* key) {
+    U8* value = hash_table_lookup(table, key);
+    if (!value) {
+        return 0;
+    }
+    U64 index = (U64)(value - table->value_offset - table->slots) / table->slot_size;
+    U8* group = table->ctrl + (index & ~(U64)(HASH_GROUP_WIDTH - 1));
+    // NOTE(ryl1k): A group that still has an empty byte has never been full,
+    // so no probe went past it and the slot can go straight back to empty.
+    if (hash_group_match_empty(group)) {
+        table->ctrl[index] = HASH_CTRL_EMPTY;
+        table->growth_left++;
+    }
+    else {
+        table->ctrl[index] = HASH_CTRL_DELETED;
+    }
+    table->count--;
+    return 1;
+}
+
+function B32 hash_table_next(HashTable* table, U64* iterator, void** key, void** value) {
+    U64 index = *iterator;
+    while (index < table->capacity) {
+        U64 group = index & ~(U64)(HASH_GROUP_WIDTH - 1);
+        U64 lane = index - group;
+        U64 mask = hash_group_match_full(table->ctrl + group) >> (lane << HASH_GROUP_SHIFT);
+        if (mask) {
+            index += hash_group_lane(mask);
+            U8* slot = hash_table_slot(table, index);
+            if (key) {
+                *key = slot;
+            }
+            if (value) {
+                *value = slot + table->value_offset;
+            }
+            *iterator = index + 1;
+            return 1;
+        }
+        index = group + HASH_GROUP_WIDTH;
+    }
+    *iterator = index;
+    return 0;
+}
+
+function void hash_table_clear(HashTable* table) {
+    if (table->capacity > 0) {
+        memset(table->ctrl, HASH_CTRL_EMPTY, table->capacity);
+    }
+    table->count = 0;
+    table->growth_left = table->capacity - table->capacity / 8;
+}
+
+function void hash_table_destroy(HashTable* table) {
+    if (!table->arena && table->memory) {
+        BASE_FREE(table->memory);
+    }
+    table->memory = NULL;
+    table->ctrl = NULL;
+    table->slots = NULL;
+    table->capacity = 0;
+    table->count = 0;
+    table->growth_left = 0;
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Unrolled List Functions
+
+function UnrolledList unrolled_list_create(Arena* arena, U32 element_size, U64 chunk_bytes) {
+    UnrolledList list;
+    MemoryZeroStruct(&list);
+    if (chunk_bytes == 0) {
+        chunk_bytes = UNROLLED_CHUNK_BYTES;
+    }
+    // NOTE(ryl1k): At least four elements per chunk, so splitting a full
+    // chunk always leaves both halves non-empty.
+    U64 min_bytes = UNROLLED_CHUNK_HEADER + 4 * (U64)element_size;
+    chunk_bytes = Max(chunk_bytes, min_bytes);
+    chunk_bytes = (chunk_bytes + CACHE_LINE_SIZE - 1) & ~(U64)(CACHE_LINE_SIZE - 1);
+    list.element_size = element_size;
+    list.chunk_bytes = chunk_bytes;
+    list.chunk_capacity = (U32)((chunk_bytes - UNROLLED_CHUNK_HEADER) / element_size);
+    list.arena = arena;
+    return list;
+}
+
+function UnrolledChunk* unrolled_list_new_chunk(UnrolledList* list) {
+    UnrolledChunk* chunk = list->free_chunks;
+    if (chunk) {
+        list->free_chunks = chunk->next;
+    } else if (list->arena) {
+        chunk = arena_alloc_aligned(list->arena, list->chunk_bytes, CACHE_LINE_SIZE);
+    } else {
+        chunk = BASE_ALLOC(list->chunk_bytes);
+    }
+    if (chunk) {
+        DLL_INIT(chunk);
+        chunk->count = 0;
+    }
+    return chunk;
+}
+
+// NOTE(ryl1k): Links chunk after prev, or at the front when prev is NULL.
+function void unrolled_list_link(UnrolledList* list, UnrolledChunk* prev, UnrolledChunk* chunk) {
+    if (prev) {
+        DLL_INSERT_AFTER(prev, chunk);
+    } else {
+        chunk->prev = NULL;
+        chunk->next = list->first;
+        if (list->first) {
+            list->first->prev = chunk;
+        }
+        list->first = chunk;
+    }
+    if (list->last == prev) {
+        list->last = chunk;
+    }
+}
+
+function void unrolled_list_free_chunk(UnrolledList* list, UnrolledChunk* chunk) {
+    if (list->first == chunk) {
+        list->first = chunk->next;
+    }
+    if (list->last == chunk) {
+        list->last = chunk->prev;
+    }
+    DLL_REMOVE(chunk);
+    chunk->next = list->free_chunks;
+    list->free_chunks = chunk;
+}
+
+function void* unrolled_list_push_back(UnrolledList* list, const void* value) {
+    UnrolledChunk* chunk = list->last;
+    if (!chunk || chunk->count == list->chunk_capacity) {
+        chunk = unrolled_list_new_chunk(list);
+        if (!chunk) {
+            return NULL;
+        }
+        unrolled_list_link(list, list->last, chunk);
+    }
+    U8* result = UNROLLED_CHUNK_DATA(chunk) + chunk->count * list->element_size;
+    MemoryCopy(result, value, list->element_size);
+    chunk->count++;
+    list->count++;
+    return result;
+}
+
+function void* unrolled_list_push_front(UnrolledList* list, const void* value) {
+    UnrolledChunk* chunk = list->first;
+    if (!chunk || chunk->count == list->chunk_capacity) {
+        chunk = unrolled_list_new_chunk(list);
+        if (!chunk) {
+            return NULL;
+        }
+        unrolled_list_link(list, NULL, chunk);
+    }
+    U8* result = UNROLLED_CHUNK_DATA(chunk);
+    MemoryCopy(result + list->element_size, result, chunk->count * list->element_size);
+    MemoryCopy(result, value, list->element_size);
+    chunk->count++;
+    list->count++;
+    return result;
+}
+
+function B32 unrolled_list_pop_back(UnrolledList* list, void* out) {
+    UnrolledChunk* chunk = list->last;
+    if (!chunk) {
+        return 0;
+    }
+    chunk->count--;
+    list->count--;
+    if (out) {
+        MemoryCopy(out, UNROLLED_CHUNK_DATA(chunk) + chunk->count * list->element_size, list->element_size);
+    }
+    if (chunk->count == 0) {
+        unrolled_list_free_chunk(list, chunk);
+    }
+    return 1;
+}
+
+function B32 unrolled_list_pop_front(UnrolledList* list, void* out) {
+    UnrolledChunk* chunk = list->first;
+    if (!chunk) {
+        return 0;
+    }
+    U8* data = UNROLLED_CHUNK_DATA(chunk);
+    if (out) {
+        MemoryCopy(out, data, list->element_size);
+    }
+    chunk->count--;
+    list->count--;
+    MemoryCopy(data, data + list->element_size, chunk->count * list->element_size);
+    if (chunk->count == 0) {
+        unrolled_list_free_chunk(list, chunk);
+    }
+    return 1;
+}
+
+// NOTE(ryl1k): Inserts before *at and leaves *at on the new element.
+function void* unrolled_list_insert(UnrolledList* list, UnrolledListIter* at, const void* value) {
+    UnrolledChunk* chunk = at->chunk;
+    U64 index = at->index;
+    if (!chunk) {
+        U8* result = unrolled_list_push_back(list, value);
+        if (result) {
+            at->chunk = list->last;
+            at->index = list->last->count - 1;
+        }
+        return result;
+    }
+    U64 size = list->element_size;
+    if (chunk->count == list->chunk_capacity) {
+        UnrolledChunk* split = unrolled_list_new_chunk(list);
+        if (!split) {
+            return NULL;
+        }
+        unrolled_list_link(list, chunk, split);
+        U64 half = chunk->count / 2;
+        split->count = chunk->count - half;
+        chunk->count = half;
+        MemoryCopy(UNROLLED_CHUNK_DATA(split), UNROLLED_CHUNK_DATA(chunk) + half * size, split->count * size);
+        if (index > half) {
+            chunk = split;
+            index -= half;
+        }
+    }
+    U8* result = UNROLLED_CHUNK_DATA(chunk) + index * size;
+    MemoryCopy(result + size, result, (chunk->count - index) * size);
+    MemoryCopy(result, value, size);
+    chunk->count++;
+    list->count++;
+    at->chunk = chunk;
+    at->index = index;
+    return result;
+}
+
+// NOTE(ryl1k): Leaves *at on the element that followed the removed one.
+function void unrolled_list_remove(UnrolledList* list, UnrolledListIter* at) {
+    UnrolledChunk* chunk = at->chunk;
+    U64 index = at->index;
+    U64 size = list->element_size;
+    U8* data = UNROLLED_CHUNK_DATA(chunk);
+    chunk->count--;
+    list->count--;
+    MemoryCopy(data + index * size, data + (index + 1) * size, (chunk->count - index) * size);
+    if (chunk->count == 0) {
+        at->chunk = chunk->next;
+        at->index = 0;
+        unrolled_list_free_chunk(list, chunk);
+        return;
+    }
+    UnrolledChunk* next = chunk->next;
+    if (chunk->count < list->chunk_capacity / 2 && next &&
+        chunk->count + next->count <= list->chunk_capacity) {
+        MemoryCopy(data + chunk->count * size, UNROLLED_CHUNK_DATA(next), next->count * size);
+        chunk->count += next->count;
+        unrolled_list_free_chunk(list, next);
+    }
+    if (index == chunk->count) {
+        at->chunk = chunk->next;
+        at->index = 0;
+    }
+}
+
+function UnrolledListIter unrolled_list_begin(UnrolledList* list) {
+    UnrolledListIter it;
+    it.chunk = list->first;
+    it.index = 0;
+    return it;
+}
+
+function UnrolledListIter unrolled_list_at(UnrolledList* list, U64 index) {
+    UnrolledListIter it;
+    it.chunk = list->first;
+    while (it.chunk && index >= it.chunk->count) {
+        index -= it.chunk->count;
+        it.chunk = it.chunk->next;
+    }
+    it.index = it.chunk ? index : 0;
+    return it;
+}
+
+function void* unrolled_list_get(UnrolledList* list, UnrolledListIter it) {
+    return UNROLLED_CHUNK_DATA(it.chunk) + it.index * list->element_size;
+}
+
+function B32 unrolled_list_next(UnrolledList* list, UnrolledListIter* it) {
+    (void)list;
+    if (!it->chunk) {
+        return 0;
+    }
+    it->index++;
+    if (it->index == it->chunk->count) {
+        it->chunk = it->chunk->next;
+        it->index = 0;
+    }
+    return it->chunk != NULL;
+}
+
+function void unrolled_list_clear(UnrolledList* list) {
+    while (list->first) {
+        unrolled_list_free_chunk(list, list->first);
+    }
+    list->count = 0;
+}
+
+function void unrolled_list_destroy(UnrolledList* list) {
+    unrolled_list_clear(list);
+    if (!list->arena) {
+        while (list->free_chunks) {
+            UnrolledChunk* next = list->free_chunks->next;
+            BASE_FREE(list->free_chunks);
+            list->free_chunks = next;
+        }
+    }
+    list->free_chunks = NULL;
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Atomic Functions
+
+function U32 atomic_load_U32(volatile U32* p) {
+#if defined(_MSC_VER) && defined(_M_ARM64)
+    return __ldar32((unsigned __int32 volatile*)p);
+#elif defined(_MSC_VER)
+    U32 v = *p;
+    _ReadWriteBarrier();
+    return v;
+#else
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#endif
+}
+
+function void atomic_store_U32(volatile U32* p, U32 v) {
+#if defined(_MSC_VER) && defined(_M_ARM64)
+    __stlr32((unsigned __int32 volatile*)p, v);
+#elif defined(_MSC_VER)
+    _ReadWriteBarrier();
+    *p = v;
+#else
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+#endif
+}
+
+function U32 atomic_fetch_add_U32(volatile U32* p, U32 v) {
+#if defined(_MSC_VER)
+    return (U32)_InterlockedExchangeAdd((volatile long*)p, (long)v);
+#else
+    return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST);
+#endif
+}
+
+function U64 atomic_load_U64(volatile U64* p) {
+#if defined(_MSC_VER) && defined(_M_ARM64)
+    return __ldar64((unsigned __int64 volatile*)p);
+#elif defined(_MSC_VER)
+    U64 v = *p;
+    _ReadWriteBarrier();
+    return v;
+#else
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#endif
+}
+
+function void atomic_store_U64(volatile U64* p, U64 v) {
+#if defined(_MSC_VER) && defined(_M_ARM64)
+    __stlr64((unsigned __int64 volatile*)p, v);
+#elif defined(_MSC_VER)
+    _ReadWriteBarrier();
+    *p = v;
+#else
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+#endif
+}
+
+function U64 atomic_fetch_add_U64(volatile U64* p, U64 v) {
+#if defined(_MSC_VER)
+    return (U64)_InterlockedExchangeAdd64((volatile __int64*)p, (__int64)v);
+#else
+    return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST);
+#endif
+}
+
+function U64 atomic_exchange_U64(volatile U64* p, U64 v) {
+#if defined(_MSC_VER)
+    return (U64)_InterlockedExchange64((volatile __int64*)p, (__int64)v);
+#else
+    return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST);
+#endif
+}
+
+function B32 atomic_cas_U64(volatile U64* p, U64* expected, U64 desired) {
+#if defined(_MSC_VER)
+    U64 prev = (U64)_InterlockedCompareExchange64((volatile __int64*)p, (__int64)desired, (__int64)*expected);
+    B32 result = (prev == *expected);
+    *expected = prev;
+    return result;
+#else
+    return __atomic_compare_exchange_n(p, expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+#if defined(ATOMIC_HAS_CAS_U128)
+function B32 atomic_cas_U128(volatile U128* p, U128* expected, U128 desired) {
+#if defined(_MSC_VER)
+    return _InterlockedCompareExchange128((volatile __int64*)p, (__int64)desired.hi,
+                                          (__int64)desired.lo, (__int64*)expected) != 0;
+#elif defined(__x86_64__)
+    U8 ok;
+    __asm__ __volatile__("lock cmpxchg16b %1\n\t"
+                         "sete %0"
+                         : "=q"(ok), "+m"(*p), "+a"(expected->lo), "+d"(expected->hi)
+                         : "b"(desired.lo), "c"(desired.hi)
+                         : "memory", "cc");
+    return ok;
+#elif defined(__aarch64__)
+    // NOTE(ryl1k): On mismatch the observed value is stored back so the
+    // pair read is single-copy atomic, as the compiler's own sequence does.
+    U64 lo, hi;
+    U32 status;
+    __asm__ __volatile__("1: ldaxp %0, %1, %3\n\t"
+                         "cmp %0, %4\n\t"
+                         "ccmp %1, %5, #0, eq\n\t"
+                         "b.ne 2f\n\t"
+                         "stlxp %w2, %6, %7, %3\n\t"
+                         "cbnz %w2, 1b\n\t"
+                         "b 3f\n"
+                         "2: stlxp %w2, %0, %1, %3\n\t"
+                         "cbnz %w2, 1b\n"
+                         "3:"
+                         : "=&r"(lo), "=&r"(hi), "=&r"(status), "+Q"(*p)
+                         : "r"(expected->lo), "r"(expected->hi), "r"(desired.lo), "r"(desired.hi)
+                         : "memory", "cc");
+    B32 ok = (lo == expected->lo && hi == expected->hi);
+    expected->lo = lo;
+    expected->hi = hi;
+    return ok;
+#else
+    return __atomic_compare_exchange_n((volatile unsigned __int128*)p, (unsigned __int128*)expected,
+                                       *(unsigned __int128*)&desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+#endif
+
+function void* atomic_load_ptr(void* volatile* p) {
+#if defined(_MSC_VER) && defined(_M_ARM64)
+    return (void*)__ldar64((unsigned __int64 volatile*)p);
+#elif defined(_MSC_VER)
+    void* v = *p;
+    _ReadWriteBarrier();
+    return v;
+#else
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#endif
+}
+
+function void atomic_store_ptr(void* volatile* p, void* v) {
+#if defined(_MSC_VER) && defined(_M_ARM64)
+    __stlr64((unsigned __int64 volatile*)p, (unsigned __int64)v);
+#elif defined(_MSC_VER)
+    _ReadWriteBarrier();
+    *p = v;
+#else
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+#endif
+}
+
+function void* atomic_exchange_ptr(void* volatile* p, void* v) {
+#if defined(_MSC_VER)
+    return _InterlockedExchangePointer(p, v);
+#else
+    return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST);
+#endif
+}
+
+function B32 atomic_cas_ptr(void* volatile* p, void** expected, void* desired) {
+#if defined(_MSC_VER)
+    void* prev = _InterlockedCompareExchangePointer(p, desired, *expected);
+    B32 result = (prev == *expected);
+    *expected = prev;
+    return result;
+#else
+    return __atomic_compare_exchange_n(p, expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+function void atomic_fence(void) {
+#if defined(_MSC_VER)
+    MemoryBarrier();
+#else
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+function void cpu_pause(void) {
+#if defined(_MSC_VER) && (defined(_M_AMD64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(_MSC_VER) && (defined(_M_ARM64) || defined(_M_ARM))
+    __yield();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Thread Functions
+
+typedef struct {
+    OSThreadFunc* func;
+    void* param;
+} OSThreadStart;
+
+#if defined(_WIN32)
+function DWORD WINAPI os_thread_entry(LPVOID param) {
+    OSThreadStart start = *(OSThreadStart*)param;
+    BASE_FREE(param);
+    start.func(start.param);
+    return 0;
+}
+#else
+function void* os_thread_entry(void* param) {
+    OSThreadStart start = *(OSThreadStart*)param;
+    BASE_FREE(param);
+    start.func(start.param);
+    return NULL;
+}
+#endif
+
+function OSThread os_thread_create(OSThreadFunc* func, void* param) {
+    OSThread thread = { 0 };
+    OSThreadStart* start = BASE_ALLOC(sizeof(OSThreadStart));
+    if (!start) {
+        fprintf(stderr, "Failed to allocate thread start parameters\n");
+        exit(EXIT_FAILURE);
+    }
+    start->func = func;
+    start->param = param;
+#if defined(_WIN32)
+    HANDLE handle = CreateThread(NULL, 0, os_thread_entry, start, 0, NULL);
+    if (!handle) {
+        fprintf(stderr, "Failed to create thread\n");
+        exit(EXIT_FAILURE);
+    }
+    thread.handle = (U64)(uintptr_t)handle;
+#else
+    pthread_t handle;
+    if (pthread_create(&handle, NULL, os_thread_entry, start) != 0) {
+        fprintf(stderr, "Failed to create thread\n");
+        exit(EXIT_FAILURE);
+    }
+    thread.handle = (U64)(uintptr_t)handle;
+#endif
+    return thread;
+}
+
+function void os_thread_join(OSThread thread) {
+#if defined(_WIN32)
+    WaitForSingleObject((HANDLE)(uintptr_t)thread.handle, INFINITE);
+    CloseHandle((HANDLE)(uintptr_t)thread.handle);
+#else
+    pthread_join((pthread_t)(uintptr_t)thread.handle, NULL);
+#endif
+}
+
+function void os_thread_yield(void) {
+#if defined(_WIN32)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// NOTE(ryl1k): Pinning and counting go through the process affinity mask,
+// so a container or taskset limited to CPUs 4-7 counts 4 and pins worker
+// 0 to CPU 4. Linux uses the raw syscalls since the glibc wrappers need
+// _GNU_SOURCE ahead of every include.
+#if defined(__linux__)
+#define OS_CPU_MASK_WORDS 16
+
+function U32 os_cpu_mask(U64* mask) {
+    MemoryZero(mask, OS_CPU_MASK_WORDS * sizeof(U64));
+    if (syscall(SYS_sched_getaffinity, 0, OS_CPU_MASK_WORDS * sizeof(U64), mask) < 0) {
+        return 0;
+    }
+    U32 count = 0;
+    for (U32 i = 0; i < OS_CPU_MASK_WORDS; i++) {
+        count += (U32)__builtin_popcountll(mask[i]);
+    }
+    return count;
+}
+#endif
+
+function B32 os_thread_pin(U32 cpu) {
+#if defined(_WIN32)
+    DWORD_PTR process_mask = 0;
+    DWORD_PTR system_mask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+        return 0;
+    }
+    for (U32 bit = 0; bit < 8 * sizeof(DWORD_PTR); bit++) {
+        DWORD_PTR single = (DWORD_PTR)1 << bit;
+        if ((process_mask & single) && cpu-- == 0) {
+            return SetThreadAffinityMask(GetCurrentThread(), single) != 0;
+        }
+    }
+    return 0;
+#elif defined(__linux__)
+    U64 mask[OS_CPU_MASK_WORDS];
+    os_cpu_mask(mask);
+    for (U32 bit = 0; bit < 64 * OS_CPU_MASK_WORDS; bit++) {
+        if ((mask[bit / 64] >> (bit % 64) & 1) && cpu-- == 0) {
+            U64 single[OS_CPU_MASK_WORDS] = { 0 };
+            single[bit / 64] = 1ull << (bit % 64);
+            return syscall(SYS_sched_setaffinity, 0, sizeof(single), single) == 0;
+        }
+    }
+    return 0;
+#else
+    (void)cpu;
+    return 0;
+#endif
+}
+
+function U32 os_cpu_count(void) {
+    U32 count = 0;
+#if defined(_WIN32)
+    DWORD_PTR process_mask = 0;
+    DWORD_PTR system_mask = 0;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+        for (; process_mask; process_mask &= process_mask - 1) {
+            count++;
+        }
+    }
+#else
+#if defined(__linux__)
+    U64 mask[OS_CPU_MASK_WORDS];
+    count = os_cpu_mask(mask);
+#endif
+    if (!count) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        count = online > 0 ? (U32)online : 0;
+    }
+#endif
+    return Max(count, 1);
+}
+
+function void os_futex_wait(volatile U32* address, U32 expected) {
+#if defined(_WIN32)
+    WaitOnAddress((volatile VOID*)address, &expected, sizeof(U32), INFINITE);
+#elif defined(__linux__)
+    syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+#else
+    if (atomic_load_U32(address) == expected) {
+        os_thread_yield();
+    }
+#endif
+}
+
+function void os_futex_wake(volatile U32* address, B32 all) {
+#if defined(_WIN32)
+    if (all) {
+        WakeByAddressAll((PVOID)address);
+    } else {
+        WakeByAddressSingle((PVOID)address);
+    }
+#elif defined(__linux__)
+    syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, all ? 0x7fffffff : 1, NULL, NULL, 0);
+#else
+    (void)address;
+    (void)all;
+#endif
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Lock-free Queues
+
+function MPMCQueue* mpmc_queue_create(Arena* arena, U64 capacity) {
+    U64 count = 2;
+    while (count < capacity) {
+        count <<= 1;
+    }
+    U64 bytes = sizeof(MPMCQueue) + count * sizeof(MPMCCell) + CACHE_LINE_SIZE;
+    void* memory = arena ? arena_alloc(arena, bytes) : BASE_ALLOC(bytes);
+    if (!memory) {
+        return NULL;
+    }
+    MPMCQueue* queue = ALIGN_PTR(memory, CACHE_LINE_SIZE);
+    MemoryZeroStruct(queue);
+    queue->memory = memory;
+    queue->arena = arena;
+    queue->cells = (MPMCCell*)(queue + 1);
+    queue->mask = count - 1;
+    for (U64 i = 0; i < count; i++) {
+        queue->cells[i].sequence = i;
+        queue->cells[i].data = NULL;
+    }
+    atomic_fence();
+    return queue;
+}
+
+function void mpmc_queue_destroy(MPMCQueue* queue) {
+    if (queue && !queue->arena) {
+        BASE_FREE(queue->memory);
+    }
+}
+
+function B32 mpmc_queue_enqueue(MPMCQueue* queue, void* data) {
+    return mpmc_queue_enqueue_batch(queue, &data, 1) == 1;
+}
+
+function B32 mpmc_queue_dequeue(MPMCQueue* queue, void** data) {
+    return mpmc_queue_dequeue_batch(queue, data, 1) == 1;
+}
+
+// NOTE(ryl1k): Cell i is free for position p when its sequence is p and
+// holds data for position p when its sequence is p + 1. A batch claims the
+// longest run of ready cells with a single CAS on the position; nobody
+// else can touch those cells until the CAS is won.
+function U64 mpmc_queue_enqueue_batch(MPMCQueue* queue, void** data, U64 count) {
+    U64 pos = atomic_load_U64(&queue->enqueue_pos);
+    U64 n;
+    for (;;) {
+        n = 0;
+        while (n < count) {
+            MPMCCell* cell = &queue->cells[(pos + n) & queue->mask];
+            S64 diff = (S64)(atomic_load_U64(&cell->sequence) - (pos + n));
+            if (diff != 0) {
+                break;
+            }
+            n++;
+        }
+        if (n == 0) {
+            MPMCCell* cell = &queue->cells[pos & queue->mask];
+            if ((S64)(atomic_load_U64(&cell->sequence) - pos) < 0) {
+                return 0;
+            }
+            pos = atomic_load_U64(&queue->enqueue_pos);
+            continue;
+        }
+        if (atomic_cas_U64(&queue->enqueue_pos, &pos, pos + n)) {
+            break;
+        }
+        cpu_pause();
+    }
+    for (U64 i = 0; i < n; i++) {
+        MPMCCell* cell = &queue->cells[(pos + i) & queue->mask];
+        cell->data = data[i];
+        atomic_store_U64(&cell->sequence, pos + i + 1);
+    }
+    return n;
+}
+
+function U64 mpmc_queue_dequeue_batch(MPMCQueue* queue, void** data, U64 count) {
+    U64 pos = atomic_load_U64(&queue->dequeue_pos);
+    U64 n;
+    for (;;) {
+        n = 0;
+        while (n < count) {
+            MPMCCell* cell = &queue->cells[(pos + n) & queue->mask];
+            S64 diff = (S64)(atomic_load_U64(&cell->sequence) - (pos + n + 1));
+            if (diff != 0) {
+                break;
+            }
+            n++;
+        }
+        if (n == 0) {
+            MPMCCell* cell = &queue->cells[pos & queue->mask];
+            if ((S64)(atomic_load_U64(&cell->sequence) - (pos + 1)) < 0) {
+                return 0;
+            }
+            pos = atomic_load_U64(&queue->dequeue_pos);
+            continue;
+        }
+        if (atomic_cas_U64(&queue->dequeue_pos, &pos, pos + n)) {
+            break;
+        }
+        cpu_pause();
+    }
+    for (U64 i = 0; i < n; i++) {
+        MPMCCell* cell = &queue->cells[(pos + i) & queue->mask];
+        data[i] = cell->data;
+        atomic_store_U64(&cell->sequence, pos + i + queue->mask + 1);
+    }
+    return n;
+}
+
+function void* volatile* mpsc_queue_link(MPSCQueue* queue, void* node) {
+    return (void* volatile*)((U8*)node + queue->link_offset);
+}
+
+function void* mpsc_queue_stub(MPSCQueue* queue) {
+    return (U8*)&queue->stub_next - queue->link_offset;
+}
+
+function void mpsc_queue_init(MPSCQueue* queue, U64 link_offset) {
+    MemoryZeroStruct(queue);
+    queue->link_offset = link_offset;
+    queue->head = mpsc_queue_stub(queue);
+    queue->tail = mpsc_queue_stub(queue);
+    queue->stub_next = NULL;
+}
+
+function void mpsc_queue_push_list(MPSCQueue* queue, void* first, void* last) {
+    atomic_store_ptr(mpsc_queue_link(queue, last), NULL);
+    void* prev = atomic_exchange_ptr(&queue->head, last);
+    atomic_store_ptr(mpsc_queue_link(queue, prev), first);
+}
+
+function void mpsc_queue_push(MPSCQueue* queue, void* node) {
+    mpsc_queue_push_list(queue, node, node);
+}
+
+function void* mpsc_queue_pop(MPSCQueue* queue) {
+    void* stub = mpsc_queue_stub(queue);
+    void* tail = queue->tail;
+    void* next = atomic_load_ptr(mpsc_queue_link(queue, tail));
+    if (tail == stub) {
+        if (!next) {
+            return NULL;
+        }
+        queue->tail = next;
+        tail = next;
+        next = atomic_load_ptr(mpsc_queue_link(queue, next));
+    }
+    if (next) {
+        queue->tail = next;
+        return tail;
+    }
+    // NOTE(ryl1k): tail looks like the last node. Either it is, and the stub
+    // is pushed behind it so it can be handed out, or a producer has swapped
+    // head but not linked yet, and the caller has to try again later.
+    if (tail != atomic_load_ptr(&queue->head)) {
+        return NULL;
+    }
+    mpsc_queue_push(queue, stub);
+    next = atomic_load_ptr(mpsc_queue_link(queue, tail));
+    if (next) {
+        queue->tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+function void* volatile* atomic_stack_link(AtomicStack* stack, void* node) {
+    return (void* volatile*)((U8*)node + stack->link_offset);
+}
+
+function U128 atomic_stack_pack(void* node, U64 tag) {
+    U128 r;
+#if defined(ATOMIC_HAS_CAS_U128)
+    r.lo = (U64)(uintptr_t)node;
+    r.hi = tag;
+#else
+    r.lo = (U64)(uintptr_t)node | (tag << 32);
+    r.hi = 0;
+#endif
+    return r;
+}
+
+function void* atomic_stack_top(U128 head) {
+    return (void*)(uintptr_t)head.lo;
+}
+
+function U64 atomic_stack_tag(U128 head) {
+#if defined(ATOMIC_HAS_CAS_U128)
+    return head.hi;
+#else
+    return head.lo >> 32;
+#endif
+}
+
+// NOTE(ryl1k): The two halves are read separately; a torn snapshot only
+// makes the following CAS fail and retry.
+function U128 atomic_stack_load(AtomicStack* stack) {
+    U128 r;
+    r.lo = atomic_load_U64(&stack->head.lo);
+    r.hi = atomic_load_U64(&stack->head.hi);
+    return r;
+}
+
+function B32 atomic_stack_cas(AtomicStack* stack, U128* expected, U128 desired) {
+#if defined(ATOMIC_HAS_CAS_U128)
+    return atomic_cas_U128(&stack->head, expected, desired);
+#else
+    return atomic_cas_U64(&stack->head.lo, &expected->lo, desired.lo);
+#endif
+}
+
+function void atomic_stack_init(AtomicStack* stack, U64 link_offset) {
+    stack->head.lo = 0;
+    stack->head.hi = 0;
+    stack->link_offset = link_offset;
+    atomic_fence();
+}
+
+function void atomic_stack_push_list(AtomicStack* stack, void* first, void* last) {
+    U128 head = atomic_stack_load(stack);
+    for (;;) {
+        atomic_store_ptr(atomic_stack_link(stack, last), atomic_stack_top(head));
+        if (atomic_stack_cas(stack, &head, atomic_stack_pack(first, atomic_stack_tag(head) + 1))) {
+            return;
+        }
+        cpu_pause();
+    }
+}
+
+function void atomic_stack_push(AtomicStack* stack, void* node) {
+    atomic_stack_push_list(stack, node, node);
+}
+
+function void* atomic_stack_pop(AtomicStack* stack) {
+    U128 head = atomic_stack_load(stack);
+    for (;;) {
+        void* top = atomic_stack_top(head);
+        if (!top) {
+            return NULL;
+        }
+        void* next = atomic_load_ptr(atomic_stack_link(stack, top));
+        if (atomic_stack_cas(stack, &head, atomic_stack_pack(next, atomic_stack_tag(head) + 1))) {
+            return top;
+        }
+        cpu_pause();
+    }
+}
+
+function void* atomic_stack_pop_all(AtomicStack* stack) {
+    U128 head = atomic_stack_load(stack);
+    for (;;) {
+        void* top = atomic_stack_top(head);
+        if (!top) {
+            return NULL;
+        }
+        if (atomic_stack_cas(stack, &head, atomic_stack_pack(NULL, atomic_stack_tag(head) + 1))) {
+            return top;
+        }
+        cpu_pause();
+    }
+}
+
+function SPSCRing* spsc_ring_create(Arena* arena, U64 capacity, U64 element_size, B32 mirrored) {
+    U64 count = 1;
+    while (count < capacity) {
+        count <<= 1;
+    }
+    if (mirrored) {
+        U64 granularity = os_allocation_granularity();
+        while ((count * element_size) % granularity != 0) {
+            count <<= 1;
+        }
+    }
+    U64 buffer_bytes = count * element_size;
+    U64 bytes = sizeof(SPSCRing) + CACHE_LINE_SIZE + (mirrored ? 0 : buffer_bytes);
+    void* memory = arena ? arena_alloc(arena, bytes) : BASE_ALLOC(bytes);
+    if (!memory) {
+        return NULL;
+    }
+    SPSCRing* ring = ALIGN_PTR(memory, CACHE_LINE_SIZE);
+    MemoryZeroStruct(ring);
+    ring->memory = memory;
+    ring->arena = arena;
+    ring->capacity = count;
+    ring->mask = count - 1;
+    ring->element_size = element_size;
+    ring->mirrored = mirrored;
+    if (mirrored) {
+        ring->buffer = os_reserve_mirrored(buffer_bytes);
+        if (!ring->buffer) {
+            if (!arena) {
+                BASE_FREE(memory);
+            }
+            return NULL;
+        }
+    }
+    else {
+        ring->buffer = (U8*)(ring + 1);
+    }
+    atomic_fence();
+    return ring;
+}
+
+function void spsc_ring_destroy(SPSCRing* ring) {
+    if (!ring) {
+        return;
+    }
+    if (ring->mirrored) {
+        os_release_mirrored(ring->buffer, ring->capacity * ring->element_size);
+    }
+    if (!ring->arena) {
+        BASE_FREE(ring->memory);
+    }
+}
+
+function void* spsc_ring_reserve(SPSCRing* ring, U64 count, U64* reserved) {
+    U64 head = ring->head;
+    U64 space = ring->capacity - (head - ring->cached_tail);
+    if (space < count) {
+        ring->cached_tail = atomic_load_U64(&ring->tail);
+        space = ring->capacity - (head - ring->cached_tail);
+    }
+    U64 index = head & ring->mask;
+    U64 n = Min(count, space);
+    if (!ring->mirrored) {
+        n = Min(n, ring->capacity - index);
+    }
+    *reserved = n;
+    return n ? ring->buffer + index * ring->element_size : NULL;
+}
+
+function void spsc_ring_commit(SPSCRing* ring, U64 count) {
+    atomic_store_U64(&ring->head, ring->head + count);
+}
+
+function void* spsc_ring_peek(SPSCRing* ring, U64 count, U64* available) {
+    U64 tail = ring->tail;
+    U64 used = ring->cached_head - tail;
+    if (used < count) {
+        ring->cached_head = atomic_load_U64(&ring->head);
+        used = ring->cached_head - tail;
+    }
+    U64 index = tail & ring->mask;
+    U64 n = Min(count, used);
+    if (!ring->mirrored) {
+        n = Min(n, ring->capacity - index);
+    }
+    *available = n;
+    return n ? ring->buffer + index * ring->element_size : NULL;
+}
+
+function void spsc_ring_consume(SPSCRing* ring, U64 count) {
+    atomic_store_U64(&ring->tail, ring->tail + count);
+}
+
+// NOTE(ryl1k): A batch is at most two contiguous runs (one when mirrored).
+function U64 spsc_ring_push_batch(SPSCRing* ring, const void* elements, U64 count) {
+    const U8* src = (const U8*)elements;
+    U64 total = 0;
+    for (int run = 0; run < 2 && total < count; run++) {
+        U64 n;
+        void* dst = spsc_ring_reserve(ring, count - total, &n);
+        if (!n) {
+            break;
+        }
+        MemoryCopy(dst, src + total * ring->element_size, n * ring->element_size);
+        spsc_ring_commit(ring, n);
+        total += n;
+    }
+    return total;
+}
+
+function U64 spsc_ring_pop_batch(SPSCRing* ring, void* elements, U64 count) {
+    U8* dst = (U8*)elements;
+    U64 total = 0;
+    for (int run = 0; run < 2 && total < count; run++) {
+        U64 n;
+        void* src = spsc_ring_peek(ring, count - total, &n);
+        if (!n) {
+            break;
+        }
+        MemoryCopy(dst + total * ring->element_size, src, n * ring->element_size);
+        spsc_ring_consume(ring, n);
+        total += n;
+    }
+    return total;
+}
+
+function B32 spsc_ring_push(SPSCRing* ring, const void* element) {
+    return spsc_ring_push_batch(ring, element, 1) == 1;
+}
+
+function B32 spsc_ring_pop(SPSCRing* ring, void* element) {
+    return spsc_ring_pop_batch(ring, element, 1) == 1;
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Sorting Functions
+
+#define RADIX_SORT_INSERTION_THRESHOLD 64
+#define RADIX_SORT_PARALLEL_MIN (1 << 16)
+#define RADIX_SORT_MAX_THREADS 64
+
+typedef struct {
+    Arena* arena;
+    size_t used;
+    void* memory;
+} SortScratch;
+
+function void* sort_scratch_begin(SortScratch* scratch, Arena* arena, U64 size) {
+    scratch->arena = arena;
+    scratch->used = arena ? arena->used : 0;
+    scratch->memory = arena ? arena_alloc_aligned(arena, size, CACHE_LINE_SIZE) : BASE_ALLOC(size);
+    return scratch->memory;
+}
+
+function void sort_scratch_end(SortScratch* scratch) {
+    if (scratch->arena) {
+        scratch->arena->used = scratch->used;
+    } else if (scratch->memory) {
+        BASE_FREE(scratch->memory);
+    }
+}
+
+// NOTE(ryl1k): Order-preserving maps onto unsigned bits and back. Signed
+// keys flip the sign bit; float keys also flip every other bit of
+// negatives so larger magnitudes sort lower.
+function U32 radix_key_U32(U32 x) { return x; }
+function U32 radix_unkey_U32(U32 x) { return x; }
+function U64 radix_key_U64(U64 x) { return x; }
+function U64 radix_unkey_U64(U64 x) { return x; }
+function U32 radix_key_S32(U32 x) { return x ^ 0x80000000u; }
+function U32 radix_unkey_S32(U32 x) { return x ^ 0x80000000u; }
+function U64 radix_key_S64(U64 x) { return x ^ 0x8000000000000000llu; }
+function U64 radix_unkey_S64(U64 x) { return x ^ 0x8000000000000000llu; }
+function U32 radix_key_F32(U32 x) { return x ^ ((U32)(-(S32)(x >> 31)) | 0x80000000u); }
+function U32 radix_unkey_F32(U32 x) { return x ^ (((x >> 31) - 1) | 0x80000000u); }
+function U64 radix_key_F64(U64 x) { return x ^ ((U64)(-(S64)(x >> 63)) | 0x8000000000000000llu); }
+function U64 radix_unkey_F64(U64 x) { return x ^ (((x >> 63) - 1) | 0x8000000000000000llu); }
+
+// NOTE(ryl1k): Sorts keys (carrying index along when it is not NULL) with
+// one histogram pass for every digit, then one scatter pass per digit that
+// is not the same for all keys. Ping-pongs between keys and tmp (index
+// and index_tmp) and returns whichever holds the result.
+#define RADIX_SORT_LSD_DEFINE(UT)                                                     \
+    function UT* radix_sort_lsd_##UT(UT* keys, UT* tmp, U32* index, U32* index_tmp, U64 count) { \
+        if (count < RADIX_SORT_INSERTION_THRESHOLD) {                                 \
+            for (U64 i = 1; i < count; i++) {                                         \
+                UT key = keys[i];                                                     \
+                U32 key_index = index ? index[i] : 0;                                 \
+                U64 j = i;                                                            \
+                for (; j > 0 && keys[j - 1] > key; j--) {                             \
+                    keys[j] = keys[j - 1];                                            \
+                    if (index) {                                                      \
+                        index[j] = index[j - 1];                                      \
+                    }                                                                 \
+                }                                                                     \
+                keys[j] = key;                                                        \
+                if (index) {                                                          \
+                    index[j] = key_index;                                             \
+                }                                                                     \
+            }                                                                         \
+            return keys;                                                              \
+        }                                                                             \
+        U64 histogram[sizeof(UT)][256];                                               \
+        MemoryZero(histogram, sizeof(histogram));                                     \
+        for (U64 i = 0; i < count; i++) {                                             \
+            UT key = keys[i];                                                         \
+            for (U32 b = 0; b < sizeof(UT); b++) {                                    \
+                histogram[b][(key >> (b * 8)) & 0xFF]++;                              \
+            }                                                                         \
+        }                                                                             \
+        UT* src = keys;                                                               \
+        UT* dst = tmp;                                                                \
+        U32* index_src = index;                                                       \
+        U32* index_dst = index_tmp;                                                   \
+        for (U32 b = 0; b < sizeof(UT); b++) {                                        \
+            U64* offsets = histogram[b];                                              \
+            U32 shift = b * 8;                                                        \
+            if (offsets[(src[0] >> shift) & 0xFF] == count) {                         \
+                continue;                                                             \
+            }                                                                         \
+            U64 sum = 0;                                                              \
+            for (U32 d = 0; d < 256; d++) {                                           \
+                U64 c = offsets[d];                                                   \
+                offsets[d] = sum;                                                     \
+                sum += c;                                                             \
+            }                                                                         \
+            if (index_src) {                                                          \
+                for (U64 i = 0; i < count; i++) {                                     \
+                    UT key = src[i];                                                  \
+                    U64 at = offsets[(key >> shift) & 0xFF]++;                        \
+                    dst[at] = key;                                                    \
+                    index_dst[at] = index_src[i];                                     \
+                }                                                                     \
+                U32* index_swap = index_src;                                          \
+                index_src = index_dst;                                                \
+                index_dst = index_swap;                                               \
+            } else {                                                                  \
+                for (U64 i = 0; i < count; i++) {                                     \
+                    UT key = src[i];                                                  \
+                    dst[offsets[(key >> shift) & 0xFF]++] = key;                      \
+                }                                                                     \
+            }                                                                         \
+            UT* swap = src;                                                           \
+            src = dst;                                                                \
+            dst = swap;                                                               \
+        }                                                                             \
+        return src;                                                                   \
+    }
+
+RADIX_SORT_LSD_DEFINE(U32)
+RADIX_SORT_LSD_DEFINE(U64)
+
+// NOTE(ryl1k): Keys are read and written as T through MemoryCopy; a UT
+// pointer into the caller's T array breaks strict aliasing.
+#define RADIX_SORT_DEFINE(T, UT)                                                      \
+    function B32 radix_sort_##T(T* keys, U64 count, Arena* scratch) {                 \
+        if (count < 2) {                                                              \
+            return 1;                                                                 \
+        }                                                                             \
+        SortScratch s;                                                                \
+        UT* tmp = sort_scratch_begin(&s, scratch, count * sizeof(UT));                \
+        if (!tmp) {                                                                   \
+            return 0;                                                                 \
+        }                                                                             \
+        UT* k = (UT*)keys;                                                            \
+        for (U64 i = 0; i < count; i++) {                                             \
+            UT bits;                                                                  \
+            MemoryCopy(&bits, keys + i, sizeof(UT));                                  \
+            bits = radix_key_##T(bits);                                               \
+            MemoryCopy(keys + i, &bits, sizeof(UT));                                  \
+        }                                                                             \
+        UT* sorted = radix_sort_lsd_##UT(k, tmp, NULL, NULL, count);                  \
+        for (U64 i = 0; i < count; i++) {                                             \
+            UT bits = radix_unkey_##T(sorted[i]);                                     \
+            MemoryCopy(keys + i, &bits, sizeof(UT));                                  \
+        }                                                                             \
+        sort_scratch_end(&s);                                                         \
+        return 1;                                                                     \
+    }                                                                                 \
+    function B32 radix_sort_index_##T(const T* keys, U32 count, U32* indices, Arena* scratch) { \
+        for (U32 i = 0; i < count; i++) {                                             \
+            indices[i] = i;                                                           \
+        }                                                                             \
+        if (count < 2) {                                                              \
+            return 1;                                                                 \
+        }                                                                             \
+        SortScratch s;                                                                \
+        UT* k = sort_scratch_begin(&s, scratch, (U64)count * (2 * sizeof(UT) + sizeof(U32))); \
+        if (!k) {                                                                     \
+            return 0;                                                                 \
+        }                                                                             \
+        UT* tmp = k + count;                                                          \
+        U32* index_tmp = (U32*)(tmp + count);                                         \
+        for (U32 i = 0; i < count; i++) {                                             \
+            UT bits;                                                                  \
+            MemoryCopy(&bits, keys + i, sizeof(UT));                                  \
+            k[i] = radix_key_##T(bits);                                               \
+        }                                                                             \
+        if (radix_sort_lsd_##UT(k, tmp, indices, index_tmp, count) != k) {            \
+            MemoryCopy(indices, index_tmp, count * sizeof(U32));                      \
+        }                                                                             \
+        sort_scratch_end(&s);                                                         \
+        return 1;                                                                     \
+    }
+
+RADIX_SORT_DEFINE(U32, U32)
+RADIX_SORT_DEFINE(U64, U64)
+RADIX_SORT_DEFINE(S32, U32)
+RADIX_SORT_DEFINE(S64, U64)
+RADIX_SORT_DEFINE(F32, U32)
+RADIX_SORT_DEFINE(F64, U64)
+
+function U64 sort_string_prefix(const String* s, U64 depth) {
+    U64 length = (U64)s->length;
+    U64 prefix = 0;
+    for (U64 i = depth; i < depth + 8; i++) {
+        prefix = (prefix << 8) | (i < length ? (U8)s->data[i] : 0);
+    }
+    return prefix;
+}
+
+function int sort_string_compare(const String* a, const String* b) {
+    int n = Min(a->length, b->length);
+    int c = n ? memcmp(a->data, b->data, (size_t)n) : 0;
+    return c ? c : (a->length > b->length) - (a->length < b->length);
+}
+
+// NOTE(ryl1k): Radix sorts the run on the 8 bytes at depth, then recurses
+// into groups that tie on them. Groups whose strings all end within those
+// bytes can only differ in trailing zero bytes, i.e. in length.
+function void sort_string_run(const String* keys, U32* indices, U64* prefix, U64* prefix_tmp,
+                              U32* index_tmp, U64 count, U64 depth) {
+    if (count < RADIX_SORT_INSERTION_THRESHOLD) {
+        for (U64 i = 1; i < count; i++) {
+            U32 index = indices[i];
+            U64 j = i;
+            for (; j > 0 && sort_string_compare(&keys[indices[j - 1]], &keys[index]) > 0; j--) {
+                indices[j] = indices[j - 1];
+            }
+            indices[j] = index;
+        }
+        return;
+    }
+    for (U64 i = 0; i < count; i++) {
+        prefix[i] = sort_string_prefix(&keys[indices[i]], depth);
+    }
+    if (radix_sort_lsd_U64(prefix, prefix_tmp, indices, index_tmp, count) != prefix) {
+        MemoryCopy(prefix, prefix_tmp, count * sizeof(U64));
+        MemoryCopy(indices, index_tmp, count * sizeof(U32));
+    }
+    for (U64 start = 0; start < count;) {
+        U64 end = start + 1;
+        B32 longer = (U64)keys[indices[start]].length > depth + 8;
+        for (; end < count && prefix[end] == prefix[start]; end++) {
+            longer |= (U64)keys[indices[end]].length > depth + 8;
+        }
+        if (end - start > 1) {
+            if (longer) {
+                sort_string_run(keys, indices + start, prefix + start, prefix_tmp + start,
+                                index_tmp + start, end - start, depth + 8);
+            } else {
+                for (U64 i = start + 1; i < end; i++) {
+                    U32 index = indices[i];
+                    U64 j = i;
+                    for (; j > start && keys[indices[j - 1]].length > keys[index].length; j--) {
+                        indices[j] = indices[j - 1];
+                    }
+                    indices[j] = index;
+                }
+            }
+        }
+        start = end;
+    }
+}
+
+function B32 sort_index_String(const String* keys, U32 count, U32* indices, Arena* scratch) {
+    for (U32 i = 0; i < count; i++) {
+        indices[i] = i;
+    }
+    if (count < 2) {
+        return 1;
+    }
+    SortScratch s;
+    U64* prefix = sort_scratch_begin(&s, scratch, (U64)count * (2 * sizeof(U64) + sizeof(U32)));
+    if (!prefix) {
+        return 0;
+    }
+    sort_string_run(keys, indices, prefix, prefix + count, (U32*)(prefix + 2 * (U64)count), count, 0);
+    sort_scratch_end(&s);
+    return 1;
+}
+
+function B32 sort_String(String* keys, U32 count, Arena* scratch) {
+    if (count < 2) {
+        return 1;
+    }
+    SortScratch s;
+    String* sorted = sort_scratch_begin(&s, scratch, (U64)count * (sizeof(String) + sizeof(U32)));
+    if (!sorted) {
+        return 0;
+    }
+    U32* indices = (U32*)(sorted + count);
+    B32 result = sort_index_String(keys, count, indices, scratch);
+    if (result) {
+        for (U32 i = 0; i < count; i++) {
+            sorted[i] = keys[indices[i]];
+        }
+        MemoryCopy(keys, sorted, count * sizeof(String));
+    }
+    sort_scratch_end(&s);
+    return result;
+}
+
+typedef struct {
+    void* keys;
+    void* tmp;
+    U64 count;
+    U64 first;
+    U32 thread_count;
+    U32 shift;
+    volatile U64 next_bucket;
+    U64 bucket_start[257];
+    U64 diff[RADIX_SORT_MAX_THREADS];
+    U64 histogram[RADIX_SORT_MAX_THREADS][256];
+} RadixSortShared;
+
+typedef struct {
+    RadixSortShared* shared;
+    U32 index;
+    U32 phase;
+} RadixSortThread;
+
+function void radix_sort_parallel_phase(OSThreadFunc* func, RadixSortThread* threads, U32 phase) {
+    OSThread handles[RADIX_SORT_MAX_THREADS];
+    U32 thread_count = threads[0].shared->thread_count;
+    for (U32 t = 0; t < thread_count; t++) {
+        threads[t].phase = phase;
+    }
+    for (U32 t = 1; t < thread_count; t++) {
+        handles[t] = os_thread_create(func, &threads[t]);
+    }
+    func(&threads[0]);
+    for (U32 t = 1; t < thread_count; t++) {
+        os_thread_join(handles[t]);
+    }
+}
+
+// NOTE(ryl1k): Phases, each run on every thread and joined before the
+// next: 0 maps the thread's slice to radix keys and ORs together how they
+// differ from the first key, 1 histograms the MSD digit, 2 scatters the
+// slice into tmp at per-thread offsets (keeping the sort stable), and 3
+// LSD sorts whole buckets handed out by an atomic counter back into keys.
+#define RADIX_SORT_PARALLEL_DEFINE(T, UT)                                             \
+    function void radix_sort_parallel_thread_##T(void* param) {                       \
+        RadixSortThread* thread = (RadixSortThread*)param;                            \
+        RadixSortShared* shared = thread->shared;                                     \
+        T* input = (T*)shared->keys;                                                  \
+        UT* keys = (UT*)shared->keys;                                                 \
+        UT* tmp = (UT*)shared->tmp;                                                   \
+        U64 lo = shared->count * thread->index / shared->thread_count;                \
+        U64 hi = shared->count * (thread->index + 1) / shared->thread_count;          \
+        U32 shift = shared->shift;                                                    \
+        U64* histogram = shared->histogram[thread->index];                            \
+        if (thread->phase == 0) {                                                     \
+            UT first = (UT)shared->first;                                             \
+            UT diff = 0;                                                              \
+            for (U64 i = lo; i < hi; i++) {                                           \
+                UT key;                                                               \
+                MemoryCopy(&key, input + i, sizeof(UT));                              \
+                key = radix_key_##T(key);                                             \
+                MemoryCopy(input + i, &key, sizeof(UT));                              \
+                diff |= key ^ first;                                                  \
+            }                                                                         \
+            shared->diff[thread->index] = diff;                                       \
+        } else if (thread->phase == 1) {                                              \
+            MemoryZero(histogram, 256 * sizeof(U64));                                 \
+            for (U64 i = lo; i < hi; i++) {                                           \
+                histogram[(keys[i] >> shift) & 0xFF]++;                               \
+            }                                                                         \
+        } else if (thread->phase == 2) {                                              \
+            for (U64 i = lo; i < hi; i++) {                                           \
+                UT key = keys[i];                                                     \
+                tmp[histogram[(key >> shift) & 0xFF]++] = key;                        \
+            }                                                                         \
+        } else {                                                                      \
+            for (;;) {                                                                \
+                U64 bucket = atomic_fetch_add_U64(&shared->next_bucket, 1);           \
+                if (bucket >= 256) {                                                  \
+                    break;                                                            \
+                }                                                                     \
+                U64 start = shared->bucket_start[bucket];                             \
+                U64 count = shared->bucket_start[bucket + 1] - start;                 \
+                UT* sorted = radix_sort_lsd_##UT(tmp + start, keys + start, NULL, NULL, count); \
+                for (U64 i = 0; i < count; i++) {                                     \
+                    UT bits = radix_unkey_##T(sorted[i]);                             \
+                    MemoryCopy(input + start + i, &bits, sizeof(UT));                 \
+                }                                                                     \
+            }                                                                         \
+        }                                                                             \
+    }                                                                                 \
+    function B32 radix_sort_parallel_##T(T* keys, U64 count, U32 thread_count, Arena* scratch) { \
+        thread_count = Min(thread_count, RADIX_SORT_MAX_THREADS);                     \
+        if (count < RADIX_SORT_PARALLEL_MIN || thread_count <= 1) {                   \
+            return radix_sort_##T(keys, count, scratch);                              \
+        }                                                                             \
+        SortScratch s;                                                                \
+        RadixSortShared* shared = sort_scratch_begin(&s, scratch, sizeof(RadixSortShared) + count * sizeof(UT)); \
+        if (!shared) {                                                                \
+            return 0;                                                                 \
+        }                                                                             \
+        RadixSortThread threads[RADIX_SORT_MAX_THREADS];                              \
+        shared->keys = keys;                                                          \
+        UT first;                                                                     \
+        MemoryCopy(&first, keys, sizeof(UT));                                         \
+        shared->first = radix_key_##T(first);                                         \
+        shared->tmp = shared + 1;                                                     \
+        shared->count = count;                                                        \
+        shared->thread_count = thread_count;                                          \
+        shared->shift = 0;                                                            \
+        shared->next_bucket = 0;                                                      \
+        for (U32 t = 0; t < thread_count; t++) {                                      \
+            threads[t].shared = shared;                                               \
+            threads[t].index = t;                                                     \
+        }                                                                             \
+        radix_sort_parallel_phase(radix_sort_parallel_thread_##T, threads, 0);        \
+        U64 diff = 0;                                                                 \
+        for (U32 t = 0; t < thread_count; t++) {                                      \
+            diff |= shared->diff[t];                                                  \
+        }                                                                             \
+        if (diff == 0) {                                                              \
+            for (U64 i = 0; i < count; i++) {                                         \
+                UT bits;                                                              \
+                MemoryCopy(&bits, keys + i, sizeof(UT));                              \
+                bits = radix_unkey_##T(bits);                                         \
+                MemoryCopy(keys + i, &bits, sizeof(UT));                              \
+            }                                                                         \
+            sort_scratch_end(&s);                                                     \
+            return 1;                                                                 \
+        }                                                                             \
+        U32 top = 63 - clz_U64(diff);                                                 \
+        shared->shift = top >= 7 ? top - 7 : 0;                                       \
+        radix_sort_parallel_phase(radix_sort_parallel_thread_##T, threads, 1);        \
+        U64 sum = 0;                                                                  \
+        for (U32 d = 0; d < 256; d++) {                                               \
+            shared->bucket_start[d] = sum;                                            \
+            for (U32 t = 0; t < thread_count; t++) {                                  \
+                U64 c = shared->histogram[t][d];                                      \
+                shared->histogram[t][d] = sum;                                        \
+                sum += c;                                                             \
+            }                                                                         \
+        }                                                                             \
+        shared->bucket_start[256] = sum;                                              \
+        radix_sort_parallel_phase(radix_sort_parallel_thread_##T, threads, 2);        \
+        radix_sort_parallel_phase(radix_sort_parallel_thread_##T, threads, 3);        \
+        sort_scratch_end(&s);                                                         \
+        return 1;                                                                     \
+    }
+
+RADIX_SORT_PARALLEL_DEFINE(U32, U32)
+RADIX_SORT_PARALLEL_DEFINE(U64, U64)
+RADIX_SORT_PARALLEL_DEFINE(S32, U32)
+RADIX_SORT_PARALLEL_DEFINE(S64, U64)
+RADIX_SORT_PARALLEL_DEFINE(F32, U32)
+RADIX_SORT_PARALLEL_DEFINE(F64, U64)
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Bitset Functions
+
+#if defined(CPU_X86)
+#define BITSET_AVX2 1
+#elif defined(CPU_ARM64)
+#define BITSET_NEON 1
+#endif
+
+// NOTE(ryl1k): Word kernels come in a base version (NEON on ARM64, which
+// always has it, scalar elsewhere) and an AVX2 version picked at runtime
+// through cpu_dispatch. AVX2 counts nibbles with a shuffle lookup and sums
+// bytes with SAD; NEON has a per-byte count and pairwise widening adds.
+function U64 bitset_popcount_words_base(const U64* words, U64 count) {
+    U64 total = 0;
+    U64 i = 0;
+#if defined(BITSET_NEON)
+    uint64x2_t sum = vdupq_n_u64(0);
+    for (; i + 2 <= count; i += 2) {
+        uint8x16_t bytes = vcntq_u8(vld1q_u8((const U8*)(words + i)));
+        sum = vpadalq_u32(sum, vpaddlq_u16(vpaddlq_u8(bytes)));
+    }
+    total = vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1);
+#endif
+    for (; i < count; i++) {
+        total += popcount_U64(words[i]);
+    }
+    return total;
+}
+
+function U64 bitset_skip_zero_words_base(const U64* words, U64 w, U64 count) {
+    (void)words;
+    (void)count;
+    return w;
+}
+
+#if defined(BITSET_AVX2)
+TARGET_AVX2 function U64 bitset_popcount_words_avx2(const U64* words, U64 count) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    __m256i sum = _mm256_setzero_si256();
+    U64 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(words + i));
+        __m256i lo = _mm256_and_si256(v, low_mask);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+    U64 total = (U64)_mm256_extract_epi64(sum, 0) + (U64)_mm256_extract_epi64(sum, 1) +
+                (U64)_mm256_extract_epi64(sum, 2) + (U64)_mm256_extract_epi64(sum, 3);
+    for (; i < count; i++) {
+        total += popcount_U64(words[i]);
+    }
+    return total;
+}
+
+// NOTE(ryl1k): Index of the first of four words at or after w that holds
+// a set bit, stepping four at a time; the caller finishes word by word.
+TARGET_AVX2 function U64 bitset_skip_zero_words_avx2(const U64* words, U64 w, U64 count) {
+    while (w + 4 <= count) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(words + w));
+        if (!_mm256_testz_si256(v, v)) {
+            break;
+        }
+        w += 4;
+    }
+    return w;
+}
+#endif
+
+#if defined(BITSET_NEON)
+#define BITSET_WORDS_OP_BASE(name, scalar, neon)                                      \
+    function void bitset_words_##name##_base(U64* dst, const U64* a, const U64* b, U64 count) {\
+        U64 i = 0;                                                                    \
+        for (; i + 2 <= count; i += 2) {                                              \
+            uint64x2_t x = vld1q_u64(a + i);                                          \
+            uint64x2_t y = vld1q_u64(b + i);                                          \
+            vst1q_u64(dst + i, neon);                                                 \
+        }                                                                             \
+        for (; i < count; i++) {                                                      \
+            U64 x = a[i];                                                             \
+            U64 y = b[i];                                                             \
+            dst[i] = scalar;                                                          \
+        }                                                                             \
+    }
+#else
+#define BITSET_WORDS_OP_BASE(name, scalar, neon)                                      \
+    function void bitset_words_##name##_base(U64* dst, const U64* a, const U64* b, U64 count) {\
+        for (U64 i = 0; i < count; i++) {                                             \
+            U64 x = a[i];                                                             \
+            U64 y = b[i];                                                             \
+            dst[i] = scalar;                                                          \
+        }                                                                             \
+    }
+#endif
+
+#if defined(BITSET_AVX2)
+#define BITSET_WORDS_OP_AVX2(name, scalar, avx2)                                      \
+    TARGET_AVX2 function void bitset_words_##name##_avx2(U64* dst, const U64* a, const U64* b, U64 count) {\
+        U64 i = 0;                                                                    \
+        for (; i + 4 <= count; i += 4) {                                              \
+            __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));                  \
+            __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));                  \
+            _mm256_storeu_si256((__m256i*)(dst + i), avx2);                           \
+        }                                                                             \
+        for (; i < count; i++) {                                                      \
+            U64 x = a[i];                                                             \
+            U64 y = b[i];                                                             \
+            dst[i] = scalar;                                                          \
+        }                                                                             \
+    }
+#else
+#define BITSET_WORDS_OP_AVX2(name, scalar, avx2)
+#endif
+
+#define BITSET_WORDS_OP(name, scalar, avx2, neon)                                     \
+    BITSET_WORDS_OP_BASE(name, scalar, neon)                                          \
+    BITSET_WORDS_OP_AVX2(name, scalar, avx2)
+
+BITSET_WORDS_OP(and, x & y, _mm256_and_si256(x, y), vandq_u64(x, y))
+BITSET_WORDS_OP(or, x | y, _mm256_or_si256(x, y), vorrq_u64(x, y))
+BITSET_WORDS_OP(xor, x ^ y, _mm256_xor_si256(x, y), veorq_u64(x, y))
+BITSET_WORDS_OP(andnot, x & ~y, _mm256_andnot_si256(y, x), vbicq_u64(x, y))
+
+typedef struct {
+    U64 (*popcount_words)(const U64* words, U64 count);
+    U64 (*skip_zero_words)(const U64* words, U64 w, U64 count);
+    void (*and_words)(U64* dst, const U64* a, const U64* b, U64 count);
+    void (*or_words)(U64* dst, const U64* a, const U64* b, U64 count);
+    void (*xor_words)(U64* dst, const U64* a, const U64* b, U64 count);
+    void (*andnot_words)(U64* dst, const U64* a, const U64* b, U64 count);
+} BitsetKernels;
+
+#define BITSET_KERNELS(suffix) { \
+    bitset_popcount_words_##suffix, bitset_skip_zero_words_##suffix, bitset_words_and_##suffix, \
+    bitset_words_or_##suffix, bitset_words_xor_##suffix, bitset_words_andnot_##suffix }
+
+global const BitsetKernels bitset_kernels_base = BITSET_KERNELS(base);
+#if defined(BITSET_AVX2)
+global const BitsetKernels bitset_kernels_avx2 = BITSET_KERNELS(avx2);
+#endif
+
+function void* bitset_kernels_resolve(const CPUFeatures* features) {
+#if defined(BITSET_AVX2)
+    if (features->avx2) {
+        return (void*)&bitset_kernels_avx2;
+    }
+#endif
+    (void)features;
+    return (void*)&bitset_kernels_base;
+}
+
+global void* volatile bitset_kernels_slot;
+
+function const BitsetKernels* bitset_kernels(void) {
+    return (const BitsetKernels*)cpu_dispatch(&bitset_kernels_slot, bitset_kernels_resolve);
+}
+
+function U64 bitset_popcount_words(const U64* words, U64 count) {
+    return bitset_kernels()->popcount_words(words, count);
+}
+
+function void bitset_words_and(U64* dst, const U64* a, const U64* b, U64 count) {
+    bitset_kernels()->and_words(dst, a, b, count);
+}
+
+function void bitset_words_or(U64* dst, const U64* a, const U64* b, U64 count) {
+    bitset_kernels()->or_words(dst, a, b, count);
+}
+
+function void bitset_words_xor(U64* dst, const U64* a, const U64* b, U64 count) {
+    bitset_kernels()->xor_words(dst, a, b, count);
+}
+
+function void bitset_words_andnot(U64* dst, const U64* a, const U64* b, U64 count) {
+    bitset_kernels()->andnot_words(dst, a, b, count);
+}
+
+// NOTE(ryl1k): Position of the k-th (from 0) set bit of x, k < popcount.
+// BMI2 deposits bit k onto the set bits of x in one pdep; it is picked at
+// runtime unless the build already targets BMI2 or pdep is microcoded.
+typedef U32 BitsetSelectWordFunc(U64 x, U32 k);
+
+function U32 bitset_select_word_scalar(U64 x, U32 k) {
+    for (U32 i = 0; i < k; i++) {
+        x &= x - 1;
+    }
+    return ctz_U64(x);
+}
+
+#if defined(CPU_X86) && (defined(__x86_64__) || defined(_M_AMD64))
+#define BITSET_SELECT_BMI2 1
+TARGET_BMI2 function U32 bitset_select_word_bmi2(U64 x, U32 k) {
+    return ctz_U64(_pdep_u64(1llu << k, x));
+}
+#endif
+
+function void* bitset_select_word_resolve(const CPUFeatures* features) {
+#if defined(BITSET_SELECT_BMI2)
+    if (features->bmi2 && !features->slow_pdep) {
+        return (void*)bitset_select_word_bmi2;
+    }
+#endif
+    (void)features;
+    return (void*)bitset_select_word_scalar;
+}
+
+global void* volatile bitset_select_word_slot;
+
+function U32 bitset_select_word(U64 x, U32 k) {
+#if defined(__BMI2__)
+    return ctz_U64(_pdep_u64(1llu << k, x));
+#else
+    BitsetSelectWordFunc* select = (BitsetSelectWordFunc*)cpu_dispatch(&bitset_select_word_slot, bitset_select_word_resolve);
+    return select(x, k);
+#endif
+}
+
+function U64 bitset_memory_size(U64 bit_count, U64* word_count) {
+    *word_count = ((bit_count + 511) / 512) * 8;
+    U64 block_count = (*word_count + BITSET_RANK_WORDS - 1) / BITSET_RANK_WORDS;
+    return (*word_count + block_count + 1) * sizeof(U64);
+}
+
+function Bitset bitset_from_memory(void* memory, U64 bit_count) {
+    Bitset bitset;
+    MemoryZeroStruct(&bitset);
+    if (memory) {
+        U64 word_count;
+        U64 size = bitset_memory_size(bit_count, &word_count);
+        MemoryZero(memory, size);
+        bitset.words = (U64*)memory;
+        bitset.rank = bitset.words + word_count;
+        bitset.bit_count = bit_count;
+        bitset.word_count = word_count;
+    }
+    return bitset;
+}
+
+function Bitset bitset_create(Arena* arena, U64 bit_count) {
+    U64 word_count;
+    U64 size = bitset_memory_size(bit_count, &word_count);
+    if (arena) {
+        return bitset_from_memory(arena_alloc_aligned(arena, size, CACHE_LINE_SIZE), bit_count);
+    }
+    Bitset bitset = bitset_from_memory(BASE_ALLOC(size), bit_count);
+    bitset.memory = bitset.words;
+    return bitset;
+}
+
+function Bitset bitset_create_arena64(Arena64* arena, U64 bit_count) {
+    U64 word_count;
+    U64 size = bitset_memory_size(bit_count, &word_count);
+    return bitset_from_memory(arena64_alloc_aligned(arena, size, CACHE_LINE_SIZE), bit_count);
+}
+
+function void bitset_destroy(Bitset* bitset) {
+    if (bitset->memory) {
+        BASE_FREE(bitset->memory);
+    }
+    MemoryZeroStruct(bitset);
+}
+
+function void bitset_set(Bitset* bitset, U64 index) {
+    bitset->words[index >> 6] |= 1llu << (index & 63);
+    bitset->rank_dirty = 1;
+}
+
+function void bitset_clear(Bitset* bitset, U64 index) {
+    bitset->words[index >> 6] &= ~(1llu << (index & 63));
+    bitset->rank_dirty = 1;
+}
+
+function B32 bitset_test(const Bitset* bitset, U64 index) {
+    return (bitset->words[index >> 6] >> (index & 63)) & 1;
+}
+
+function void bitset_set_all(Bitset* bitset) {
+    U64 full = bitset->bit_count >> 6;
+    memset(bitset->words, 0xFF, full * sizeof(U64));
+    if (bitset->bit_count & 63) {
+        bitset->words[full] = (1llu << (bitset->bit_count & 63)) - 1;
+    }
+    bitset->rank_dirty = 1;
+}
+
+function void bitset_clear_all(Bitset* bitset) {
+    MemoryZero(bitset->words, bitset->word_count * sizeof(U64));
+    bitset->rank_dirty = 1;
+}
+
+function U64 bitset_popcount(const Bitset* bitset) {
+    return bitset_popcount_words(bitset->words, bitset->word_count);
+}
+
+function void bitset_update_rank(Bitset* bitset) {
+    if (!bitset->rank_dirty) {
+        return;
+    }
+    U64 total = 0;
+    U64 block = 0;
+    for (U64 w = 0; w < bitset->word_count; w += BITSET_RANK_WORDS, block++) {
+        bitset->rank[block] = total;
+        total += bitset_popcount_words(bitset->words + w, Min(BITSET_RANK_WORDS, bitset->word_count - w));
+    }
+    bitset->rank[block] = total;
+    bitset->rank_dirty = 0;
+}
+
+function U64 bitset_rank(Bitset* bitset, U64 index) {
+    bitset_update_rank(bitset);
+    index = Min(index, bitset->bit_count);
+    U64 word = index >> 6;
+    U64 block = word / BITSET_RANK_WORDS;
+    U64 first = block * BITSET_RANK_WORDS;
+    U64 result = bitset->rank[block] + bitset_popcount_words(bitset->words + first, word - first);
+    if (index & 63) {
+        result += popcount_U64(bitset->words[word] & ((1llu << (index & 63)) - 1));
+    }
+    return result;
+}
+
+// NOTE(ryl1k): Position of the set bit with the given rank (counting from
+// 0), or bit_count if there are not that many.
+function U64 bitset_select(Bitset* bitset, U64 rank) {
+    bitset_update_rank(bitset);
+    U64 block_count = (bitset->word_count + BITSET_RANK_WORDS - 1) / BITSET_RANK_WORDS;
+    if (rank >= bitset->rank[block_count]) {
+        return bitset->bit_count;
+    }
+    U64 lo = 0;
+    U64 hi = block_count;
+    while (hi - lo > 1) {
+        U64 mid = (lo + hi) / 2;
+        if (bitset->rank[mid] <= rank) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    rank -= bitset->rank[lo];
+    for (U64 w = lo * BITSET_RANK_WORDS;; w++) {
+        U64 count = popcount_U64(bitset->words[w]);
+        if (rank < count) {
+            return w * 64 + bitset_select_word(bitset->words[w], (U32)rank);
+        }
+        rank -= count;
+    }
+}
+
+function U64 bitset_next_set(const Bitset* bitset, U64 from) {
+    if (from >= bitset->bit_count) {
+        return bitset->bit_count;
+    }
+    const BitsetKernels* kernels = bitset_kernels();
+    U64 w = from >> 6;
+    U64 word = bitset->words[w] & (~0llu << (from & 63));
+    while (!word) {
+        w++;
+        w = kernels->skip_zero_words(bitset->words, w, bitset->word_count);
+        if (w >= bitset->word_count) {
+            return bitset->bit_count;
+        }
+        word = bitset->words[w];
+    }
+    return w * 64 + ctz_U64(word);
+}
+
+function void bitset_and(Bitset* dst, const Bitset* a, const Bitset* b) {
+    bitset_words_and(dst->words, a->words, b->words, Min(dst->word_count, Min(a->word_count, b->word_count)));
+    dst->rank_dirty = 1;
+}
+
+function void bitset_or(Bitset* dst, const Bitset* a, const Bitset* b) {
+    bitset_words_or(dst->words, a->words, b->words, Min(dst->word_count, Min(a->word_count, b->word_count)));
+    dst->rank_dirty = 1;
+}
+
+function void bitset_xor(Bitset* dst, const Bitset* a, const Bitset* b) {
+    bitset_words_xor(dst->words, a->words, b->words, Min(dst->word_count, Min(a->word_count, b->word_count)));
+    dst->rank_dirty = 1;
+}
+
+function void bitset_andnot(Bitset* dst, const Bitset* a, const Bitset* b) {
+    bitset_words_andnot(dst->words, a->words, b->words, Min(dst->word_count, Min(a->word_count, b->word_count)));
+    dst->rank_dirty = 1;
+}
+
+function void* roaring_alloc(RoaringBitmap* bitmap, U64 size) {
+    return bitmap->arena ? arena_alloc_aligned(bitmap->arena, size, 32) : BASE_ALLOC(size);
+}
+
+function void roaring_free(RoaringBitmap* bitmap, void* data) {
+    if (!bitmap->arena && data) {
+        BASE_FREE(data);
+    }
+}
+
+// NOTE(ryl1k): Index of the first container with key >= key.
+function U32 roaring_find(const RoaringBitmap* bitmap, U32 key, B32* found) {
+    U32 lo = 0;
+    U32 hi = bitmap->count;
+    while (lo < hi) {
+        U32 mid = (lo + hi) / 2;
+        if (bitmap->containers[mid].key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    *found = lo < bitmap->count && bitmap->containers[lo].key == key;
+    return lo;
+}
+
+function U32 roaring_array_find(const U16* values, U32 count, U32 value) {
+    U32 lo = 0;
+    U32 hi = count;
+    while (lo < hi) {
+        U32 mid = (lo + hi) / 2;
+        if (values[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+function RoaringContainer* roaring_insert_container(RoaringBitmap* bitmap, U32 at, U16 key) {
+    if (bitmap->count == bitmap->capacity) {
+        U32 capacity = bitmap->capacity ? bitmap->capacity * 2 : 4;
+        RoaringContainer* containers = array_grow(bitmap->arena, bitmap->containers, bitmap->count,
+                                                  bitmap->capacity, capacity, sizeof(RoaringContainer));
+        if (!containers) {
+            return NULL;
+        }
+        bitmap->containers = containers;
+        bitmap->capacity = capacity;
+    }
+    RoaringContainer* c = &bitmap->containers[at];
+    MemoryCopy(c + 1, c, (bitmap->count - at) * sizeof(RoaringContainer));
+    bitmap->count++;
+    MemoryZeroStruct(c);
+    c->key = key;
+    c->type = RoaringContainer_Array;
+    return c;
+}
+
+function void roaring_remove_container(RoaringBitmap* bitmap, U32 at) {
+    RoaringContainer* c = &bitmap->containers[at];
+    roaring_free(bitmap, c->data);
+    MemoryCopy(c, c + 1, (bitmap->count - at - 1) * sizeof(RoaringContainer));
+    bitmap->count--;
+}
+
+function B32 roaring_to_bitmap(RoaringBitmap* bitmap, RoaringContainer* c) {
+    U64* words = roaring_alloc(bitmap, ROARING_BITMAP_WORDS * sizeof(U64));
+    if (!words) {
+        return 0;
+    }
+    MemoryZero(words, ROARING_BITMAP_WORDS * sizeof(U64));
+    U16* values = c->data;
+    for (U32 i = 0; i < c->cardinality; i++) {
+        words[values[i] >> 6] |= 1llu << (values[i] & 63);
+    }
+    roaring_free(bitmap, c->data);
+    c->data = words;
+    c->type = RoaringContainer_Bitmap;
+    c->capacity = 0;
+    return 1;
+}
+
+function U32 roaring_words_to_array(const U64* words, U16* values) {
+    U32 count = 0;
+    for (U32 w = 0; w < ROARING_BITMAP_WORDS; w++) {
+        for (U64 word = words[w]; word; word &= word - 1) {
+            values[count++] = (U16)(w * 64 + ctz_U64(word));
+        }
+    }
+    return count;
+}
+
+function B32 roaring_to_array(RoaringBitmap* bitmap, RoaringContainer* c) {
+    U16* values = roaring_alloc(bitmap, c->cardinality * sizeof(U16));
+    if (!values) {
+        return 0;
+    }
+    roaring_words_to_array(c->data, values);
+    roaring_free(bitmap, c->data);
+    c->data = values;
+    c->type = RoaringContainer_Array;
+    c->capacity = c->cardinality;
+    return 1;
+}
+
+function RoaringBitmap roaring_create(Arena* arena) {
+    RoaringBitmap bitmap;
+    MemoryZeroStruct(&bitmap);
+    bitmap.arena = arena;
+    return bitmap;
+}
+
+function void roaring_destroy(RoaringBitmap* bitmap) {
+    if (!bitmap->arena) {
+        for (U32 i = 0; i < bitmap->count; i++) {
+            BASE_FREE(bitmap->containers[i].data);
+        }
+        if (bitmap->containers) {
+            BASE_FREE(bitmap->containers);
+        }
+    }
+    MemoryZeroStruct(bitmap);
+}
+
+// NOTE(ryl1k): Returns 1 if value was not present and has been added.
+function B32 roaring_add(RoaringBitmap* bitmap, U32 value) {
+    B32 found;
+    U32 at = roaring_find(bitmap, value >> 16, &found);
+    RoaringContainer* c = found ? &bitmap->containers[at] : roaring_insert_container(bitmap, at, (U16)(value >> 16));
+    if (!c) {
+        return 0;
+    }
+    U32 low = value & 0xFFFF;
+    if (c->type == RoaringContainer_Bitmap) {
+        U64* word = (U64*)c->data + (low >> 6);
+        U64 bit = 1llu << (low & 63);
+        if (*word & bit) {
+            return 0;
+        }
+        *word |= bit;
+        c->cardinality++;
+        return 1;
+    }
+    U16* values = c->data;
+    U32 index = roaring_array_find(values, c->cardinality, low);
+    if (index < c->cardinality && values[index] == low) {
+        return 0;
+    }
+    if (c->cardinality == ROARING_ARRAY_MAX) {
+        if (!roaring_to_bitmap(bitmap, c)) {
+            return 0;
+        }
+        ((U64*)c->data)[low >> 6] |= 1llu << (low & 63);
+        c->cardinality++;
+        return 1;
+    }
+    if (c->cardinality == c->capacity) {
+        U32 capacity = c->capacity ? Min(c->capacity * 2, ROARING_ARRAY_MAX) : 4;
+        values = array_grow(bitmap->arena, c->data, c->cardinality, c->capacity, capacity, sizeof(U16));
+        if (!values) {
+            if (c->cardinality == 0) {
+                roaring_remove_container(bitmap, at);
+            }
+            return 0;
+        }
+        c->data = values;
+        c->capacity = capacity;
+    }
+    MemoryCopy(values + index + 1, values + index, (c->cardinality - index) * sizeof(U16));
+    values[index] = (U16)low;
+    c->cardinality++;
+    return 1;
+}
+
+// NOTE(ryl1k): Returns 1 if value was present and has been removed.
+function B32 roaring_remove(RoaringBitmap* bitmap, U32 value) {
+    B32 found;
+    U32 at = roaring_find(bitmap, value >> 16, &found);
+    if (!found) {
+        return 0;
+    }
+    RoaringContainer* c = &bitmap->containers[at];
+    U32 low = value & 0xFFFF;
+    if (c->type == RoaringContainer_Bitmap) {
+        U64* word = (U64*)c->data + (low >> 6);
+        U64 bit = 1llu << (low & 63);
+        if (!(*word & bit)) {
+            return 0;
+        }
+        *word &= ~bit;
+        c->cardinality--;
+        if (c->cardinality <= ROARING_ARRAY_MAX) {
+            roaring_to_array(bitmap, c);
+        }
+        return 1;
+    }
+    U16* values = c->data;
+    U32 index = roaring_array_find(values, c->cardinality, low);
+    if (index == c->cardinality || values[index] != low) {
+        return 0;
+    }
+    c->cardinality--;
+    MemoryCopy(values + index, values + index + 1, (c->cardinality - index) * sizeof(U16));
+    if (c->cardinality == 0) {
+        roaring_remove_container(bitmap, at);
+    }
+    return 1;
+}
+
+function B32 roaring_contains(const RoaringBitmap* bitmap, U32 value) {
+    B32 found;
+    U32 at = roaring_find(bitmap, value >> 16, &found);
+    if (!found) {
+        return 0;
+    }
+    const RoaringContainer* c = &bitmap->containers[at];
+    U32 low = value & 0xFFFF;
+    if (c->type == RoaringContainer_Bitmap) {
+        return (((const U64*)c->data)[low >> 6] >> (low & 63)) & 1;
+    }
+    const U16* values = c->data;
+    U32 index = roaring_array_find(values, c->cardinality, low);
+    return index < c->cardinality && values[index] == low;
+}
+
+function U64 roaring_cardinality(const RoaringBitmap* bitmap) {
+    U64 total = 0;
+    for (U32 i = 0; i < bitmap->count; i++) {
+        total += bitmap->containers[i].cardinality;
+    }
+    return total;
+}
+
+// NOTE(ryl1k): Finds the smallest value >= from.
+function B32 roaring_next(const RoaringBitmap* bitmap, U32 from, U32* value) {
+    B32 found;
+    U32 at = roaring_find(bitmap, from >> 16, &found);
+    U32 low = found ? (from & 0xFFFF) : 0;
+    for (; at < bitmap->count; at++, low = 0) {
+        const RoaringContainer* c = &bitmap->containers[at];
+        U32 base = (U32)c->key << 16;
+        if (c->type == RoaringContainer_Array) {
+            const U16* values = c->data;
+            U32 index = roaring_array_find(values, c->cardinality, low);
+            if (index < c->cardinality) {
+                *value = base | values[index];
+                return 1;
+            }
+        } else {
+            const U64* words = c->data;
+            U32 w = low >> 6;
+            U64 word = words[w] & (~0llu << (low & 63));
+            while (!word && ++w < ROARING_BITMAP_WORDS) {
+                word = words[w];
+            }
+            if (word) {
+                *value = base | (w * 64 + ctz_U64(word));
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+function void roaring_container_words(const RoaringContainer* c, U64* words) {
+    if (c->type == RoaringContainer_Bitmap) {
+        MemoryCopy(words, c->data, ROARING_BITMAP_WORDS * sizeof(U64));
+        return;
+    }
+    MemoryZero(words, ROARING_BITMAP_WORDS * sizeof(U64));
+    const U16* values = c->data;
+    for (U32 i = 0; i < c->cardinality; i++) {
+        words[values[i] >> 6] |= 1llu << (values[i] & 63);
+    }
+}
+
+// NOTE(ryl1k): Appends a container for key holding the given values,
+// either as a sorted array or (values NULL) as a bitmap in words.
+function B32 roaring_append(RoaringBitmap* bitmap, U16 key, const U16* values, const U64* words, U32 cardinality) {
+    if (cardinality == 0) {
+        return 1;
+    }
+    RoaringContainer* c = roaring_insert_container(bitmap, bitmap->count, key);
+    if (!c) {
+        return 0;
+    }
+    U16 array[ROARING_ARRAY_MAX];
+    if (!values && cardinality <= ROARING_ARRAY_MAX) {
+        roaring_words_to_array(words, array);
+        values = array;
+    }
+    if (values) {
+        c->data = roaring_alloc(bitmap, cardinality * sizeof(U16));
+        if (c->data) {
+            MemoryCopy(c->data, values, cardinality * sizeof(U16));
+        }
+        c->capacity = cardinality;
+    } else {
+        c->data = roaring_alloc(bitmap, ROARING_BITMAP_WORDS * sizeof(U64));
+        if (c->data) {
+            MemoryCopy(c->data, words, ROARING_BITMAP_WORDS * sizeof(U64));
+        }
+        c->type = RoaringContainer_Bitmap;
+    }
+    if (!c->data) {
+        bitmap->count--;
+        return 0;
+    }
+    c->cardinality = cardinality;
+    return 1;
+}
+
+typedef enum {
+    RoaringOp_And,
+    RoaringOp_Or,
+    RoaringOp_Xor,
+    RoaringOp_AndNot
+} RoaringOp;
+
+function U32 roaring_merge_arrays(const U16* a, U32 a_count, const U16* b, U32 b_count, U16* out, RoaringOp op) {
+    U32 i = 0;
+    U32 j = 0;
+    U32 n = 0;
+    B32 keep_a = op != RoaringOp_And;
+    B32 keep_b = op == RoaringOp_Or || op == RoaringOp_Xor;
+    B32 keep_both = op == RoaringOp_And || op == RoaringOp_Or;
+    while (i < a_count && j < b_count) {
+        if (a[i] < b[j]) {
+            if (keep_a) {
+                out[n++] = a[i];
+            }
+            i++;
+        } else if (b[j] < a[i]) {
+            if (keep_b) {
+                out[n++] = b[j];
+            }
+            j++;
+        } else {
+            if (keep_both) {
+                out[n++] = a[i];
+            }
+            i++;
+            j++;
+        }
+    }
+    for (; keep_a && i < a_count; i++) {
+        out[n++] = a[i];
+    }
+    for (; keep_b && j < b_count; j++) {
+        out[n++] = b[j];
+    }
+    return n;
+}
+
+// NOTE(ryl1k): Containers are merged by key. Two arrays are merged
+// directly; anything involving a bitmap runs as a SIMD word operation
+// over 65536 bits, then shrinks back to an array if small enough.
+function B32 roaring_op(RoaringBitmap* result, const RoaringBitmap* a, const RoaringBitmap* b, RoaringOp op) {
+    U64 words[ROARING_BITMAP_WORDS];
+    U64 other[ROARING_BITMAP_WORDS];
+    U16 merged[2 * ROARING_ARRAY_MAX];
+    U32 i = 0;
+    U32 j = 0;
+    B32 ok = 1;
+    while (ok && (i < a->count || j < b->count)) {
+        U32 key_a = i < a->count ? a->containers[i].key : 0x10000;
+        U32 key_b = j < b->count ? b->containers[j].key : 0x10000;
+        if (key_a < key_b) {
+            const RoaringContainer* c = &a->containers[i++];
+            if (op != RoaringOp_And) {
+                B32 array = c->type == RoaringContainer_Array;
+                ok = roaring_append(result, c->key, array ? c->data : NULL, array ? NULL : c->data, c->cardinality);
+            }
+        } else if (key_b < key_a) {
+            const RoaringContainer* c = &b->containers[j++];
+            if (op == RoaringOp_Or || op == RoaringOp_Xor) {
+                B32 array = c->type == RoaringContainer_Array;
+                ok = roaring_append(result, c->key, array ? c->data : NULL, array ? NULL : c->data, c->cardinality);
+            }
+        } else {
+            const RoaringContainer* ca = &a->containers[i++];
+            const RoaringContainer* cb = &b->containers[j++];
+            if (ca->type == RoaringContainer_Array && cb->type == RoaringContainer_Array) {
+                U32 n = roaring_merge_arrays(ca->data, ca->cardinality, cb->data, cb->cardinality, merged, op);
+                if (n <= ROARING_ARRAY_MAX) {
+                    ok = roaring_append(result, ca->key, merged, NULL, n);
+                    continue;
+                }
+                MemoryZero(words, sizeof(words));
+                for (U32 k = 0; k < n; k++) {
+                    words[merged[k] >> 6] |= 1llu << (merged[k] & 63);
+                }
+                ok = roaring_append(result, ca->key, NULL, words, n);
+                continue;
+            }
+            roaring_container_words(ca, words);
+            roaring_container_words(cb, other);
+            switch (op) {
+                case RoaringOp_And: bitset_words_and(words, words, other, ROARING_BITMAP_WORDS); break;
+                case RoaringOp_Or: bitset_words_or(words, words, other, ROARING_BITMAP_WORDS); break;
+                case RoaringOp_Xor: bitset_words_xor(words, words, other, ROARING_BITMAP_WORDS); break;
+                case RoaringOp_AndNot: bitset_words_andnot(words, words, other, ROARING_BITMAP_WORDS); break;
+            }
+            U32 n = (U32)bitset_popcount_words(words, ROARING_BITMAP_WORDS);
+            ok = roaring_append(result, ca->key, NULL, words, n);
+        }
+    }
+    return ok;
+}
+
+function B32 roaring_and(RoaringBitmap* result, const RoaringBitmap* a, const RoaringBitmap* b) {
+    return roaring_op(result, a, b, RoaringOp_And);
+}
+
+function B32 roaring_or(RoaringBitmap* result, const RoaringBitmap* a, const RoaringBitmap* b) {
+    return roaring_op(result, a, b, RoaringOp_Or);
+}
+
+function B32 roaring_xor(RoaringBitmap* result, const RoaringBitmap* a, const RoaringBitmap* b) {
+    return roaring_op(result, a, b, RoaringOp_Xor);
+}
+
+function B32 roaring_andnot(RoaringBitmap* result, const RoaringBitmap* a, const RoaringBitmap* b) {
+    return roaring_op(result, a, b, RoaringOp_AndNot);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Priority Queue Functions
+
+// NOTE(ryl1k): entries points one entry before a cache line boundary, so
+// children 4i+1..4i+4 of entry i start on a line.
+function B32 heap_grow(Heap* heap, U32 capacity) {
+    U64 size = (U64)capacity * sizeof(HeapEntry) + 2 * CACHE_LINE_SIZE;
+    void* memory = heap->arena ? arena_alloc(heap->arena, size) : BASE_ALLOC(size);
+    if (!memory) {
+        return 0;
+    }
+    HeapEntry* entries = (HeapEntry*)((U8*)ALIGN_PTR(memory, CACHE_LINE_SIZE) + CACHE_LINE_SIZE) - 1;
+    if (heap->count) {
+        MemoryCopy(entries, heap->entries, heap->count * sizeof(HeapEntry));
+    }
+    if (!heap->arena && heap->memory) {
+        BASE_FREE(heap->memory);
+    }
+    heap->memory = memory;
+    heap->entries = entries;
+    heap->capacity = capacity;
+    return 1;
+}
+
+function Heap heap_create(Arena* arena, U32 capacity) {
+    Heap heap;
+    MemoryZeroStruct(&heap);
+    heap.arena = arena;
+    heap.free_handle = HEAP_INVALID_HANDLE;
+    if (capacity) {
+        heap_grow(&heap, capacity);
+    }
+    return heap;
+}
+
+function void heap_destroy(Heap* heap) {
+    if (!heap->arena) {
+        if (heap->memory) {
+            BASE_FREE(heap->memory);
+        }
+        if (heap->handles) {
+            BASE_FREE(heap->handles);
+        }
+    }
+    MemoryZeroStruct(heap);
+    heap->free_handle = HEAP_INVALID_HANDLE;
+}
+
+function void heap_sift_up(Heap* heap, U32 i) {
+    HeapEntry entry = heap->entries[i];
+    while (i > 0) {
+        U32 parent = (i - 1) / 4;
+        if (heap->entries[parent].key <= entry.key) {
+            break;
+        }
+        heap->entries[i] = heap->entries[parent];
+        heap->handles[heap->entries[i].handle].position = i;
+        i = parent;
+    }
+    heap->entries[i] = entry;
+    heap->handles[entry.handle].position = i;
+}
+
+function void heap_sift_down(Heap* heap, U32 i) {
+    HeapEntry entry = heap->entries[i];
+    for (;;) {
+        U32 first = 4 * i + 1;
+        if (first >= heap->count) {
+            break;
+        }
+        U32 last = Min(first + 4, heap->count);
+        U32 best = first;
+        for (U32 child = first + 1; child < last; child++) {
+            if (heap->entries[child].key < heap->entries[best].key) {
+                best = child;
+            }
+        }
+        if (heap->entries[best].key >= entry.key) {
+            break;
+        }
+        heap->entries[i] = heap->entries[best];
+        heap->handles[heap->entries[i].handle].position = i;
+        i = best;
+    }
+    heap->entries[i] = entry;
+    heap->handles[entry.handle].position = i;
+}
+
+function void heap_free_handle(Heap* heap, U32 handle) {
+    heap->handles[handle].position = HEAP_INVALID_HANDLE;
+    heap->handles[handle].next_free = heap->free_handle;
+    heap->free_handle = handle;
+}
+
+// NOTE(ryl1k): Returns HEAP_INVALID_HANDLE if the heap could not grow.
+function U32 heap_push(Heap* heap, U64 key, void* value) {
+    if (heap->count == heap->capacity && !heap_grow(heap, heap->capacity ? heap->capacity * 2 : 16)) {
+        return HEAP_INVALID_HANDLE;
+    }
+    U32 handle = heap->free_handle;
+    if (handle != HEAP_INVALID_HANDLE) {
+        heap->free_handle = heap->handles[handle].next_free;
+    } else {
+        if (heap->handle_count == heap->handle_capacity) {
+            U32 capacity = heap->handle_capacity ? heap->handle_capacity * 2 : 16;
+            HeapHandle* handles = array_grow(heap->arena, heap->handles, heap->handle_count,
+                                             heap->handle_capacity, capacity, sizeof(HeapHandle));
+            if (!handles) {
+                return HEAP_INVALID_HANDLE;
+            }
+            heap->handles = handles;
+            heap->handle_capacity = capacity;
+        }
+        handle = heap->handle_count++;
+    }
+    heap->handles[handle].value = value;
+    heap->entries[heap->count].key = key;
+    heap->entries[heap->count].handle = handle;
+    heap->entries[heap->count].unused = 0;
+    heap_sift_up(heap, heap->count++);
+    return handle;
+}
+
+function B32 heap_peek(Heap* heap, U64* key, void** value) {
+    if (!heap->count) {
+        return 0;
+    }
+    if (key) {
+        *key = heap->entries[0].key;
+    }
+    if (value) {
+        *value = heap->handles[heap->entries[0].handle].value;
+    }
+    return 1;
+}
+
+function B32 heap_pop(Heap* heap, U64* key, void** value) {
+    if (!heap_peek(heap, key, value)) {
+        return 0;
+    }
+    heap_free_handle(heap, heap->entries[0].handle);
+    heap->count--;
+    if (heap->count) {
+        heap->entries[0] = heap->entries[heap->count];
+        heap_sift_down(heap, 0);
+    }
+    return 1;
+}
+
+// NOTE(ryl1k): Decrease-key sifts up, increase-key sifts down.
+function void heap_update(Heap* heap, U32 handle, U64 key) {
+    U32 i = heap->handles[handle].position;
+    U64 old = heap->entries[i].key;
+    heap->entries[i].key = key;
+    if (key < old) {
+        heap_sift_up(heap, i);
+    } else {
+        heap_sift_down(heap, i);
+    }
+}
+
+function void heap_remove(Heap* heap, U32 handle) {
+    U32 i = heap->handles[handle].position;
+    U64 old = heap->entries[i].key;
+    heap_free_handle(heap, handle);
+    heap->count--;
+    if (i == heap->count) {
+        return;
+    }
+    heap->entries[i] = heap->entries[heap->count];
+    if (heap->entries[i].key < old) {
+        heap_sift_up(heap, i);
+    } else {
+        heap_sift_down(heap, i);
+    }
+}
+
+function U64 heap_key(Heap* heap, U32 handle) {
+    return heap->entries[heap->handles[handle].position].key;
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Timer Wheel Functions
+
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_RANGE (1llu << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS))
+
+function void timer_list_init(TimerNode* list) {
+    list->prev = list;
+    list->next = list;
+}
+
+function TimerNode* timer_list_pop(TimerNode* list) {
+    TimerNode* node = list->next;
+    if (node == list) {
+        return NULL;
+    }
+    DLL_REMOVE(node);
+    return node;
+}
+
+function TimerWheel* timer_wheel_create(Arena* arena, U64 now) {
+    U64 size = sizeof(TimerWheel) + CACHE_LINE_SIZE;
+    void* memory = arena ? arena_alloc(arena, size) : BASE_ALLOC(size);
+    if (!memory) {
+        return NULL;
+    }
+    TimerWheel* wheel = (TimerWheel*)ALIGN_PTR(memory, CACHE_LINE_SIZE);
+    MemoryZeroStruct(wheel);
+    for (U32 level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (U32 slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            timer_list_init(&wheel->slots[level][slot]);
+        }
+    }
+    wheel->next_tick = now + 1;
+    wheel->memory = memory;
+    wheel->arena = arena;
+    return wheel;
+}
+
+function void timer_wheel_destroy(TimerWheel* wheel) {
+    if (wheel && !wheel->arena) {
+        BASE_FREE(wheel->memory);
+    }
+}
+
+// NOTE(ryl1k): Files node by how far its deadline is from the next tick;
+// overdue timers go in the next tick's slot.
+function void timer_wheel_file(TimerWheel* wheel, TimerNode* node) {
+    U64 deadline = Max(node->deadline, wheel->next_tick);
+    U64 delta = deadline - wheel->next_tick;
+    U32 level = 0;
+    while (level + 1 < TIMER_WHEEL_LEVELS && (delta >> ((level + 1) * TIMER_WHEEL_BITS))) {
+        level++;
+    }
+    if (delta >= TIMER_WHEEL_RANGE) {
+        deadline = wheel->next_tick + TIMER_WHEEL_RANGE - 1;
+    }
+    U32 slot = (U32)(deadline >> (level * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK;
+    TimerNode* tail = wheel->slots[level][slot].prev;
+    DLL_INSERT_AFTER(tail, node);
+    wheel->occupied[level][slot >> 6] |= 1llu << (slot & 63);
+}
+
+// NOTE(ryl1k): Nodes must start zeroed (or DLL_INIT); a pending node is
+// re-armed. A deadline at or before the last advanced tick fires on the
+// next one.
+function void timer_wheel_add(TimerWheel* wheel, TimerNode* node, U64 deadline) {
+    if (node->next) {
+        DLL_REMOVE(node);
+    }
+    node->deadline = deadline;
+    timer_wheel_file(wheel, node);
+}
+
+// NOTE(ryl1k): Also takes the node back out of an expired list.
+function void timer_wheel_cancel(TimerWheel* wheel, TimerNode* node) {
+    (void)wheel;
+    if (node->next) {
+        DLL_REMOVE(node);
+    }
+}
+
+function B32 timer_wheel_pending(TimerNode* node) {
+    return node->next != NULL;
+}
+
+function U32 timer_wheel_next_occupied(const U64* occupied, U32 from) {
+    for (U32 w = from >> 6; w < TIMER_WHEEL_SLOTS / 64; w++) {
+        U64 word = occupied[w];
+        if (w == from >> 6) {
+            word &= ~0llu << (from & 63);
+        }
+        if (word) {
+            return w * 64 + ctz_U64(word);
+        }
+    }
+    return TIMER_WHEEL_SLOTS;
+}
+
+function void timer_wheel_cascade(TimerWheel* wheel, U32 level, U32 slot) {
+    TimerNode* head = &wheel->slots[level][slot];
+    wheel->occupied[level][slot >> 6] &= ~(1llu << (slot & 63));
+    if (head->next == head) {
+        return;
+    }
+    TimerNode* node = head->next;
+    head->prev->next = NULL;
+    timer_list_init(head);
+    while (node) {
+        TimerNode* next = node->next;
+        timer_wheel_file(wheel, node);
+        node = next;
+    }
+}
+
+// NOTE(ryl1k): Earliest tick after t at which a slot can expire or
+// cascade, skipping runs of empty slots on every level. Bits left set by
+// cancel only cost a visit to an empty slot.
+function U64 timer_wheel_next_event(TimerWheel* wheel, U64 t) {
+    for (U32 level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        U32 shift = level * TIMER_WHEEL_BITS;
+        U32 index = (U32)(t >> shift) & TIMER_WHEEL_MASK;
+        U32 slot = timer_wheel_next_occupied(wheel->occupied[level], index + 1);
+        if (slot < TIMER_WHEEL_SLOTS) {
+            return ((t >> shift) - index + slot) << shift;
+        }
+        if (timer_wheel_next_occupied(wheel->occupied[level], 0) < TIMER_WHEEL_SLOTS) {
+            return ((t >> shift) - index + TIMER_WHEEL_SLOTS) << shift;
+        }
+    }
+    return ~0llu;
+}
+
+// NOTE(ryl1k): Appends every timer due at or before now to expired (a list
+// set up with timer_list_init), a whole slot at a time.
+function void timer_wheel_advance(TimerWheel* wheel, U64 now, TimerNode* expired) {
+    while (wheel->next_tick <= now) {
+        U64 t = wheel->next_tick;
+        U32 index = (U32)t & TIMER_WHEEL_MASK;
+        if (index == 0) {
+            for (U32 level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+                U32 slot = (U32)(t >> (level * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK;
+                timer_wheel_cascade(wheel, level, slot);
+                if (slot != 0) {
+                    break;
+                }
+            }
+        }
+        TimerNode* head = &wheel->slots[0][index];
+        wheel->occupied[0][index >> 6] &= ~(1llu << (index & 63));
+        if (head->next != head) {
+            TimerNode* first = head->next;
+            TimerNode* last = head->prev;
+            TimerNode* tail = expired->prev;
+            tail->next = first;
+            first->prev = tail;
+            last->next = expired;
+            expired->prev = last;
+            timer_list_init(head);
+        }
+        wheel->next_tick = Min(timer_wheel_next_event(wheel, t), now + 1);
+    }
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Float Constant Functions
+
+function F32 inf_F32(void) {
+    union { F32 f; U32 u; } r;
+    r.u = 0x7f800000;
+    return(r.f);
+}
+
+function F32 neg_inf_F32(void) {
+    union { F32 f; U32 u; } r;
+    r.u = 0xff800000;
+    return(r.f);
+}
+
+function F64 inf_F64(void) {
+    union { F64 f; U64 u; } r;
+    r.u = 0x7ff0000000000000;
+    return(r.f);
+}
+
+function F64 neg_inf_F64(void) {
+    union { F64 f; U64 u; } r;
+    r.u = 0xfff0000000000000;
+    return(r.f);
+}
+
+function F32 nan_F32(void) {
+    union { F32 f; U32 u; } r;
+    r.u = 0x7fc00000;
+    return(r.f);
+}
+
+function F64 nan_F64(void) {
+    union { F64 f; U64 u; } r;
+    r.u = 0x7ff8000000000000;
+    return(r.f);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Math Functions
+
+#include <math.h>
+
+#if defined(__SSE__) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define RSQRT_SSE 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define RSQRT_NEON 1
+#endif
+
+// NOTE(ryl1k): Hardware estimate refined by Newton steps to ~22 bits.
+// rsqrt_fast_F32(0) is inf, like 1/sqrt.
+function F32 rsqrt_fast_F32(F32 x) {
+#if defined(RSQRT_SSE)
+    F32 y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+    return(y * (1.5f - 0.5f * x * y * y));
+#elif defined(RSQRT_NEON)
+    F32 y = vrsqrtes_f32(x);
+    y = y * vrsqrtss_f32(x * y, y);
+    return(y * vrsqrtss_f32(x * y, y));
+#else
+    return(1.0f / sqrtf(x));
+#endif
+}
+
+function F32 sin_F32(F32 x) {
+    return(sinf(x));
+}
+
+function F32 cos_F32(F32 x) {
+    return(cosf(x));
+}
+
+function F32 tan_F32(F32 x) {
+    return(tanf(x));
+}
+
+function F32 ln_F32(F32 x) {
+    return(logf(x));
+}
+
+function F32 exp_F32(F32 x) {
+    return(expf(x));
+}
+
+function F64 sin_F64(F64 x) {
+    return(sin(x));
+}
+
+function F64 cos_F64(F64 x) {
+    return(cos(x));
+}
+
+function F64 tan_F64(F64 x) {
+    return(tan(x));
+}
+
+function F64 ln_F64(F64 x) {
+    return(log(x));
+}
+
+function F64 exp_F64(F64 x) {
+    return(exp(x));
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Bit Functions
+
+function U32 clz_U64(U64 x) {
+    if (x == 0) {
+        return 64;
+    }
+#if defined(_MSC_VER) && (defined(_M_AMD64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return 63 - index;
+#elif defined(__GNUC__) || defined(__clang__)
+    return (U32)__builtin_clzll(x);
+#else
+    U32 n = 0;
+    while (!(x & 0x8000000000000000llu)) {
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+function U32 ctz_U64(U64 x) {
+    if (x == 0) {
+        return 64;
+    }
+#if defined(_MSC_VER) && (defined(_M_AMD64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return index;
+#elif defined(__GNUC__) || defined(__clang__)
+    return (U32)__builtin_ctzll(x);
+#else
+    U32 n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+function U32 popcount_U64(U64 x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (U32)__builtin_popcountll(x);
+#elif defined(_MSC_VER) && defined(_M_AMD64) && defined(__AVX__)
+    return (U32)__popcnt64(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555llu);
+    x = (x & 0x3333333333333333llu) + ((x >> 2) & 0x3333333333333333llu);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Fllu;
+    return (U32)((x * 0x0101010101010101llu) >> 56);
+#endif
+}
+
+function U64 mul_U64_hi_lo(U64 a, U64 b, U64* lo) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = (unsigned __int128)a * b;
+    *lo = (U64)r;
+    return (U64)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_AMD64)
+    U64 hi;
+    *lo = _umul128(a, b, &hi);
+    return hi;
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    *lo = a * b;
+    return __umulh(a, b);
+#else
+    U64 a_lo = (U32)a, a_hi = a >> 32;
+    U64 b_lo = (U32)b, b_hi = b >> 32;
+    U64 p0 = a_lo * b_lo;
+    U64 p1 = a_lo * b_hi;
+    U64 p2 = a_hi * b_lo;
+    U64 p3 = a_hi * b_hi;
+    U64 mid = (p0 >> 32) + (U32)p1 + (U32)p2;
+    *lo = (mid << 32) | (U32)p0;
+    return p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+#endif
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Compound Type Functions
+
+function V2F32 V2F32_normalize_fast(V2F32 v) {
+    F32 length_squared = V2F32_dot(v, v);
+    F32 s = length_squared > 0.0f ? rsqrt_fast_F32(length_squared) : 0.0f;
+    return (multiply_V2F32(&v, &s));
+}
+function V3F32 V3F32_normalize_fast(V3F32 v) {
+    F32 length_squared = V3F32_dot(v, v);
+    F32 s = length_squared > 0.0f ? rsqrt_fast_F32(length_squared) : 0.0f;
+    return (multiply_V3F32(&v, &s));
+}
+function V4F32 V4F32_normalize_fast(V4F32 v) {
+    F32 length_squared = V4F32_dot(v, v);
+    F32 s = length_squared > 0.0f ? rsqrt_fast_F32(length_squared) : 0.0f;
+    return (multiply_V4F32(&v, &s));
+}
+
+function M3F32 m3f32_identity(void) {
+    M3F32 result = {0};
+    result.m[0][0] = result.m[1][1] = result.m[2][2] = 1.0f;
+    return result;
+}
+function M4F32 m4f32_identity(void) {
+    M4F32 result = {0};
+    result.m[0][0] = result.m[1][1] = result.m[2][2] = result.m[3][3] = 1.0f;
+    return result;
+}
+
+function M3F32 m3f32_columns(V3F32 c0, V3F32 c1, V3F32 c2) {
+    M3F32 result;
+    result.c[0] = c0;
+    result.c[1] = c1;
+    result.c[2] = c2;
+    return result;
+}
+function M4F32 m4f32_columns(V4F32 c0, V4F32 c1, V4F32 c2, V4F32 c3) {
+    M4F32 result;
+    result.c[0] = c0;
+    result.c[1] = c1;
+    result.c[2] = c2;
+    result.c[3] = c3;
+    return result;
+}
+
+function M4F32 m4f32_from_m3f32(const M3F32* m) {
+    M4F32 result = m4f32_identity();
+    for (U32 j = 0; j < 3; j++) {
+        for (U32 i = 0; i < 3; i++) {
+            result.m[j][i] = m->m[j][i];
+        }
+    }
+    return result;
+}
+
+// NOTE(ryl1k): Rodrigues' formula; the axis need not be normalized.
+function M3F32 m3f32_rotation(V3F32 axis, F32 radians) {
+    V3F32 u = V3F32_normalize(axis);
+    F32 s = sin_F32(radians);
+    F32 c = cos_F32(radians);
+    F32 t = 1.0f - c;
+    M3F32 result = m3f32_columns(
+        v3f32(t * u.x * u.x + c,       t * u.x * u.y + s * u.z, t * u.x * u.z - s * u.y),
+        v3f32(t * u.x * u.y - s * u.z, t * u.y * u.y + c,       t * u.y * u.z + s * u.x),
+        v3f32(t * u.x * u.z + s * u.y, t * u.y * u.z - s * u.x, t * u.z * u.z + c));
+    return result;
+}
+
+function M4F32 m4f32_translation(V3F32 t) {
+    M4F32 result = m4f32_identity();
+    result.c[3] = v4f32(t.x, t.y, t.z, 1.0f);
+    return result;
+}
+
+function M4F32 m4f32_scale(V3F32 s) {
+    M4F32 result = {0};
+    result.m[0][0] = s.x;
+    result.m[1][1] = s.y;
+    result.m[2][2] = s.z;
+    result.m[3][3] = 1.0f;
+    return result;
+}
+
+function M4F32 m4f32_compose(V3F32 translation, const M3F32* rotation, V3F32 scale) {
+    M4F32 result;
+    for (U32 j = 0; j < 3; j++) {
+        V3F32 c = rotation->c[j];
+        result.c[j] = v4f32(c.x * scale.v[j], c.y * scale.v[j], c.z * scale.v[j], 0.0f);
+    }
+    result.c[3] = v4f32(translation.x, translation.y, translation.z, 1.0f);
+    return result;
+}
+
+function M3F32 M3F32_multiply(const M3F32* a, const M3F32* b) {
+    M3F32 result;
+    for (U32 j = 0; j < 3; j++) {
+        result.c[j] = M3F32_multiply_V3F32(a, b->c[j]);
+    }
+    return result;
+}
+function M4F32 M4F32_multiply(const M4F32* a, const M4F32* b) {
+    M4F32 result;
+    for (U32 j = 0; j < 4; j++) {
+        result.c[j] = M4F32_multiply_V4F32(a, b->c[j]);
+    }
+    return result;
+}
+
+function M3F32 M3F32_transpose(const M3F32* m) {
+    M3F32 result;
+    for (U32 j = 0; j < 3; j++) {
+        for (U32 i = 0; i < 3; i++) {
+            result.m[j][i] = m->m[i][j];
+        }
+    }
+    return result;
+}
+function M4F32 M4F32_transpose(const M4F32* m) {
+    M4F32 result;
+    for (U32 j = 0; j < 4; j++) {
+        for (U32 i = 0; i < 4; i++) {
+            result.m[j][i] = m->m[i][j];
+        }
+    }
+    return result;
+}
+
+function F32 M3F32_determinant(const M3F32* m) {
+    return V3F32_dot(m->c[0], V3F32_cross(m->c[1], m->c[2]));
+}
+
+// NOTE(ryl1k): Laplace expansion over 2x2 minors of the top two and bottom
+// two rows; the same minors give the adjugate in M4F32_inverse.
+#define M4F32_MINORS(m) \
+    F32 a00 = m->m[0][0], a01 = m->m[1][0], a02 = m->m[2][0], a03 = m->m[3][0]; \
+    F32 a10 = m->m[0][1], a11 = m->m[1][1], a12 = m->m[2][1], a13 = m->m[3][1]; \
+    F32 a20 = m->m[0][2], a21 = m->m[1][2], a22 = m->m[2][2], a23 = m->m[3][2]; \
+    F32 a30 = m->m[0][3], a31 = m->m[1][3], a32 = m->m[2][3], a33 = m->m[3][3]; \
+    F32 s0 = a00 * a11 - a10 * a01, s1 = a00 * a12 - a10 * a02, s2 = a00 * a13 - a10 * a03; \
+    F32 s3 = a01 * a12 - a11 * a02, s4 = a01 * a13 - a11 * a03, s5 = a02 * a13 - a12 * a03; \
+    F32 c0 = a20 * a31 - a30 * a21, c1 = a20 * a32 - a30 * a22, c2 = a20 * a33 - a30 * a23; \
+    F32 c3 = a21 * a32 - a31 * a22, c4 = a21 * a33 - a31 * a23, c5 = a22 * a33 - a32 * a23; \
+    F32 det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+
+function F32 M4F32_determinant(const M4F32* m) {
+    M4F32_MINORS(m)
+    return det;
+}
+
+function B32 M3F32_inverse(const M3F32* m, M3F32* out) {
+    V3F32 r0 = V3F32_cross(m->c[1], m->c[2]);
+    V3F32 r1 = V3F32_cross(m->c[2], m->c[0]);
+    V3F32 r2 = V3F32_cross(m->c[0], m->c[1]);
+    F32 det = V3F32_dot(m->c[0], r0);
+    if (det == 0.0f) {
+        return 0;
+    }
+    F32 inv = 1.0f / det;
+    for (U32 j = 0; j < 3; j++) {
+        out->c[j] = v3f32(r0.v[j] * inv, r1.v[j] * inv, r2.v[j] * inv);
+    }
+    return 1;
+}
+
+function B32 M4F32_inverse(const M4F32* m, M4F32* out) {
+    M4F32_MINORS(m)
+    if (det == 0.0f) {
+        return 0;
+    }
+    F32 inv = 1.0f / det;
+    M4F32 r;
+    r.m[0][0] = ( a11 * c5 - a12 * c4 + a13 * c3) * inv;
+    r.m[1][0] = (-a01 * c5 + a02 * c4 - a03 * c3) * inv;
+    r.m[2][0] = ( a31 * s5 - a32 * s4 + a33 * s3) * inv;
+    r.m[3][0] = (-a21 * s5 + a22 * s4 - a23 * s3) * inv;
+    r.m[0][1] = (-a10 * c5 + a12 * c2 - a13 * c1) * inv;
+    r.m[1][1] = ( a00 * c5 - a02 * c2 + a03 * c1) * inv;
+    r.m[2][1] = (-a30 * s5 + a32 * s2 - a33 * s1) * inv;
+    r.m[3][1] = ( a20 * s5 - a22 * s2 + a23 * s1) * inv;
+    r.m[0][2] = ( a10 * c4 - a11 * c2 + a13 * c0) * inv;
+    r.m[1][2] = (-a00 * c4 + a01 * c2 - a03 * c0) * inv;
+    r.m[2][2] = ( a30 * s4 - a31 * s2 + a33 * s0) * inv;
+    r.m[3][2] = (-a20 * s4 + a21 * s2 - a23 * s0) * inv;
+    r.m[0][3] = (-a10 * c3 + a11 * c1 - a12 * c0) * inv;
+    r.m[1][3] = ( a00 * c3 - a01 * c1 + a02 * c0) * inv;
+    r.m[2][3] = (-a30 * s3 + a31 * s1 - a32 * s0) * inv;
+    r.m[3][3] = ( a20 * s3 - a21 * s1 + a22 * s0) * inv;
+    *out = r;
+    return 1;
+}
+
+function V3F32 M3F32_multiply_V3F32(const M3F32* m, V3F32 v) {
+    V3F32 result;
+    for (U32 i = 0; i < 3; i++) {
+        result.v[i] = m->m[0][i] * v.x + m->m[1][i] * v.y + m->m[2][i] * v.z;
+    }
+    return result;
+}
+function V4F32 M4F32_multiply_V4F32(const M4F32* m, V4F32 v) {
+    V4F32 result;
+    for (U32 i = 0; i < 4; i++) {
+        result.v[i] = m->m[0][i] * v.x + m->m[1][i] * v.y + m->m[2][i] * v.z + m->m[3][i] * v.w;
+    }
+    return result;
+}
+function V3F32 M4F32_transform_point(const M4F32* m, V3F32 p) {
+    V3F32 result;
+    for (U32 i = 0; i < 3; i++) {
+        result.v[i] = m->m[0][i] * p.x + m->m[1][i] * p.y + m->m[2][i] * p.z + m->m[3][i];
+    }
+    return result;
+}
+function V3F32 M4F32_transform_direction(const M4F32* m, V3F32 d) {
+    V3F32 result;
+    for (U32 i = 0; i < 3; i++) {
+        result.v[i] = m->m[0][i] * d.x + m->m[1][i] * d.y + m->m[2][i] * d.z;
+    }
+    return result;
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): CPU Features Functions
+
+#if defined(CPU_X86)
+function void cpu_cpuid(U32 leaf, U32 subleaf, U32 regs[4]) {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, (int)leaf, (int)subleaf);
+    for (U32 i = 0; i < 4; i++) {
+        regs[i] = (U32)r[i];
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+function U64 cpu_xgetbv(void) {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    U32 lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((U64)hi << 32) | lo;
+#endif
+}
+#endif
+
+function void cpu_add_cache(CPUTopology* t, U32 level, B32 instruction, U64 size, U64 line_size) {
+    if (level == 1 && instruction) {
+        if (!t->l1i_size) {
+            t->l1i_size = size;
+        }
+    } else if (level == 1) {
+        if (!t->l1d_size) {
+            t->l1d_size = size;
+        }
+        if (!t->cache_line_size) {
+            t->cache_line_size = (U32)line_size;
+        }
+    } else if (level == 2) {
+        if (!t->l2_size) {
+            t->l2_size = size;
+        }
+    } else if (level == 3) {
+        if (!t->l3_size) {
+            t->l3_size = size;
+        }
+    }
+}
+
+#if defined(CPU_X86)
+// NOTE(ryl1k): Deterministic cache parameters (leaf 4 on Intel, 0x8000001D
+// on AMD), one subleaf per cache until a null type.
+function void cpu_cpuid_caches(U32 leaf, CPUTopology* t) {
+    for (U32 i = 0; i < 16; i++) {
+        U32 regs[4];
+        cpu_cpuid(leaf, i, regs);
+        U32 type = regs[0] & 0x1F;
+        if (type == 0) {
+            break;
+        }
+        U64 ways = (regs[1] >> 22) + 1;
+        U64 partitions = ((regs[1] >> 12) & 0x3FF) + 1;
+        U64 line_size = (regs[1] & 0xFFF) + 1;
+        U64 sets = (U64)regs[2] + 1;
+        cpu_add_cache(t, (regs[0] >> 5) & 0x7, type == 2, ways * partitions * line_size * sets, line_size);
+    }
+}
+#endif
+
+#if defined(__linux__)
+function U64 cpu_read_file(const char* path, char* buffer, U64 size) {
+    U64 length = 0;
+    FILE* file = fopen(path, "rb");
+    if (file) {
+        length = fread(buffer, 1, size - 1, file);
+        fclose(file);
+    }
+    buffer[length] = 0;
+    return length;
+}
+
+// NOTE(ryl1k): The number after key (or at the start of the file), scaled
+// by a K/M/G suffix as sysfs and /proc/meminfo write sizes.
+function U64 cpu_read_number(const char* path, const char* key) {
+    char buffer[4096];
+    if (!cpu_read_file(path, buffer, sizeof(buffer))) {
+        return 0;
+    }
+    const char* at = buffer;
+    if (key) {
+        at = strstr(buffer, key);
+        if (!at) {
+            return 0;
+        }
+        at += strlen(key);
+    }
+    char* end;
+    U64 value = strtoull(at, &end, 10);
+    while (*end == ' ') {
+        end++;
+    }
+    switch (*end) {
+        case 'k': case 'K': value <<= 10; break;
+        case 'M': value <<= 20; break;
+        case 'G': value <<= 30; break;
+    }
+    return value;
+}
+
+// NOTE(ryl1k): Counts the CPUs in a list such as "0-3,8,10-11".
+function U32 cpu_read_list_count(const char* path) {
+    char buffer[1024];
+    if (!cpu_read_file(path, buffer, sizeof(buffer))) {
+        return 0;
+    }
+    U32 count = 0;
+    char* at = buffer;
+    while (*at >= '0' && *at <= '9') {
+        U64 first = strtoull(at, &at, 10);
+        U64 last = first;
+        if (*at == '-') {
+            last = strtoull(at + 1, &at, 10);
+        }
+        count += (U32)(last - first + 1);
+        if (*at == ',') {
+            at++;
+        }
+    }
+    return count;
+}
+#endif
+
+#if defined(__APPLE__)
+function U64 cpu_sysctl_U64(const char* name) {
+    U64 value = 0;
+    size_t size = sizeof(value);
+    if (sysctlbyname(name, &value, &size, NULL, 0) != 0) {
+        return 0;
+    }
+    return value;
+}
+#endif
+
+function CPUFeatures cpu_detect_features(void) {
+    CPUFeatures f = {0};
+#if defined(CPU_X86)
+    U32 regs[4];
+    cpu_cpuid(0, 0, regs);
+    U32 max_leaf = regs[0];
+    B32 amd = (regs[1] == 0x68747541 || regs[1] == 0x6F677948); // "Auth", "Hygo"
+
+    if (max_leaf >= 1) {
+        cpu_cpuid(1, 0, regs);
+        U32 family = (regs[0] >> 8) & 0xF;
+        if (family == 0xF) {
+            family += (regs[0] >> 20) & 0xFF;
+        }
+        f.sse2 = (regs[3] >> 26) & 1;
+        f.sse41 = (regs[2] >> 19) & 1;
+        f.sse42 = (regs[2] >> 20) & 1;
+        f.popcnt = (regs[2] >> 23) & 1;
+
+        // NOTE(ryl1k): The OS has to save the wider registers on context
+        // switch too, which XCR0 reports.
+        B32 osxsave = (regs[2] >> 27) & 1;
+        U64 xcr0 = osxsave ? cpu_xgetbv() : 0;
+        f.avx = ((regs[2] >> 28) & 1) && (xcr0 & 0x6) == 0x6;
+        f.fma = ((regs[2] >> 12) & 1) && f.avx;
+
+        if (max_leaf >= 7) {
+            cpu_cpuid(7, 0, regs);
+            B32 avx512_state = (xcr0 & 0xE6) == 0xE6;
+            f.avx2 = ((regs[1] >> 5) & 1) && f.avx;
+            f.bmi1 = (regs[1] >> 3) & 1;
+            f.bmi2 = (regs[1] >> 8) & 1;
+            f.slow_pdep = f.bmi2 && amd && family < 0x19;
+            f.avx512f = ((regs[1] >> 16) & 1) && avx512_state;
+            f.avx512dq = ((regs[1] >> 17) & 1) && f.avx512f;
+            f.avx512cd = ((regs[1] >> 28) & 1) && f.avx512f;
+            f.avx512bw = ((regs[1] >> 30) & 1) && f.avx512f;
+            f.avx512vl = ((regs[1] >> 31) & 1) && f.avx512f;
+            f.avx512vnni = ((regs[2] >> 11) & 1) && f.avx512f;
+        }
+    }
+#elif defined(CPU_ARM64)
+    f.neon = 1;
+#if defined(__linux__)
+#if !defined(HWCAP_SVE)
+#define HWCAP_SVE (1 << 22)
+#endif
+    f.sve = (getauxval(AT_HWCAP) & HWCAP_SVE) != 0;
+#elif defined(_WIN32) && defined(PF_ARM_SVE_INSTRUCTIONS_AVAILABLE)
+    f.sve = IsProcessorFeaturePresent(PF_ARM_SVE_INSTRUCTIONS_AVAILABLE) != 0;
+#endif
+#endif
+    return f;
+}
+
+// NOTE(ryl1k): Caches and cores come from the OS where it reports them
+// (sysfs, GetLogicalProcessorInformation, sysctl), else from the CPU.
+function CPUTopology cpu_detect_topology(void) {
+    CPUTopology t = {0};
+#if defined(_WIN32)
+    DWORD length = 0;
+    GetLogicalProcessorInformation(NULL, &length);
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION* info = length ? (SYSTEM_LOGICAL_PROCESSOR_INFORMATION*)BASE_ALLOC(length) : NULL;
+    if (info && GetLogicalProcessorInformation(info, &length)) {
+        U32 count = length / sizeof(*info);
+        for (U32 i = 0; i < count; i++) {
+            if (info[i].Relationship == RelationProcessorCore) {
+                t.core_count++;
+                t.thread_count += popcount_U64((U64)info[i].ProcessorMask);
+            } else if (info[i].Relationship == RelationCache) {
+                CACHE_DESCRIPTOR* cache = &info[i].Cache;
+                cpu_add_cache(&t, cache->Level, cache->Type == CacheInstruction, cache->Size, cache->LineSize);
+            }
+        }
+    }
+    if (info) {
+        BASE_FREE(info);
+    }
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    t.page_size = system_info.dwPageSize;
+    t.huge_page_size = GetLargePageMinimum();
+#elif defined(__linux__)
+    for (U32 i = 0; i < 16; i++) {
+        char path[96];
+        char type[32];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/type", i);
+        if (!cpu_read_file(path, type, sizeof(type))) {
+            break;
+        }
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/level", i);
+        U32 level = (U32)cpu_read_number(path, NULL);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/size", i);
+        U64 size = cpu_read_number(path, NULL);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/coherency_line_size", i);
+        U64 line_size = cpu_read_number(path, NULL);
+        cpu_add_cache(&t, level, type[0] == 'I', size, line_size);
+    }
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    t.thread_count = online > 0 ? (U32)online : 0;
+    U32 smt = cpu_read_list_count("/sys/devices/system/cpu/cpu0/topology/thread_siblings_list");
+    t.core_count = smt ? t.thread_count / smt : 0;
+    t.page_size = (U64)sysconf(_SC_PAGESIZE);
+    t.huge_page_size = cpu_read_number("/proc/meminfo", "Hugepagesize:");
+#elif defined(__APPLE__)
+    t.l1d_size = cpu_sysctl_U64("hw.l1dcachesize");
+    t.l1i_size = cpu_sysctl_U64("hw.l1icachesize");
+    t.l2_size = cpu_sysctl_U64("hw.l2cachesize");
+    t.l3_size = cpu_sysctl_U64("hw.l3cachesize");
+    t.cache_line_size = (U32)cpu_sysctl_U64("hw.cachelinesize");
+    t.core_count = (U32)cpu_sysctl_U64("hw.physicalcpu");
+    t.thread_count = (U32)cpu_sysctl_U64("hw.logicalcpu");
+    t.page_size = (U64)sysconf(_SC_PAGESIZE);
+#else
+    t.page_size = (U64)sysconf(_SC_PAGESIZE);
+#endif
+
+#if defined(CPU_X86)
+    U32 regs[4];
+    if (!t.l1d_size) {
+        cpu_cpuid(0, 0, regs);
+        U32 max_leaf = regs[0];
+        B32 intel = regs[1] == 0x756E6547; // "Genu"
+        cpu_cpuid(0x80000000, 0, regs);
+        U32 max_extended_leaf = regs[0];
+        if (intel && max_leaf >= 4) {
+            cpu_cpuid_caches(4, &t);
+        } else if (!intel && max_extended_leaf >= 0x8000001D) {
+            cpu_cpuid_caches(0x8000001D, &t);
+        }
+    }
+    if (!t.cache_line_size) {
+        cpu_cpuid(1, 0, regs);
+        t.cache_line_size = ((regs[1] >> 8) & 0xFF) * 8;
+    }
+#elif defined(CPU_ARM64) && !defined(_MSC_VER)
+    // NOTE(ryl1k): CTR_EL0.DminLine is log2 of the smallest data cache
+    // line in words, and is readable from user space.
+    if (!t.cache_line_size) {
+        U64 ctr;
+        __asm__ volatile("mrs %0, ctr_el0" : "=r"(ctr));
+        t.cache_line_size = 4u << ((ctr >> 16) & 0xF);
+    }
+#endif
+    if (!t.cache_line_size) {
+        t.cache_line_size = CACHE_LINE_SIZE;
+    }
+    if (!t.thread_count) {
+        t.thread_count = os_cpu_count();
+    }
+    if (!t.core_count) {
+        t.core_count = t.thread_count;
+    }
+    return t;
+}
+
+global CPUFeatures cpu_features_cache;
+global CPUTopology cpu_topology_cache;
+global volatile U64 cpu_detect_state;
+
+// NOTE(ryl1k): The first caller detects while any others wait for it, so
+// the caches are written once and only read after state 2 is published.
+function void cpu_detect(void) {
+    if (atomic_load_U64(&cpu_detect_state) == 2) {
+        return;
+    }
+    U64 expected = 0;
+    if (atomic_cas_U64(&cpu_detect_state, &expected, 1)) {
+        cpu_features_cache = cpu_detect_features();
+        cpu_topology_cache = cpu_detect_topology();
+        atomic_store_U64(&cpu_detect_state, 2);
+    }
+    while (atomic_load_U64(&cpu_detect_state) != 2) {
+        os_thread_yield();
+    }
+}
+
+function CPUFeatures cpu_features(void) {
+    cpu_detect();
+    return cpu_features_cache;
+}
+
+function CPUTopology cpu_topology(void) {
+    cpu_detect();
+    return cpu_topology_cache;
+}
+
+function void* cpu_dispatch(void* volatile* slot, CPUDispatchResolver* resolve) {
+    void* result = atomic_load_ptr(slot);
+    if (!result) {
+        CPUFeatures features = cpu_features();
+        result = resolve(&features);
+        atomic_store_ptr(slot, result);
+    }
+    return result;
+}
+
+function B32 simd_level_supported(SIMDLevel level) {
+    CPUFeatures f = cpu_features();
+    switch (level) {
+        case SIMDLevel_Scalar: return 1;
+        case SIMDLevel_SSE2:   return f.sse2;
+        case SIMDLevel_AVX2:   return f.avx2 && f.fma;
+        case SIMDLevel_AVX512: return f.avx512f && f.avx2 && f.fma;
+        case SIMDLevel_NEON:   return f.neon;
+    }
+    return 0;
+}
+
+function SIMDLevel simd_level_best(void) {
+    if (simd_level_supported(SIMDLevel_AVX512)) {
+        return SIMDLevel_AVX512;
+    }
+    if (simd_level_supported(SIMDLevel_AVX2)) {
+        return SIMDLevel_AVX2;
+    }
+    if (simd_level_supported(SIMDLevel_SSE2)) {
+        return SIMDLevel_SSE2;
+    }
+    if (simd_level_supported(SIMDLevel_NEON)) {
+        return SIMDLevel_NEON;
+    }
+    return SIMDLevel_Scalar;
+}
+
+function const char* simd_level_name(SIMDLevel level) {
+    switch (level) {
+        case SIMDLevel_Scalar: return "scalar";
+        case SIMDLevel_SSE2:   return "sse2";
+        case SIMDLevel_AVX2:   return "avx2";
+        case SIMDLevel_AVX512: return "avx512";
+        case SIMDLevel_NEON:   return "neon";
+    }
+    return "unknown";
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Vector Array Functions
+
+// NOTE(ryl1k): One set of F32 kernels per SIMD level, each a wide main
+// loop plus a scalar tail. The AoS and SoA entry points all reduce to
+// these, since every op here is elementwise.
+#define VECTOR_KERNELS_DEFINE(suffix, TARGET, W, VT, LOAD, STORE, SET1, ADD, SUB, MUL, FMADD) \
+TARGET function void add_F32_array_##suffix(F32* out, const F32* a, const F32* b, U64 count) { \
+    U64 i = 0; \
+    for (; i + (W) <= count; i += (W)) { \
+        STORE(out + i, ADD(LOAD(a + i), LOAD(b + i))); \
+    } \
+    for (; i < count; i++) { \
+        out[i] = a[i] + b[i]; \
+    } \
+} \
+TARGET function void subtract_F32_array_##suffix(F32* out, const F32* a, const F32* b, U64 count) { \
+    U64 i = 0; \
+    for (; i + (W) <= count; i += (W)) { \
+        STORE(out + i, SUB(LOAD(a + i), LOAD(b + i))); \
+    } \
+    for (; i < count; i++) { \
+        out[i] = a[i] - b[i]; \
+    } \
+} \
+TARGET function void scale_F32_array_##suffix(F32* out, const F32* a, F32 s, U64 count) { \
+    VT vs = SET1(s); \
+    U64 i = 0; \
+    for (; i + (W) <= count; i += (W)) { \
+        STORE(out + i, MUL(LOAD(a + i), vs)); \
+    } \
+    for (; i < count; i++) { \
+        out[i] = a[i] * s; \
+    } \
+} \
+TARGET function void hadamard_F32_array_##suffix(F32* out, const F32* a, const F32* b, U64 count) { \
+    U64 i = 0; \
+    for (; i + (W) <= count; i += (W)) { \
+        STORE(out + i, MUL(LOAD(a + i), LOAD(b + i))); \
+    } \
+    for (; i < count; i++) { \
+        out[i] = a[i] * b[i]; \
+    } \
+} \
+TARGET function void fma_F32_array_##suffix(F32* out, const F32* a, const F32* b, const F32* c, U64 count) { \
+    U64 i = 0; \
+    for (; i + (W) <= count; i += (W)) { \
+        STORE(out + i, FMADD(LOAD(a + i), LOAD(b + i), LOAD(c + i))); \
+    } \
+    for (; i < count; i++) { \
+        out[i] = a[i] * b[i] + c[i]; \
+    } \
+} \
+TARGET function void lerp_F32_array_##suffix(F32* out, const F32* a, const F32* b, F32 t, U64 count) { \
+    VT vt = SET1(t); \
+    U64 i = 0; \
+    for (; i + (W) <= count; i += (W)) { \
+        VT va = LOAD(a + i); \
+        STORE(out + i, FMADD(SUB(LOAD(b + i), va), vt, va)); \
+    } \
+    for (; i < count; i++) { \
+        out[i] = a[i] + (b[i] - a[i]) * t; \
+    } \
+}
+
+#define SCALAR_LOAD(p)          (*(p))
+#define SCALAR_STORE(p, v)      (*(p) = (v))
+#define SCALAR_SET1(s)          (s)
+#define SCALAR_ADD(a, b)        ((a) + (b))
+#define SCALAR_SUB(a, b)        ((a) - (b))
+#define SCALAR_MUL(a, b)        ((a) * (b))
+#define SCALAR_FMADD(a, b, c)   ((a) * (b) + (c))
+VECTOR_KERNELS_DEFINE(scalar, , 1, F32, SCALAR_LOAD, SCALAR_STORE, SCALAR_SET1,
+                      SCALAR_ADD, SCALAR_SUB, SCALAR_MUL, SCALAR_FMADD)
+
+#if defined(CPU_X86)
+#define SSE2_FMADD(a, b, c) _mm_add_ps(_mm_mul_ps(a, b), c)
+VECTOR_KERNELS_DEFINE(sse2, , 4, __m128, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps,
+                      _mm_add_ps, _mm_sub_ps, _mm_mul_ps, SSE2_FMADD)
+VECTOR_KERNELS_DEFINE(avx2, TARGET_AVX2, 8, __m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps,
+                      _mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps, _mm256_fmadd_ps)
+VECTOR_KERNELS_DEFINE(avx512, TARGET_AVX512, 16, __m512, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_set1_ps,
+                      _mm512_add_ps, _mm512_sub_ps, _mm512_mul_ps, _mm512_fmadd_ps)
+#elif defined(CPU_ARM64)
+#define NEON_FMADD(a, b, c) vfmaq_f32(c, a, b)
+VECTOR_KERNELS_DEFINE(neon, , 4, float32x4_t, vld1q_f32, vst1q_f32, vdupq_n_f32,
+                      vaddq_f32, vsubq_f32, vmulq_f32, NEON_FMADD)
+#endif
+
+// NOTE(ryl1k): Reductions keep several accumulators so the adds are not one
+// long dependency chain. For vectors of 1, 2 or 4 components every lane of
+// an accumulator always sees the same component; for 3 components three
+// registers cover 3*W floats and lane j of register r holds component
+// (r*W + j) % 3. Lanes are folded into the result at the end.
+#define VECTOR_REDUCE_BODY(R, W, VT, LOAD, STORE, SET1, OP, SCALAR_OP, INIT) { \
+    VT acc[R]; \
+    for (U32 r = 0; r < (R); r++) { \
+        acc[r] = SET1(INIT); \
+    } \
+    for (; i + (R) * (W) <= count; i += (R) * (W)) { \
+        for (U32 r = 0; r < (R); r++) { \
+            acc[r] = OP(acc[r], LOAD(a + i + r * (W))); \
+        } \
+    } \
+    F32 lanes[W]; \
+    for (U32 r = 0; r < (R); r++) { \
+        STORE(lanes, acc[r]); \
+        for (U32 j = 0; j < (W); j++) { \
+            U32 k = (r * (W) + j) % components; \
+            result[k] = SCALAR_OP(result[k], lanes[j]); \
+        } \
+    } \
+}
+
+#define VECTOR_REDUCE_KERNEL(name, suffix, TARGET, W, VT, LOAD, STORE, SET1, OP, SCALAR_OP, INIT) \
+TARGET function void name##_F32_components_##suffix(F32* result, const F32* a, U64 count, U32 components) { \
+    for (U32 k = 0; k < components; k++) { \
+        result[k] = (INIT); \
+    } \
+    U64 i = 0; \
+    if (components == 3) { \
+        VECTOR_REDUCE_BODY(3, W, VT, LOAD, STORE, SET1, OP, SCALAR_OP, INIT) \
+    } \
+    else { \
+        VECTOR_REDUCE_BODY(4, W, VT, LOAD, STORE, SET1, OP, SCALAR_OP, INIT) \
+    } \
+    for (; i < count; i++) { \
+        U32 k = (U32)(i % components); \
+        result[k] = SCALAR_OP(result[k], a[i]); \
+    } \
+}
+
+// NOTE(ryl1k): Per-vector kernels are written once for a fixed component
+// count N and switched on, so the component loops unroll. SoA input loads
+// one register per component directly; AoS input goes through LOAD_AOS and
+// STORE_AOS, which transpose W vectors in registers.
+#define VECTOR_DOT_BODY(N, W, VT, LOAD_COMPONENTS, LOAD_OP, STORE, SET1, MUL, FMADD) { \
+    VT bv[N]; \
+    for (U32 k = 0; k < (N); k++) { \
+        bv[k] = SET1(b[k]); \
+    } \
+    for (; i + (W) <= count; i += (W)) { \
+        VT c[N]; \
+        LOAD_COMPONENTS(c, i, N, LOAD_OP); \
+        VT acc = MUL(c[0], bv[0]); \
+        for (U32 k = 1; k < (N); k++) { \
+            acc = FMADD(c[k], bv[k], acc); \
+        } \
+        STORE(out + i, acc); \
+    } \
+}
+
+#define VECTOR_NORMALIZE_BODY(N, W, VT, LOAD_COMPONENTS, LOAD_OP, STORE_COMPONENTS, STORE_OP, SET1, MUL, FMADD, SQRT, DIV, RSQRT, KEEP_POSITIVE) { \
+    for (; i + (W) <= count; i += (W)) { \
+        VT c[N]; \
+        LOAD_COMPONENTS(c, i, N, LOAD_OP); \
+        VT length_squared = MUL(c[0], c[0]); \
+        for (U32 k = 1; k < (N); k++) { \
+            length_squared = FMADD(c[k], c[k], length_squared); \
+        } \
+        VT s; \
+        if (fast) { \
+            s = RSQRT(length_squared); \
+        } \
+        else { \
+            s = DIV(SET1(1.0f), SQRT(length_squared)); \
+        } \
+        s = KEEP_POSITIVE(s, length_squared); \
+        for (U32 k = 0; k < (N); k++) { \
+            c[k] = MUL(c[k], s); \
+        } \
+        STORE_COMPONENTS(c, i, N, STORE_OP); \
+    } \
+}
+
+#define VECTOR_SWITCH_COMPONENTS(BODY, ...) \
+    switch (components) { \
+        case 2: BODY(2, __VA_ARGS__) break; \
+        case 3: BODY(3, __VA_ARGS__) break; \
+        default: BODY(4, __VA_ARGS__) break; \
+    }
+
+#define VECTOR_SOA_LOAD(c, i, N, LOAD)   for (U32 k = 0; k < (N); k++) c[k] = LOAD(a[k] + (i))
+#define VECTOR_SOA_STORE(c, i, N, STORE) for (U32 k = 0; k < (N); k++) STORE(out[k] + (i), c[k])
+#define VECTOR_AOS_LOAD(c, i, N, LOAD)   LOAD(c, a + (i) * (N), N)
+#define VECTOR_AOS_STORE(c, i, N, STORE) STORE(out + (i) * (N), c, N)
+
+#define VECTOR_REDUCE_KERNELS_DEFINE(suffix, TARGET, W, VT, LOAD, STORE, SET1, ADD, MUL, FMADD, MIN, MAX, SQRT, DIV, RSQRT, KEEP_POSITIVE) \
+TARGET function F32 dot_F32_array_##suffix(const F32* a, const F32* b, U64 count) { \
+    VT acc0 = SET1(0.0f), acc1 = SET1(0.0f), acc2 = SET1(0.0f), acc3 = SET1(0.0f); \
+    U64 i = 0; \
+    for (; i + 4 * (W) <= count; i += 4 * (W)) { \
+        acc0 = FMADD(LOAD(a + i), LOAD(b + i), acc0); \
+        acc1 = FMADD(LOAD(a + i + (W)), LOAD(b + i + (W)), acc1); \
+        acc2 = FMADD(LOAD(a + i + 2 * (W)), LOAD(b + i + 2 * (W)), acc2); \
+        acc3 = FMADD(LOAD(a + i + 3 * (W)), LOAD(b + i + 3 * (W)), acc3); \
+    } \
+    for (; i + (W) <= count; i += (W)) { \
+        acc0 = FMADD(LOAD(a + i), LOAD(b + i), acc0); \
+    } \
+    F32 lanes[W]; \
+    STORE(lanes, ADD(ADD(acc0, acc1), ADD(acc2, acc3))); \
+    F32 result = 0.0f; \
+    for (U32 j = 0; j < (W); j++) { \
+        result += lanes[j]; \
+    } \
+    for (; i < count; i++) { \
+        result += a[i] * b[i]; \
+    } \
+    return result; \
+} \
+VECTOR_REDUCE_KERNEL(sum, suffix, TARGET, W, VT, LOAD, STORE, SET1, ADD, SCALAR_ADD, 0.0f) \
+VECTOR_REDUCE_KERNEL(min, suffix, TARGET, W, VT, LOAD, STORE, SET1, MIN, Min, inf_F32()) \
+VECTOR_REDUCE_KERNEL(max, suffix, TARGET, W, VT, LOAD, STORE, SET1, MAX, Max, neg_inf_F32()) \
+TARGET function void dot_soa_##suffix(F32* out, const F32* const* a, const F32* b, U32 components, U64 count) { \
+    U64 i = 0; \
+    VECTOR_SWITCH_COMPONENTS(VECTOR_DOT_BODY, W, VT, VECTOR_SOA_LOAD, LOAD, STORE, SET1, MUL, FMADD) \
+    for (; i < count; i++) { \
+        F32 acc = a[0][i] * b[0]; \
+        for (U32 k = 1; k < components; k++) { \
+            acc += a[k][i] * b[k]; \
+        } \
+        out[i] = acc; \
+    } \
+} \
+TARGET function void normalize_soa_##suffix(F32* const* out, const F32* const* a, U32 components, U64 count, B32 fast) { \
+    U64 i = 0; \
+    VECTOR_SWITCH_COMPONENTS(VECTOR_NORMALIZE_BODY, W, VT, VECTOR_SOA_LOAD, LOAD, VECTOR_SOA_STORE, STORE, SET1, MUL, FMADD, \
+                             SQRT, DIV, RSQRT, KEEP_POSITIVE) \
+    for (; i < count; i++) { \
+        F32 length_squared = 0.0f; \
+        for (U32 k = 0; k < components; k++) { \
+            length_squared += a[k][i] * a[k][i]; \
+        } \
+        F32 s = 0.0f; \
+        if (length_squared > 0.0f) { \
+            s = fast ? rsqrt_fast_F32(length_squared) : 1.0f / sqrt_F32(length_squared); \
+        } \
+        for (U32 k = 0; k < components; k++) { \
+            out[k][i] = a[k][i] * s; \
+        } \
+    } \
+}
+
+#define VECTOR_AOS_KERNELS_DEFINE(suffix, TARGET, W, VT, STORE, LOAD_AOS, STORE_AOS, SET1, MUL, FMADD, SQRT, DIV, RSQRT, KEEP_POSITIVE) \
+TARGET function void dot_aos_##suffix(F32* out, const F32* a, const F32* b, U32 components, U64 count) { \
+    U64 i = 0; \
+    VECTOR_SWITCH_COMPONENTS(VECTOR_DOT_BODY, W, VT, VECTOR_AOS_LOAD, LOAD_AOS, STORE, SET1, MUL, FMADD) \
+    for (; i < count; i++) { \
+        const F32* v = a + i * components; \
+        F32 acc = v[0] * b[0]; \
+        for (U32 k = 1; k < components; k++) { \
+            acc += v[k] * b[k]; \
+        } \
+        out[i] = acc; \
+    } \
+} \
+TARGET function void normalize_aos_##suffix(F32* out, const F32* a, U32 components, U64 count, B32 fast) { \
+    U64 i = 0; \
+    VECTOR_SWITCH_COMPONENTS(VECTOR_NORMALIZE_BODY, W, VT, VECTOR_AOS_LOAD, LOAD_AOS, VECTOR_AOS_STORE, STORE_AOS, SET1, MUL, FMADD, \
+                             SQRT, DIV, RSQRT, KEEP_POSITIVE) \
+    for (; i < count; i++) { \
+        const F32* v = a + i * components; \
+        F32 length_squared = 0.0f; \
+        for (U32 k = 0; k < components; k++) { \
+            length_squared += v[k] * v[k]; \
+        } \
+        F32 s = 0.0f; \
+        if (length_squared > 0.0f) { \
+            s = fast ? rsqrt_fast_F32(length_squared) : 1.0f / sqrt_F32(length_squared); \
+        } \
+        for (U32 k = 0; k < components; k++) { \
+            out[i * components + k] = v[k] * s; \
+        } \
+    } \
+}
+
+#define SCALAR_DIV(a, b)                ((a) / (b))
+#define SCALAR_KEEP_POSITIVE(v, x)      ((x) > 0.0f ? (v) : 0.0f)
+#define SCALAR_LOAD_AOS(c, p, N)        for (U32 k = 0; k < (N); k++) { c[k] = (p)[k]; }
+#define SCALAR_STORE_AOS(p, c, N)       for (U32 k = 0; k < (N); k++) { (p)[k] = c[k]; }
+VECTOR_REDUCE_KERNELS_DEFINE(scalar, , 1, F32, SCALAR_LOAD, SCALAR_STORE, SCALAR_SET1, SCALAR_ADD, SCALAR_MUL,
+                             SCALAR_FMADD, Min, Max, sqrt_F32, SCALAR_DIV, rsqrt_fast_F32, SCALAR_KEEP_POSITIVE)
+VECTOR_AOS_KERNELS_DEFINE(scalar, , 1, F32, SCALAR_STORE, SCALAR_LOAD_AOS, SCALAR_STORE_AOS, SCALAR_SET1, SCALAR_MUL,
+                          SCALAR_FMADD, sqrt_F32, SCALAR_DIV, rsqrt_fast_F32, SCALAR_KEEP_POSITIVE)
+
+// NOTE(ryl1k): Transforms take a column-major 4x4 matrix as 16 floats.
+// With 3 components the input is a point (w = 1) and the bottom row is
+// ignored. Peeling and tails go through the scalar range functions.
+function void transform_F32_one(F32* r, const F32* v, const F32* m, U32 components) {
+    for (U32 row = 0; row < components; row++) {
+        F32 acc = (components == 4) ? m[12 + row] * v[3] : m[12 + row];
+        r[row] = m[row] * v[0] + m[4 + row] * v[1] + m[8 + row] * v[2] + acc;
+    }
+}
+
+function void transform_soa_range(F32* const* out, const F32* const* a, const F32* m, U32 components, U64 begin, U64 end) {
+    for (U64 i = begin; i < end; i++) {
+        F32 v[4];
+        F32 r[4];
+        for (U32 k = 0; k < components; k++) {
+            v[k] = a[k][i];
+        }
+        transform_F32_one(r, v, m, components);
+        for (U32 k = 0; k < components; k++) {
+            out[k][i] = r[k];
+        }
+    }
+}
+
+function void transform_aos_range(F32* out, const F32* a, const F32* m, U32 components, U64 begin, U64 end) {
+    for (U64 i = begin; i < end; i++) {
+        F32 v[4];
+        F32 r[4];
+        for (U32 k = 0; k < components; k++) {
+            v[k] = a[i * components + k];
+        }
+        transform_F32_one(r, v, m, components);
+        for (U32 k = 0; k < components; k++) {
+            out[i * components + k] = r[k];
+        }
+    }
+}
+
+// NOTE(ryl1k): The scalar path has no streaming stores, so streaming is ignored.
+function void transform_soa_scalar(F32* const* out, const F32* const* a, const F32* m, U32 components, U64 count, B32 streaming) {
+    (void)streaming;
+    transform_soa_range(out, a, m, components, 0, count);
+}
+
+function void transform_aos_scalar(F32* out, const F32* a, const F32* m, U32 components, U64 count, B32 streaming) {
+    (void)streaming;
+    transform_aos_range(out, a, m, components, 0, count);
+}
+
+// NOTE(ryl1k): Streaming stores need aligned addresses. Returns the first
+// index at which every out[k] + i * stride is aligned, or max_U64 if the
+// arrays never line up (then the kernel uses ordinary stores).
+function U64 transform_stream_start(F32* const* out, U32 arrays, U32 stride, U64 alignment, U64 count) {
+    for (U64 i = 0; i < alignment / sizeof(F32) && i <= count; i++) {
+        B32 aligned = 1;
+        for (U32 k = 0; k < arrays; k++) {
+            aligned &= IS_ALIGNED(out[k] + i * stride, alignment);
+        }
+        if (aligned) {
+            return i;
+        }
+    }
+    return max_U64;
+}
+
+#define VECTOR_TRANSFORM_BODY(N, W, VT, LOAD_MACRO, LOAD, STORE_MACRO, STORE, SET1, MUL, FMADD) \
+    { \
+        VT mc[4][4]; \
+        for (U32 col = 0; col < 4; col++) { \
+            for (U32 row = 0; row < (N); row++) { \
+                mc[col][row] = SET1(m[col * 4 + row]); \
+            } \
+        } \
+        for (; i + (W) <= count; i += (W)) { \
+            VT c[4]; \
+            VT o[4]; \
+            LOAD_MACRO(c, i, N, LOAD); \
+            for (U32 row = 0; row < (N); row++) { \
+                VT acc = mc[3][row]; \
+                if ((N) == 4) { \
+                    acc = MUL(acc, c[3]); \
+                } \
+                acc = FMADD(mc[2][row], c[2], acc); \
+                acc = FMADD(mc[1][row], c[1], acc); \
+                o[row] = FMADD(mc[0][row], c[0], acc); \
+            } \
+            STORE_MACRO(o, i, N, STORE); \
+        } \
+    }
+
+#define VECTOR_TRANSFORM_SWITCH(...) \
+    if (components == 3) { \
+        VECTOR_TRANSFORM_BODY(3, __VA_ARGS__) \
+    } \
+    else { \
+        VECTOR_TRANSFORM_BODY(4, __VA_ARGS__) \
+    }
+
+#define VECTOR_NO_FENCE()
+
+#define VECTOR_TRANSFORM_KERNELS_DEFINE(suffix, TARGET, W, VT, LOAD, STORE, STREAM, SET1, MUL, FMADD, HAS_STREAM, FENCE) \
+TARGET function void transform_soa_##suffix(F32* const* out, const F32* const* a, const F32* m, U32 components, U64 count, B32 streaming) { \
+    U64 i = 0; \
+    U64 start = (streaming && (HAS_STREAM)) ? transform_stream_start(out, components, 1, (W) * sizeof(F32), count) : max_U64; \
+    if (start != max_U64) { \
+        transform_soa_range(out, a, m, components, 0, start); \
+        i = start; \
+        VECTOR_TRANSFORM_SWITCH(W, VT, VECTOR_SOA_LOAD, LOAD, VECTOR_SOA_STORE, STREAM, SET1, MUL, FMADD) \
+        FENCE(); \
+    } else { \
+        VECTOR_TRANSFORM_SWITCH(W, VT, VECTOR_SOA_LOAD, LOAD, VECTOR_SOA_STORE, STORE, SET1, MUL, FMADD) \
+    } \
+    transform_soa_range(out, a, m, components, i, count); \
+}
+
+// NOTE(ryl1k): The AoS store helpers write 128-bit pieces, so streaming
+// only needs 16-byte alignment at any width.
+#define VECTOR_TRANSFORM_AOS_KERNELS_DEFINE(suffix, TARGET, W, VT, LOAD_AOS, STORE_AOS, STREAM_AOS, SET1, MUL, FMADD, HAS_STREAM, FENCE) \
+TARGET function void transform_aos_##suffix(F32* out, const F32* a, const F32* m, U32 components, U64 count, B32 streaming) { \
+    U64 i = 0; \
+    U64 start = (streaming && (HAS_STREAM)) ? transform_stream_start(&out, 1, components, 16, count) : max_U64; \
+    if (start != max_U64) { \
+        transform_aos_range(out, a, m, components, 0, start); \
+        i = start; \
+        VECTOR_TRANSFORM_SWITCH(W, VT, VECTOR_AOS_LOAD, LOAD_AOS, VECTOR_AOS_STORE, STREAM_AOS, SET1, MUL, FMADD) \
+        FENCE(); \
+    } else { \
+        VECTOR_TRANSFORM_SWITCH(W, VT, VECTOR_AOS_LOAD, LOAD_AOS, VECTOR_AOS_STORE, STORE_AOS, SET1, MUL, FMADD) \
+    } \
+    transform_aos_range(out, a, m, components, i, count); \
+}
+
+#if defined(CPU_X86)
+// NOTE(ryl1k): In-register AoS <-> SoA for 4 vectors per 128-bit lane:
+// r holds the N*4 interleaved floats, c one register per component. Both
+// shuffle and unpack work lane by lane, so the 256-bit version is the same
+// code once vectors 0-3 sit in the low lanes and 4-7 in the high lanes.
+#define LANE_SHUFFLE(i0, i1, i2, i3) _MM_SHUFFLE(i3, i2, i1, i0)
+#define AOS_TRANSPOSE_DEFINE(suffix, TARGET, VT, SHUFFLE, UNPACKLO, UNPACKHI) \
+TARGET function void aos_to_soa_##suffix(VT* c, const VT* r, U32 components) { \
+    if (components == 2) { \
+        c[0] = SHUFFLE(r[0], r[1], LANE_SHUFFLE(0, 2, 0, 2)); \
+        c[1] = SHUFFLE(r[0], r[1], LANE_SHUFFLE(1, 3, 1, 3)); \
+    } else if (components == 3) { \
+        VT x2y2x3y3 = SHUFFLE(r[1], r[2], LANE_SHUFFLE(2, 3, 1, 2)); \
+        VT y0z0y1z1 = SHUFFLE(r[0], r[1], LANE_SHUFFLE(1, 2, 0, 1)); \
+        c[0] = SHUFFLE(r[0], x2y2x3y3, LANE_SHUFFLE(0, 3, 0, 2)); \
+        c[1] = SHUFFLE(y0z0y1z1, x2y2x3y3, LANE_SHUFFLE(0, 2, 1, 3)); \
+        c[2] = SHUFFLE(y0z0y1z1, r[2], LANE_SHUFFLE(1, 3, 0, 3)); \
+    } else { \
+        VT x0x1y0y1 = UNPACKLO(r[0], r[1]); \
+        VT x2x3y2y3 = UNPACKLO(r[2], r[3]); \
+        VT z0z1w0w1 = UNPACKHI(r[0], r[1]); \
+        VT z2z3w2w3 = UNPACKHI(r[2], r[3]); \
+        c[0] = SHUFFLE(x0x1y0y1, x2x3y2y3, LANE_SHUFFLE(0, 1, 0, 1)); \
+        c[1] = SHUFFLE(x0x1y0y1, x2x3y2y3, LANE_SHUFFLE(2, 3, 2, 3)); \
+        c[2] = SHUFFLE(z0z1w0w1, z2z3w2w3, LANE_SHUFFLE(0, 1, 0, 1)); \
+        c[3] = SHUFFLE(z0z1w0w1, z2z3w2w3, LANE_SHUFFLE(2, 3, 2, 3)); \
+    } \
+} \
+TARGET function void soa_to_aos_##suffix(VT* r, const VT* c, U32 components) { \
+    if (components == 2) { \
+        r[0] = UNPACKLO(c[0], c[1]); \
+        r[1] = UNPACKHI(c[0], c[1]); \
+    } else if (components == 3) { \
+        VT x0y0x1y1 = UNPACKLO(c[0], c[1]); \
+        VT z0z0x1x1 = SHUFFLE(c[2], c[0], LANE_SHUFFLE(0, 0, 1, 1)); \
+        VT y1y1z1z1 = SHUFFLE(c[1], c[2], LANE_SHUFFLE(1, 1, 1, 1)); \
+        VT x2x2y2y2 = SHUFFLE(c[0], c[1], LANE_SHUFFLE(2, 2, 2, 2)); \
+        VT z2z2x3x3 = SHUFFLE(c[2], c[0], LANE_SHUFFLE(2, 2, 3, 3)); \
+        VT y3y3z3z3 = SHUFFLE(c[1], c[2], LANE_SHUFFLE(3, 3, 3, 3)); \
+        r[0] = SHUFFLE(x0y0x1y1, z0z0x1x1, LANE_SHUFFLE(0, 1, 0, 2)); \
+        r[1] = SHUFFLE(y1y1z1z1, x2x2y2y2, LANE_SHUFFLE(0, 2, 0, 2)); \
+        r[2] = SHUFFLE(z2z2x3x3, y3y3z3z3, LANE_SHUFFLE(0, 2, 0, 2)); \
+    } else { \
+        aos_to_soa_##suffix(r, c, 4); \
+    } \
+}
+
+AOS_TRANSPOSE_DEFINE(sse2, , __m128, _mm_shuffle_ps, _mm_unpacklo_ps, _mm_unpackhi_ps)
+AOS_TRANSPOSE_DEFINE(avx2, TARGET_AVX2, __m256, _mm256_shuffle_ps, _mm256_unpacklo_ps, _mm256_unpackhi_ps)
+
+function void load_aos_sse2(__m128* c, const F32* p, U32 components) {
+    __m128 r[4];
+    for (U32 j = 0; j < components; j++) {
+        r[j] = _mm_loadu_ps(p + 4 * j);
+    }
+    aos_to_soa_sse2(c, r, components);
+}
+function void store_aos_sse2(F32* p, const __m128* c, U32 components) {
+    __m128 r[4];
+    soa_to_aos_sse2(r, c, components);
+    for (U32 j = 0; j < components; j++) {
+        _mm_storeu_ps(p + 4 * j, r[j]);
+    }
+}
+TARGET_AVX2 function void load_aos_avx2(__m256* c, const F32* p, U32 components) {
+    __m256 r[4];
+    for (U32 j = 0; j < components; j++) {
+        __m128 lo = _mm_loadu_ps(p + 4 * j);
+        __m128 hi = _mm_loadu_ps(p + 4 * (components + j));
+        r[j] = _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+    }
+    aos_to_soa_avx2(c, r, components);
+}
+TARGET_AVX2 function void store_aos_avx2(F32* p, const __m256* c, U32 components) {
+    __m256 r[4];
+    soa_to_aos_avx2(r, c, components);
+    for (U32 j = 0; j < components; j++) {
+        _mm_storeu_ps(p + 4 * j, _mm256_castps256_ps128(r[j]));
+        _mm_storeu_ps(p + 4 * (components + j), _mm256_extractf128_ps(r[j], 1));
+    }
+}
+function void store_aos_stream_sse2(F32* p, const __m128* c, U32 components) {
+    __m128 r[4];
+    soa_to_aos_sse2(r, c, components);
+    for (U32 j = 0; j < components; j++) {
+        _mm_stream_ps(p + 4 * j, r[j]);
+    }
+}
+TARGET_AVX2 function void store_aos_stream_avx2(F32* p, const __m256* c, U32 components) {
+    __m256 r[4];
+    soa_to_aos_avx2(r, c, components);
+    for (U32 j = 0; j < components; j++) {
+        _mm_stream_ps(p + 4 * j, _mm256_castps256_ps128(r[j]));
+        _mm_stream_ps(p + 4 * (components + j), _mm256_extractf128_ps(r[j], 1));
+    }
+}
+
+function __m128 rsqrt_sse2(__m128 x) {
+    __m128 y = _mm_rsqrt_ps(x);
+    __m128 half_x_yy = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), x), _mm_mul_ps(y, y));
+    return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), half_x_yy));
+}
+TARGET_AVX2 function __m256 rsqrt_avx2(__m256 x) {
+    __m256 y = _mm256_rsqrt_ps(x);
+    __m256 half_x_yy = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), x), _mm256_mul_ps(y, y));
+    return _mm256_mul_ps(y, _mm256_sub_ps(_mm256_set1_ps(1.5f), half_x_yy));
+}
+TARGET_AVX512 function __m512 rsqrt_avx512(__m512 x) {
+    __m512 y = _mm512_rsqrt14_ps(x);
+    __m512 half_x_yy = _mm512_mul_ps(_mm512_mul_ps(_mm512_set1_ps(0.5f), x), _mm512_mul_ps(y, y));
+    return _mm512_mul_ps(y, _mm512_sub_ps(_mm512_set1_ps(1.5f), half_x_yy));
+}
+#define SSE2_KEEP_POSITIVE(v, x)   _mm_and_ps(v, _mm_cmpgt_ps(x, _mm_setzero_ps()))
+#define AVX2_KEEP_POSITIVE(v, x)   _mm256_and_ps(v, _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GT_OQ))
+#define AVX512_KEEP_POSITIVE(v, x) _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_GT_OQ), v)
+VECTOR_REDUCE_KERNELS_DEFINE(sse2, , 4, __m128, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, _mm_add_ps, _mm_mul_ps,
+                             SSE2_FMADD, _mm_min_ps, _mm_max_ps, _mm_sqrt_ps, _mm_div_ps, rsqrt_sse2, SSE2_KEEP_POSITIVE)
+VECTOR_REDUCE_KERNELS_DEFINE(avx2, TARGET_AVX2, 8, __m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, _mm256_add_ps,
+                             _mm256_mul_ps, _mm256_fmadd_ps, _mm256_min_ps, _mm256_max_ps, _mm256_sqrt_ps, _mm256_div_ps,
+                             rsqrt_avx2, AVX2_KEEP_POSITIVE)
+VECTOR_REDUCE_KERNELS_DEFINE(avx512, TARGET_AVX512, 16, __m512, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_set1_ps,
+                             _mm512_add_ps, _mm512_mul_ps, _mm512_fmadd_ps, _mm512_min_ps, _mm512_max_ps, _mm512_sqrt_ps,
+                             _mm512_div_ps, rsqrt_avx512, AVX512_KEEP_POSITIVE)
+// NOTE(ryl1k): The AVX-512 level reuses the AVX2 AoS kernels; the shuffles
+// dominate there and a 512-bit transpose buys little over two 256-bit ones.
+VECTOR_AOS_KERNELS_DEFINE(sse2, , 4, __m128, _mm_storeu_ps, load_aos_sse2, store_aos_sse2, _mm_set1_ps, _mm_mul_ps,
+                          SSE2_FMADD, _mm_sqrt_ps, _mm_div_ps, rsqrt_sse2, SSE2_KEEP_POSITIVE)
+VECTOR_AOS_KERNELS_DEFINE(avx2, TARGET_AVX2, 8, __m256, _mm256_storeu_ps, load_aos_avx2, store_aos_avx2, _mm256_set1_ps,
+                          _mm256_mul_ps, _mm256_fmadd_ps, _mm256_sqrt_ps, _mm256_div_ps, rsqrt_avx2, AVX2_KEEP_POSITIVE)
+VECTOR_TRANSFORM_KERNELS_DEFINE(sse2, , 4, __m128, _mm_loadu_ps, _mm_storeu_ps, _mm_stream_ps, _mm_set1_ps, _mm_mul_ps,
+                                SSE2_FMADD, 1, _mm_sfence)
+VECTOR_TRANSFORM_KERNELS_DEFINE(avx2, TARGET_AVX2, 8, __m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_stream_ps,
+                                _mm256_set1_ps, _mm256_mul_ps, _mm256_fmadd_ps, 1, _mm_sfence)
+VECTOR_TRANSFORM_KERNELS_DEFINE(avx512, TARGET_AVX512, 16, __m512, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_stream_ps,
+                                _mm512_set1_ps, _mm512_mul_ps, _mm512_fmadd_ps, 1, _mm_sfence)
+VECTOR_TRANSFORM_AOS_KERNELS_DEFINE(sse2, , 4, __m128, load_aos_sse2, store_aos_sse2, store_aos_stream_sse2, _mm_set1_ps,
+                                    _mm_mul_ps, SSE2_FMADD, 1, _mm_sfence)
+VECTOR_TRANSFORM_AOS_KERNELS_DEFINE(avx2, TARGET_AVX2, 8, __m256, load_aos_avx2, store_aos_avx2, store_aos_stream_avx2,
+                                    _mm256_set1_ps, _mm256_mul_ps, _mm256_fmadd_ps, 1, _mm_sfence)
+#elif defined(CPU_ARM64)
+// NOTE(ryl1k): vld2q/vld3q/vld4q deinterleave AoS input in the load itself.
+function void load_aos_neon(float32x4_t* c, const F32* p, U32 components) {
+    if (components == 2) {
+        float32x4x2_t v = vld2q_f32(p);
+        c[0] = v.val[0]; c[1] = v.val[1];
+    } else if (components == 3) {
+        float32x4x3_t v = vld3q_f32(p);
+        c[0] = v.val[0]; c[1] = v.val[1]; c[2] = v.val[2];
+    } else {
+        float32x4x4_t v = vld4q_f32(p);
+        c[0] = v.val[0]; c[1] = v.val[1]; c[2] = v.val[2]; c[3] = v.val[3];
+    }
+}
+function void store_aos_neon(F32* p, const float32x4_t* c, U32 components) {
+    if (components == 2) {
+        float32x4x2_t v = { { c[0], c[1] } };
+        vst2q_f32(p, v);
+    } else if (components == 3) {
+        float32x4x3_t v = { { c[0], c[1], c[2] } };
+        vst3q_f32(p, v);
+    } else {
+        float32x4x4_t v = { { c[0], c[1], c[2], c[3] } };
+        vst4q_f32(p, v);
+    }
+}
+function float32x4_t rsqrt_neon(float32x4_t x) {
+    float32x4_t y = vrsqrteq_f32(x);
+    y = vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(x, y), y));
+    return vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(x, y), y));
+}
+#define NEON_KEEP_POSITIVE(v, x) \
+    vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v), vcgtq_f32(x, vdupq_n_f32(0.0f))))
+VECTOR_REDUCE_KERNELS_DEFINE(neon, , 4, float32x4_t, vld1q_f32, vst1q_f32, vdupq_n_f32, vaddq_f32, vmulq_f32,
+                             NEON_FMADD, vminq_f32, vmaxq_f32, vsqrtq_f32, vdivq_f32, rsqrt_neon, NEON_KEEP_POSITIVE)
+VECTOR_AOS_KERNELS_DEFINE(neon, , 4, float32x4_t, vst1q_f32, load_aos_neon, store_aos_neon, vdupq_n_f32, vmulq_f32,
+                          NEON_FMADD, vsqrtq_f32, vdivq_f32, rsqrt_neon, NEON_KEEP_POSITIVE)
+VECTOR_TRANSFORM_KERNELS_DEFINE(neon, , 4, float32x4_t, vld1q_f32, vst1q_f32, vst1q_f32, vdupq_n_f32, vmulq_f32,
+                                NEON_FMADD, 0, VECTOR_NO_FENCE)
+VECTOR_TRANSFORM_AOS_KERNELS_DEFINE(neon, , 4, float32x4_t, load_aos_neon, store_aos_neon, store_aos_neon, vdupq_n_f32,
+                                    vmulq_f32, NEON_FMADD, 0, VECTOR_NO_FENCE)
+#endif
+
+typedef struct {
+    SIMDLevel level;
+    void (*add)(F32*, const F32*, const F32*, U64);
+    void (*subtract)(F32*, const F32*, const F32*, U64);
+    void (*scale)(F32*, const F32*, F32, U64);
+    void (*hadamard)(F32*, const F32*, const F32*, U64);
+    void (*fma)(F32*, const F32*, const F32*, const F32*, U64);
+    void (*lerp)(F32*, const F32*, const F32*, F32, U64);
+    F32 (*dot)(const F32*, const F32*, U64);
+    void (*sum)(F32*, const F32*, U64, U32);
+    void (*min)(F32*, const F32*, U64, U32);
+    void (*max)(F32*, const F32*, U64, U32);
+    void (*dot_soa)(F32*, const F32* const*, const F32*, U32, U64);
+    void (*dot_aos)(F32*, const F32*, const F32*, U32, U64);
+    void (*normalize_soa)(F32* const*, const F32* const*, U32, U64, B32);
+    void (*normalize_aos)(F32*, const F32*, U32, U64, B32);
+    void (*transform_soa)(F32* const*, const F32* const*, const F32*, U32, U64, B32);
+    void (*transform_aos)(F32*, const F32*, const F32*, U32, U64, B32);
+} VectorKernels;
+
+#define VECTOR_KERNELS(level, suffix, aos_suffix) { level, \
+    add_F32_array_##suffix, subtract_F32_array_##suffix, scale_F32_array_##suffix, \
+    hadamard_F32_array_##suffix, fma_F32_array_##suffix, lerp_F32_array_##suffix, \
+    dot_F32_array_##suffix, sum_F32_components_##suffix, min_F32_components_##suffix, \
+    max_F32_components_##suffix, dot_soa_##suffix, dot_aos_##aos_suffix, \
+    normalize_soa_##suffix, normalize_aos_##aos_suffix, \
+    transform_soa_##suffix, transform_aos_##aos_suffix }
+
+global const VectorKernels vector_kernels_scalar = VECTOR_KERNELS(SIMDLevel_Scalar, scalar, scalar);
+#if defined(CPU_X86)
+global const VectorKernels vector_kernels_sse2 = VECTOR_KERNELS(SIMDLevel_SSE2, sse2, sse2);
+global const VectorKernels vector_kernels_avx2 = VECTOR_KERNELS(SIMDLevel_AVX2, avx2, avx2);
+global const VectorKernels vector_kernels_avx512 = VECTOR_KERNELS(SIMDLevel_AVX512, avx512, avx2);
+#elif defined(CPU_ARM64)
+global const VectorKernels vector_kernels_neon = VECTOR_KERNELS(SIMDLevel_NEON, neon, neon);
+#endif
+
+function const VectorKernels* vector_kernels_for(SIMDLevel level) {
+    if (!simd_level_supported(level)) {
+        level = SIMDLevel_Scalar;
+    }
+    switch (level) {
+#if defined(CPU_X86)
+        case SIMDLevel_SSE2: return &vector_kernels_sse2;
+        case SIMDLevel_AVX2: return &vector_kernels_avx2;
+        case SIMDLevel_AVX512: return &vector_kernels_avx512;
+#elif defined(CPU_ARM64)
+        case SIMDLevel_NEON: return &vector_kernels_neon;
+#endif
+        default: return &vector_kernels_scalar;
+    }
+}
+
+function void* vector_kernels_resolve(const CPUFeatures* features) {
+    (void)features;
+    return (void*)vector_kernels_for(simd_level_best());
+}
+
+// NOTE(ryl1k): The tables are constant and the slot holds the selected
+// one, so the level and every kernel change together in one atomic store
+// and concurrent first use from several threads resolves the same table.
+global void* volatile vector_kernels_slot;
+
+function const VectorKernels* vector_kernels_get(void) {
+    return (const VectorKernels*)cpu_dispatch(&vector_kernels_slot, vector_kernels_resolve);
+}
+
+function SIMDLevel simd_select_level(SIMDLevel level) {
+    const VectorKernels* kernels = vector_kernels_for(level);
+    atomic_store_ptr(&vector_kernels_slot, (void*)kernels);
+    return kernels->level;
+}
+
+function SIMDLevel simd_current_level(void) {
+    return vector_kernels_get()->level;
+}
+
+function void add_F32_array(F32* out, const F32* a, const F32* b, U64 count) {
+    const VectorKernels* kernels = vector_kernels_get();
+    kernels->add(out, a, b, count);
+}
+
+function void subtract_F32_array(F32* out, const F32* a, const F32* b, U64 count) {
+    const VectorKernels* kernels = vector_kernels_get();
+    kernels->subtract(out, a, b, count);
+}
+
+function void scale_F32_array(F32* out, const F32* a, F32 s, U64 count) {
+    const VectorKernels* kernels = vector_kernels_get();
+    kernels->scale(out, a, s, count);
+}
+
+function void hadamard_F32_array(F32* out, const F32* a, const F32* b, U64 count) {
+    const VectorKernels* kernels = vector_kernels_get();
+    kernels->hadamard(out, a, b, count);
+}
+
+function void fma_F32_array(F32* out, const F32* a, const F32* b, const F32* c, U64 count) {
+    const VectorKernels* kernels = vector_kernels_get();
+    kernels->fma(out, a, b, c, count);
+}
+
+function void lerp_F32_array(F32* out, const F32* a, const F32* b, F32 t, U64 count) {
+    const VectorKernels* kernels = vector_kernels_get();
+    kernels->lerp(out, a, b, t, count);
+}
+
+function F32 dot_F32_array(const F32* a, const F32* b, U64 count) {
+    const VectorKernels* kernels = vector_kernels_get();
+    return kernels->dot(a, b, count);
+}
+
+function void dot_F32_rows(F32* out, const F32* rows, U64 row_count, U64 dim, const F32* query) {
+    const VectorKernels* kernels = vector_kernels_get();
+    for (U64 r = 0; r < row_count; r++) {
+        out[r] = kernels->dot(rows + r * dim, query, dim);
+    }
+}
+
+function F32 sum_F32_array(const F32* a, U64 count) {
+    F32 result;
+    const VectorKernels* kernels = vector_kernels_get();
+    kernels->sum(&result, a, count, 1);
+    return result;
+}
+
+function F32 min_F32_array(const F32* a, U64 count) {
+    F32 result;
+    const VectorKernels* kernels = vector_kernels_get();
+    kernels->min(&result, a, count, 1);
+    return result;
+}
+
+function F32 max_F32_array(const F32* a, U64 count) {
+    F32 result;
+    const VectorKernels* kernels = vector_kernels_get();
+    kernels->max(&result, a, count, 1);
+    return result;
+}
+
+// NOTE(ryl1k): V*F32 is exactly N packed floats, so an AoS array is a flat
+// F32 array N times as long.
+#define VECTOR_ARRAY_DEFINE(V, N) \
+function void add_##V##_array(V* out, const V* a, const V* b, U64 count) { \
+    add_F32_array((F32*)out, (const F32*)a, (const F32*)b, count * (N)); \
+} \
+function void subtract_##V##_array(V* out, const V* a, const V* b, U64 count) { \
+    subtract_F32_array((F32*)out, (const F32*)a, (const F32*)b, count * (N)); \
+} \
+function void scale_##V##_array(V* out, const V* a, F32 s, U64 count) { \
+    scale_F32_array((F32*)out, (const F32*)a, s, count * (N)); \
+} \
+function void hadamard_##V##_array(V* out, const V* a, const V* b, U64 count) { \
+    hadamard_F32_array((F32*)out, (const F32*)a, (const F32*)b, count * (N)); \
+} \
+function void fma_##V##_array(V* out, const V* a, const V* b, const V* c, U64 count) { \
+    fma_F32_array((F32*)out, (const F32*)a, (const F32*)b, (const F32*)c, count * (N)); \
+} \
+function void lerp_##V##_array(V* out, const V* a, const V* b, F32 t, U64 count) { \
+    lerp_F32_array((F32*)out, (const F32*)a, (const F32*)b, t, count * (N)); \
+} \
+function void add_##V##_soa(V##SoA out, V##SoA a, V##SoA b, U64 count) { \
+    for (U32 k = 0; k < (N); k++) { \
+        add_F32_array(out.v[k], a.v[k], b.v[k], count); \
+    } \
+} \
+function void subtract_##V##_soa(V##SoA out, V##SoA a, V##SoA b, U64 count) { \
+    for (U32 k = 0; k < (N); k++) { \
+        subtract_F32_array(out.v[k], a.v[k], b.v[k], count); \
+    } \
+} \
+function void scale_##V##_soa(V##SoA out, V##SoA a, F32 s, U64 count) { \
+    for (U32 k = 0; k < (N); k++) { \
+        scale_F32_array(out.v[k], a.v[k], s, count); \
+    } \
+} \
+function void hadamard_##V##_soa(V##SoA out, V##SoA a, V##SoA b, U64 count) { \
+    for (U32 k = 0; k < (N); k++) { \
+        hadamard_F32_array(out.v[k], a.v[k], b.v[k], count); \
+    } \
+} \
+function void fma_##V##_soa(V##SoA out, V##SoA a, V##SoA b, V##SoA c, U64 count) { \
+    for (U32 k = 0; k < (N); k++) { \
+        fma_F32_array(out.v[k], a.v[k], b.v[k], c.v[k], count); \
+    } \
+} \
+function void lerp_##V##_soa(V##SoA out, V##SoA a, V##SoA b, F32 t, U64 count) { \
+    for (U32 k = 0; k < (N); k++) { \
+        lerp_F32_array(out.v[k], a.v[k], b.v[k], t, count); \
+    } \
+}
+
+#define VECTOR_REDUCE_DEFINE(V, N) \
+function void dot_##V##_array(F32* out, const V* a, V b, U64 count) { \
+    const VectorKernels* kernels = vector_kernels_get(); \
+    kernels->dot_aos(out, (const F32*)a, b.v, (N), count); \
+} \
+function void normalize_##V##_array(V* out, const V* a, U64 count) { \
+    const VectorKernels* kernels = vector_kernels_get(); \
+    kernels->normalize_aos((F32*)out, (const F32*)a, (N), count, 0); \
+} \
+function void normalize_fast_##V##_array(V* out, const V* a, U64 count) { \
+    const VectorKernels* kernels = vector_kernels_get(); \
+    kernels->normalize_aos((F32*)out, (const F32*)a, (N), count, 1); \
+} \
+function V sum_##V##_array(const V* a, U64 count) { \
+    V result; \
+    const VectorKernels* kernels = vector_kernels_get(); \
+    kernels->sum(result.v, (const F32*)a, count * (N), (N)); \
+    return result; \
+} \
+function V min_##V##_array(const V* a, U64 count) { \
+    V result; \
+    const VectorKernels* kernels = vector_kernels_get(); \
+    kernels->min(result.v, (const F32*)a, count * (N), (N)); \
+    return result; \
+} \
+function V max_##V##_array(const V* a, U64 count) { \
+    V result; \
+    const VectorKernels* kernels = vector_kernels_get(); \
+    kernels->max(result.v, (const F32*)a, count * (N), (N)); \
+    return result; \
+} \
+function void dot_##V##_soa(F32* out, V##SoA a, V b, U64 count) { \
+    const VectorKernels* kernels = vector_kernels_get(); \
+    kernels->dot_soa(out, (const F32* const*)a.v, b.v, (N), count); \
+} \
+function void normalize_##V##_soa(V##SoA out, V##SoA a, U64 count) { \
+    const VectorKernels* kernels = vector_kernels_get(); \
+    kernels->normalize_soa(out.v, (const F32* const*)a.v, (N), count, 0); \
+} \
+function void normalize_fast_##V##_soa(V##SoA out, V##SoA a, U64 count) { \
+    const VectorKernels* kernels = vector_kernels_get(); \
+    kernels->normalize_soa(out.v, (const F32* const*)a.v, (N), count, 1); \
+} \
+function V sum_##V##_soa(V##SoA a, U64 count) { \
+    V result; \
+    for (U32 k = 0; k < (N); k++) { \
+        result.v[k] = sum_F32_array(a.v[k], count); \
+    } \
+    return result; \
+} \
+function V min_##V##_soa(V##SoA a, U64 count) { \
+    V result; \
+    for (U32 k = 0; k < (N); k++) { \
+        result.v[k] = min_F32_array(a.v[k], count); \
+    } \
+    return result; \
+} \
+function V max_##V##_soa(V##SoA a, U64 count) { \
+    V result; \
+    for (U32 k = 0; k < (N); k++) { \
+        result.v[k] = max_F32_array(a.v[k], count); \
+    } \
+    return result; \
+}
+
+VECTOR_ARRAY_DEFINE(V2F32, 2)
+VECTOR_ARRAY_DEFINE(V3F32, 3)
+VECTOR_ARRAY_DEFINE(V4F32, 4)
+
+VECTOR_REDUCE_DEFINE(V2F32, 2)
+VECTOR_REDUCE_DEFINE(V3F32, 3)
+VECTOR_REDUCE_DEFINE(V4F32, 4)
+
+// NOTE(ryl1k): An M3F32 runs through the point kernels as an affine
+// M4F32 with zero translation.
+function void transform_V3F32_array(V3F32* out, const V3F32* a, const M3F32* m, U64 count, StoreHint hint) {
+    M4F32 affine = m4f32_from_m3f32(m);
+    transform_points_V3F32_array(out, a, &affine, count, hint);
+}
+
+function void transform_points_V3F32_array(V3F32* out, const V3F32* a, const M4F32* m, U64 count, StoreHint hint) {
+    const VectorKernels* kernels = vector_kernels_get();
+    kernels->transform_aos((F32*)out, (const F32*)a, m->v, 3, count, hint == StoreHint_Streaming);
+}
+
+function void transform_V4F32_array(V4F32* out, const V4F32* a, const M4F32* m, U64 count, StoreHint hint) {
+    const VectorKernels* kernels = vector_kernels_get();
+    kernels->transform_aos((F32*)out, (const F32*)a, m->v, 4, count, hint == StoreHint_Streaming);
+}
+
+function void transform_V3F32_soa(V3F32SoA out, V3F32SoA a, const M3F32* m, U64 count, StoreHint hint) {
+    M4F32 affine = m4f32_from_m3f32(m);
+    transform_points_V3F32_soa(out, a, &affine, count, hint);
+}
+
+function void transform_points_V3F32_soa(V3F32SoA out, V3F32SoA a, const M4F32* m, U64 count, StoreHint hint) {
+    const VectorKernels* kernels = vector_kernels_get();
+    kernels->transform_soa(out.v, (const F32* const*)a.v, m->v, 3, count, hint == StoreHint_Streaming);
+}
+
+function void transform_V4F32_soa(V4F32SoA out, V4F32SoA a, const M4F32* m, U64 count, StoreHint hint) {
+    const VectorKernels* kernels = vector_kernels_get();
+    kernels->transform_soa(out.v, (const F32* const*)a.v, m->v, 4, count, hint == StoreHint_Streaming);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Vector Math Functions
+
+// NOTE(ryl1k): Each function reduces the argument with constants split so
+// that n * C1 (and n * C2) is exact for every n in the fast domain, then
+// evaluates a Taylor polynomial on the reduced range; the tiers only differ
+// in the number of terms. exp saturates to 0 and inf in-lane; other lanes
+// outside the fast domain (huge sin/cos arguments, subnormal exp results,
+// log of subnormals, zero, negatives, inf and nan) are recomputed with libm,
+// so special cases match it exactly.
+//
+// Everything is written against a small set of per-ISA operations named
+// P##_OP; the scalar level just loops over libm.
+
+#define MATH_F32_MANTISSA_BITS   23
+#define MATH_F32_MANTISSA_MASK   0x007FFFFFu
+#define MATH_F32_ONE_BITS        0x3F800000u
+#define MATH_F32_ROUND_MAGIC     12582912.0f      // 1.5 * 2^23
+#define MATH_F32_EXP_MAGIC       8388735.0f       // 2^23 + 127
+#define MATH_F32_EXPONENT_MAGIC  8388608.0f       // 2^23
+#define MATH_F32_PIO2_C1         1.57080078125f
+#define MATH_F32_PIO2_C2         -4.453584551811218e-06f
+#define MATH_F32_PIO2_C3         -8.705515752716053e-10f
+#define MATH_F32_LN2_C1          0.693115234375f
+#define MATH_F32_LN2_C2          3.1946183e-05f
+#define MATH_F32_EXPONENT_BIAS   127.0f
+#define MATH_F32_TRIG_LIMIT      4096.0f
+#define MATH_F32_EXP_MIN         -87.0f
+#define MATH_F32_EXP_MAX         88.0f
+#define MATH_F32_EXP_UNDERFLOW   -104.0f
+#define MATH_F32_EXP_OVERFLOW    89.0f
+#define MATH_F32_LOG_MIN         1.17549435e-38f
+#define MATH_F32_LOG_MAX         3.40282347e+38f
+
+#define MATH_F64_MANTISSA_BITS   52
+#define MATH_F64_MANTISSA_MASK   0x000FFFFFFFFFFFFFllu
+#define MATH_F64_ONE_BITS        0x3FF0000000000000llu
+#define MATH_F64_ROUND_MAGIC     6755399441055744.0        // 1.5 * 2^52
+#define MATH_F64_EXP_MAGIC       4503599627371519.0        // 2^52 + 1023
+#define MATH_F64_EXPONENT_MAGIC  4503599627370496.0        // 2^52
+#define MATH_F64_PIO2_C1         1.5707963267341256
+#define MATH_F64_PIO2_C2         6.077100506303966e-11
+#define MATH_F64_PIO2_C3         2.0222662487959506e-21
+#define MATH_F64_LN2_C1          0.6931471806019545
+#define MATH_F64_LN2_C2          -4.2009150726810846e-11
+#define MATH_F64_EXPONENT_BIAS   1023.0
+#define MATH_F64_TRIG_LIMIT      1.0e6
+#define MATH_F64_EXP_MIN         -708.0
+#define MATH_F64_EXP_MAX         709.0
+#define MATH_F64_EXP_UNDERFLOW   -746.0
+#define MATH_F64_EXP_OVERFLOW    710.0
+#define MATH_F64_LOG_MIN         2.2250738585072014e-308
+#define MATH_F64_LOG_MAX         1.7976931348623157e+308
+
+#define MATH_TERMS_MAX 12
+
+// NOTE(ryl1k): sin(r) = r + r*z*P(z), cos(r) = 1 + z*Q(z), exp(r) =
+// 1 + r + r^2*E(r), log(m) = 2s + 2s*z*L(z) with s = (m-1)/(m+1), z = r^2
+// or s^2. Term counts are {full, fast}.
+#define MATH_COEFFICIENTS_DEFINE(T) \
+global const T math_sin_coefficients_##T[MATH_TERMS_MAX] = { \
+    (T)(-1.0 / 6.0), (T)(1.0 / 120.0), (T)(-1.0 / 5040.0), (T)(1.0 / 362880.0), (T)(-1.0 / 39916800.0), \
+    (T)(1.0 / 6227020800.0), (T)(-1.0 / 1307674368000.0), (T)(1.0 / 355687428096000.0) }; \
+global const T math_cos_coefficients_##T[MATH_TERMS_MAX] = { \
+    (T)(-1.0 / 2.0), (T)(1.0 / 24.0), (T)(-1.0 / 720.0), (T)(1.0 / 40320.0), (T)(-1.0 / 3628800.0), \
+    (T)(1.0 / 479001600.0), (T)(-1.0 / 87178291200.0), (T)(1.0 / 20922789888000.0) }; \
+global const T math_exp_coefficients_##T[MATH_TERMS_MAX] = { \
+    (T)(1.0 / 2.0), (T)(1.0 / 6.0), (T)(1.0 / 24.0), (T)(1.0 / 120.0), (T)(1.0 / 720.0), (T)(1.0 / 5040.0), \
+    (T)(1.0 / 40320.0), (T)(1.0 / 362880.0), (T)(1.0 / 3628800.0), (T)(1.0 / 39916800.0), \
+    (T)(1.0 / 479001600.0), (T)(1.0 / 6227020800.0) }; \
+global const T math_log_coefficients_##T[MATH_TERMS_MAX] = { \
+    (T)(1.0 / 3.0), (T)(1.0 / 5.0), (T)(1.0 / 7.0), (T)(1.0 / 9.0), (T)(1.0 / 11.0), (T)(1.0 / 13.0), \
+    (T)(1.0 / 15.0), (T)(1.0 / 17.0), (T)(1.0 / 19.0), (T)(1.0 / 21.0), (T)(1.0 / 23.0), (T)(1.0 / 25.0) };
+
+MATH_COEFFICIENTS_DEFINE(F32)
+MATH_COEFFICIENTS_DEFINE(F64)
+
+global const U32 math_sin_terms_F32[MathAccuracy_Count] = { 4, 3 };
+global const U32 math_cos_terms_F32[MathAccuracy_Count] = { 5, 4 };
+global const U32 math_exp_terms_F32[MathAccuracy_Count] = { 6, 4 };
+global const U32 math_log_terms_F32[MathAccuracy_Count] = { 4, 3 };
+global const U32 math_sin_terms_F64[MathAccuracy_Count] = { 8, 5 };
+global const U32 math_cos_terms_F64[MathAccuracy_Count] = { 8, 5 };
+global const U32 math_exp_terms_F64[MathAccuracy_Count] = { 12, 7 };
+global const U32 math_log_terms_F64[MathAccuracy_Count] = { 10, 5 };
+
+function F32 math_bits_F32(U32 bits) {
+    union { F32 f; U32 u; } r;
+    r.u = bits;
+    return r.f;
+}
+
+function F64 math_bits_F64(U64 bits) {
+    union { F64 f; U64 u; } r;
+    r.u = bits;
+    return r.f;
+}
+
+// NOTE(ryl1k): Lane kernels. ROUND adds and subtracts 1.5 * 2^mantissa,
+// which rounds to nearest for |v| < 2^(mantissa-1). The sin/cos quadrant
+// q = j mod 4 is recovered in floating point: floor(j/4) is
+// round(j/4 - 0.375) for integer j. Zero lanes pass x through so that
+// sin(-0) stays -0.
+#define MATH_LANE_KERNELS_DEFINE(P, T, suffix) \
+P##_TARGET function P##_VT math_round_##T##_##suffix(P##_VT v) { \
+    P##_VT magic = P##_SET1(MATH_##T##_ROUND_MAGIC); \
+    return P##_SUB(P##_ADD(v, magic), magic); \
+} \
+P##_TARGET function P##_VT math_select_##T##_##suffix(P##_VT mask, P##_VT a, P##_VT b) { \
+    return P##_OR(P##_AND(mask, a), P##_ANDNOT(mask, b)); \
+} \
+P##_TARGET function P##_VT math_poly_##T##_##suffix(P##_VT z, const T* coefficients, U32 terms) { \
+    P##_VT p = P##_SET1(coefficients[terms - 1]); \
+    for (U32 k = terms - 1; k > 0; k--) { \
+        p = P##_FMADD(p, z, P##_SET1(coefficients[k - 1])); \
+    } \
+    return p; \
+} \
+P##_TARGET function void math_sincos_##T##_##suffix(P##_VT x, P##_VT* out_sin, P##_VT* out_cos, U32 sin_terms, U32 cos_terms) { \
+    P##_VT one = P##_SET1((T)1); \
+    P##_VT j = math_round_##T##_##suffix(P##_MUL(x, P##_SET1((T)0.63661977236758134308))); \
+    P##_VT r = P##_FMADD(j, P##_SET1(-MATH_##T##_PIO2_C1), x); \
+    r = P##_FMADD(j, P##_SET1(-MATH_##T##_PIO2_C2), r); \
+    r = P##_FMADD(j, P##_SET1(-MATH_##T##_PIO2_C3), r); \
+    P##_VT z = P##_MUL(r, r); \
+    P##_VT sign = P##_SET1((T)-0.0); \
+    P##_VT sin_r = P##_FMADD(P##_MUL(r, z), math_poly_##T##_##suffix(z, math_sin_coefficients_##T, sin_terms), r); \
+    P##_VT cos_r = P##_FMADD(z, math_poly_##T##_##suffix(z, math_cos_coefficients_##T, cos_terms), one); \
+    P##_VT j4 = math_round_##T##_##suffix(P##_SUB(P##_MUL(j, P##_SET1((T)0.25)), P##_SET1((T)0.375))); \
+    P##_VT q = P##_FMADD(j4, P##_SET1((T)-4), j); \
+    P##_VT q_is_1 = P##_EQ(q, one); \
+    P##_VT q_is_2 = P##_EQ(q, P##_SET1((T)2)); \
+    P##_VT odd = P##_OR(q_is_1, P##_EQ(q, P##_SET1((T)3))); \
+    P##_VT sin_negative = P##_LE(P##_SET1((T)2), q); \
+    P##_VT cos_negative = P##_OR(q_is_1, q_is_2); \
+    *out_sin = P##_XOR(math_select_##T##_##suffix(odd, cos_r, sin_r), P##_AND(sin_negative, sign)); \
+    *out_sin = math_select_##T##_##suffix(P##_EQ(x, P##_SET1((T)0)), x, *out_sin); \
+    *out_cos = P##_XOR(math_select_##T##_##suffix(odd, sin_r, cos_r), P##_AND(cos_negative, sign)); \
+} \
+P##_TARGET function P##_VT math_exp_##T##_##suffix(P##_VT x, U32 terms) { \
+    P##_VT n = math_round_##T##_##suffix(P##_MUL(x, P##_SET1((T)1.44269504088896340736))); \
+    P##_VT r = P##_FMADD(n, P##_SET1(-MATH_##T##_LN2_C1), x); \
+    r = P##_FMADD(n, P##_SET1(-MATH_##T##_LN2_C2), r); \
+    P##_VT p = math_poly_##T##_##suffix(r, math_exp_coefficients_##T, terms); \
+    P##_VT y = P##_ADD(P##_SET1((T)1), P##_FMADD(P##_MUL(r, r), p, r)); \
+    P##_VT scale = P##_SHL(P##_ADD(n, P##_SET1(MATH_##T##_EXP_MAGIC)), MATH_##T##_MANTISSA_BITS); \
+    return P##_MUL(y, scale); \
+} \
+P##_TARGET function P##_VT math_log_##T##_##suffix(P##_VT x, U32 terms) { \
+    P##_VT one = P##_SET1((T)1); \
+    P##_VT exponent_magic = P##_SET1(MATH_##T##_EXPONENT_MAGIC); \
+    P##_VT e = P##_OR(P##_SHR(x, MATH_##T##_MANTISSA_BITS), exponent_magic); \
+    e = P##_SUB(e, P##_SET1(MATH_##T##_EXPONENT_MAGIC + MATH_##T##_EXPONENT_BIAS)); \
+    P##_VT m = P##_OR(P##_AND(x, P##_SET1(math_bits_##T(MATH_##T##_MANTISSA_MASK))), P##_SET1(math_bits_##T(MATH_##T##_ONE_BITS))); \
+    P##_VT big = P##_LT(P##_SET1((T)1.41421356237309504880), m); \
+    m = math_select_##T##_##suffix(big, P##_MUL(m, P##_SET1((T)0.5)), m); \
+    e = P##_ADD(e, P##_AND(big, one)); \
+    P##_VT s = P##_DIV(P##_SUB(m, one), P##_ADD(m, one)); \
+    P##_VT z = P##_MUL(s, s); \
+    P##_VT two_s = P##_ADD(s, s); \
+    P##_VT log_m = P##_FMADD(P##_MUL(two_s, z), math_poly_##T##_##suffix(z, math_log_coefficients_##T, terms), two_s); \
+    return P##_FMADD(e, P##_SET1(MATH_##T##_LN2_C1), P##_FMADD(e, P##_SET1(MATH_##T##_LN2_C2), log_m)); \
+}
+
+// NOTE(ryl1k): Array drivers. Full chunks load and store in place; the
+// tail goes through a padded buffer so it runs the same kernel, and a chunk
+// with out-of-domain lanes is copied first so out may alias x.
+#define MATH_LOAD_CHUNK(P, T) \
+    U64 n = Min((U64)P##_W, count - i); \
+    T in[P##_W]; \
+    const T* src = x + i; \
+    if (n < P##_W) { \
+        for (U64 l = 0; l < P##_W; l++) { \
+            in[l] = (l < n) ? x[i + l] : (T)1; \
+        } \
+        src = in; \
+    } \
+    P##_VT v = P##_LOAD(src);
+
+#define MATH_FIX_CHUNK(P, T, all_ok) \
+    if (!(all_ok) && src != in) { \
+        for (U64 l = 0; l < P##_W; l++) { \
+            in[l] = src[l]; \
+        } \
+        src = in; \
+    }
+
+#define MATH_STORE_CHUNK(P, T, dst, result, all_ok, OK, libm) \
+    if (dst) { \
+        if ((all_ok) && n == P##_W) { \
+            P##_STORE(dst + i, result); \
+        } else { \
+            T lanes[P##_W]; \
+            P##_STORE(lanes, result); \
+            for (U64 l = 0; l < n; l++) { \
+                dst[i + l] = ((all_ok) || OK(src[l])) ? lanes[l] : libm(src[l]); \
+            } \
+        } \
+    }
+
+#define MATH_TRIG_OK(T, v)  (abs_##T(v) <= MATH_##T##_TRIG_LIMIT)
+#define MATH_EXP_OK(T, v)   (((v) >= MATH_##T##_EXP_MIN && (v) <= MATH_##T##_EXP_MAX) || \
+                             (v) < MATH_##T##_EXP_UNDERFLOW || (v) > MATH_##T##_EXP_OVERFLOW)
+#define MATH_LOG_OK(T, v)   ((v) >= MATH_##T##_LOG_MIN && (v) <= MATH_##T##_LOG_MAX)
+#define MATH_SQRT_OK(T, v)  MATH_LOG_OK(T, v)
+#define MATH_TRIG_OK_F32(v) MATH_TRIG_OK(F32, v)
+#define MATH_TRIG_OK_F64(v) MATH_TRIG_OK(F64, v)
+#define MATH_EXP_OK_F32(v)  MATH_EXP_OK(F32, v)
+#define MATH_EXP_OK_F64(v)  MATH_EXP_OK(F64, v)
+#define MATH_LOG_OK_F32(v)  MATH_LOG_OK(F32, v)
+#define MATH_LOG_OK_F64(v)  MATH_LOG_OK(F64, v)
+#define MATH_SQRT_OK_F32(v) MATH_SQRT_OK(F32, v)
+#define MATH_SQRT_OK_F64(v) MATH_SQRT_OK(F64, v)
+
+#define MATH_ARRAY_KERNELS_DEFINE(P, T, suffix, libm_sin, libm_cos, libm_exp, libm_log, libm_sqrt) \
+P##_TARGET function void sincos_##T##_array_##suffix(T* out_sin, T* out_cos, const T* x, U64 count, MathAccuracy accuracy) { \
+    U32 sin_terms = math_sin_terms_##T[accuracy]; \
+    U32 cos_terms = math_cos_terms_##T[accuracy]; \
+    for (U64 i = 0; i < count; i += P##_W) { \
+        MATH_LOAD_CHUNK(P, T) \
+        P##_VT s; \
+        P##_VT c; \
+        math_sincos_##T##_##suffix(v, &s, &c, sin_terms, cos_terms); \
+        B32 all_ok = P##_ALL(P##_LE(P##_ANDNOT(P##_SET1((T)-0.0), v), P##_SET1(MATH_##T##_TRIG_LIMIT))); \
+        MATH_FIX_CHUNK(P, T, all_ok) \
+        MATH_STORE_CHUNK(P, T, out_sin, s, all_ok, MATH_TRIG_OK_##T, libm_sin) \
+        MATH_STORE_CHUNK(P, T, out_cos, c, all_ok, MATH_TRIG_OK_##T, libm_cos) \
+    } \
+} \
+P##_TARGET function void exp_##T##_array_##suffix(T* out, const T* x, U64 count, MathAccuracy accuracy) { \
+    U32 terms = math_exp_terms_##T[accuracy]; \
+    P##_VT lo = P##_SET1(MATH_##T##_EXP_MIN); \
+    P##_VT hi = P##_SET1(MATH_##T##_EXP_MAX); \
+    P##_VT underflow = P##_SET1(MATH_##T##_EXP_UNDERFLOW); \
+    P##_VT overflow = P##_SET1(MATH_##T##_EXP_OVERFLOW); \
+    P##_VT infinity = P##_SET1((T)INFINITY); \
+    for (U64 i = 0; i < count; i += P##_W) { \
+        MATH_LOAD_CHUNK(P, T) \
+        P##_VT in_range = P##_AND(P##_LE(lo, v), P##_LE(v, hi)); \
+        P##_VT is_zero = P##_LT(v, underflow); \
+        P##_VT is_infinity = P##_LT(overflow, v); \
+        P##_VT result = math_exp_##T##_##suffix(math_select_##T##_##suffix(in_range, v, P##_SET1((T)0)), terms); \
+        result = P##_ANDNOT(is_zero, math_select_##T##_##suffix(is_infinity, infinity, result)); \
+        B32 all_ok = P##_ALL(P##_OR(in_range, P##_OR(is_zero, is_infinity))); \
+        MATH_FIX_CHUNK(P, T, all_ok) \
+        MATH_STORE_CHUNK(P, T, out, result, all_ok, MATH_EXP_OK_##T, libm_exp) \
+    } \
+} \
+P##_TARGET function void log_##T##_array_##suffix(T* out, const T* x, U64 count, MathAccuracy accuracy) { \
+    U32 terms = math_log_terms_##T[accuracy]; \
+    P##_VT lo = P##_SET1(MATH_##T##_LOG_MIN); \
+    P##_VT hi = P##_SET1(MATH_##T##_LOG_MAX); \
+    for (U64 i = 0; i < count; i += P##_W) { \
+        MATH_LOAD_CHUNK(P, T) \
+        P##_VT result = math_log_##T##_##suffix(v, terms); \
+        B32 all_ok = P##_ALL(P##_AND(P##_LE(lo, v), P##_LE(v, hi))); \
+        MATH_FIX_CHUNK(P, T, all_ok) \
+        MATH_STORE_CHUNK(P, T, out, result, all_ok, MATH_LOG_OK_##T, libm_log) \
+    } \
+} \
+P##_TARGET function void sqrt_##T##_array_##suffix(T* out, const T* x, U64 count, MathAccuracy accuracy) { \
+    B32 fast = (accuracy == MathAccuracy_Fast) && P##_HAS_RSQRT; \
+    P##_VT lo = P##_SET1(MATH_##T##_LOG_MIN); \
+    P##_VT hi = P##_SET1(MATH_##T##_LOG_MAX); \
+    for (U64 i = 0; i < count; i += P##_W) { \
+        MATH_LOAD_CHUNK(P, T) \
+        P##_VT result; \
+        B32 all_ok = 1; \
+        if (fast) { \
+            result = P##_MUL(v, P##_RSQRT(v)); \
+            all_ok = P##_ALL(P##_AND(P##_LE(lo, v), P##_LE(v, hi))); \
+        } else { \
+            result = P##_SQRT(v); \
+        } \
+        MATH_FIX_CHUNK(P, T, all_ok) \
+        MATH_STORE_CHUNK(P, T, out, result, all_ok, MATH_SQRT_OK_##T, libm_sqrt) \
+    } \
+}
+
+#define MATH_KERNELS_DEFINE(P32, P64, suffix) \
+MATH_LANE_KERNELS_DEFINE(P32, F32, suffix) \
+MATH_LANE_KERNELS_DEFINE(P64, F64, suffix) \
+MATH_ARRAY_KERNELS_DEFINE(P32, F32, suffix, sinf, cosf, expf, logf, sqrtf) \
+MATH_ARRAY_KERNELS_DEFINE(P64, F64, suffix, sin, cos, exp, log, sqrt)
+
+// NOTE(ryl1k): Scalar level: plain libm for both tiers.
+#define MATH_SCALAR_DEFINE(T, libm_sin, libm_cos, libm_exp, libm_log, libm_sqrt) \
+function void sincos_##T##_array_scalar(T* out_sin, T* out_cos, const T* x, U64 count, MathAccuracy accuracy) { \
+    (void)accuracy; \
+    for (U64 i = 0; i < count; i++) { \
+        T v = x[i]; \
+        if (out_sin) { \
+            out_sin[i] = libm_sin(v); \
+        } \
+        if (out_cos) { \
+            out_cos[i] = libm_cos(v); \
+        } \
+    } \
+} \
+function void exp_##T##_array_scalar(T* out, const T* x, U64 count, MathAccuracy accuracy) { \
+    (void)accuracy; \
+    for (U64 i = 0; i < count; i++) { \
+        out[i] = libm_exp(x[i]); \
+    } \
+} \
+function void log_##T##_array_scalar(T* out, const T* x, U64 count, MathAccuracy accuracy) { \
+    (void)accuracy; \
+    for (U64 i = 0; i < count; i++) { \
+        out[i] = libm_log(x[i]); \
+    } \
+} \
+function void sqrt_##T##_array_scalar(T* out, const T* x, U64 count, MathAccuracy accuracy) { \
+    (void)accuracy; \
+    for (U64 i = 0; i < count; i++) { \
+        out[i] = libm_sqrt(x[i]); \
+    } \
+}
+
+MATH_SCALAR_DEFINE(F32, sinf, cosf, expf, logf, sqrtf)
+MATH_SCALAR_DEFINE(F64, sin, cos, exp, log, sqrt)
+
+#if defined(CPU_X86)
+#define SSE2_F32_TARGET
+#define SSE2_F32_VT             __m128
+#define SSE2_F32_W              4
+#define SSE2_F32_LOAD           _mm_loadu_ps
+#define SSE2_F32_STORE          _mm_storeu_ps
+#define SSE2_F32_SET1           _mm_set1_ps
+#define SSE2_F32_ADD            _mm_add_ps
+#define SSE2_F32_SUB            _mm_sub_ps
+#define SSE2_F32_MUL            _mm_mul_ps
+#define SSE2_F32_DIV            _mm_div_ps
+#define SSE2_F32_SQRT           _mm_sqrt_ps
+#define SSE2_F32_FMADD          SSE2_FMADD
+#define SSE2_F32_AND            _mm_and_ps
+#define SSE2_F32_OR             _mm_or_ps
+#define SSE2_F32_XOR            _mm_xor_ps
+#define SSE2_F32_ANDNOT         _mm_andnot_ps
+#define SSE2_F32_EQ             _mm_cmpeq_ps
+#define SSE2_F32_LE             _mm_cmple_ps
+#define SSE2_F32_LT             _mm_cmplt_ps
+#define SSE2_F32_ALL(m)         (_mm_movemask_ps(m) == 0xF)
+#define SSE2_F32_SHL(v, n)      _mm_castsi128_ps(_mm_slli_epi32(_mm_castps_si128(v), n))
+#define SSE2_F32_SHR(v, n)      _mm_castsi128_ps(_mm_srli_epi32(_mm_castps_si128(v), n))
+#define SSE2_F32_HAS_RSQRT      1
+#define SSE2_F32_RSQRT          rsqrt_sse2
+
+#define SSE2_F64_TARGET
+#define SSE2_F64_VT             __m128d
+#define SSE2_F64_W              2
+#define SSE2_F64_LOAD           _mm_loadu_pd
+#define SSE2_F64_STORE          _mm_storeu_pd
+#define SSE2_F64_SET1           _mm_set1_pd
+#define SSE2_F64_ADD            _mm_add_pd
+#define SSE2_F64_SUB            _mm_sub_pd
+#define SSE2_F64_MUL            _mm_mul_pd
+#define SSE2_F64_DIV            _mm_div_pd
+#define SSE2_F64_SQRT           _mm_sqrt_pd
+#define SSE2_F64_FMADD(a, b, c) _mm_add_pd(_mm_mul_pd(a, b), c)
+#define SSE2_F64_AND            _mm_and_pd
+#define SSE2_F64_OR             _mm_or_pd
+#define SSE2_F64_XOR            _mm_xor_pd
+#define SSE2_F64_ANDNOT         _mm_andnot_pd
+#define SSE2_F64_EQ             _mm_cmpeq_pd
+#define SSE2_F64_LE             _mm_cmple_pd
+#define SSE2_F64_LT             _mm_cmplt_pd
+#define SSE2_F64_ALL(m)         (_mm_movemask_pd(m) == 0x3)
+#define SSE2_F64_SHL(v, n)      _mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128(v), n))
+#define SSE2_F64_SHR(v, n)      _mm_castsi128_pd(_mm_srli_epi64(_mm_castpd_si128(v), n))
+#define SSE2_F64_HAS_RSQRT      0
+#define SSE2_F64_RSQRT          _mm_sqrt_pd
+
+#define AVX2_F32_TARGET         TARGET_AVX2
+#define AVX2_F32_VT             __m256
+#define AVX2_F32_W              8
+#define AVX2_F32_LOAD           _mm256_loadu_ps
+#define AVX2_F32_STORE          _mm256_storeu_ps
+#define AVX2_F32_SET1           _mm256_set1_ps
+#define AVX2_F32_ADD            _mm256_add_ps
+#define AVX2_F32_SUB            _mm256_sub_ps
+#define AVX2_F32_MUL            _mm256_mul_ps
+#define AVX2_F32_DIV            _mm256_div_ps
+#define AVX2_F32_SQRT           _mm256_sqrt_ps
+#define AVX2_F32_FMADD          _mm256_fmadd_ps
+#define AVX2_F32_AND            _mm256_and_ps
+#define AVX2_F32_OR             _mm256_or_ps
+#define AVX2_F32_XOR            _mm256_xor_ps
+#define AVX2_F32_ANDNOT         _mm256_andnot_ps
+#define AVX2_F32_EQ(a, b)       _mm256_cmp_ps(a, b, _CMP_EQ_OQ)
+#define AVX2_F32_LE(a, b)       _mm256_cmp_ps(a, b, _CMP_LE_OQ)
+#define AVX2_F32_LT(a, b)       _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define AVX2_F32_ALL(m)         (_mm256_movemask_ps(m) == 0xFF)
+#define AVX2_F32_SHL(v, n)      _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_castps_si256(v), n))
+#define AVX2_F32_SHR(v, n)      _mm256_castsi256_ps(_mm256_srli_epi32(_mm256_castps_si256(v), n))
+#define AVX2_F32_HAS_RSQRT      1
+#define AVX2_F32_RSQRT          rsqrt_avx2
+
+#define AVX2_F64_TARGET         TARGET_AVX2
+#define AVX2_F64_VT             __m256d
+#define AVX2_F64_W              4
+#define AVX2_F64_LOAD           _mm256_loadu_pd
+#define AVX2_F64_STORE          _mm256_storeu_pd
+#define AVX2_F64_SET1           _mm256_set1_pd
+#define AVX2_F64_ADD            _mm256_add_pd
+#define AVX2_F64_SUB            _mm256_sub_pd
+#define AVX2_F64_MUL            _mm256_mul_pd
+#define AVX2_F64_DIV            _mm256_div_pd
+#define AVX2_F64_SQRT           _mm256_sqrt_pd
+#define AVX2_F64_FMADD          _mm256_fmadd_pd
+#define AVX2_F64_AND            _mm256_and_pd
+#define AVX2_F64_OR             _mm256_or_pd
+#define AVX2_F64_XOR            _mm256_xor_pd
+#define AVX2_F64_ANDNOT         _mm256_andnot_pd
+#define AVX2_F64_EQ(a, b)       _mm256_cmp_pd(a, b, _CMP_EQ_OQ)
+#define AVX2_F64_LE(a, b)       _mm256_cmp_pd(a, b, _CMP_LE_OQ)
+#define AVX2_F64_LT(a, b)       _mm256_cmp_pd(a, b, _CMP_LT_OQ)
+#define AVX2_F64_ALL(m)         (_mm256_movemask_pd(m) == 0xF)
+#define AVX2_F64_SHL(v, n)      _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(v), n))
+#define AVX2_F64_SHR(v, n)      _mm256_castsi256_pd(_mm256_srli_epi64(_mm256_castpd_si256(v), n))
+#define AVX2_F64_HAS_RSQRT      0
+#define AVX2_F64_RSQRT          _mm256_sqrt_pd
+
+MATH_KERNELS_DEFINE(SSE2_F32, SSE2_F64, sse2)
+MATH_KERNELS_DEFINE(AVX2_F32, AVX2_F64, avx2)
+#elif defined(CPU_ARM64)
+#define NEON_F32_TARGET
+#define NEON_F32_VT             float32x4_t
+#define NEON_F32_W              4
+#define NEON_F32_LOAD           vld1q_f32
+#define NEON_F32_STORE          vst1q_f32
+#define NEON_F32_SET1           vdupq_n_f32
+#define NEON_F32_ADD            vaddq_f32
+#define NEON_F32_SUB            vsubq_f32
+#define NEON_F32_MUL            vmulq_f32
+#define NEON_F32_DIV            vdivq_f32
+#define NEON_F32_SQRT           vsqrtq_f32
+#define NEON_F32_FMADD          NEON_FMADD
+#define NEON_F32_U(v)           vreinterpretq_u32_f32(v)
+#define NEON_F32_F(v)           vreinterpretq_f32_u32(v)
+#define NEON_F32_AND(a, b)      NEON_F32_F(vandq_u32(NEON_F32_U(a), NEON_F32_U(b)))
+#define NEON_F32_OR(a, b)       NEON_F32_F(vorrq_u32(NEON_F32_U(a), NEON_F32_U(b)))
+#define NEON_F32_XOR(a, b)      NEON_F32_F(veorq_u32(NEON_F32_U(a), NEON_F32_U(b)))
+#define NEON_F32_ANDNOT(a, b)   NEON_F32_F(vbicq_u32(NEON_F32_U(b), NEON_F32_U(a)))
+#define NEON_F32_EQ(a, b)       NEON_F32_F(vceqq_f32(a, b))
+#define NEON_F32_LE(a, b)       NEON_F32_F(vcleq_f32(a, b))
+#define NEON_F32_LT(a, b)       NEON_F32_F(vcltq_f32(a, b))
+#define NEON_F32_ALL(m)         (vminvq_u32(NEON_F32_U(m)) != 0)
+#define NEON_F32_SHL(v, n)      NEON_F32_F(vshlq_n_u32(NEON_F32_U(v), n))
+#define NEON_F32_SHR(v, n)      NEON_F32_F(vshrq_n_u32(NEON_F32_U(v), n))
+#define NEON_F32_HAS_RSQRT      1
+#define NEON_F32_RSQRT          rsqrt_neon
+
+#define NEON_F64_TARGET
+#define NEON_F64_VT             float64x2_t
+#define NEON_F64_W              2
+#define NEON_F64_LOAD           vld1q_f64
+#define NEON_F64_STORE          vst1q_f64
+#define NEON_F64_SET1           vdupq_n_f64
+#define NEON_F64_ADD            vaddq_f64
+#define NEON_F64_SUB            vsubq_f64
+#define NEON_F64_MUL            vmulq_f64
+#define NEON_F64_DIV            vdivq_f64
+#define NEON_F64_SQRT           vsqrtq_f64
+#define NEON_F64_FMADD(a, b, c) vfmaq_f64(c, a, b)
+#define NEON_F64_U(v)           vreinterpretq_u64_f64(v)
+#define NEON_F64_F(v)           vreinterpretq_f64_u64(v)
+#define NEON_F64_AND(a, b)      NEON_F64_F(vandq_u64(NEON_F64_U(a), NEON_F64_U(b)))
+#define NEON_F64_OR(a, b)       NEON_F64_F(vorrq_u64(NEON_F64_U(a), NEON_F64_U(b)))
+#define NEON_F64_XOR(a, b)      NEON_F64_F(veorq_u64(NEON_F64_U(a), NEON_F64_U(b)))
+#define NEON_F64_ANDNOT(a, b)   NEON_F64_F(vbicq_u64(NEON_F64_U(b), NEON_F64_U(a)))
+#define NEON_F64_EQ(a, b)       NEON_F64_F(vceqq_f64(a, b))
+#define NEON_F64_LE(a, b)       NEON_F64_F(vcleq_f64(a, b))
+#define NEON_F64_LT(a, b)       NEON_F64_F(vcltq_f64(a, b))
+#define NEON_F64_ALL(m)         (vminvq_u32(vreinterpretq_u32_f64(m)) != 0)
+#define NEON_F64_SHL(v, n)      NEON_F64_F(vshlq_n_u64(NEON_F64_U(v), n))
+#define NEON_F64_SHR(v, n)      NEON_F64_F(vshrq_n_u64(NEON_F64_U(v), n))
+#define NEON_F64_HAS_RSQRT      0
+#define NEON_F64_RSQRT          vsqrtq_f64
+
+MATH_KERNELS_DEFINE(NEON_F32, NEON_F64, neon)
+#endif
+
+typedef struct {
+    void (*sincos_F32)(F32*, F32*, const F32*, U64, MathAccuracy);
+    void (*exp_F32)(F32*, const F32*, U64, MathAccuracy);
+    void (*log_F32)(F32*, const F32*, U64, MathAccuracy);
+    void (*sqrt_F32)(F32*, const F32*, U64, MathAccuracy);
+    void (*sincos_F64)(F64*, F64*, const F64*, U64, MathAccuracy);
+    void (*exp_F64)(F64*, const F64*, U64, MathAccuracy);
+    void (*log_F64)(F64*, const F64*, U64, MathAccuracy);
+    void (*sqrt_F64)(F64*, const F64*, U64, MathAccuracy);
+} MathKernels;
+
+#define MATH_KERNELS(suffix) { \
+    sincos_F32_array_##suffix, exp_F32_array_##suffix, log_F32_array_##suffix, sqrt_F32_array_##suffix, \
+    sincos_F64_array_##suffix, exp_F64_array_##suffix, log_F64_array_##suffix, sqrt_F64_array_##suffix }
+
+global const MathKernels math_kernels_scalar = MATH_KERNELS(scalar);
+#if defined(CPU_X86)
+global const MathKernels math_kernels_sse2 = MATH_KERNELS(sse2);
+global const MathKernels math_kernels_avx2 = MATH_KERNELS(avx2);
+#elif defined(CPU_ARM64)
+global const MathKernels math_kernels_neon = MATH_KERNELS(neon);
+#endif
+
+// NOTE(ryl1k): Follows simd_select_level. The tables are constant, so
+// there is nothing to race on; the AVX-512 level uses the AVX2 kernels.
+function const MathKernels* math_kernels_get(void) {
+    switch (simd_current_level()) {
+#if defined(CPU_X86)
+        case SIMDLevel_SSE2: return &math_kernels_sse2;
+        case SIMDLevel_AVX2: return &math_kernels_avx2;
+        case SIMDLevel_AVX512: return &math_kernels_avx2;
+#elif defined(CPU_ARM64)
+        case SIMDLevel_NEON: return &math_kernels_neon;
+#endif
+        default: return &math_kernels_scalar;
+    }
+}
+
+function void sin_F32_array(F32* out, const F32* x, U64 count, MathAccuracy accuracy) {
+    math_kernels_get()->sincos_F32(out, NULL, x, count, accuracy);
+}
+
+function void cos_F32_array(F32* out, const F32* x, U64 count, MathAccuracy accuracy) {
+    math_kernels_get()->sincos_F32(NULL, out, x, count, accuracy);
+}
+
+function void sincos_F32_array(F32* out_sin, F32* out_cos, const F32* x, U64 count, MathAccuracy accuracy) {
+    math_kernels_get()->sincos_F32(out_sin, out_cos, x, count, accuracy);
+}
+
+function void exp_F32_array(F32* out, const F32* x, U64 count, MathAccuracy accuracy) {
+    math_kernels_get()->exp_F32(out, x, count, accuracy);
+}
+
+function void log_F32_array(F32* out, const F32* x, U64 count, MathAccuracy accuracy) {
+    math_kernels_get()->log_F32(out, x, count, accuracy);
+}
+
+function void sqrt_F32_array(F32* out, const F32* x, U64 count, MathAccuracy accuracy) {
+    math_kernels_get()->sqrt_F32(out, x, count, accuracy);
+}
+
+function void sin_F64_array(F64* out, const F64* x, U64 count, MathAccuracy accuracy) {
+    math_kernels_get()->sincos_F64(out, NULL, x, count, accuracy);
+}
+
+function void cos_F64_array(F64* out, const F64* x, U64 count, MathAccuracy accuracy) {
+    math_kernels_get()->sincos_F64(NULL, out, x, count, accuracy);
+}
+
+function void sincos_F64_array(F64* out_sin, F64* out_cos, const F64* x, U64 count, MathAccuracy accuracy) {
+    math_kernels_get()->sincos_F64(out_sin, out_cos, x, count, accuracy);
+}
+
+function void exp_F64_array(F64* out, const F64* x, U64 count, MathAccuracy accuracy) {
+    math_kernels_get()->exp_F64(out, x, count, accuracy);
+}
+
+function void log_F64_array(F64* out, const F64* x, U64 count, MathAccuracy accuracy) {
+    math_kernels_get()->log_F64(out, x, count, accuracy);
+}
+
+function void sqrt_F64_array(F64* out, const F64* x, U64 count, MathAccuracy accuracy) {
+    math_kernels_get()->sqrt_F64(out, x, count, accuracy);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Box Array Functions
+
+// NOTE(ryl1k): Mask kernels fill one U64 per 64 elements; TEST yields the
+// hit bits of W elements starting at i. Half-open compares only need
+// signed greater-than: lo <= x < hi is !(lo > x) && hi > x.
+#define BOX_MASK_LOOP(W, TEST, SCALAR_TEST) \
+    U64 hits = 0; \
+    U64 i = 0; \
+    for (U64 word = 0; i < count; word++) { \
+        U64 end = Min(i + 64, count); \
+        U64 bits = 0; \
+        U32 shift = 0; \
+        for (; i + (W) <= end; i += (W), shift += (W)) { \
+            bits |= (U64)(TEST) << shift; \
+        } \
+        for (; i < end; i++, shift++) { \
+            bits |= (U64)(SCALAR_TEST) << shift; \
+        } \
+        mask[word] = bits; \
+        hits += popcount_U64(bits); \
+    } \
+    return hits;
+
+#define BOX_OVERLAPS_SCALAR(bx0, by0, bx1, by1) (q.x0 < (bx1) && (bx0) < q.x1 && q.y0 < (by1) && (by0) < q.y1)
+#define BOX_CONTAINS_SCALAR(px, py)             (q.x0 <= (px) && (px) < q.x1 && q.y0 <= (py) && (py) < q.y1)
+
+function U64 box_overlaps_soa_scalar(U64* mask, const S32* const* b, I2S32 q, U64 count) {
+    BOX_MASK_LOOP(1, BOX_OVERLAPS_SCALAR(b[0][i], b[1][i], b[2][i], b[3][i]), 0)
+}
+
+function U64 box_overlaps_aos_scalar(U64* mask, const I2S32* b, I2S32 q, U64 count) {
+    BOX_MASK_LOOP(1, BOX_OVERLAPS_SCALAR(b[i].x0, b[i].y0, b[i].x1, b[i].y1), 0)
+}
+
+function U64 box_contains_soa_scalar(U64* mask, const S32* const* p, I2S32 q, U64 count) {
+    BOX_MASK_LOOP(1, BOX_CONTAINS_SCALAR(p[0][i], p[1][i]), 0)
+}
+
+function U64 box_contains_aos_scalar(U64* mask, const V2S32* p, I2S32 q, U64 count) {
+    BOX_MASK_LOOP(1, BOX_CONTAINS_SCALAR(p[i].x, p[i].y), 0)
+}
+
+// NOTE(ryl1k): clip, when given, replaces b with the same box everywhere.
+function void box_combine_soa_scalar(S32* const* out, const S32* const* a, const S32* const* b, const I2S32* clip, U64 count, B32 is_union) {
+    for (U64 i = 0; i < count; i++) {
+        I2S32 x, y;
+        x.x0 = a[0][i];
+        x.y0 = a[1][i];
+        x.x1 = a[2][i];
+        x.y1 = a[3][i];
+        if (clip) {
+            y = *clip;
+        } else {
+            y.x0 = b[0][i];
+            y.y0 = b[1][i];
+            y.x1 = b[2][i];
+            y.y1 = b[3][i];
+        }
+        I2S32 r = is_union ? I2S32_union(x, y) : I2S32_intersection(x, y);
+        out[0][i] = r.x0;
+        out[1][i] = r.y0;
+        out[2][i] = r.x1;
+        out[3][i] = r.y1;
+    }
+}
+
+function void box_combine_aos_scalar(I2S32* out, const I2S32* a, const I2S32* b, const I2S32* clip, U64 count, B32 is_union) {
+    for (U64 i = 0; i < count; i++) {
+        I2S32 y = clip ? *clip : b[i];
+        out[i] = is_union ? I2S32_union(a[i], y) : I2S32_intersection(a[i], y);
+    }
+}
+
+// NOTE(ryl1k): Pointers are copied to locals since the vector stores may
+// alias the pointer arrays, which would force a reload every iteration.
+#define BOX_COMBINE_SOA_DEFINE(suffix, TARGET, W, VT, LOAD, STORE, SET1, MIN, MAX) \
+TARGET function void box_combine_soa_##suffix(S32* const* out, const S32* const* a, const S32* const* b, const I2S32* clip, U64 count, B32 is_union) { \
+    const S32 *ax0 = a[0], *ay0 = a[1], *ax1 = a[2], *ay1 = a[3]; \
+    const S32 *bx0 = b[0], *by0 = b[1], *bx1 = b[2], *by1 = b[3]; \
+    S32 *ox0 = out[0], *oy0 = out[1], *ox1 = out[2], *oy1 = out[3]; \
+    VT cx0 = SET1(clip ? clip->x0 : 0), cy0 = SET1(clip ? clip->y0 : 0); \
+    VT cx1 = SET1(clip ? clip->x1 : 0), cy1 = SET1(clip ? clip->y1 : 0); \
+    U64 i = 0; \
+    for (; i + (W) <= count; i += (W)) { \
+        VT vx0 = LOAD(ax0 + i), vy0 = LOAD(ay0 + i), vx1 = LOAD(ax1 + i), vy1 = LOAD(ay1 + i); \
+        VT wx0 = clip ? cx0 : LOAD(bx0 + i), wy0 = clip ? cy0 : LOAD(by0 + i); \
+        VT wx1 = clip ? cx1 : LOAD(bx1 + i), wy1 = clip ? cy1 : LOAD(by1 + i); \
+        if (is_union) { \
+            STORE(ox0 + i, MIN(vx0, wx0)); \
+            STORE(oy0 + i, MIN(vy0, wy0)); \
+            STORE(ox1 + i, MAX(vx1, wx1)); \
+            STORE(oy1 + i, MAX(vy1, wy1)); \
+        } else { \
+            VT rx0 = MAX(vx0, wx0), ry0 = MAX(vy0, wy0); \
+            STORE(ox0 + i, rx0); \
+            STORE(oy0 + i, ry0); \
+            STORE(ox1 + i, MAX(MIN(vx1, wx1), rx0)); \
+            STORE(oy1 + i, MAX(MIN(vy1, wy1), ry0)); \
+        } \
+    } \
+    const S32* a_tail[4] = { ax0 + i, ay0 + i, ax1 + i, ay1 + i }; \
+    const S32* b_tail[4] = { bx0 + i, by0 + i, bx1 + i, by1 + i }; \
+    S32* out_tail[4] = { ox0 + i, oy0 + i, ox1 + i, oy1 + i }; \
+    box_combine_soa_scalar(out_tail, a_tail, b_tail, clip, count - i, is_union); \
+}
+
+#if defined(CPU_X86)
+#define SSE2_LOAD_S32(p) _mm_loadu_si128((const __m128i*)(p))
+
+function U32 box_overlaps_bits_sse2(__m128i x0, __m128i y0, __m128i x1, __m128i y1, const __m128i* q) {
+    __m128i x = _mm_and_si128(_mm_cmpgt_epi32(x1, q[0]), _mm_cmpgt_epi32(q[2], x0));
+    __m128i y = _mm_and_si128(_mm_cmpgt_epi32(y1, q[1]), _mm_cmpgt_epi32(q[3], y0));
+    return (U32)_mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(x, y)));
+}
+
+function U32 box_contains_bits_sse2(__m128i x, __m128i y, const __m128i* q) {
+    __m128i outside = _mm_or_si128(_mm_cmpgt_epi32(q[0], x), _mm_cmpgt_epi32(q[1], y));
+    __m128i inside = _mm_and_si128(_mm_cmpgt_epi32(q[2], x), _mm_cmpgt_epi32(q[3], y));
+    return (U32)_mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(outside, inside)));
+}
+
+// NOTE(ryl1k): Four I2S32 rows in, x0/y0/x1/y1 columns out.
+function void box_transpose_sse2(__m128i* r) {
+    __m128i t0 = _mm_unpacklo_epi32(r[0], r[1]);
+    __m128i t1 = _mm_unpacklo_epi32(r[2], r[3]);
+    __m128i t2 = _mm_unpackhi_epi32(r[0], r[1]);
+    __m128i t3 = _mm_unpackhi_epi32(r[2], r[3]);
+    r[0] = _mm_unpacklo_epi64(t0, t1);
+    r[1] = _mm_unpackhi_epi64(t0, t1);
+    r[2] = _mm_unpacklo_epi64(t2, t3);
+    r[3] = _mm_unpackhi_epi64(t2, t3);
+}
+
+function U32 box_overlaps_aos4_sse2(const I2S32* b, const __m128i* q) {
+    __m128i r[4] = { SSE2_LOAD_S32(b), SSE2_LOAD_S32(b + 1), SSE2_LOAD_S32(b + 2), SSE2_LOAD_S32(b + 3) };
+    box_transpose_sse2(r);
+    return box_overlaps_bits_sse2(r[0], r[1], r[2], r[3], q);
+}
+
+function U32 box_contains_aos4_sse2(const V2S32* p, const __m128i* q) {
+    __m128 lo = _mm_castsi128_ps(SSE2_LOAD_S32(p));
+    __m128 hi = _mm_castsi128_ps(SSE2_LOAD_S32(p + 2));
+    __m128i x = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+    __m128i y = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+    return box_contains_bits_sse2(x, y, q);
+}
+
+function U64 box_overlaps_soa_sse2(U64* mask, const S32* const* b, I2S32 q, U64 count) {
+    __m128i vq[4] = { _mm_set1_epi32(q.x0), _mm_set1_epi32(q.y0), _mm_set1_epi32(q.x1), _mm_set1_epi32(q.y1) };
+    BOX_MASK_LOOP(4, box_overlaps_bits_sse2(SSE2_LOAD_S32(b[0] + i), SSE2_LOAD_S32(b[1] + i), SSE2_LOAD_S32(b[2] + i), SSE2_LOAD_S32(b[3] + i), vq),
+                  BOX_OVERLAPS_SCALAR(b[0][i], b[1][i], b[2][i], b[3][i]))
+}
+
+function U64 box_overlaps_aos_sse2(U64* mask, const I2S32* b, I2S32 q, U64 count) {
+    __m128i vq[4] = { _mm_set1_epi32(q.x0), _mm_set1_epi32(q.y0), _mm_set1_epi32(q.x1), _mm_set1_epi32(q.y1) };
+    BOX_MASK_LOOP(4, box_overlaps_aos4_sse2(b + i, vq), BOX_OVERLAPS_SCALAR(b[i].x0, b[i].y0, b[i].x1, b[i].y1))
+}
+
+function U64 box_contains_soa_sse2(U64* mask, const S32* const* p, I2S32 q, U64 count) {
+    __m128i vq[4] = { _mm_set1_epi32(q.x0), _mm_set1_epi32(q.y0), _mm_set1_epi32(q.x1), _mm_set1_epi32(q.y1) };
+    BOX_MASK_LOOP(4, box_contains_bits_sse2(SSE2_LOAD_S32(p[0] + i), SSE2_LOAD_S32(p[1] + i), vq), BOX_CONTAINS_SCALAR(p[0][i], p[1][i]))
+}
+
+function U64 box_contains_aos_sse2(U64* mask, const V2S32* p, I2S32 q, U64 count) {
+    __m128i vq[4] = { _mm_set1_epi32(q.x0), _mm_set1_epi32(q.y0), _mm_set1_epi32(q.x1), _mm_set1_epi32(q.y1) };
+    BOX_MASK_LOOP(4, box_contains_aos4_sse2(p + i, vq), BOX_CONTAINS_SCALAR(p[i].x, p[i].y))
+}
+
+// NOTE(ryl1k): SSE2 has no 32-bit min/max (SSE4.1), so select on compare.
+function __m128i box_min_sse2(__m128i a, __m128i b) {
+    __m128i gt = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+}
+
+function __m128i box_max_sse2(__m128i a, __m128i b) {
+    __m128i gt = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+}
+
+#define SSE2_STORE_S32(p, v) _mm_storeu_si128((__m128i*)(p), v)
+BOX_COMBINE_SOA_DEFINE(sse2, , 4, __m128i, SSE2_LOAD_S32, SSE2_STORE_S32, _mm_set1_epi32, box_min_sse2, box_max_sse2)
+
+// NOTE(ryl1k): One box per register: [x0 y0] from one op and [x1 y1] from
+// the other, then intersections raise max to min by comparing against
+// [x0 y0 x0 y0].
+function void box_combine_aos_sse2(I2S32* out, const I2S32* a, const I2S32* b, const I2S32* clip, U64 count, B32 is_union) {
+    __m128i vclip = clip ? SSE2_LOAD_S32(clip) : _mm_setzero_si128();
+    for (U64 i = 0; i < count; i++) {
+        __m128i va = SSE2_LOAD_S32(a + i);
+        __m128i vb = clip ? vclip : SSE2_LOAD_S32(b + i);
+        __m128i lo = is_union ? box_min_sse2(va, vb) : box_max_sse2(va, vb);
+        __m128i hi = is_union ? box_max_sse2(va, vb) : box_min_sse2(va, vb);
+        __m128i r = _mm_castpd_si128(_mm_move_sd(_mm_castsi128_pd(hi), _mm_castsi128_pd(lo)));
+        if (!is_union) {
+            r = box_max_sse2(r, _mm_shuffle_epi32(r, _MM_SHUFFLE(1, 0, 1, 0)));
+        }
+        _mm_storeu_si128((__m128i*)(out + i), r);
+    }
+}
+
+#define AVX2_LOAD_S32(p) _mm256_loadu_si256((const __m256i*)(p))
+
+TARGET_AVX2 function U32 box_overlaps_bits_avx2(__m256i x0, __m256i y0, __m256i x1, __m256i y1, const __m256i* q) {
+    __m256i x = _mm256_and_si256(_mm256_cmpgt_epi32(x1, q[0]), _mm256_cmpgt_epi32(q[2], x0));
+    __m256i y = _mm256_and_si256(_mm256_cmpgt_epi32(y1, q[1]), _mm256_cmpgt_epi32(q[3], y0));
+    return (U32)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(x, y)));
+}
+
+TARGET_AVX2 function U32 box_contains_bits_avx2(__m256i x, __m256i y, const __m256i* q) {
+    __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(q[0], x), _mm256_cmpgt_epi32(q[1], y));
+    __m256i inside = _mm256_and_si256(_mm256_cmpgt_epi32(q[2], x), _mm256_cmpgt_epi32(q[3], y));
+    return (U32)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(outside, inside)));
+}
+
+// NOTE(ryl1k): Boxes 0-3 go to the low lanes and 4-7 to the high lanes, so
+// the in-lane transpose leaves the columns in order.
+TARGET_AVX2 function U32 box_overlaps_aos8_avx2(const I2S32* b, const __m256i* q) {
+    __m256i r[4];
+    for (U32 k = 0; k < 4; k++) {
+        r[k] = _mm256_inserti128_si256(_mm256_castsi128_si256(SSE2_LOAD_S32(b + k)), SSE2_LOAD_S32(b + 4 + k), 1);
+    }
+    __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    __m256i t1 = _mm256_unpacklo_epi32(r[2], r[3]);
+    __m256i t2 = _mm256_unpackhi_epi32(r[0], r[1]);
+    __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    return box_overlaps_bits_avx2(_mm256_unpacklo_epi64(t0, t1), _mm256_unpackhi_epi64(t0, t1),
+                                  _mm256_unpacklo_epi64(t2, t3), _mm256_unpackhi_epi64(t2, t3), q);
+}
+
+TARGET_AVX2 function U32 box_contains_aos8_avx2(const V2S32* p, const __m256i* q) {
+    __m256 lo = _mm256_castsi256_ps(AVX2_LOAD_S32(p));
+    __m256 hi = _mm256_castsi256_ps(AVX2_LOAD_S32(p + 4));
+    __m256i x = _mm256_permute4x64_epi64(_mm256_castps_si256(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0));
+    __m256i y = _mm256_permute4x64_epi64(_mm256_castps_si256(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0));
+    return box_contains_bits_avx2(x, y, q);
+}
+
+TARGET_AVX2 function U64 box_overlaps_soa_avx2(U64* mask, const S32* const* b, I2S32 q, U64 count) {
+    __m256i vq[4] = { _mm256_set1_epi32(q.x0), _mm256_set1_epi32(q.y0), _mm256_set1_epi32(q.x1), _mm256_set1_epi32(q.y1) };
+    BOX_MASK_LOOP(8, box_overlaps_bits_avx2(AVX2_LOAD_S32(b[0] + i), AVX2_LOAD_S32(b[1] + i), AVX2_LOAD_S32(b[2] + i), AVX2_LOAD_S32(b[3] + i), vq),
+                  BOX_OVERLAPS_SCALAR(b[0][i], b[1][i], b[2][i], b[3][i]))
+}
+
+TARGET_AVX2 function U64 box_overlaps_aos_avx2(U64* mask, const I2S32* b, I2S32 q, U64 count) {
+    __m256i vq[4] = { _mm256_set1_epi32(q.x0), _mm256_set1_epi32(q.y0), _mm256_set1_epi32(q.x1), _mm256_set1_epi32(q.y1) };
+    BOX_MASK_LOOP(8, box_overlaps_aos8_avx2(b + i, vq), BOX_OVERLAPS_SCALAR(b[i].x0, b[i].y0, b[i].x1, b[i].y1))
+}
+
+TARGET_AVX2 function U64 box_contains_soa_avx2(U64* mask, const S32* const* p, I2S32 q, U64 count) {
+    __m256i vq[4] = { _mm256_set1_epi32(q.x0), _mm256_set1_epi32(q.y0), _mm256_set1_epi32(q.x1), _mm256_set1_epi32(q.y1) };
+    BOX_MASK_LOOP(8, box_contains_bits_avx2(AVX2_LOAD_S32(p[0] + i), AVX2_LOAD_S32(p[1] + i), vq), BOX_CONTAINS_SCALAR(p[0][i], p[1][i]))
+}
+
+TARGET_AVX2 function U64 box_contains_aos_avx2(U64* mask, const V2S32* p, I2S32 q, U64 count) {
+    __m256i vq[4] = { _mm256_set1_epi32(q.x0), _mm256_set1_epi32(q.y0), _mm256_set1_epi32(q.x1), _mm256_set1_epi32(q.y1) };
+    BOX_MASK_LOOP(8, box_contains_aos8_avx2(p + i, vq), BOX_CONTAINS_SCALAR(p[i].x, p[i].y))
+}
+
+#define AVX2_STORE_S32(p, v) _mm256_storeu_si256((__m256i*)(p), v)
+BOX_COMBINE_SOA_DEFINE(avx2, TARGET_AVX2, 8, __m256i, AVX2_LOAD_S32, AVX2_STORE_S32, _mm256_set1_epi32, _mm256_min_epi32, _mm256_max_epi32)
+
+TARGET_AVX2 function void box_combine_aos_avx2(I2S32* out, const I2S32* a, const I2S32* b, const I2S32* clip, U64 count, B32 is_union) {
+    __m256i vclip = clip ? _mm256_broadcastsi128_si256(SSE2_LOAD_S32(clip)) : _mm256_setzero_si256();
+    U64 i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m256i va = AVX2_LOAD_S32(a + i);
+        __m256i vb = clip ? vclip : AVX2_LOAD_S32(b + i);
+        __m256i lo = is_union ? _mm256_min_epi32(va, vb) : _mm256_max_epi32(va, vb);
+        __m256i hi = is_union ? _mm256_max_epi32(va, vb) : _mm256_min_epi32(va, vb);
+        __m256i r = _mm256_blend_epi32(lo, hi, 0xCC);
+        if (!is_union) {
+            r = _mm256_max_epi32(r, _mm256_shuffle_epi32(r, _MM_SHUFFLE(1, 0, 1, 0)));
+        }
+        _mm256_storeu_si256((__m256i*)(out + i), r);
+    }
+    box_combine_aos_scalar(out + i, a + i, b + i, clip, count - i, is_union);
+}
+#elif defined(CPU_ARM64)
+function U32 box_bits_neon(uint32x4_t m) {
+    const U32 lane_bits[4] = { 1, 2, 4, 8 };
+    return vaddvq_u32(vandq_u32(m, vld1q_u32(lane_bits)));
+}
+
+function U32 box_overlaps_bits_neon(int32x4_t x0, int32x4_t y0, int32x4_t x1, int32x4_t y1, const int32x4_t* q) {
+    uint32x4_t x = vandq_u32(vcgtq_s32(x1, q[0]), vcgtq_s32(q[2], x0));
+    uint32x4_t y = vandq_u32(vcgtq_s32(y1, q[1]), vcgtq_s32(q[3], y0));
+    return box_bits_neon(vandq_u32(x, y));
+}
+
+function U32 box_contains_bits_neon(int32x4_t x, int32x4_t y, const int32x4_t* q) {
+    uint32x4_t inside = vandq_u32(vcleq_s32(q[0], x), vcleq_s32(q[1], y));
+    inside = vandq_u32(inside, vandq_u32(vcgtq_s32(q[2], x), vcgtq_s32(q[3], y)));
+    return box_bits_neon(inside);
+}
+
+function U32 box_overlaps_aos4_neon(const I2S32* b, const int32x4_t* q) {
+    int32x4x4_t r = vld4q_s32((const S32*)b);
+    return box_overlaps_bits_neon(r.val[0], r.val[1], r.val[2], r.val[3], q);
+}
+
+function U32 box_contains_aos4_neon(const V2S32* p, const int32x4_t* q) {
+    int32x4x2_t r = vld2q_s32((const S32*)p);
+    return box_contains_bits_neon(r.val[0], r.val[1], q);
+}
+
+function U64 box_overlaps_soa_neon(U64* mask, const S32* const* b, I2S32 q, U64 count) {
+    int32x4_t vq[4] = { vdupq_n_s32(q.x0), vdupq_n_s32(q.y0), vdupq_n_s32(q.x1), vdupq_n_s32(q.y1) };
+    BOX_MASK_LOOP(4, box_overlaps_bits_neon(vld1q_s32(b[0] + i), vld1q_s32(b[1] + i), vld1q_s32(b[2] + i), vld1q_s32(b[3] + i), vq),
+                  BOX_OVERLAPS_SCALAR(b[0][i], b[1][i], b[2][i], b[3][i]))
+}
+
+function U64 box_overlaps_aos_neon(U64* mask, const I2S32* b, I2S32 q, U64 count) {
+    int32x4_t vq[4] = { vdupq_n_s32(q.x0), vdupq_n_s32(q.y0), vdupq_n_s32(q.x1), vdupq_n_s32(q.y1) };
+    BOX_MASK_LOOP(4, box_overlaps_aos4_neon(b + i, vq), BOX_OVERLAPS_SCALAR(b[i].x0, b[i].y0, b[i].x1, b[i].y1))
+}
+
+function U64 box_contains_soa_neon(U64* mask, const S32* const* p, I2S32 q, U64 count) {
+    int32x4_t vq[4] = { vdupq_n_s32(q.x0), vdupq_n_s32(q.y0), vdupq_n_s32(q.x1), vdupq_n_s32(q.y1) };
+    BOX_MASK_LOOP(4, box_contains_bits_neon(vld1q_s32(p[0] + i), vld1q_s32(p[1] + i), vq), BOX_CONTAINS_SCALAR(p[0][i], p[1][i]))
+}
+
+function U64 box_contains_aos_neon(U64* mask, const V2S32* p, I2S32 q, U64 count) {
+    int32x4_t vq[4] = { vdupq_n_s32(q.x0), vdupq_n_s32(q.y0), vdupq_n_s32(q.x1), vdupq_n_s32(q.y1) };
+    BOX_MASK_LOOP(4, box_contains_aos4_neon(p + i, vq), BOX_CONTAINS_SCALAR(p[i].x, p[i].y))
+}
+
+function int32x4x4_t box_combine4_neon(int32x4x4_t a, int32x4x4_t b, B32 is_union) {
+    int32x4x4_t r;
+    if (is_union) {
+        r.val[0] = vminq_s32(a.val[0], b.val[0]);
+        r.val[1] = vminq_s32(a.val[1], b.val[1]);
+        r.val[2] = vmaxq_s32(a.val[2], b.val[2]);
+        r.val[3] = vmaxq_s32(a.val[3], b.val[3]);
+    } else {
+        r.val[0] = vmaxq_s32(a.val[0], b.val[0]);
+        r.val[1] = vmaxq_s32(a.val[1], b.val[1]);
+        r.val[2] = vmaxq_s32(vminq_s32(a.val[2], b.val[2]), r.val[0]);
+        r.val[3] = vmaxq_s32(vminq_s32(a.val[3], b.val[3]), r.val[1]);
+    }
+    return r;
+}
+
+BOX_COMBINE_SOA_DEFINE(neon, , 4, int32x4_t, vld1q_s32, vst1q_s32, vdupq_n_s32, vminq_s32, vmaxq_s32)
+
+function void box_combine_aos_neon(I2S32* out, const I2S32* a, const I2S32* b, const I2S32* clip, U64 count, B32 is_union) {
+    U64 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        int32x4x4_t va = vld4q_s32((const S32*)(a + i));
+        int32x4x4_t vb;
+        if (clip) {
+            for (U32 k = 0; k < 4; k++) {
+                vb.val[k] = vdupq_n_s32(clip->v[k]);
+            }
+        } else {
+            vb = vld4q_s32((const S32*)(b + i));
+        }
+        vst4q_s32((S32*)(out + i), box_combine4_neon(va, vb, is_union));
+    }
+    box_combine_aos_scalar(out + i, a + i, b + i, clip, count - i, is_union);
+}
+#endif
+
+typedef struct {
+    U64 (*overlaps_soa)(U64*, const S32* const*, I2S32, U64);
+    U64 (*overlaps_aos)(U64*, const I2S32*, I2S32, U64);
+    U64 (*contains_soa)(U64*, const S32* const*, I2S32, U64);
+    U64 (*contains_aos)(U64*, const V2S32*, I2S32, U64);
+    void (*combine_soa)(S32* const*, const S32* const*, const S32* const*, const I2S32*, U64, B32);
+    void (*combine_aos)(I2S32*, const I2S32*, const I2S32*, const I2S32*, U64, B32);
+} BoxKernels;
+
+#define BOX_KERNELS(suffix) { \
+    box_overlaps_soa_##suffix, box_overlaps_aos_##suffix, box_contains_soa_##suffix, box_contains_aos_##suffix, \
+    box_combine_soa_##suffix, box_combine_aos_##suffix }
+
+global const BoxKernels box_kernels_scalar = BOX_KERNELS(scalar);
+#if defined(CPU_X86)
+global const BoxKernels box_kernels_sse2 = BOX_KERNELS(sse2);
+global const BoxKernels box_kernels_avx2 = BOX_KERNELS(avx2);
+#elif defined(CPU_ARM64)
+global const BoxKernels box_kernels_neon = BOX_KERNELS(neon);
+#endif
+
+// NOTE(ryl1k): Follows simd_select_level like math_kernels_get.
+function const BoxKernels* box_kernels_get(void) {
+    switch (simd_current_level()) {
+#if defined(CPU_X86)
+        case SIMDLevel_SSE2: return &box_kernels_sse2;
+        case SIMDLevel_AVX2: return &box_kernels_avx2;
+        case SIMDLevel_AVX512: return &box_kernels_avx2;
+#elif defined(CPU_ARM64)
+        case SIMDLevel_NEON: return &box_kernels_neon;
+#endif
+        default: return &box_kernels_scalar;
+    }
+}
+
+// NOTE(ryl1k): Index lists are built from masks a block at a time.
+#define BOX_INDEX_BLOCK 4096
+
+function U64 box_mask_indices(U32* out, const U64* mask, U64 count, U64 base) {
+    U64 hits = 0;
+    for (U64 w = 0; w < (count + 63) / 64; w++) {
+        U64 bits = mask[w];
+        while (bits) {
+            out[hits++] = (U32)(base + w * 64 + ctz_U64(bits));
+            bits &= bits - 1;
+        }
+    }
+    return hits;
+}
+
+function U64 overlaps_mask_I2S32_array(U64* out, const I2S32* boxes, I2S32 query, U64 count) {
+    return box_kernels_get()->overlaps_aos(out, boxes, query, count);
+}
+
+function U64 overlaps_mask_I2S32_soa(U64* out, I2S32SoA boxes, I2S32 query, U64 count) {
+    return box_kernels_get()->overlaps_soa(out, (const S32* const*)boxes.v, query, count);
+}
+
+function U64 overlaps_indices_I2S32_array(U32* out, const I2S32* boxes, I2S32 query, U64 count) {
+    const BoxKernels* k = box_kernels_get();
+    U64 mask[BOX_INDEX_BLOCK / 64];
+    U64 hits = 0;
+    for (U64 start = 0; start < count; start += BOX_INDEX_BLOCK) {
+        U64 n = Min(count - start, BOX_INDEX_BLOCK);
+        k->overlaps_aos(mask, boxes + start, query, n);
+        hits += box_mask_indices(out + hits, mask, n, start);
+    }
+    return hits;
+}
+
+function U64 overlaps_indices_I2S32_soa(U32* out, I2S32SoA boxes, I2S32 query, U64 count) {
+    const BoxKernels* k = box_kernels_get();
+    U64 mask[BOX_INDEX_BLOCK / 64];
+    U64 hits = 0;
+    for (U64 start = 0; start < count; start += BOX_INDEX_BLOCK) {
+        U64 n = Min(count - start, BOX_INDEX_BLOCK);
+        const S32* b[4] = { boxes.x0 + start, boxes.y0 + start, boxes.x1 + start, boxes.y1 + start };
+        k->overlaps_soa(mask, b, query, n);
+        hits += box_mask_indices(out + hits, mask, n, start);
+    }
+    return hits;
+}
+
+function U64 contains_mask_V2S32_array(U64* out, const V2S32* points, I2S32 box, U64 count) {
+    return box_kernels_get()->contains_aos(out, points, box, count);
+}
+
+function U64 contains_mask_V2S32_soa(U64* out, V2S32SoA points, I2S32 box, U64 count) {
+    return box_kernels_get()->contains_soa(out, (const S32* const*)points.v, box, count);
+}
+
+function U64 contains_indices_V2S32_array(U32* out, const V2S32* points, I2S32 box, U64 count) {
+    const BoxKernels* k = box_kernels_get();
+    U64 mask[BOX_INDEX_BLOCK / 64];
+    U64 hits = 0;
+    for (U64 start = 0; start < count; start += BOX_INDEX_BLOCK) {
+        U64 n = Min(count - start, BOX_INDEX_BLOCK);
+        k->contains_aos(mask, points + start, box, n);
+        hits += box_mask_indices(out + hits, mask, n, start);
+    }
+    return hits;
+}
+
+function U64 contains_indices_V2S32_soa(U32* out, V2S32SoA points, I2S32 box, U64 count) {
+    const BoxKernels* k = box_kernels_get();
+    U64 mask[BOX_INDEX_BLOCK / 64];
+    U64 hits = 0;
+    for (U64 start = 0; start < count; start += BOX_INDEX_BLOCK) {
+        U64 n = Min(count - start, BOX_INDEX_BLOCK);
+        const S32* p[2] = { points.x + start, points.y + start };
+        k->contains_soa(mask, p, box, n);
+        hits += box_mask_indices(out + hits, mask, n, start);
+    }
+    return hits;
+}
+
+function void intersect_I2S32_array(I2S32* out, const I2S32* a, const I2S32* b, U64 count) {
+    box_kernels_get()->combine_aos(out, a, b, 0, count, 0);
+}
+
+function void intersect_I2S32_soa(I2S32SoA out, I2S32SoA a, I2S32SoA b, U64 count) {
+    box_kernels_get()->combine_soa(out.v, (const S32* const*)a.v, (const S32* const*)b.v, 0, count, 0);
+}
+
+function void union_I2S32_array(I2S32* out, const I2S32* a, const I2S32* b, U64 count) {
+    box_kernels_get()->combine_aos(out, a, b, 0, count, 1);
+}
+
+function void union_I2S32_soa(I2S32SoA out, I2S32SoA a, I2S32SoA b, U64 count) {
+    box_kernels_get()->combine_soa(out.v, (const S32* const*)a.v, (const S32* const*)b.v, 0, count, 1);
+}
+
+function void clip_I2S32_array(I2S32* out, const I2S32* a, I2S32 clip, U64 count) {
+    box_kernels_get()->combine_aos(out, a, a, &clip, count, 0);
+}
+
+function void clip_I2S32_soa(I2S32SoA out, I2S32SoA a, I2S32 clip, U64 count) {
+    box_kernels_get()->combine_soa(out.v, (const S32* const*)a.v, (const S32* const*)a.v, &clip, count, 0);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Spatial Index Functions
+
+typedef struct {
+    F32 x0;
+    F32 y0;
+    F32 x1;
+    F32 y1;
+    U32 id;
+} SpatialEntry;
+
+// NOTE(ryl1k): I2S32 coordinates beyond 2^24 are not exact in F32, so
+// bounds are rounded outward and never miss a box.
+function F32 spatial_floor_S32(S32 v) {
+    F32 f = (F32)v;
+    if ((F64)f > (F64)v) {
+        f = nextafterf(f, -INFINITY);
+    }
+    return f;
+}
+
+function F32 spatial_ceil_S32(S32 v) {
+    F32 f = (F32)v;
+    if ((F64)f < (F64)v) {
+        f = nextafterf(f, INFINITY);
+    }
+    return f;
+}
+
+function I2F32 spatial_bounds_S32(I2S32 box) {
+    I2F32 result = i2f32(spatial_floor_S32(box.x0), spatial_floor_S32(box.y0), spatial_ceil_S32(box.x1), spatial_ceil_S32(box.y1));
+    return result;
+}
+
+function F32 spatial_distance_squared(I2F32 box, V2F32 p) {
+    F32 dx = Max(Max(box.x0 - p.x, p.x - box.x1), 0.0f);
+    F32 dy = Max(Max(box.y0 - p.y, p.y - box.y1), 0.0f);
+    return dx * dx + dy * dy;
+}
+
+function void* spatial_alloc(Arena* arena, U64 size) {
+    return arena ? arena_alloc_aligned(arena, size, CACHE_LINE_SIZE) : BASE_ALLOC(size);
+}
+
+// NOTE(ryl1k): Keeps out/out_distance_squared sorted; when full the new
+// item replaces the farthest one.
+function void spatial_nearest_insert(U32* out, F32* out_distance_squared, U32* found, U32 k, U32 id, F32 d) {
+    U32 at = (*found < k) ? (*found)++ : k - 1;
+    while (at > 0 && out_distance_squared[at - 1] > d) {
+        out[at] = out[at - 1];
+        out_distance_squared[at] = out_distance_squared[at - 1];
+        at--;
+    }
+    out[at] = id;
+    out_distance_squared[at] = d;
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): R-tree
+
+// NOTE(ryl1k): Bit i of the result is set if child i's bounds overlap the
+// closed query box.
+function U32 rtree_overlap_mask(const RTreeNode* node, F32 qx0, F32 qy0, F32 qx1, F32 qy1) {
+    U32 mask = 0;
+#if defined(CPU_X86)
+    __m128 vx0 = _mm_set1_ps(qx0), vy0 = _mm_set1_ps(qy0), vx1 = _mm_set1_ps(qx1), vy1 = _mm_set1_ps(qy1);
+    for (U32 h = 0; h < RTREE_FANOUT; h += 4) {
+        __m128 x = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(node->x0 + h), vx1), _mm_cmple_ps(vx0, _mm_loadu_ps(node->x1 + h)));
+        __m128 y = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(node->y0 + h), vy1), _mm_cmple_ps(vy0, _mm_loadu_ps(node->y1 + h)));
+        mask |= (U32)_mm_movemask_ps(_mm_and_ps(x, y)) << h;
+    }
+#elif defined(CPU_ARM64)
+    const U32 lane_bits[4] = { 1, 2, 4, 8 };
+    uint32x4_t bits = vld1q_u32(lane_bits);
+    float32x4_t vx0 = vdupq_n_f32(qx0), vy0 = vdupq_n_f32(qy0), vx1 = vdupq_n_f32(qx1), vy1 = vdupq_n_f32(qy1);
+    for (U32 h = 0; h < RTREE_FANOUT; h += 4) {
+        uint32x4_t x = vandq_u32(vcleq_f32(vld1q_f32(node->x0 + h), vx1), vcleq_f32(vx0, vld1q_f32(node->x1 + h)));
+        uint32x4_t y = vandq_u32(vcleq_f32(vld1q_f32(node->y0 + h), vy1), vcleq_f32(vy0, vld1q_f32(node->y1 + h)));
+        mask |= vaddvq_u32(vandq_u32(vandq_u32(x, y), bits)) << h;
+    }
+#else
+    for (U32 i = 0; i < RTREE_FANOUT; i++) {
+        B32 hit = node->x0[i] <= qx1 && qx0 <= node->x1[i] && node->y0[i] <= qy1 && qy0 <= node->y1[i];
+        mask |= (U32)hit << i;
+    }
+#endif
+    return mask & ((1u << node->count) - 1);
+}
+
+// NOTE(ryl1k): Squared distance from p to each child's bounds.
+function void rtree_distances(const RTreeNode* node, V2F32 p, F32* out) {
+#if defined(CPU_X86)
+    __m128 px = _mm_set1_ps(p.x), py = _mm_set1_ps(p.y), zero = _mm_setzero_ps();
+    for (U32 h = 0; h < RTREE_FANOUT; h += 4) {
+        __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(node->x0 + h), px), _mm_sub_ps(px, _mm_loadu_ps(node->x1 + h))), zero);
+        __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(node->y0 + h), py), _mm_sub_ps(py, _mm_loadu_ps(node->y1 + h))), zero);
+        _mm_storeu_ps(out + h, _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+    }
+#elif defined(CPU_ARM64)
+    float32x4_t px = vdupq_n_f32(p.x), py = vdupq_n_f32(p.y), zero = vdupq_n_f32(0.0f);
+    for (U32 h = 0; h < RTREE_FANOUT; h += 4) {
+        float32x4_t dx = vmaxq_f32(vmaxq_f32(vsubq_f32(vld1q_f32(node->x0 + h), px), vsubq_f32(px, vld1q_f32(node->x1 + h))), zero);
+        float32x4_t dy = vmaxq_f32(vmaxq_f32(vsubq_f32(vld1q_f32(node->y0 + h), py), vsubq_f32(py, vld1q_f32(node->y1 + h))), zero);
+        vst1q_f32(out + h, vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy)));
+    }
+#else
+    for (U32 i = 0; i < RTREE_FANOUT; i++) {
+        out[i] = spatial_distance_squared(i2f32(node->x0[i], node->y0[i], node->x1[i], node->y1[i]), p);
+    }
+#endif
+}
+
+function RTree rtree_create(Arena* arena) {
+    RTree tree;
+    MemoryZeroStruct(&tree);
+    tree.arena = arena;
+    return tree;
+}
+
+function void rtree_destroy(RTree* tree) {
+    if (!tree->arena && tree->memory) {
+        BASE_FREE(tree->memory);
+    }
+    MemoryZeroStruct(tree);
+}
+
+function U32 rtree_nodes_needed(U32 count) {
+    U32 total = 0;
+    U32 n = count;
+    do {
+        n = Max((n + RTREE_FANOUT - 1) / RTREE_FANOUT, 1);
+        total += n;
+    } while (n > 1);
+    return total;
+}
+
+function B32 rtree_reserve(RTree* tree, U32 count, B32 is_s32) {
+    U32 nodes = rtree_nodes_needed(count);
+    U32 boxes = is_s32 ? count : 0;
+    if (nodes <= tree->node_capacity && boxes <= tree->box_capacity) {
+        return 1;
+    }
+    U32 node_capacity = Max(nodes, tree->node_capacity);
+    U32 box_capacity = Max(boxes, tree->box_capacity);
+    U64 node_bytes = (U64)node_capacity * sizeof(RTreeNode);
+    void* memory = spatial_alloc(tree->arena, node_bytes + (U64)box_capacity * sizeof(I2S32));
+    if (!memory) {
+        return 0;
+    }
+    if (!tree->arena && tree->memory) {
+        BASE_FREE(tree->memory);
+    }
+    tree->memory = memory;
+    tree->nodes = (RTreeNode*)memory;
+    tree->boxes_s32 = (I2S32*)((char*)memory + node_bytes);
+    tree->node_capacity = node_capacity;
+    tree->box_capacity = box_capacity;
+    return 1;
+}
+
+function U32 rtree_emit_node(RTree* tree, const SpatialEntry* entries, U32 count, B32 leaf) {
+    U32 index = tree->node_count++;
+    RTreeNode* node = &tree->nodes[index];
+    for (U32 i = 0; i < RTREE_FANOUT; i++) {
+        B32 used = i < count;
+        node->x0[i] = used ? entries[i].x0 : INFINITY;
+        node->y0[i] = used ? entries[i].y0 : INFINITY;
+        node->x1[i] = used ? entries[i].x1 : -INFINITY;
+        node->y1[i] = used ? entries[i].y1 : -INFINITY;
+        node->child[i] = used ? entries[i].id : 0;
+    }
+    node->count = count;
+    node->leaf = leaf;
+    return index;
+}
+
+// NOTE(ryl1k): Sort-Tile-Recursive packing, one level per pass: sort the
+// entries by x center, cut them into about sqrt(nodes) vertical slices,
+// sort each slice by y center and pack runs of RTREE_FANOUT into nodes.
+// The nodes' bounds become the next level's entries until one node is
+// left, which is the root.
+function B32 rtree_pack(RTree* tree, SpatialEntry* entries, SpatialEntry* sorted, F32* keys, U32* order, U32* slice_order,
+                        U32 count) {
+    tree->node_count = 0;
+    tree->item_count = count;
+    B32 leaf = 1;
+    U32 n = count;
+    while (n > RTREE_FANOUT) {
+        U32 node_total = (n + RTREE_FANOUT - 1) / RTREE_FANOUT;
+        U32 slices = (U32)ceil(sqrt((F64)node_total));
+        U32 slice_size = ((node_total + slices - 1) / slices) * RTREE_FANOUT;
+        for (U32 i = 0; i < n; i++) {
+            keys[i] = entries[i].x0 + entries[i].x1;
+        }
+        if (!radix_sort_index_F32(keys, n, order, tree->arena)) {
+            return 0;
+        }
+        for (U32 start = 0; start < n; start += slice_size) {
+            U32 m = Min(slice_size, n - start);
+            for (U32 j = 0; j < m; j++) {
+                const SpatialEntry* e = &entries[order[start + j]];
+                keys[j] = e->y0 + e->y1;
+            }
+            if (!radix_sort_index_F32(keys, m, slice_order, tree->arena)) {
+                return 0;
+            }
+            for (U32 j = 0; j < m; j++) {
+                sorted[start + j] = entries[order[start + slice_order[j]]];
+            }
+        }
+        U32 next = 0;
+        for (U32 start = 0; start < n; start += RTREE_FANOUT) {
+            U32 m = Min(RTREE_FANOUT, n - start);
+            SpatialEntry bounds = sorted[start];
+            for (U32 j = 1; j < m; j++) {
+                const SpatialEntry* e = &sorted[start + j];
+                bounds.x0 = Min(bounds.x0, e->x0);
+                bounds.y0 = Min(bounds.y0, e->y0);
+                bounds.x1 = Max(bounds.x1, e->x1);
+                bounds.y1 = Max(bounds.y1, e->y1);
+            }
+            bounds.id = rtree_emit_node(tree, sorted + start, m, leaf);
+            entries[next++] = bounds;
+        }
+        n = next;
+        leaf = 0;
+    }
+    tree->root = rtree_emit_node(tree, entries, n, leaf);
+    return 1;
+}
+
+function B32 rtree_build(RTree* tree, const I2F32* boxes_f32, const I2S32* boxes_s32, U32 count) {
+    B32 is_s32 = boxes_s32 != 0;
+    if (!rtree_reserve(tree, count, is_s32)) {
+        tree->node_count = tree->item_count = 0;
+        return 0;
+    }
+    tree->is_s32 = is_s32;
+    U64 scratch_size = (U64)count * (2 * sizeof(SpatialEntry) + sizeof(F32) + 2 * sizeof(U32)) + sizeof(SpatialEntry);
+    SortScratch s;
+    SpatialEntry* entries = sort_scratch_begin(&s, tree->arena, scratch_size);
+    B32 ok = entries != 0;
+    if (ok) {
+        SpatialEntry* sorted = entries + count;
+        F32* keys = (F32*)(sorted + count);
+        U32* order = (U32*)(keys + count);
+        U32* slice_order = order + count;
+        for (U32 i = 0; i < count; i++) {
+            I2F32 b = is_s32 ? spatial_bounds_S32(boxes_s32[i]) : boxes_f32[i];
+            SpatialEntry e = { b.x0, b.y0, b.x1, b.y1, i };
+            entries[i] = e;
+            if (is_s32) {
+                tree->boxes_s32[i] = boxes_s32[i];
+            }
+        }
+        ok = rtree_pack(tree, entries, sorted, keys, order, slice_order, count);
+    }
+    sort_scratch_end(&s);
+    if (!ok) {
+        tree->node_count = tree->item_count = 0;
+    }
+    return ok;
+}
+
+function B32 rtree_build_I2F32(RTree* tree, const I2F32* boxes, U32 count) {
+    return rtree_build(tree, boxes, 0, count);
+}
+
+function B32 rtree_build_I2S32(RTree* tree, const I2S32* boxes, U32 count) {
+    return rtree_build(tree, 0, boxes, count);
+}
+
+// NOTE(ryl1k): Nodes are tested against the closed F32 box; for I2S32
+// trees, leaf hits are then checked exactly against the query box or point.
+function U32 rtree_query(const RTree* tree, I2F32 q, const I2S32* box_s32, const V2S32* point_s32, U32* out, U32 max_out) {
+    if (!tree->node_count) {
+        return 0;
+    }
+    U32 stack[RTREE_STACK];
+    U32 top = 0;
+    U32 hits = 0;
+    stack[top++] = tree->root;
+    while (top) {
+        const RTreeNode* node = &tree->nodes[stack[--top]];
+        U32 mask = rtree_overlap_mask(node, q.x0, q.y0, q.x1, q.y1);
+        while (mask) {
+            U32 i = ctz_U64(mask);
+            U32 child = node->child[i];
+            mask &= mask - 1;
+            if (!node->leaf) {
+                stack[top++] = child;
+                continue;
+            }
+            if (box_s32 && !I2S32_overlaps(tree->boxes_s32[child], *box_s32)) {
+                continue;
+            }
+            if (point_s32 && !I2S32_contains(tree->boxes_s32[child], *point_s32)) {
+                continue;
+            }
+            if (hits < max_out) {
+                out[hits] = child;
+            }
+            hits++;
+        }
+    }
+    return hits;
+}
+
+function U32 rtree_query_I2F32(const RTree* tree, I2F32 box, U32* out, U32 max_out) {
+    Assert(!tree->is_s32);
+    return rtree_query(tree, box, 0, 0, out, max_out);
+}
+
+function U32 rtree_query_I2S32(const RTree* tree, I2S32 box, U32* out, U32 max_out) {
+    Assert(tree->is_s32 || !tree->node_count);
+    return rtree_query(tree, spatial_bounds_S32(box), &box, 0, out, max_out);
+}
+
+function U32 rtree_query_point_V2F32(const RTree* tree, V2F32 point, U32* out, U32 max_out) {
+    Assert(!tree->is_s32);
+    return rtree_query(tree, i2f32(point.x, point.y, point.x, point.y), 0, 0, out, max_out);
+}
+
+function U32 rtree_query_point_V2S32(const RTree* tree, V2S32 point, U32* out, U32 max_out) {
+    Assert(tree->is_s32 || !tree->node_count);
+    I2S32 p = i2s32(point.x, point.y, point.x, point.y);
+    return rtree_query(tree, spatial_bounds_S32(p), 0, &point, out, max_out);
+}
+
+// NOTE(ryl1k): Depth-first branch and bound: children are pushed farthest
+// first so the nearest is expanded next, and anything no closer than the
+// current k-th best is skipped.
+function U32 rtree_nearest(const RTree* tree, V2F32 point, U32 k, U32* out, F32* out_distance_squared) {
+    if (!tree->node_count || !k) {
+        return 0;
+    }
+    struct { U32 node; F32 d; } stack[RTREE_STACK];
+    U32 top = 0;
+    U32 found = 0;
+    stack[top].node = tree->root;
+    stack[top].d = 0.0f;
+    top++;
+    while (top) {
+        top--;
+        F32 worst = (found == k) ? out_distance_squared[k - 1] : INFINITY;
+        if (stack[top].d >= worst) {
+            continue;
+        }
+        const RTreeNode* node = &tree->nodes[stack[top].node];
+        F32 d[RTREE_FANOUT];
+        rtree_distances(node, point, d);
+        if (node->leaf) {
+            for (U32 i = 0; i < node->count; i++) {
+                if (found < k || d[i] < out_distance_squared[k - 1]) {
+                    spatial_nearest_insert(out, out_distance_squared, &found, k, node->child[i], d[i]);
+                }
+            }
+            continue;
+        }
+        U32 by_distance[RTREE_FANOUT];
+        for (U32 i = 0; i < node->count; i++) {
+            U32 j = i;
+            while (j > 0 && d[by_distance[j - 1]] < d[i]) {
+                by_distance[j] = by_distance[j - 1];
+                j--;
+            }
+            by_distance[j] = i;
+        }
+        for (U32 i = 0; i < node->count; i++) {
+            U32 c = by_distance[i];
+            if (d[c] < worst) {
+                stack[top].node = node->child[c];
+                stack[top].d = d[c];
+                top++;
+            }
+        }
+    }
+    return found;
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Uniform Grid
+
+function SpatialGrid spatial_grid_create(Arena* arena) {
+    SpatialGrid grid;
+    MemoryZeroStruct(&grid);
+    grid.arena = arena;
+    return grid;
+}
+
+function void spatial_grid_destroy(SpatialGrid* grid) {
+    if (!grid->arena) {
+        if (grid->cell_start) {
+            BASE_FREE(grid->cell_start);
+        }
+        if (grid->cell_items) {
+            BASE_FREE(grid->cell_items);
+        }
+        if (grid->bounds) {
+            BASE_FREE(grid->bounds);
+        }
+    }
+    MemoryZeroStruct(grid);
+}
+
+function B32 spatial_grid_reserve(Arena* arena, void** memory, U32* capacity, U64 needed, U64 element_size) {
+    if (needed <= *capacity) {
+        return 1;
+    }
+    if (needed > 0xFFFFFFFFu) {
+        return 0;
+    }
+    void* block = spatial_alloc(arena, needed * element_size);
+    if (!block) {
+        return 0;
+    }
+    if (!arena && *memory) {
+        BASE_FREE(*memory);
+    }
+    *memory = block;
+    *capacity = (U32)needed;
+    return 1;
+}
+
+function U32 spatial_grid_cell_x(const SpatialGrid* grid, F32 x) {
+    F32 c = (x - grid->origin_x) / grid->cell_width;
+    return (c <= 0.0f) ? 0 : (c >= (F32)(grid->cells_x - 1)) ? grid->cells_x - 1 : (U32)c;
+}
+
+function U32 spatial_grid_cell_y(const SpatialGrid* grid, F32 y) {
+    F32 c = (y - grid->origin_y) / grid->cell_height;
+    return (c <= 0.0f) ? 0 : (c >= (F32)(grid->cells_y - 1)) ? grid->cells_y - 1 : (U32)c;
+}
+
+// NOTE(ryl1k): Counting sort into cells: count entries per cell, turn the
+// counts into end offsets, then fill each cell backwards so cell_start
+// ends up holding the start offsets.
+function B32 spatial_grid_build(SpatialGrid* grid, const I2F32* boxes_f32, const I2S32* boxes_s32, U32 count, U32 cells_x, U32 cells_y) {
+    B32 is_s32 = boxes_s32 != 0;
+    U32 items = (is_s32 ? 2 : 1) * count;
+    grid->item_count = grid->entry_count = 0;
+    grid->cells_x = grid->cells_y = 1;
+    if (!spatial_grid_reserve(grid->arena, (void**)&grid->bounds, &grid->item_capacity, (U64)Max(items, 1), sizeof(I2F32))) {
+        return 0;
+    }
+    grid->is_s32 = is_s32;
+    grid->boxes_s32 = (I2S32*)(grid->bounds + count);
+    F32 x0 = INFINITY, y0 = INFINITY, x1 = -INFINITY, y1 = -INFINITY;
+    for (U32 i = 0; i < count; i++) {
+        I2F32 b = is_s32 ? spatial_bounds_S32(boxes_s32[i]) : boxes_f32[i];
+        grid->bounds[i] = b;
+        if (is_s32) {
+            grid->boxes_s32[i] = boxes_s32[i];
+        }
+        x0 = Min(x0, b.x0);
+        y0 = Min(y0, b.y0);
+        x1 = Max(x1, b.x1);
+        y1 = Max(y1, b.y1);
+    }
+    if (!count) {
+        x0 = y0 = 0.0f;
+        x1 = y1 = 1.0f;
+    }
+    U32 automatic = (U32)ceil(sqrt((F64)count));
+    grid->cells_x = Clamp(1, cells_x ? cells_x : automatic, SPATIAL_GRID_MAX_CELLS);
+    grid->cells_y = Clamp(1, cells_y ? cells_y : automatic, SPATIAL_GRID_MAX_CELLS);
+    grid->origin_x = x0;
+    grid->origin_y = y0;
+    grid->cell_width = (x1 > x0) ? (x1 - x0) / (F32)grid->cells_x : 1.0f;
+    grid->cell_height = (y1 > y0) ? (y1 - y0) / (F32)grid->cells_y : 1.0f;
+
+    U32 cell_count = grid->cells_x * grid->cells_y;
+    if (!spatial_grid_reserve(grid->arena, (void**)&grid->cell_start, &grid->cell_capacity, (U64)cell_count + 1, sizeof(U32))) {
+        grid->cells_x = grid->cells_y = 1;
+        return 0;
+    }
+    MemoryZero(grid->cell_start, ((U64)cell_count + 1) * sizeof(U32));
+    U64 entries = 0;
+    for (U32 i = 0; i < count; i++) {
+        I2F32 b = grid->bounds[i];
+        U32 cx0 = spatial_grid_cell_x(grid, b.x0), cx1 = spatial_grid_cell_x(grid, b.x1);
+        U32 cy0 = spatial_grid_cell_y(grid, b.y0), cy1 = spatial_grid_cell_y(grid, b.y1);
+        for (U32 cy = cy0; cy <= cy1; cy++) {
+            for (U32 cx = cx0; cx <= cx1; cx++) {
+                grid->cell_start[cy * grid->cells_x + cx]++;
+            }
+        }
+        entries += (U64)(cx1 - cx0 + 1) * (cy1 - cy0 + 1);
+    }
+    if (!spatial_grid_reserve(grid->arena, (void**)&grid->cell_items, &grid->entry_capacity, Max(entries, 1), sizeof(U32))) {
+        grid->cells_x = grid->cells_y = 1;
+        MemoryZero(grid->cell_start, 2 * sizeof(U32));
+        return 0;
+    }
+    U32 end = 0;
+    for (U32 c = 0; c < cell_count; c++) {
+        end += grid->cell_start[c];
+        grid->cell_start[c] = end;
+    }
+    grid->cell_start[cell_count] = end;
+    for (U32 i = count; i-- > 0;) {
+        I2F32 b = grid->bounds[i];
+        U32 cx0 = spatial_grid_cell_x(grid, b.x0), cx1 = spatial_grid_cell_x(grid, b.x1);
+        U32 cy0 = spatial_grid_cell_y(grid, b.y0), cy1 = spatial_grid_cell_y(grid, b.y1);
+        for (U32 cy = cy0; cy <= cy1; cy++) {
+            for (U32 cx = cx0; cx <= cx1; cx++) {
+                grid->cell_items[--grid->cell_start[cy * grid->cells_x + cx]] = i;
+            }
+        }
+    }
+    grid->item_count = count;
+    grid->entry_count = (U32)entries;
+    return 1;
+}
+
+function B32 spatial_grid_build_I2F32(SpatialGrid* grid, const I2F32* boxes, U32 count, U32 cells_x, U32 cells_y) {
+    return spatial_grid_build(grid, boxes, 0, count, cells_x, cells_y);
+}
+
+function B32 spatial_grid_build_I2S32(SpatialGrid* grid, const I2S32* boxes, U32 count, U32 cells_x, U32 cells_y) {
+    return spatial_grid_build(grid, 0, boxes, count, cells_x, cells_y);
+}
+
+// NOTE(ryl1k): A box spanning several cells is reported only from the cell
+// holding the lower corner of its overlap with the query.
+function U32 spatial_grid_query(const SpatialGrid* grid, I2F32 q, const I2S32* box_s32, U32* out, U32 max_out) {
+    if (!grid->item_count) {
+        return 0;
+    }
+    U32 hits = 0;
+    U32 qx0 = spatial_grid_cell_x(grid, q.x0), qx1 = spatial_grid_cell_x(grid, q.x1);
+    U32 qy0 = spatial_grid_cell_y(grid, q.y0), qy1 = spatial_grid_cell_y(grid, q.y1);
+    for (U32 cy = qy0; cy <= qy1; cy++) {
+        for (U32 cx = qx0; cx <= qx1; cx++) {
+            U32 c = cy * grid->cells_x + cx;
+            for (U32 e = grid->cell_start[c]; e < grid->cell_start[c + 1]; e++) {
+                U32 id = grid->cell_items[e];
+                I2F32 b = grid->bounds[id];
+                if (Max(spatial_grid_cell_x(grid, b.x0), qx0) != cx || Max(spatial_grid_cell_y(grid, b.y0), qy0) != cy) {
+                    continue;
+                }
+                if (!I2F32_overlaps(b, q)) {
+                    continue;
+                }
+                if (box_s32 && !I2S32_overlaps(grid->boxes_s32[id], *box_s32)) {
+                    continue;
+                }
+                if (hits < max_out) {
+                    out[hits] = id;
+                }
+                hits++;
+            }
+        }
+    }
+    return hits;
+}
+
+function U32 spatial_grid_query_I2F32(const SpatialGrid* grid, I2F32 box, U32* out, U32 max_out) {
+    Assert(!grid->is_s32);
+    return spatial_grid_query(grid, box, 0, out, max_out);
+}
+
+function U32 spatial_grid_query_I2S32(const SpatialGrid* grid, I2S32 box, U32* out, U32 max_out) {
+    Assert(grid->is_s32 || !grid->item_count);
+    return spatial_grid_query(grid, spatial_bounds_S32(box), &box, out, max_out);
+}
+
+function U32 spatial_grid_query_point_V2F32(const SpatialGrid* grid, V2F32 point, U32* out, U32 max_out) {
+    Assert(!grid->is_s32);
+    return spatial_grid_query(grid, i2f32(point.x, point.y, point.x, point.y), 0, out, max_out);
+}
+
+function U32 spatial_grid_query_point_V2S32(const SpatialGrid* grid, V2S32 point, U32* out, U32 max_out) {
+    Assert(grid->is_s32 || !grid->item_count);
+    if (!grid->item_count) {
+        return 0;
+    }
+    I2F32 q = spatial_bounds_S32(i2s32(point.x, point.y, point.x, point.y));
+    U32 c = spatial_grid_cell_y(grid, q.y0) * grid->cells_x + spatial_grid_cell_x(grid, q.x0);
+    U32 hits = 0;
+    for (U32 e = grid->cell_start[c]; e < grid->cell_start[c + 1]; e++) {
+        U32 id = grid->cell_items[e];
+        if (!I2S32_contains(grid->boxes_s32[id], point)) {
+            continue;
+        }
+        if (hits < max_out) {
+            out[hits] = id;
+        }
+        hits++;
+    }
+    return hits;
+}
+
+// NOTE(ryl1k): Searches square rings of cells outward from the point's
+// cell. A box not seen yet touches none of the searched cells, so it is at
+// least as far as the nearest inner edge of the searched block (edges on
+// the grid border extend to infinity, since cells clamp).
+function U32 spatial_grid_nearest(const SpatialGrid* grid, V2F32 point, U32 k, U32* out, F32* out_distance_squared) {
+    if (!grid->item_count || !k) {
+        return 0;
+    }
+    S64 px = spatial_grid_cell_x(grid, point.x);
+    S64 py = spatial_grid_cell_y(grid, point.y);
+    S64 cells_x = grid->cells_x;
+    S64 cells_y = grid->cells_y;
+    U32 found = 0;
+    for (S64 r = 0;; r++) {
+        for (S64 cy = Max(py - r, 0); cy <= Min(py + r, cells_y - 1); cy++) {
+            B32 edge_row = (cy == py - r) || (cy == py + r);
+            for (S64 cx = Max(px - r, 0); cx <= Min(px + r, cells_x - 1); cx++) {
+                if (!edge_row && cx != px - r && cx != px + r) {
+                    cx = px + r - 1;
+                    continue;
+                }
+                U32 c = (U32)(cy * cells_x + cx);
+                for (U32 e = grid->cell_start[c]; e < grid->cell_start[c + 1]; e++) {
+                    U32 id = grid->cell_items[e];
+                    F32 d = spatial_distance_squared(grid->bounds[id], point);
+                    if (found == k && d >= out_distance_squared[k - 1]) {
+                        continue;
+                    }
+                    B32 seen = 0;
+                    for (U32 j = 0; j < found && !seen; j++) {
+                        seen = out[j] == id;
+                    }
+                    if (!seen) {
+                        spatial_nearest_insert(out, out_distance_squared, &found, k, id, d);
+                    }
+                }
+            }
+        }
+        F32 bound = INFINITY;
+        if (px - r > 0) {
+            bound = Min(bound, point.x - (grid->origin_x + (F32)(px - r) * grid->cell_width));
+        }
+        if (px + r < cells_x - 1) {
+            bound = Min(bound, grid->origin_x + (F32)(px + r + 1) * grid->cell_width - point.x);
+        }
+        if (py - r > 0) {
+            bound = Min(bound, point.y - (grid->origin_y + (F32)(py - r) * grid->cell_height));
+        }
+        if (py + r < cells_y - 1) {
+            bound = Min(bound, grid->origin_y + (F32)(py + r + 1) * grid->cell_height - point.y);
+        }
+        if (bound == INFINITY) {
+            break;
+        }
+        if (found == k && out_distance_squared[k - 1] <= Max(bound, 0.0f) * Max(bound, 0.0f)) {
+            break;
+        }
+    }
+    return found;
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Interval Index Functions
+
+function U64 interval_key_F32(F32 x) {
+    union { F32 f; U32 u; } bits;
+    bits.f = x + 0.0f;
+    return radix_key_F32(bits.u);
+}
+
+function I1U64 interval_range_F32(I1F32 range) {
+    I1U64 result;
+    result.min = interval_key_F32(range.min);
+    result.max = interval_key_F32(range.max);
+    return result;
+}
+
+function IntervalTree interval_tree_create(Arena* arena) {
+    IntervalTree tree;
+    MemoryZeroStruct(&tree);
+    tree.arena = arena;
+    return tree;
+}
+
+function void interval_tree_destroy(IntervalTree* tree) {
+    if (!tree->arena) {
+        if (tree->entries) {
+            BASE_FREE(tree->entries);
+        }
+        if (tree->pending) {
+            BASE_FREE(tree->pending);
+        }
+    }
+    MemoryZeroStruct(tree);
+}
+
+function B32 interval_tree_reserve(IntervalTree* tree, IntervalEntry** entries, U32* capacity, U32 count, U64 needed) {
+    if (needed <= *capacity) {
+        return 1;
+    }
+    U64 new_capacity = *capacity ? (U64)*capacity * 2 : 16;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    new_capacity = Min(new_capacity, 0xFFFFFFFFu);
+    if (needed > new_capacity) {
+        return 0;
+    }
+    IntervalEntry* v = array_grow(tree->arena, *entries, count, *capacity, new_capacity, sizeof(IntervalEntry));
+    if (!v) {
+        return 0;
+    }
+    *entries = v;
+    *capacity = (U32)new_capacity;
+    return 1;
+}
+
+// NOTE(ryl1k): Implicit tree over the sorted array: leaves are the even
+// indices and a node at level k is an index whose low k bits are set,
+// with children x -/+ 2^(k-1). Indices past count still act as nodes, so
+// `last` carries the largest max_end seen along the rightmost path.
+function void interval_tree_index(IntervalTree* tree) {
+    IntervalEntry* a = tree->entries;
+    U64 n = tree->count;
+    tree->levels = 0;
+    if (!n) {
+        return;
+    }
+    U64 last_i = 0;
+    U64 last = 0;
+    for (U64 i = 0; i < n; i += 2) {
+        last_i = i;
+        last = a[i].max_end = a[i].max;
+    }
+    U32 k = 1;
+    for (; (1llu << k) <= n; k++) {
+        U64 x = 1llu << (k - 1);
+        for (U64 i = 2 * x - 1; i < n; i += 4 * x) {
+            U64 left = a[i - x].max_end;
+            U64 right = (i + x < n) ? a[i + x].max_end : last;
+            a[i].max_end = Max(a[i].max, Max(left, right));
+        }
+        last_i = ((last_i >> k) & 1) ? last_i - x : last_i + x;
+        if (last_i < n && a[last_i].max_end > last) {
+            last = a[last_i].max_end;
+        }
+    }
+    tree->levels = k - 1;
+}
+
+// NOTE(ryl1k): Drops tombstones, sorts the pending entries by min and
+// merges them in from the back, then re-indexes.
+function B32 interval_tree_flush(IntervalTree* tree) {
+    U32 live = 0;
+    for (U32 i = 0; i < tree->count; i++) {
+        if (!tree->entries[i].removed) {
+            tree->entries[live++] = tree->entries[i];
+        }
+    }
+    tree->count = live;
+    tree->removed_count = 0;
+    U32 p = tree->pending_count;
+    if (p) {
+        if (!interval_tree_reserve(tree, &tree->entries, &tree->capacity, tree->count, (U64)live + p)) {
+            interval_tree_index(tree);
+            return 0;
+        }
+        SortScratch s;
+        U64* keys = sort_scratch_begin(&s, tree->arena, (U64)p * (sizeof(U64) + sizeof(U32) + sizeof(IntervalEntry)) + 8);
+        if (!keys) {
+            interval_tree_index(tree);
+            return 0;
+        }
+        U32* order = (U32*)(keys + p);
+        IntervalEntry* sorted = (IntervalEntry*)ALIGN_PTR(order + p, 8);
+        for (U32 i = 0; i < p; i++) {
+            keys[i] = tree->pending[i].min;
+        }
+        if (!radix_sort_index_U64(keys, p, order, tree->arena)) {
+            sort_scratch_end(&s);
+            interval_tree_index(tree);
+            return 0;
+        }
+        for (U32 i = 0; i < p; i++) {
+            sorted[i] = tree->pending[order[i]];
+        }
+        U64 i = live;
+        U64 j = p;
+        U64 w = (U64)live + p;
+        while (j) {
+            if (i && tree->entries[i - 1].min > sorted[j - 1].min) {
+                tree->entries[--w] = tree->entries[--i];
+            } else {
+                tree->entries[--w] = sorted[--j];
+            }
+        }
+        sort_scratch_end(&s);
+        tree->count = live + p;
+        tree->pending_count = 0;
+    }
+    interval_tree_index(tree);
+    return 1;
+}
+
+function B32 interval_tree_build(IntervalTree* tree, const I1U64* ranges_u64, const I1F32* ranges_f32, U32 count) {
+    tree->count = tree->pending_count = tree->removed_count = tree->levels = 0;
+    tree->is_f32 = ranges_f32 != 0;
+    if (!interval_tree_reserve(tree, &tree->entries, &tree->capacity, 0, count)) {
+        return 0;
+    }
+    SortScratch s;
+    U64* keys = sort_scratch_begin(&s, tree->arena, (U64)count * (sizeof(U64) + sizeof(U32)) + 1);
+    if (!keys) {
+        return 0;
+    }
+    U32* order = (U32*)(keys + count);
+    for (U32 i = 0; i < count; i++) {
+        keys[i] = ranges_f32 ? interval_key_F32(ranges_f32[i].min) : ranges_u64[i].min;
+    }
+    B32 ok = radix_sort_index_U64(keys, count, order, tree->arena);
+    if (ok) {
+        for (U32 i = 0; i < count; i++) {
+            U32 at = order[i];
+            IntervalEntry* e = &tree->entries[i];
+            e->min = keys[at];
+            e->max = ranges_f32 ? interval_key_F32(ranges_f32[at].max) : ranges_u64[at].max;
+            e->id = at;
+            e->removed = 0;
+        }
+        tree->count = count;
+        interval_tree_index(tree);
+    }
+    sort_scratch_end(&s);
+    return ok;
+}
+
+function B32 interval_tree_build_I1U64(IntervalTree* tree, const I1U64* ranges, U32 count) {
+    return interval_tree_build(tree, ranges, 0, count);
+}
+
+function B32 interval_tree_build_I1F32(IntervalTree* tree, const I1F32* ranges, U32 count) {
+    return interval_tree_build(tree, 0, ranges, count);
+}
+
+function B32 interval_tree_insert(IntervalTree* tree, I1U64 range, U32 id) {
+    if (!interval_tree_reserve(tree, &tree->pending, &tree->pending_capacity, tree->pending_count, (U64)tree->pending_count + 1)) {
+        return 0;
+    }
+    IntervalEntry* e = &tree->pending[tree->pending_count++];
+    e->min = range.min;
+    e->max = range.max;
+    e->max_end = range.max;
+    e->id = id;
+    e->removed = 0;
+    if (tree->pending_count > Max(64, (U32)sqrt((F64)tree->count))) {
+        interval_tree_flush(tree);
+    }
+    return 1;
+}
+
+function B32 interval_tree_insert_I1U64(IntervalTree* tree, I1U64 range, U32 id) {
+    Assert(!tree->is_f32 || !(tree->count + tree->pending_count));
+    tree->is_f32 = 0;
+    return interval_tree_insert(tree, range, id);
+}
+
+function B32 interval_tree_insert_I1F32(IntervalTree* tree, I1F32 range, U32 id) {
+    Assert(tree->is_f32 || !(tree->count + tree->pending_count));
+    tree->is_f32 = 1;
+    return interval_tree_insert(tree, interval_range_F32(range), id);
+}
+
+function B32 interval_tree_remove(IntervalTree* tree, I1U64 range, U32 id) {
+    for (U32 i = 0; i < tree->pending_count; i++) {
+        IntervalEntry* e = &tree->pending[i];
+        if (e->id == id && e->min == range.min && e->max == range.max) {
+            *e = tree->pending[--tree->pending_count];
+            return 1;
+        }
+    }
+    U32 lo = 0;
+    U32 hi = tree->count;
+    while (lo < hi) {
+        U32 mid = lo + (hi - lo) / 2;
+        if (tree->entries[mid].min < range.min) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    for (U32 i = lo; i < tree->count && tree->entries[i].min == range.min; i++) {
+        IntervalEntry* e = &tree->entries[i];
+        if (!e->removed && e->id == id && e->max == range.max) {
+            e->removed = 1;
+            tree->removed_count++;
+            if (2 * (U64)tree->removed_count > tree->count) {
+                interval_tree_flush(tree);
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+function B32 interval_tree_remove_I1U64(IntervalTree* tree, I1U64 range, U32 id) {
+    Assert(!tree->is_f32 || !(tree->count + tree->pending_count));
+    return interval_tree_remove(tree, range, id);
+}
+
+function B32 interval_tree_remove_I1F32(IntervalTree* tree, I1F32 range, U32 id) {
+    Assert(tree->is_f32 || !(tree->count + tree->pending_count));
+    return interval_tree_remove(tree, interval_range_F32(range), id);
+}
+
+// NOTE(ryl1k): Top-down walk of the implicit tree; a left subtree is
+// skipped when its max_end cannot reach the query, a right subtree once
+// the node's min is past it, and subtrees of height <= 3 are scanned.
+function U32 interval_tree_query(const IntervalTree* tree, U64 min, U64 max, U32* out, U32 max_out) {
+    U32 hits = 0;
+    const IntervalEntry* a = tree->entries;
+    U64 n = tree->count;
+    if (n) {
+        struct { U64 x; U32 k; B32 right; } stack[64];
+        U32 top = 0;
+        stack[top].x = (1llu << tree->levels) - 1;
+        stack[top].k = tree->levels;
+        stack[top].right = 0;
+        top++;
+        while (top) {
+            top--;
+            U64 x = stack[top].x;
+            U32 k = stack[top].k;
+            if (k <= 3) {
+                U64 i0 = x >> k << k;
+                U64 i1 = Min(i0 + (1llu << (k + 1)) - 1, n);
+                for (U64 i = i0; i < i1 && a[i].min < max; i++) {
+                    if (min < a[i].max && !a[i].removed) {
+                        if (hits < max_out) {
+                            out[hits] = a[i].id;
+                        }
+                        hits++;
+                    }
+                }
+            } else if (!stack[top].right) {
+                U64 left = x - (1llu << (k - 1));
+                stack[top].right = 1;
+                top++;
+                if (left >= n || a[left].max_end > min) {
+                    stack[top].x = left;
+                    stack[top].k = k - 1;
+                    stack[top].right = 0;
+                    top++;
+                }
+            } else if (x < n && a[x].min < max) {
+                if (min < a[x].max && !a[x].removed) {
+                    if (hits < max_out) {
+                        out[hits] = a[x].id;
+                    }
+                    hits++;
+                }
+                stack[top].x = x + (1llu << (k - 1));
+                stack[top].k = k - 1;
+                stack[top].right = 0;
+                top++;
+            }
+        }
+    }
+    for (U32 i = 0; i < tree->pending_count; i++) {
+        const IntervalEntry* e = &tree->pending[i];
+        if (e->min < max && min < e->max) {
+            if (hits < max_out) {
+                out[hits] = e->id;
+            }
+            hits++;
+        }
+    }
+    return hits;
+}
+
+function U32 interval_tree_query_I1U64(const IntervalTree* tree, I1U64 range, U32* out, U32 max_out) {
+    Assert(!tree->is_f32 || !(tree->count + tree->pending_count));
+    return interval_tree_query(tree, range.min, range.max, out, max_out);
+}
+
+function U32 interval_tree_query_I1F32(const IntervalTree* tree, I1F32 range, U32* out, U32 max_out) {
+    Assert(tree->is_f32 || !(tree->count + tree->pending_count));
+    I1U64 keys = interval_range_F32(range);
+    return interval_tree_query(tree, keys.min, keys.max, out, max_out);
+}
+
+// NOTE(ryl1k): min <= x < max is the overlap test against [x, x + 1).
+function U32 interval_tree_stab_U64(const IntervalTree* tree, U64 x, U32* out, U32 max_out) {
+    Assert(!tree->is_f32 || !(tree->count + tree->pending_count));
+    return (x == max_U64) ? 0 : interval_tree_query(tree, x, x + 1, out, max_out);
+}
+
+function U32 interval_tree_stab_F32(const IntervalTree* tree, F32 x, U32* out, U32 max_out) {
+    Assert(tree->is_f32 || !(tree->count + tree->pending_count));
+    U64 key = interval_key_F32(x);
+    return interval_tree_query(tree, key, key + 1, out, max_out);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Interval Set
+
+function IntervalSet interval_set_create(Arena* arena) {
+    IntervalSet set;
+    MemoryZeroStruct(&set);
+    set.arena = arena;
+    return set;
+}
+
+function void interval_set_destroy(IntervalSet* set) {
+    if (!set->arena && set->ranges) {
+        BASE_FREE(set->ranges);
+    }
+    MemoryZeroStruct(set);
+}
+
+function void interval_set_clear(IntervalSet* set) {
+    set->count = 0;
+}
+
+function B32 interval_set_reserve(IntervalSet* set, U64 needed) {
+    if (needed <= set->capacity) {
+        return 1;
+    }
+    U64 new_capacity = set->capacity ? set->capacity * 2 : 16;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    I1U64* ranges = array_grow(set->arena, set->ranges, set->count, set->capacity, new_capacity, sizeof(I1U64));
+    if (!ranges) {
+        return 0;
+    }
+    set->ranges = ranges;
+    set->capacity = new_capacity;
+    return 1;
+}
+
+// NOTE(ryl1k): First range whose opl is above x (strict) or at least x.
+function U64 interval_set_search(const IntervalSet* set, U64 x, B32 inclusive) {
+    U64 lo = 0;
+    U64 hi = set->count;
+    while (lo < hi) {
+        U64 mid = lo + (hi - lo) / 2;
+        U64 opl = set->ranges[mid].opl;
+        if (opl < x || (opl == x && !inclusive)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// NOTE(ryl1k): Replaces ranges [i, j) with the given ones.
+function B32 interval_set_splice(IntervalSet* set, U64 i, U64 j, const I1U64* ranges, U64 count) {
+    U64 new_count = set->count - (j - i) + count;
+    if (!interval_set_reserve(set, Max(new_count, 1))) {
+        return 0;
+    }
+    MemoryCopy(set->ranges + i + count, set->ranges + j, (set->count - j) * sizeof(I1U64));
+    MemoryCopy(set->ranges + i, ranges, count * sizeof(I1U64));
+    set->count = new_count;
+    return 1;
+}
+
+function B32 interval_set_add(IntervalSet* set, I1U64 range) {
+    if (range.first >= range.opl) {
+        return 1;
+    }
+    U64 i = interval_set_search(set, range.first, 1);
+    U64 j = i;
+    while (j < set->count && set->ranges[j].first <= range.opl) {
+        j++;
+    }
+    I1U64 merged = range;
+    if (j > i) {
+        merged.first = Min(merged.first, set->ranges[i].first);
+        merged.opl = Max(merged.opl, set->ranges[j - 1].opl);
+    }
+    return interval_set_splice(set, i, j, &merged, 1);
+}
+
+function B32 interval_set_subtract(IntervalSet* set, I1U64 range) {
+    if (range.first >= range.opl) {
+        return 1;
+    }
+    U64 i = interval_set_search(set, range.first, 0);
+    U64 j = i;
+    while (j < set->count && set->ranges[j].first < range.opl) {
+        j++;
+    }
+    if (i == j) {
+        return 1;
+    }
+    I1U64 rest[2];
+    U64 count = 0;
+    if (set->ranges[i].first < range.first) {
+        rest[count].first = set->ranges[i].first;
+        rest[count].opl = range.first;
+        count++;
+    }
+    if (set->ranges[j - 1].opl > range.opl) {
+        rest[count].first = range.opl;
+        rest[count].opl = set->ranges[j - 1].opl;
+        count++;
+    }
+    return interval_set_splice(set, i, j, rest, count);
+}
+
+function void interval_set_intersect(IntervalSet* set, I1U64 range) {
+    if (range.first >= range.opl) {
+        set->count = 0;
+        return;
+    }
+    U64 i = interval_set_search(set, range.first, 0);
+    U64 j = i;
+    while (j < set->count && set->ranges[j].first < range.opl) {
+        j++;
+    }
+    if (i < j) {
+        MemoryCopy(set->ranges, set->ranges + i, (j - i) * sizeof(I1U64));
+    }
+    set->count = j - i;
+    if (set->count) {
+        set->ranges[0].first = Max(set->ranges[0].first, range.first);
+        set->ranges[set->count - 1].opl = Min(set->ranges[set->count - 1].opl, range.opl);
+    }
+}
+
+function void interval_set_append(IntervalSet* out, U64 first, U64 opl) {
+    if (first >= opl) {
+        return;
+    }
+    if (out->count && out->ranges[out->count - 1].opl >= first) {
+        I1U64* last = &out->ranges[out->count - 1];
+        last->opl = Max(last->opl, opl);
+        return;
+    }
+    out->ranges[out->count].first = first;
+    out->ranges[out->count].opl = opl;
+    out->count++;
+}
+
+function B32 interval_set_union(IntervalSet* out, const IntervalSet* a, const IntervalSet* b) {
+    Assert(out != a && out != b);
+    out->count = 0;
+    if (!interval_set_reserve(out, a->count + b->count)) {
+        return 0;
+    }
+    U64 i = 0;
+    U64 j = 0;
+    while (i < a->count || j < b->count) {
+        B32 take_a = j == b->count || (i < a->count && a->ranges[i].first <= b->ranges[j].first);
+        I1U64 r = take_a ? a->ranges[i++] : b->ranges[j++];
+        interval_set_append(out, r.first, r.opl);
+    }
+    return 1;
+}
+
+function B32 interval_set_difference(IntervalSet* out, const IntervalSet* a, const IntervalSet* b) {
+    Assert(out != a && out != b);
+    out->count = 0;
+    if (!interval_set_reserve(out, a->count + b->count)) {
+        return 0;
+    }
+    U64 j = 0;
+    for (U64 i = 0; i < a->count; i++) {
+        U64 first = a->ranges[i].first;
+        U64 opl = a->ranges[i].opl;
+        while (j < b->count && b->ranges[j].opl <= first) {
+            j++;
+        }
+        for (U64 k = j; k < b->count && b->ranges[k].first < opl; k++) {
+            interval_set_append(out, first, b->ranges[k].first);
+            first = Max(first, b->ranges[k].opl);
+        }
+        interval_set_append(out, first, opl);
+    }
+    return 1;
+}
+
+function B32 interval_set_intersection(IntervalSet* out, const IntervalSet* a, const IntervalSet* b) {
+    Assert(out != a && out != b);
+    out->count = 0;
+    if (!interval_set_reserve(out, a->count + b->count)) {
+        return 0;
+    }
+    U64 i = 0;
+    U64 j = 0;
+    while (i < a->count && j < b->count) {
+        I1U64 x = a->ranges[i];
+        I1U64 y = b->ranges[j];
+        interval_set_append(out, Max(x.first, y.first), Min(x.opl, y.opl));
+        if (x.opl < y.opl) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+    return 1;
+}
+
+function U64 interval_set_find(const IntervalSet* set, U64 x) {
+    U64 i = interval_set_search(set, x, 0);
+    return (i < set->count && set->ranges[i].first <= x) ? i : max_U64;
+}
+
+function B32 interval_set_contains(const IntervalSet* set, U64 x) {
+    return interval_set_find(set, x) != max_U64;
+}
+
+function B32 interval_set_overlaps(const IntervalSet* set, I1U64 range) {
+    if (range.first >= range.opl) {
+        return 0;
+    }
+    U64 i = interval_set_search(set, range.first, 0);
+    return i < set->count && set->ranges[i].first < range.opl;
+}
+
+function U64 interval_set_total(const IntervalSet* set) {
+    U64 total = 0;
+    for (U64 i = 0; i < set->count; i++) {
+        total += set->ranges[i].opl - set->ranges[i].first;
+    }
+    return total;
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Random Functions
+
+function U64 random_rotl_U64(U64 x, U32 k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+function U64 splitmix64_next(U64* state) {
+    U64 z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+#define PCG32_MULTIPLIER 6364136223846793005ull
+
+// NOTE(ryl1k): Same seeding as the reference pcg32_srandom_r, so (42, 54)
+// gives the published sequence.
+function PCG32 pcg32_seed(U64 seed, U64 stream) {
+    PCG32 rng;
+    rng.state = 0;
+    rng.inc = (stream << 1) | 1;
+    pcg32_next(&rng);
+    rng.state += seed;
+    pcg32_next(&rng);
+    return rng;
+}
+
+function U32 pcg32_next(PCG32* rng) {
+    U64 old = rng->state;
+    rng->state = old * PCG32_MULTIPLIER + rng->inc;
+    U32 xorshifted = (U32)(((old >> 18) ^ old) >> 27);
+    U32 rot = (U32)(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31));
+}
+
+// NOTE(ryl1k): Lemire's multiply-shift; retries only for the low product
+// values that would bias the result.
+function U32 pcg32_bounded(PCG32* rng, U32 bound) {
+    U64 m = (U64)pcg32_next(rng) * bound;
+    U32 low = (U32)m;
+    if (low < bound) {
+        U32 threshold = (0u - bound) % bound;
+        while (low < threshold) {
+            m = (U64)pcg32_next(rng) * bound;
+            low = (U32)m;
+        }
+    }
+    return (U32)(m >> 32);
+}
+
+function F32 pcg32_F32(PCG32* rng) {
+    return (F32)(pcg32_next(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+// NOTE(ryl1k): Composes delta LCG steps by repeated squaring (Brown,
+// "Random Number Generation with Arbitrary Strides").
+function void pcg32_advance(PCG32* rng, U64 delta) {
+    U64 cur_mult = PCG32_MULTIPLIER;
+    U64 cur_plus = rng->inc;
+    U64 acc_mult = 1;
+    U64 acc_plus = 0;
+    while (delta > 0) {
+        if (delta & 1) {
+            acc_mult *= cur_mult;
+            acc_plus = acc_plus * cur_mult + cur_plus;
+        }
+        cur_plus = (cur_mult + 1) * cur_plus;
+        cur_mult *= cur_mult;
+        delta >>= 1;
+    }
+    rng->state = acc_mult * rng->state + acc_plus;
+}
+
+function Xoshiro256 xoshiro256_seed(U64 seed) {
+    Xoshiro256 rng;
+    for (U32 i = 0; i < 4; i++) {
+        rng.s[i] = splitmix64_next(&seed);
+    }
+    return rng;
+}
+
+function U64 xoshiro256_next(Xoshiro256* rng) {
+    U64* s = rng->s;
+    U64 result = random_rotl_U64(s[1] * 5, 7) * 9;
+    U64 t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = random_rotl_U64(s[3], 45);
+    return result;
+}
+
+function U64 xoshiro256_bounded(Xoshiro256* rng, U64 bound) {
+    U64 low;
+    U64 high = mul_U64_hi_lo(xoshiro256_next(rng), bound, &low);
+    if (low < bound) {
+        U64 threshold = (0ull - bound) % bound;
+        while (low < threshold) {
+            high = mul_U64_hi_lo(xoshiro256_next(rng), bound, &low);
+        }
+    }
+    return high;
+}
+
+function F32 xoshiro256_F32(Xoshiro256* rng) {
+    return (F32)(xoshiro256_next(rng) >> 40) * (1.0f / 16777216.0f);
+}
+
+function F64 xoshiro256_F64(Xoshiro256* rng) {
+    return (F64)(xoshiro256_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+function void xoshiro256_jump_by(Xoshiro256* rng, const U64* polynomial) {
+    U64 s[4] = {0, 0, 0, 0};
+    for (U32 i = 0; i < 4; i++) {
+        for (U32 b = 0; b < 64; b++) {
+            if (polynomial[i] & (1ull << b)) {
+                s[0] ^= rng->s[0];
+                s[1] ^= rng->s[1];
+                s[2] ^= rng->s[2];
+                s[3] ^= rng->s[3];
+            }
+            xoshiro256_next(rng);
+        }
+    }
+    MemoryCopy(rng->s, s, sizeof(s));
+}
+
+function void xoshiro256_jump(Xoshiro256* rng) {
+    local const U64 jump[4] = {0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull};
+    xoshiro256_jump_by(rng, jump);
+}
+
+function void xoshiro256_long_jump(Xoshiro256* rng) {
+    local const U64 long_jump[4] = {0x76e15d3efefdcbbfull, 0xc5004e441c522fb3ull, 0x77710069854ee241ull, 0x39109bb02acbe635ull};
+    xoshiro256_jump_by(rng, long_jump);
+}
+
+function Xoshiro256 xoshiro256_split(Xoshiro256* rng) {
+    Xoshiro256 result = *rng;
+    xoshiro256_jump(rng);
+    return result;
+}
+
+function RandomBulk random_bulk_seed(Xoshiro256* source) {
+    RandomBulk rng;
+    for (U32 l = 0; l < RANDOM_LANES; l++) {
+        for (U32 i = 0; i < 4; i++) {
+            rng.s[i][l] = source->s[i];
+        }
+        xoshiro256_jump(source);
+    }
+    return rng;
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Bulk Kernels
+
+// NOTE(ryl1k): A level P supplies a vector of P##_N U64 lanes (P##_VT),
+// 64-bit lane ops and stores that turn one vector of outputs into U64,
+// F32 or F64 values.
+// The multiplies by 5 and 9 are shift-adds: SSE2/AVX2 have no 64-bit
+// multiply.
+#define RANDOM_STEP(P, s0, s1, s2, s3, result) do { \
+    P##_VT m5_ = P##_ADD(P##_SHL(s1, 2), s1); \
+    P##_VT r7_ = P##_OR(P##_SHL(m5_, 7), P##_SHR(m5_, 57)); \
+    result = P##_ADD(P##_SHL(r7_, 3), r7_); \
+    P##_VT t_ = P##_SHL(s1, 17); \
+    s2 = P##_XOR(s2, s0); \
+    s3 = P##_XOR(s3, s1); \
+    s1 = P##_XOR(s1, s2); \
+    s0 = P##_XOR(s0, s3); \
+    s2 = P##_XOR(s2, t_); \
+    s3 = P##_OR(P##_SHL(s3, 45), P##_SHR(s3, 19)); \
+} while (0)
+
+// NOTE(ryl1k): i is the index of the first U64 lane of the vector; an F32
+// store writes two floats per lane (low half first). The integer store
+// has no range, so it only marks min and scale used.
+#define RANDOM_STORE_U64(P, out, i, r, min, scale) do { \
+    (void)(min); \
+    (void)(scale); \
+    P##_STORE((U64*)(out) + (i), r); \
+} while (0)
+#define RANDOM_STORE_F32(P, out, i, r, min, scale) P##_STORE_F32((F32*)(out) + 2 * (i), r, (F32)(min), (F32)(scale))
+#define RANDOM_STORE_F64(P, out, i, r, min, scale) P##_STORE_F64((F64*)(out) + (i), r, min, scale)
+
+// NOTE(ryl1k): Groups run one after another over a chunk of steps that
+// fits in L1, so each group's state stays in registers; one xoshiro chain
+// already keeps the vector units busy.
+#define RANDOM_CHUNK_STEPS 256
+
+#define RANDOM_KERNEL_DEFINE(P, suffix, T, STORE) \
+P##_TARGET function void random_fill_##T##_##suffix(RandomBulk* rng, void* out, U64 steps, F64 min, F64 scale) { \
+    for (U64 first = 0; first < steps; first += RANDOM_CHUNK_STEPS) { \
+        U64 last = Min(first + RANDOM_CHUNK_STEPS, steps); \
+        for (U32 lane = 0; lane < RANDOM_LANES; lane += P##_N) { \
+            P##_VT s0 = P##_LOAD(rng->s[0] + lane); \
+            P##_VT s1 = P##_LOAD(rng->s[1] + lane); \
+            P##_VT s2 = P##_LOAD(rng->s[2] + lane); \
+            P##_VT s3 = P##_LOAD(rng->s[3] + lane); \
+            for (U64 t = first; t < last; t++) { \
+                P##_VT r; \
+                RANDOM_STEP(P, s0, s1, s2, s3, r); \
+                STORE(P, out, t * RANDOM_LANES + lane, r, min, scale); \
+            } \
+            P##_STORE(rng->s[0] + lane, s0); \
+            P##_STORE(rng->s[1] + lane, s1); \
+            P##_STORE(rng->s[2] + lane, s2); \
+            P##_STORE(rng->s[3] + lane, s3); \
+        } \
+    } \
+}
+
+#define RANDOM_KERNELS_DEFINE(P, suffix) \
+RANDOM_KERNEL_DEFINE(P, suffix, U64, RANDOM_STORE_U64) \
+RANDOM_KERNEL_DEFINE(P, suffix, F32, RANDOM_STORE_F32) \
+RANDOM_KERNEL_DEFINE(P, suffix, F64, RANDOM_STORE_F64)
+
+// NOTE(ryl1k): U32 fills store U64s at 4-byte alignment, hence MemoryCopy.
+#define RANDOM_F64_ONE_BITS 0x3ff0000000000000ull
+
+function void random_store_U64_scalar(U64* p, U64 v) {
+    MemoryCopy(p, &v, sizeof(v));
+}
+
+function void random_store_F64_scalar(F64* p, U64 r, F64 min, F64 scale) {
+    U64 bits = (r >> 12) | RANDOM_F64_ONE_BITS;
+    F64 d;
+    MemoryCopy(&d, &bits, sizeof(d));
+    p[0] = (d - 1.0) * scale + min;
+}
+
+#define RANDOM_SCALAR_TARGET
+#define RANDOM_SCALAR_VT                      U64
+#define RANDOM_SCALAR_N                       1
+#define RANDOM_SCALAR_LOAD(p)                 (*(p))
+#define RANDOM_SCALAR_STORE(p, v)             random_store_U64_scalar(p, v)
+#define RANDOM_SCALAR_ADD(a, b)               ((a) + (b))
+#define RANDOM_SCALAR_XOR(a, b)               ((a) ^ (b))
+#define RANDOM_SCALAR_OR(a, b)                ((a) | (b))
+#define RANDOM_SCALAR_SHL(a, n)               ((a) << (n))
+#define RANDOM_SCALAR_SHR(a, n)               ((a) >> (n))
+#define RANDOM_SCALAR_STORE_F32(p, r, min, k) do { \
+    (p)[0] = (F32)((U32)(r) >> 8) * (k) + (min); \
+    (p)[1] = (F32)((U32)((r) >> 32) >> 8) * (k) + (min); \
+} while (0)
+#define RANDOM_SCALAR_STORE_F64(p, r, min, scale) random_store_F64_scalar(p, r, min, scale)
+
+RANDOM_KERNELS_DEFINE(RANDOM_SCALAR, scalar)
+
+#if defined(CPU_X86)
+#define RANDOM_SSE2_TARGET
+#define RANDOM_SSE2_VT                      __m128i
+#define RANDOM_SSE2_N                       2
+#define RANDOM_SSE2_LOAD(p)                 _mm_loadu_si128((const __m128i*)(p))
+#define RANDOM_SSE2_STORE(p, v)             _mm_storeu_si128((__m128i*)(p), v)
+#define RANDOM_SSE2_ADD(a, b)               _mm_add_epi64(a, b)
+#define RANDOM_SSE2_XOR(a, b)               _mm_xor_si128(a, b)
+#define RANDOM_SSE2_OR(a, b)                _mm_or_si128(a, b)
+#define RANDOM_SSE2_SHL(a, n)               _mm_slli_epi64(a, n)
+#define RANDOM_SSE2_SHR(a, n)               _mm_srli_epi64(a, n)
+#define RANDOM_SSE2_STORE_F32(p, r, min, k) \
+    _mm_storeu_ps(p, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(r, 8)), _mm_set1_ps(k)), _mm_set1_ps(min)))
+#define RANDOM_SSE2_STORE_F64(p, r, min, scale) \
+    _mm_storeu_pd(p, _mm_add_pd(_mm_mul_pd(_mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(r, 12), \
+        _mm_set1_epi64x((S64)RANDOM_F64_ONE_BITS))), _mm_set1_pd(1.0)), _mm_set1_pd(scale)), _mm_set1_pd(min)))
+
+#define RANDOM_AVX2_TARGET                  TARGET_AVX2
+#define RANDOM_AVX2_VT                      __m256i
+#define RANDOM_AVX2_N                       4
+#define RANDOM_AVX2_LOAD(p)                 _mm256_loadu_si256((const __m256i*)(p))
+#define RANDOM_AVX2_STORE(p, v)             _mm256_storeu_si256((__m256i*)(p), v)
+#define RANDOM_AVX2_ADD(a, b)               _mm256_add_epi64(a, b)
+#define RANDOM_AVX2_XOR(a, b)               _mm256_xor_si256(a, b)
+#define RANDOM_AVX2_OR(a, b)                _mm256_or_si256(a, b)
+#define RANDOM_AVX2_SHL(a, n)               _mm256_slli_epi64(a, n)
+#define RANDOM_AVX2_SHR(a, n)               _mm256_srli_epi64(a, n)
+#define RANDOM_AVX2_STORE_F32(p, r, min, k) \
+    _mm256_storeu_ps(p, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(r, 8)), _mm256_set1_ps(k)), _mm256_set1_ps(min)))
+#define RANDOM_AVX2_STORE_F64(p, r, min, scale) \
+    _mm256_storeu_pd(p, _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(r, 12), \
+        _mm256_set1_epi64x((S64)RANDOM_F64_ONE_BITS))), _mm256_set1_pd(1.0)), _mm256_set1_pd(scale)), _mm256_set1_pd(min)))
+
+RANDOM_KERNELS_DEFINE(RANDOM_SSE2, sse2)
+RANDOM_KERNELS_DEFINE(RANDOM_AVX2, avx2)
+#elif defined(CPU_ARM64)
+#define RANDOM_NEON_TARGET
+#define RANDOM_NEON_VT                      uint64x2_t
+#define RANDOM_NEON_N                       2
+#define RANDOM_NEON_LOAD(p)                 vld1q_u64(p)
+#define RANDOM_NEON_STORE(p, v)             vst1q_u64((U64*)(p), v)
+#define RANDOM_NEON_ADD(a, b)               vaddq_u64(a, b)
+#define RANDOM_NEON_XOR(a, b)               veorq_u64(a, b)
+#define RANDOM_NEON_OR(a, b)                vorrq_u64(a, b)
+#define RANDOM_NEON_SHL(a, n)               vshlq_n_u64(a, n)
+#define RANDOM_NEON_SHR(a, n)               vshrq_n_u64(a, n)
+#define RANDOM_NEON_STORE_F32(p, r, min, k) \
+    vst1q_f32(p, vaddq_f32(vmulq_f32(vcvtq_f32_u32(vshrq_n_u32(vreinterpretq_u32_u64(r), 8)), vdupq_n_f32(k)), vdupq_n_f32(min)))
+#define RANDOM_NEON_STORE_F64(p, r, min, scale) \
+    vst1q_f64(p, vaddq_f64(vmulq_f64(vsubq_f64(vreinterpretq_f64_u64(vorrq_u64(vshrq_n_u64(r, 12), \
+        vdupq_n_u64(RANDOM_F64_ONE_BITS))), vdupq_n_f64(1.0)), vdupq_n_f64(scale)), vdupq_n_f64(min)))
+
+RANDOM_KERNELS_DEFINE(RANDOM_NEON, neon)
+#endif
+
+typedef void RandomKernel(RandomBulk* rng, void* out, U64 steps, F64 min, F64 scale);
+
+typedef struct {
+    RandomKernel* fill_U64;
+    RandomKernel* fill_F32;
+    RandomKernel* fill_F64;
+} RandomKernels;
+
+#define RANDOM_KERNELS(suffix) { random_fill_U64_##suffix, random_fill_F32_##suffix, random_fill_F64_##suffix }
+
+global const RandomKernels random_kernels_scalar = RANDOM_KERNELS(scalar);
+#if defined(CPU_X86)
+global const RandomKernels random_kernels_sse2 = RANDOM_KERNELS(sse2);
+global const RandomKernels random_kernels_avx2 = RANDOM_KERNELS(avx2);
+#elif defined(CPU_ARM64)
+global const RandomKernels random_kernels_neon = RANDOM_KERNELS(neon);
+#endif
+
+// NOTE(ryl1k): Follows simd_select_level like math_kernels_get.
+function const RandomKernels* random_kernels_get(void) {
+    switch (simd_current_level()) {
+#if defined(CPU_X86)
+        case SIMDLevel_SSE2: return &random_kernels_sse2;
+        case SIMDLevel_AVX2: return &random_kernels_avx2;
+        case SIMDLevel_AVX512: return &random_kernels_avx2;
+#elif defined(CPU_ARM64)
+        case SIMDLevel_NEON: return &random_kernels_neon;
+#endif
+        default: return &random_kernels_scalar;
+    }
+}
+
+// NOTE(ryl1k): Whole steps go straight to out; a partial last step is
+// generated into a local block and the needed prefix copied.
+function void random_fill_steps(RandomBulk* rng, RandomKernel* kernel, void* out, U64 count, U64 size, U64 per_step, F64 min, F64 scale) {
+    U64 steps = count / per_step;
+    kernel(rng, out, steps, min, scale);
+    U64 done = steps * per_step;
+    if (done < count) {
+        U64 block[RANDOM_LANES];
+        kernel(rng, block, 1, min, scale);
+        MemoryCopy((U8*)out + done * size, block, (count - done) * size);
+    }
+}
+
+function void random_fill_U32(RandomBulk* rng, U32* out, U64 count) {
+    random_fill_steps(rng, random_kernels_get()->fill_U64, out, count, sizeof(U32), 2 * RANDOM_LANES, 0.0, 0.0);
+}
+
+function void random_fill_U64(RandomBulk* rng, U64* out, U64 count) {
+    random_fill_steps(rng, random_kernels_get()->fill_U64, out, count, sizeof(U64), RANDOM_LANES, 0.0, 0.0);
+}
+
+// NOTE(ryl1k): The 24-bit integer is scaled by (max - min) / 2^24 in one
+// multiply; the power-of-two factor keeps that exact.
+function void random_fill_F32(RandomBulk* rng, F32* out, U64 count, F32 min, F32 max) {
+    F32 k = (max - min) * (1.0f / 16777216.0f);
+    random_fill_steps(rng, random_kernels_get()->fill_F32, out, count, sizeof(F32), 2 * RANDOM_LANES, min, k);
+}
+
+function void random_fill_F64(RandomBulk* rng, F64* out, U64 count, F64 min, F64 max) {
+    random_fill_steps(rng, random_kernels_get()->fill_F64, out, count, sizeof(F64), RANDOM_LANES, min, max - min);
+}
+
+// NOTE(ryl1k): Points are filled with [0, 1) a chunk at a time and scaled
+// per axis while the chunk is still in cache. Chunks are whole steps, so
+// no values are dropped between them.
+#define RANDOM_POINT_CHUNK 1024
+
+function void random_fill_V2F32(RandomBulk* rng, V2F32* out, U64 count, I2F32 box) {
+    F32 w = box.x1 - box.x0;
+    F32 h = box.y1 - box.y0;
+    for (U64 i = 0; i < count; i += RANDOM_POINT_CHUNK) {
+        U64 n = Min(RANDOM_POINT_CHUNK, count - i);
+        V2F32* p = out + i;
+        random_fill_F32(rng, p->v, 2 * n, 0.0f, 1.0f);
+        for (U64 j = 0; j < n; j++) {
+            p[j].x = p[j].x * w + box.x0;
+            p[j].y = p[j].y * h + box.y0;
+        }
+    }
+}
+
+function void random_fill_V3F32(RandomBulk* rng, V3F32* out, U64 count, I2F32 box, I1F32 z) {
+    F32 w = box.x1 - box.x0;
+    F32 h = box.y1 - box.y0;
+    F32 d = z.max - z.min;
+    for (U64 i = 0; i < count; i += RANDOM_POINT_CHUNK) {
+        U64 n = Min(RANDOM_POINT_CHUNK, count - i);
+        V3F32* p = out + i;
+        random_fill_F32(rng, p->v, 3 * n, 0.0f, 1.0f);
+        for (U64 j = 0; j < n; j++) {
+            p[j].x = p[j].x * w + box.x0;
+            p[j].y = p[j].y * h + box.y0;
+            p[j].z = p[j].z * d + z.min;
+        }
+    }
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Job System Functions
+
+thread_static JobWorker* job_current_worker;
+
+function JobWorker* job_worker_get(JobSystem* system) {
+    JobWorker* worker = job_current_worker;
+    return (worker && worker->system == system) ? worker : NULL;
+}
+
+// NOTE(ryl1k): Chase-Lev deque with the fences of Le, Pop, Cohen and
+// Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory
+// Models". top and bottom are free-running. The owner pops by lowering
+// bottom before it reads top, so a thief that read the old bottom either
+// sees its CAS on top fail or has already taken the job; for the last job
+// the owner races the thieves with the same CAS.
+
+function B32 job_deque_push(JobDeque* deque, Job* job) {
+    U64 bottom = deque->bottom;
+    U64 top = atomic_load_U64(&deque->top);
+    if (bottom - top > deque->mask) {
+        return 0;
+    }
+    deque->slots[bottom & deque->mask] = job;
+    atomic_store_U64(&deque->bottom, bottom + 1);
+    return 1;
+}
+
+function Job* job_deque_pop(JobDeque* deque) {
+    U64 bottom = deque->bottom - 1;
+    atomic_exchange_U64(&deque->bottom, bottom);
+    U64 top = atomic_load_U64(&deque->top);
+    if ((S64)(bottom - top) < 0) {
+        atomic_store_U64(&deque->bottom, bottom + 1);
+        return NULL;
+    }
+    Job* job = deque->slots[bottom & deque->mask];
+    if (bottom != top) {
+        return job;
+    }
+    B32 won = atomic_cas_U64(&deque->top, &top, top + 1);
+    atomic_store_U64(&deque->bottom, bottom + 1);
+    return won ? job : NULL;
+}
+
+function Job* job_deque_steal(JobDeque* deque) {
+    U64 top = atomic_load_U64(&deque->top);
+    atomic_fence();
+    U64 bottom = atomic_load_U64(&deque->bottom);
+    if ((S64)(bottom - top) <= 0) {
+        return NULL;
+    }
+    Job* job = deque->slots[top & deque->mask];
+    if (!atomic_cas_U64(&deque->top, &top, top + 1)) {
+        return NULL;
+    }
+    return job;
+}
+
+function B32 job_has_work(JobSystem* system) {
+    if (atomic_load_U64(&system->inbox->enqueue_pos) != atomic_load_U64(&system->inbox->dequeue_pos)) {
+        return 1;
+    }
+    for (U32 i = 0; i < system->worker_count; i++) {
+        JobDeque* deque = &system->workers[i].deque;
+        if ((S64)(atomic_load_U64(&deque->bottom) - atomic_load_U64(&deque->top)) > 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// NOTE(ryl1k): Own deque first, then the inbox, then one pass over the
+// other workers from a random victim.
+function Job* job_find(JobSystem* system, JobWorker* worker) {
+    Job* job = job_deque_pop(&worker->deque);
+    if (job) {
+        return job;
+    }
+    void* data = NULL;
+    if (mpmc_queue_dequeue(system->inbox, &data)) {
+        return data;
+    }
+    U32 count = system->worker_count;
+    if (count > 1) {
+        U32 victim = pcg32_bounded(&worker->rng, count);
+        for (U32 i = 0; i < count; i++) {
+            if (victim != worker->index) {
+                job = job_deque_steal(&system->workers[victim].deque);
+                if (job) {
+                    return job;
+                }
+            }
+            victim = (victim + 1 == count) ? 0 : victim + 1;
+        }
+    }
+    return NULL;
+}
+
+function void job_release(JobSystem* system, JobWorker* worker, Job* job) {
+    if (worker && worker->free_count < JOB_FREE_LOCAL_MAX) {
+        STACK_PUSH(worker->free_jobs, job);
+        worker->free_count++;
+    } else {
+        atomic_stack_push(&system->free_jobs, job);
+    }
+}
+
+// NOTE(ryl1k): parent is read before the decrement, after which a waiter
+// or the last child may release the job; the wake only needs the address.
+function void job_finish(JobSystem* system, JobWorker* worker, Job* job) {
+    while (job) {
+        Job* parent = job->parent;
+        U32 left = atomic_fetch_add_U32(&job->unfinished, (U32)-1) - 1;
+        if (left & ~JOB_WAITING_BIT) {
+            return;
+        }
+        if (!parent) {
+            if (left & JOB_WAITING_BIT) {
+                os_futex_wake(&job->unfinished, 1);
+            }
+            return;
+        }
+        job_release(system, worker, job);
+        job = parent;
+    }
+}
+
+function void job_execute(JobSystem* system, JobWorker* worker, Job* job) {
+    size_t mark = worker->scratch.used;
+    if (job->func) {
+        PROFILE_BEGIN("job");
+        job->func(worker, job, job->data);
+        PROFILE_END();
+    }
+    worker->scratch.used = mark;
+    job_finish(system, worker, job);
+}
+
+function Job* job_alloc(JobSystem* system, JobWorker* worker) {
+    for (;;) {
+        Job* job = NULL;
+        if (worker && worker->free_jobs) {
+            STACK_POP(worker->free_jobs, job);
+            worker->free_count--;
+            return job;
+        }
+        job = atomic_stack_pop(&system->free_jobs);
+        if (job) {
+            return job;
+        }
+        Job* other = worker ? job_find(system, worker) : NULL;
+        if (other) {
+            job_execute(system, worker, other);
+        } else {
+            os_thread_yield();
+        }
+    }
+}
+
+// NOTE(ryl1k): Sleepers and submitters each write, fence, then read the
+// other's side (sleepers count vs queued work), so either the submitter
+// sees the sleeper and bumps epoch, or the sleeper sees the work. A bump
+// between reading epoch and the wait makes the wait return at once.
+function void job_notify(JobSystem* system) {
+    atomic_fence();
+    if (atomic_load_U64(&system->sleepers)) {
+        atomic_fetch_add_U32(&system->epoch, 1);
+        os_futex_wake(&system->epoch, 0);
+    }
+}
+
+function void job_worker_sleep(JobSystem* system) {
+    atomic_fetch_add_U64(&system->sleepers, 1);
+    atomic_fence();
+    U32 epoch = atomic_load_U32(&system->epoch);
+    if (atomic_load_U64(&system->running) && !job_has_work(system)) {
+        os_futex_wait(&system->epoch, epoch);
+    }
+    atomic_fetch_add_U64(&system->sleepers, (U64)-1);
+}
+
+function void job_worker_main(void* param) {
+    JobWorker* worker = param;
+    JobSystem* system = worker->system;
+    job_current_worker = worker;
+#if defined(BASE_PROFILE)
+    char name[32];
+    snprintf(name, sizeof(name), "job worker %u", worker->index);
+    PROFILE_THREAD_NAME(name);
+#endif
+    if (system->pin_workers) {
+        os_thread_pin(worker->index % os_cpu_count());
+    }
+    U32 idle = 0;
+    while (atomic_load_U64(&system->running)) {
+        Job* job = job_find(system, worker);
+        if (job) {
+            job_execute(system, worker, job);
+            idle = 0;
+        } else if (idle < JOB_SPIN_COUNT) {
+            cpu_pause();
+            idle++;
+        } else if (idle < JOB_SPIN_COUNT + JOB_YIELD_COUNT) {
+            os_thread_yield();
+            idle++;
+        } else {
+            job_worker_sleep(system);
+            idle = 0;
+        }
+    }
+}
+
+function JobSystem* job_system_create(Arena* arena, U32 worker_count, U64 scratch_size, B32 pin_workers) {
+    if (!worker_count) {
+        worker_count = os_cpu_count();
+    }
+    // With no background workers one more worker is kept for the guest.
+    U32 slot_count = (worker_count == 1) ? 2 : worker_count;
+    U64 job_count = (U64)worker_count * JOB_POOL_PER_WORKER;
+    U64 bytes = sizeof(JobSystem) + slot_count * sizeof(JobWorker) +
+                slot_count * JOB_DEQUE_CAPACITY * sizeof(Job*) + job_count * sizeof(Job) +
+                slot_count * scratch_size + 5 * CACHE_LINE_SIZE;
+    void* memory = arena ? arena_alloc(arena, bytes) : BASE_ALLOC(bytes);
+    if (!memory) {
+        return NULL;
+    }
+    MPMCQueue* inbox = mpmc_queue_create(arena, JOB_DEQUE_CAPACITY);
+    if (!inbox) {
+        if (!arena) {
+            BASE_FREE(memory);
+        }
+        return NULL;
+    }
+
+    U8* at = ALIGN_PTR(memory, CACHE_LINE_SIZE);
+    JobSystem* system = (JobSystem*)at;
+    at = ALIGN_PTR(at + sizeof(JobSystem), CACHE_LINE_SIZE);
+    MemoryZeroStruct(system);
+    system->workers = (JobWorker*)at;
+    at = ALIGN_PTR(at + slot_count * sizeof(JobWorker), CACHE_LINE_SIZE);
+    Job* volatile* slots = (Job* volatile*)at;
+    at = ALIGN_PTR(at + slot_count * JOB_DEQUE_CAPACITY * sizeof(Job*), CACHE_LINE_SIZE);
+    Job* jobs = (Job*)at;
+    at = ALIGN_PTR(at + job_count * sizeof(Job), CACHE_LINE_SIZE);
+
+    system->worker_count = worker_count;
+    system->pin_workers = pin_workers;
+    system->inbox = inbox;
+    system->memory = memory;
+    system->arena = arena;
+    system->running = 1;
+
+    for (U64 i = 0; i < job_count; i++) {
+        jobs[i].next = (i + 1 < job_count) ? &jobs[i + 1] : NULL;
+    }
+    atomic_stack_init(&system->free_jobs, OffsetOfMember(Job, next));
+    atomic_stack_push_list(&system->free_jobs, &jobs[0], &jobs[job_count - 1]);
+
+    for (U32 i = 0; i < slot_count; i++) {
+        JobWorker* worker = &system->workers[i];
+        MemoryZeroStruct(worker);
+        worker->deque.slots = slots + (U64)i * JOB_DEQUE_CAPACITY;
+        worker->deque.mask = JOB_DEQUE_CAPACITY - 1;
+        worker->system = system;
+        worker->scratch.base = (char*)at + i * scratch_size;
+        worker->scratch.size = scratch_size;
+        worker->scratch.used = 0;
+        worker->index = i;
+        worker->rng = pcg32_seed(0x853c49e6748fea9bull, i);
+    }
+    atomic_fence();
+
+    job_current_worker = &system->workers[0];
+    for (U32 i = 1; i < worker_count; i++) {
+        system->workers[i].thread = os_thread_create(job_worker_main, &system->workers[i]);
+    }
+    return system;
+}
+
+// NOTE(ryl1k): All jobs must be done; queued ones are dropped.
+function void job_system_destroy(JobSystem* system) {
+    if (!system) {
+        return;
+    }
+    atomic_store_U64(&system->running, 0);
+    atomic_fetch_add_U32(&system->epoch, 1);
+    os_futex_wake(&system->epoch, 1);
+    for (U32 i = 1; i < system->worker_count; i++) {
+        os_thread_join(system->workers[i].thread);
+    }
+    if (job_current_worker == &system->workers[0]) {
+        job_current_worker = NULL;
+    }
+    mpmc_queue_destroy(system->inbox);
+    if (!system->arena) {
+        BASE_FREE(system->memory);
+    }
+}
+
+function Job* job_create(JobSystem* system, Job* parent, JobFunc* func, void* data) {
+    JobWorker* worker = job_worker_get(system);
+    Job* job = job_alloc(system, worker);
+    job->func = func;
+    job->data = data;
+    job->parent = parent;
+    job->unfinished = 1;
+    if (parent) {
+        atomic_fetch_add_U32(&parent->unfinished, 1);
+    }
+    return job;
+}
+
+function void job_submit(JobSystem* system, Job* job) {
+    JobWorker* worker = job_worker_get(system);
+    if (worker) {
+        if (!job_deque_push(&worker->deque, job)) {
+            job_execute(system, worker, job);
+            return;
+        }
+    } else {
+        while (!mpmc_queue_enqueue(system->inbox, job)) {
+            os_thread_yield();
+        }
+    }
+    job_notify(system);
+}
+
+// NOTE(ryl1k): Only a system of one worker has a guest. A waiter that
+// finds it taken yields rather than sleeps, so it can take it next.
+function JobWorker* job_guest_acquire(JobSystem* system) {
+    U64 expected = 0;
+    if (!atomic_cas_U64(&system->guest_taken, &expected, 1)) {
+        return NULL;
+    }
+    JobWorker* guest = &system->workers[1];
+    job_current_worker = guest;
+    return guest;
+}
+
+// NOTE(ryl1k): Workers run other jobs while they wait; every waiter spins,
+// yields, then sleeps on the job's count until job_finish wakes it.
+function void job_wait(JobSystem* system, Job* job) {
+    JobWorker* worker = job_worker_get(system);
+    JobWorker* previous = job_current_worker;
+    B32 lone = !worker && system->worker_count == 1;
+    B32 guest = 0;
+    U32 idle = 0;
+    while (!job_is_done(job)) {
+        if (lone && !guest) {
+            worker = job_guest_acquire(system);
+            guest = worker != NULL;
+        }
+        Job* next = worker ? job_find(system, worker) : NULL;
+        if (next) {
+            job_execute(system, worker, next);
+            idle = 0;
+        } else if (idle < JOB_SPIN_COUNT) {
+            cpu_pause();
+            idle++;
+        } else if (idle < JOB_SPIN_COUNT + JOB_YIELD_COUNT || (lone && !guest)) {
+            os_thread_yield();
+            idle++;
+        } else {
+            U32 unfinished = atomic_load_U32(&job->unfinished);
+            if (!(unfinished & JOB_WAITING_BIT)) {
+                unfinished = atomic_fetch_add_U32(&job->unfinished, JOB_WAITING_BIT) + JOB_WAITING_BIT;
+            }
+            if (unfinished & ~JOB_WAITING_BIT) {
+                os_futex_wait(&job->unfinished, unfinished);
+            }
+            idle = 0;
+        }
+    }
+    job_release(system, worker, job);
+    if (guest) {
+        // Nobody steals from the guest, so run the jobs left on its deque.
+        for (Job* left = job_deque_pop(&worker->deque); left; left = job_deque_pop(&worker->deque)) {
+            job_execute(system, worker, left);
+        }
+        job_current_worker = previous;
+        atomic_store_U64(&system->guest_taken, 0);
+    }
+}
+
+function B32 job_is_done(Job* job) {
+    return (atomic_load_U32(&job->unfinished) & ~JOB_WAITING_BIT) == 0;
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Parallel Loops Functions
+
+typedef struct {
+    JobSystem* system;
+    ParallelForFunc* for_func;
+    ParallelReduceFunc* reduce_func;
+    ParallelCombineFunc* combine;
+    void* data;
+    U64 count;
+    U64 grain;
+} ParallelTask;
+
+typedef struct {
+    ParallelTask* task;
+    U64 lo;
+    U64 hi;
+    void* partial;
+} ParallelRange;
+
+// NOTE(ryl1k): lo and hi are chunk indices. An empty deque means the
+// forked half is the only thing a thief could take, so it is worth a job.
+function void parallel_run(JobWorker* worker, ParallelTask* task, U64 lo, U64 hi, void* partial);
+
+function void parallel_job(JobWorker* worker, Job* job, void* data) {
+    (void)job;
+    ParallelRange* range = data;
+    parallel_run(worker, range->task, range->lo, range->hi, range->partial);
+}
+
+function void parallel_run(JobWorker* worker, ParallelTask* task, U64 lo, U64 hi, void* partial) {
+    if (hi - lo == 1) {
+        U64 begin = lo * task->grain;
+        U64 end = Min(begin + task->grain, task->count);
+        if (task->reduce_func) {
+            task->reduce_func(worker, begin, end, task->data, partial);
+        } else {
+            task->for_func(worker, begin, end, task->data);
+        }
+        return;
+    }
+    ALIGN_AS(CACHE_LINE_SIZE) U8 right[PARALLEL_PARTIAL_MAX];
+    U64 mid = lo + (hi - lo) / 2;
+    JobDeque* deque = &worker->deque;
+    if ((S64)(deque->bottom - atomic_load_U64(&deque->top)) <= 0) {
+        ParallelRange range = { task, mid, hi, right };
+        Job* job = job_create(task->system, NULL, parallel_job, &range);
+        job_submit(task->system, job);
+        parallel_run(worker, task, lo, mid, partial);
+        job_wait(task->system, job);
+    } else {
+        parallel_run(worker, task, lo, mid, partial);
+        parallel_run(worker, task, mid, hi, right);
+    }
+    if (task->combine) {
+        task->combine(partial, right, task->data);
+    }
+}
+
+function void parallel_dispatch(ParallelTask* task, void* result) {
+    if (!task->count) {
+        return;
+    }
+    task->grain = parallel_grain(task->count, task->grain);
+    ALIGN_AS(CACHE_LINE_SIZE) U8 total[PARALLEL_PARTIAL_MAX];
+    ParallelRange range = { task, 0, (task->count + task->grain - 1) / task->grain, total };
+    Job* job = job_create(task->system, NULL, parallel_job, &range);
+    job_submit(task->system, job);
+    job_wait(task->system, job);
+    if (task->combine) {
+        task->combine(result, total, task->data);
+    }
+}
+
+function U64 parallel_grain(U64 count, U64 grain) {
+    if (!grain) {
+        grain = Max(count / PARALLEL_MAX_CHUNKS, PARALLEL_MIN_GRAIN);
+        grain = (grain + PARALLEL_GRAIN_ALIGN - 1) & ~(U64)(PARALLEL_GRAIN_ALIGN - 1);
+    }
+    return grain;
+}
+
+function void parallel_for(JobSystem* system, U64 count, U64 grain, ParallelForFunc* func, void* data) {
+    ParallelTask task = { system, func, NULL, NULL, data, count, grain };
+    parallel_dispatch(&task, NULL);
+}
+
+function void parallel_reduce(JobSystem* system, U64 count, U64 grain, U64 partial_size,
+                              ParallelReduceFunc* func, ParallelCombineFunc* combine, void* data, void* result) {
+    Assert(partial_size <= PARALLEL_PARTIAL_MAX);
+    ParallelTask task = { system, NULL, func, combine, data, count, grain };
+    parallel_dispatch(&task, result);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Timer Functions
+
+function U64 timer_ns(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    U64 f = (U64)frequency.QuadPart;
+    U64 c = (U64)counter.QuadPart;
+    return (c / f) * 1000000000ull + (c % f) * 1000000000ull / f;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (U64)ts.tv_sec * 1000000000ull + (U64)ts.tv_nsec;
+#endif
+}
+
+global volatile U64 timer_frequency_cache;
+
+// NOTE(ryl1k): A racing first call from two threads calibrates twice and
+// stores nearly the same value.
+function U64 timer_frequency(void) {
+    U64 frequency = atomic_load_U64(&timer_frequency_cache);
+    if (frequency) {
+        return frequency;
+    }
+#if defined(__aarch64__) && !defined(_MSC_VER)
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(frequency));
+#elif defined(_M_AMD64) || defined(_M_IX86) || defined(_M_ARM64) || defined(__x86_64__) || defined(__i386__)
+    U64 ns0 = timer_ns();
+    U64 ticks0 = timer_ticks();
+    U64 ns1 = ns0;
+    while (ns1 - ns0 < TIMER_CALIBRATION_NS) {
+        ns1 = timer_ns();
+    }
+    U64 ticks1 = timer_ticks();
+    frequency = (U64)((F64)(ticks1 - ticks0) * 1e9 / (F64)(ns1 - ns0));
+#else
+    frequency = 1000000000ull;
+#endif
+    atomic_store_U64(&timer_frequency_cache, frequency);
+    return frequency;
+}
+
+function F64 timer_seconds(U64 ticks) {
+    return (F64)ticks / (F64)timer_frequency();
+}
+
+function U64 timer_ticks_to_ns(U64 ticks) {
+    return (U64)((F64)ticks * 1e9 / (F64)timer_frequency());
+}
+
+// NOTE(ryl1k): Shared by the trace and benchmark exports.
+function void json_write_string(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', file);
+            fputc(*c, file);
+        } else if ((U8)*c < 0x20) {
+            fprintf(file, "\\u%04x", (U8)*c);
+        } else {
+            fputc(*c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+#if defined(BASE_PROFILE)
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Profiler Functions
+
+global ProfileThread* volatile profile_threads;
+global volatile U32 profile_thread_ids;
+thread_static ProfileThread* profile_current;
+
+function ProfileThread* profile_thread_get(void) {
+    ProfileThread* thread = profile_current;
+    if (thread) {
+        return thread;
+    }
+    thread = BASE_ALLOC(sizeof(ProfileThread));
+    ProfileEvent* events = BASE_ALLOC(PROFILE_EVENTS_PER_THREAD * sizeof(ProfileEvent));
+    if (!thread || !events) {
+        fprintf(stderr, "Failed to allocate profile buffer\n");
+        exit(EXIT_FAILURE);
+    }
+    MemoryZeroStruct(thread);
+    thread->events = events;
+    thread->id = atomic_fetch_add_U32(&profile_thread_ids, 1) + 1;
+    void* head = atomic_load_ptr((void* volatile*)&profile_threads);
+    do {
+        thread->next = head;
+    } while (!atomic_cas_ptr((void* volatile*)&profile_threads, &head, thread));
+    profile_current = thread;
+    return thread;
+}
+
+function void profile_begin(const char* name) {
+    ProfileThread* thread = profile_thread_get();
+    U32 depth = thread->depth++;
+    if (depth < PROFILE_MAX_DEPTH) {
+        thread->open[depth].name = name;
+        thread->open[depth].begin = timer_ticks();
+    }
+}
+
+function void profile_end(void) {
+    U64 end = timer_ticks();
+    ProfileThread* thread = profile_current;
+    if (!thread || !thread->depth) {
+        return;
+    }
+    U32 depth = --thread->depth;
+    U64 count = thread->count;
+    if (depth >= PROFILE_MAX_DEPTH || count == PROFILE_EVENTS_PER_THREAD) {
+        thread->dropped++;
+        return;
+    }
+    ProfileEvent* event = &thread->events[count];
+    event->name = thread->open[depth].name;
+    event->begin = thread->open[depth].begin;
+    event->end = end;
+    atomic_store_U64(&thread->count, count + 1);
+}
+
+function void profile_thread_name(const char* name) {
+    ProfileThread* thread = profile_thread_get();
+    U64 length = Min(strlen(name), sizeof(thread->name) - 1);
+    MemoryCopy(thread->name, name, length);
+    thread->name[length] = 0;
+}
+
+function U64 profile_dropped(void) {
+    U64 dropped = 0;
+    for (ProfileThread* thread = atomic_load_ptr((void* volatile*)&profile_threads); thread; thread = thread->next) {
+        dropped += thread->dropped;
+    }
+    return dropped;
+}
+
+function void profile_reset(void) {
+    for (ProfileThread* thread = atomic_load_ptr((void* volatile*)&profile_threads); thread; thread = thread->next) {
+        atomic_store_U64(&thread->count, 0);
+        thread->dropped = 0;
+    }
+}
+
+function B32 profile_write_chrome_trace(const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return 0;
+    }
+    ProfileThread* threads = atomic_load_ptr((void* volatile*)&profile_threads);
+    U64 epoch = max_U64;
+    for (ProfileThread* thread = threads; thread; thread = thread->next) {
+        U64 count = atomic_load_U64(&thread->count);
+        for (U64 i = 0; i < count; i++) {
+            epoch = Min(epoch, thread->events[i].begin);
+        }
+    }
+    F64 us_per_tick = 1e6 / (F64)timer_frequency();
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+    B32 first = 1;
+    for (ProfileThread* thread = threads; thread; thread = thread->next) {
+        if (thread->name[0]) {
+            fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                    first ? "" : ",", thread->id);
+            json_write_string(file, thread->name);
+            fputs("}}", file);
+            first = 0;
+        }
+        U64 count = atomic_load_U64(&thread->count);
+        for (U64 i = 0; i < count; i++) {
+            ProfileEvent* event = &thread->events[i];
+            fprintf(file, "%s\n{\"name\":", first ? "" : ",");
+            json_write_string(file, event->name);
+            fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", thread->id,
+                    (F64)(event->begin - epoch) * us_per_tick, (F64)(event->end - event->begin) * us_per_tick);
+            first = 0;
+        }
+    }
+    fputs("\n]}\n", file);
+    B32 result = !ferror(file);
+    result &= fclose(file) == 0;
+    return result;
+}
+#endif
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Benchmark Harness Functions
+
+global void* volatile bench_sink;
+
+function void bench_escape(void* p) {
+    bench_sink = p;
+}
+
+function BenchSuite bench_suite_create(void) {
+    BenchSuite suite = { 0 };
+    suite.samples = BENCH_SAMPLES;
+    suite.sample_ns = BENCH_SAMPLE_NS;
+    return suite;
+}
+
+function void bench_suite_destroy(BenchSuite* suite) {
+    BASE_FREE(suite->results);
+    MemoryZeroStruct(suite);
+}
+
+function BenchResult* bench_run(BenchSuite* suite, const char* name, BenchFunc* func, void* data, U64 ops, U64 bytes) {
+    if (suite->filter && !strstr(name, suite->filter)) {
+        return NULL;
+    }
+    if (suite->count == suite->capacity) {
+        U64 capacity = Max(2 * suite->capacity, 16);
+        BenchResult* results = array_grow(NULL, suite->results, suite->count, suite->capacity,
+                                          capacity, sizeof(BenchResult));
+        if (!results) {
+            return NULL;
+        }
+        suite->results = results;
+        suite->capacity = capacity;
+    }
+    U64 samples = Max(suite->samples, 1);
+    U64* ticks = BASE_ALLOC(samples * sizeof(U64));
+    if (!ticks) {
+        return NULL;
+    }
+
+    F64 frequency = (F64)timer_frequency();
+    U64 target = (U64)((F64)suite->sample_ns * frequency / 1e9);
+    U64 iterations = 1;
+    for (;;) {
+        U64 t0 = timer_ticks();
+        func(data, iterations);
+        U64 elapsed = timer_ticks() - t0;
+        if (elapsed >= target || iterations >= (1ull << 40)) {
+            break;
+        }
+        iterations *= 2;
+    }
+    for (U64 i = 0; i < BENCH_WARMUP_SAMPLES; i++) {
+        func(data, iterations);
+    }
+    F64 total = 0.0;
+    for (U64 i = 0; i < samples; i++) {
+        U64 t0 = timer_ticks();
+        func(data, iterations);
+        ticks[i] = timer_ticks() - t0;
+        total += (F64)ticks[i];
+    }
+    if (!radix_sort_U64(ticks, samples, NULL)) {
+        BASE_FREE(ticks);
+        return NULL;
+    }
+
+    F64 per_op = 1.0 / ((F64)iterations * (F64)Max(ops, 1));
+    F64 ns_per_tick = 1e9 / frequency;
+    U64 p99 = (U64)ceil(0.99 * (F64)samples) - 1;
+    BenchResult* result = &suite->results[suite->count++];
+    result->name = name;
+    result->iterations = iterations;
+    result->samples = samples;
+    result->ops = ops;
+    result->bytes = bytes;
+    result->min_ns = (F64)ticks[0] * ns_per_tick * per_op;
+    result->median_ns = (F64)ticks[samples / 2] * ns_per_tick * per_op;
+    result->p99_ns = (F64)ticks[p99] * ns_per_tick * per_op;
+    result->mean_ns = total / (F64)samples * ns_per_tick * per_op;
+    result->cycles_per_op = (F64)ticks[samples / 2] * per_op;
+    result->cycles_per_byte = bytes ? (F64)ticks[samples / 2] / ((F64)iterations * (F64)bytes) : 0.0;
+    BASE_FREE(ticks);
+    return result;
+}
+
+function void bench_print_header(void) {
+    printf("%-36s %12s %12s %12s %12s %12s\n", "benchmark", "median ns", "p99 ns", "min ns",
+           "cycles/op", "cycles/byte");
+}
+
+function void bench_print(const BenchResult* result) {
+    if (!result) {
+        return;
+    }
+    printf("%-36s %12.2f %12.2f %12.2f %12.2f", result->name, result->median_ns, result->p99_ns,
+           result->min_ns, result->cycles_per_op);
+    if (result->bytes) {
+        printf(" %12.3f\n", result->cycles_per_byte);
+    } else {
+        printf(" %12s\n", "-");
+    }
+}
+
+function B32 bench_write_json(const BenchSuite* suite, const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return 0;
+    }
+    fprintf(file, "{\"timer_frequency\":%llu,\"results\":[", (unsigned long long)timer_frequency());
+    for (U64 i = 0; i < suite->count; i++) {
+        const BenchResult* r = &suite->results[i];
+        fprintf(file, "%s\n{\"name\":", i ? "," : "");
+        json_write_string(file, r->name);
+        fprintf(file, ",\"iterations\":%llu,\"samples\":%llu,\"ops\":%llu,\"bytes\":%llu,"
+                      "\"min_ns\":%.4f,\"median_ns\":%.4f,\"p99_ns\":%.4f,\"mean_ns\":%.4f,"
+                      "\"cycles_per_op\":%.4f,\"cycles_per_byte\":%.4f}",
+                (unsigned long long)r->iterations, (unsigned long long)r->samples,
+                (unsigned long long)r->ops, (unsigned long long)r->bytes, r->min_ns, r->median_ns,
+                r->p99_ns, r->mean_ns, r->cycles_per_op, r->cycles_per_byte);
+    }
+    fputs("\n]}\n", file);
+    B32 result = !ferror(file);
+    result &= fclose(file) == 0;
+    return result;
+}
+
+function B32 bench_write_csv(const BenchSuite* suite, const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return 0;
+    }
+    fputs("name,iterations,samples,ops,bytes,min_ns,median_ns,p99_ns,mean_ns,cycles_per_op,cycles_per_byte\n", file);
+    for (U64 i = 0; i < suite->count; i++) {
+        const BenchResult* r = &suite->results[i];
+        fputc('"', file);
+        for (const char* c = r->name; *c; c++) {
+            if (*c == '"') {
+                fputc('"', file);
+            }
+            fputc(*c, file);
+        }
+        fprintf(file, "\",%llu,%llu,%llu,%llu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                (unsigned long long)r->iterations, (unsigned long long)r->samples,
+                (unsigned long long)r->ops, (unsigned long long)r->bytes, r->min_ns, r->median_ns,
+                r->p99_ns, r->mean_ns, r->cycles_per_op, r->cycles_per_byte);
+    }
+    B32 result = !ferror(file);
+    result &= fclose(file) == 0;
+    return result;
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Clock Functions
+
+function U64 clock_realtime_coarse_ns(void) {
+#if defined(_WIN32)
+    FILETIME file_time;
+    GetSystemTimeAsFileTime(&file_time);
+    U64 intervals = ((U64)file_time.dwHighDateTime << 32) | file_time.dwLowDateTime;
+    return (intervals - 116444736000000000ull) * 100;
+#else
+#if defined(CLOCK_REALTIME_COARSE)
+    clockid_t id = CLOCK_REALTIME_COARSE;
+#else
+    clockid_t id = CLOCK_REALTIME;
+#endif
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return (U64)ts.tv_sec * 1000000000ull + (U64)ts.tv_nsec;
+#endif
+}
+
+function U64 clock_monotonic_coarse_ns(void) {
+#if defined(_WIN32)
+    return GetTickCount64() * 1000000ull;
+#else
+#if defined(CLOCK_MONOTONIC_COARSE)
+    clockid_t id = CLOCK_MONOTONIC_COARSE;
+#else
+    clockid_t id = CLOCK_MONOTONIC;
+#endif
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return (U64)ts.tv_sec * 1000000000ull + (U64)ts.tv_nsec;
+#endif
+}
+
+// NOTE(ryl1k): Days since 1970-01-01 of a proleptic Gregorian date, with
+// March-based years so the leap day falls at the end (Hinnant).
+function S64 clock_days_from_civil(S64 year, S32 month, S32 day) {
+    year -= month <= 2;
+    S64 era = (year >= 0 ? year : year - 399) / 400;
+    S64 year_of_era = year - era * 400;
+    S64 day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    S64 day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+global ClockSnapshot clock_snapshots[CLOCK_SNAPSHOT_SLOTS];
+global void* volatile clock_current;
+global volatile U64 clock_refreshing;
+global U32 clock_next_slot;
+
+// NOTE(ryl1k): Runs under clock_refreshing. Readers may still be copying
+// the published slot, so the next one in the ring is filled instead.
+function void clock_refresh(S64 seconds) {
+    ClockSnapshot* snapshot = &clock_snapshots[clock_next_slot];
+    clock_next_slot = (clock_next_slot + 1) % CLOCK_SNAPSHOT_SLOTS;
+
+    time_t now = (time_t)seconds;
+    struct tm calendar;
+#if defined(_WIN32)
+    localtime_s(&calendar, &now);
+#else
+    localtime_r(&now, &calendar);
+#endif
+    snapshot->epoch_seconds = seconds;
+    snapshot->year = calendar.tm_year + 1900;
+    snapshot->month = (U8)(calendar.tm_mon + 1);
+    snapshot->day = (U8)calendar.tm_mday;
+    snapshot->hour = (U8)calendar.tm_hour;
+    snapshot->minute = (U8)calendar.tm_min;
+    snapshot->second = (U8)calendar.tm_sec;
+    snapshot->day_of_week = (U8)calendar.tm_wday;
+    snapshot->day_of_year = (U16)calendar.tm_yday;
+
+    S64 local_seconds = clock_days_from_civil(snapshot->year, snapshot->month, snapshot->day) * 86400 +
+                        calendar.tm_hour * 3600 + calendar.tm_min * 60 + calendar.tm_sec;
+    snapshot->utc_offset = (S32)(local_seconds - seconds);
+
+    S32 offset = snapshot->utc_offset;
+    char sign = offset < 0 ? '-' : '+';
+    offset = offset < 0 ? -offset : offset;
+    int length = snprintf(snapshot->timestamp, sizeof(snapshot->timestamp), "%04d-%02d-%02dT%02d:%02d:%02d%c%02d:%02d",
+                          (int)snapshot->year, snapshot->month, snapshot->day, snapshot->hour, snapshot->minute,
+                          snapshot->second, sign, (int)(offset / 3600), (int)(offset / 60 % 60));
+    snapshot->timestamp_length = length > 0 ? (U32)Min(length, CLOCK_TIMESTAMP_SIZE - 1) : 0;
+
+    atomic_store_ptr(&clock_current, snapshot);
+}
+
+// NOTE(ryl1k): A snapshot is current unless the second has advanced or
+// the clock stepped back by more than a second. Threads that raced a
+// refresh across a second boundary would otherwise flip it back and forth.
+function ClockSnapshot clock_snapshot(void) {
+    S64 seconds = (S64)(clock_realtime_coarse_ns() / 1000000000ull);
+    ClockSnapshot* current = (ClockSnapshot*)atomic_load_ptr(&clock_current);
+    while (!current || seconds > current->epoch_seconds || seconds + 1 < current->epoch_seconds) {
+        U64 expected = 0;
+        if (atomic_cas_U64(&clock_refreshing, &expected, 1)) {
+            current = (ClockSnapshot*)atomic_load_ptr(&clock_current);
+            if (!current || seconds > current->epoch_seconds || seconds + 1 < current->epoch_seconds) {
+                clock_refresh(seconds);
+            }
+            atomic_store_U64(&clock_refreshing, 0);
+            current = (ClockSnapshot*)atomic_load_ptr(&clock_current);
+            break;
+        }
+        if (current) {
+            break;
+        }
+        os_thread_yield();
+        current = (ClockSnapshot*)atomic_load_ptr(&clock_current);
+    }
+    return *current;
+}
@@ -2,7 +2,14 @@
 #define BASE_H
 
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
+#include <float.h>
+#include <math.h>
+#include <wchar.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #if !defined(ENABLE_ASSERT)
 #define ENABLE_ASSERT
@@ -30,11 +37,18 @@
 
 #define ArrayCount(a) (sizeof(a)/sizeof(*(a)))
 
+#if defined(_MSC_VER)
+#define ALIGN_AS(n) __declspec(align(n))
+#else
+#define ALIGN_AS(n) __attribute__((aligned(n)))
+#endif
+
 #define IntFromPtr(p) ((uintptr_t)((char*)(p) - (char*)0))
 #define PtrFromInt(i) ((void*)((char*)0 + (uintptr_t)(i)))
 
 #define Member(T,m) (((T*)0)->m)
 #define OffsetOfMember(T,m)  IntFromPtr(&Member(T,m))
+#define ContainerOf(p,T,m) ((T*)((char*)(p) - OffsetOfMember(T,m)))
 
 #define Min(a,b) (((a) < (b)) ? (a) : (b))
 #define Max(a,b) (((a) > (b)) ? (a) : (b))
@@ -43,9 +57,34 @@
 #define ClampTop(val,max) Min(a,b)
 #define ClampBot(val,max) Max(a,b)
 
+// NOTE(ryl1k): function is static: a program includes base.c into one
+// translation unit, as main.c and bench.c do. With BASE_LIBRARY defined,
+// function has external linkage instead, base.c is compiled once as a
+// library and other files include only base.h. Code the _DEFINE macros
+// generate into each includer is header_function, static inline in both
+// modes so the helpers a file does not call raise no unused warnings.
+// inline_function is for the small hot functions defined in this header
+// (Inline Functions), which must inline without LTO. thread_static is a
+// static with one instance per thread.
 #define global static
 #define local static
+#if defined(_MSC_VER)
+#define thread_static static __declspec(thread)
+#else
+#define thread_static static __thread
+#endif
+#if defined(BASE_LIBRARY)
+#define function
+#else
 #define function static
+#endif
+#if defined(_MSC_VER)
+#define header_function static __inline
+#define inline_function static __forceinline
+#else
+#define header_function static inline
+#define inline_function static inline __attribute__((always_inline))
+#endif
 
 #define c_linkage_begin extern "C" {
 #define c_linkage_end   }
@@ -83,15 +122,20 @@ typedef struct {
 function Arena arena_create(size_t size);
 function Arena64 arena64_create(uint64_t size);
 
-function void* arena_alloc(Arena* arena, size_t alloc_size);
-function void* arena64_alloc(Arena64* arena, uint64_t alloc_size);
-
 function void arena_reset(Arena* arena);
 function void arena64_reset(Arena64* arena);
 
 function void arena_destroy(Arena* arena);
 function void arena64_destroy(Arena64* arena);
 
+// NOTE(ryl1k): os_allocation_granularity is the alignment and size unit
+// of os_reserve_mirrored: the page size, except on Windows where views are
+// placed on 64 KB allocation granularity. cpu_topology has the page size.
+
+function uint64_t os_allocation_granularity(void);
+function void* os_reserve_mirrored(uint64_t size);
+function void os_release_mirrored(void* base, uint64_t size);
+
 function void initialize_string_arena(size_t size);
 function void destroy_string_arena();
 function void initialize_utf_string_arena(size_t size);
@@ -106,8 +150,8 @@ function void destroy_utf_string_arena();
 #define IS_ALIGNED(ptr, alignment) \
     (((uintptr_t)(ptr) & (alignment - 1)) == 0)
 
-Arena g_string_arena;
-Arena g_utf_string_arena;
+extern Arena g_string_arena;
+extern Arena g_utf_string_arena;
 
 //////////////////////////////////////////////////////
 // NOTE(ryl1k): String And UTF Macros
@@ -130,9 +174,9 @@ function int myprintf(const char* str, ...);
 function String string_create_literal(const char* literal);
 
 function char* utf8_to_utf16(const char* utf8);
-function char* utf16_to_utf8(const char* utf16);
+function char* utf16_to_utf8(const wchar_t* utf16);
 function int utf8_strlen(const char* utf8);
-function int utf16_strlen(const char* utf16);
+function int utf16_strlen(const wchar_t* utf16);
 
 #define UTF8String(literal) utf8_create_literal(literal)
 #define UTF16String(literal) utf16_create_literal(literal)
@@ -140,6 +184,227 @@ function int utf16_strlen(const char* utf16);
 function String utf8_create_literal(const char* utf8);
 function String utf16_create_literal(const char* utf8);
 
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Array Macros
+
+// NOTE(ryl1k): ARRAY_DEFINE(Name, T) generates a growable contiguous array
+// of T and its functions. Storage comes from the arena when one is given
+// (growing in place while the array is the last thing allocated, otherwise
+// copying and abandoning the old block) or from BASE_ALLOC. Pointers into
+// the array are invalidated by any call that can grow it.
+
+function void* array_grow(Arena* arena, void* data, uint64_t count, uint64_t capacity,
+                          uint64_t new_capacity, uint64_t element_size);
+
+#define ARRAY_DEFINE(Name, T)                                                          \
+    typedef struct {                                                                   \
+        T* v;                                                                          \
+        uint64_t count;                                                                \
+        uint64_t capacity;                                                             \
+        Arena* arena;                                                                  \
+    } Name;                                                                            \
+    header_function Name Name##_create(Arena* arena, uint64_t capacity) {              \
+        Name a;                                                                        \
+        a.v = NULL;                                                                    \
+        a.count = 0;                                                                   \
+        a.capacity = 0;                                                                \
+        a.arena = arena;                                                               \
+        if (capacity > 0) {                                                            \
+            a.v = (T*)array_grow(arena, NULL, 0, 0, capacity, sizeof(T));              \
+            a.capacity = a.v ? capacity : 0;                                           \
+        }                                                                              \
+        return a;                                                                      \
+    }                                                                                  \
+    header_function int Name##_reserve(Name* a, uint64_t capacity) {                   \
+        if (capacity <= a->capacity) {                                                 \
+            return 1;                                                                  \
+        }                                                                              \
+        uint64_t new_capacity = a->capacity ? a->capacity * 2 : 16;                    \
+        while (new_capacity < capacity) {                                              \
+            new_capacity *= 2;                                                         \
+        }                                                                              \
+        T* v = (T*)array_grow(a->arena, a->v, a->count, a->capacity,                   \
+                              new_capacity, sizeof(T));                                \
+        if (!v) {                                                                      \
+            return 0;                                                                  \
+        }                                                                              \
+        a->v = v;                                                                      \
+        a->capacity = new_capacity;                                                    \
+        return 1;                                                                      \
+    }                                                                                  \
+    header_function T* Name##_push(Name* a, T value) {                                 \
+        if (!Name##_reserve(a, a->count + 1)) {                                        \
+            return NULL;                                                               \
+        }                                                                              \
+        a->v[a->count] = value;                                                        \
+        return &a->v[a->count++];                                                      \
+    }                                                                                  \
+    header_function T* Name##_append(Name* a, const T* values, uint64_t count) {       \
+        if (!Name##_reserve(a, a->count + count)) {                                    \
+            return NULL;                                                               \
+        }                                                                              \
+        T* result = a->v + a->count;                                                   \
+        MemoryCopy(result, values, count * sizeof(T));                                 \
+        a->count += count;                                                             \
+        return result;                                                                 \
+    }                                                                                  \
+    header_function T* Name##_insert(Name* a, uint64_t index, T value) {               \
+        if (index > a->count || !Name##_reserve(a, a->count + 1)) {                    \
+            return NULL;                                                               \
+        }                                                                              \
+        MemoryCopy(a->v + index + 1, a->v + index, (a->count - index) * sizeof(T));    \
+        a->v[index] = value;                                                           \
+        a->count++;                                                                    \
+        return &a->v[index];                                                           \
+    }                                                                                  \
+    header_function void Name##_remove(Name* a, uint64_t index) {                      \
+        MemoryCopy(a->v + index, a->v + index + 1,                                     \
+                   (a->count - index - 1) * sizeof(T));                                \
+        a->count--;                                                                    \
+    }                                                                                  \
+    header_function void Name##_swap_remove(Name* a, uint64_t index) {                 \
+        a->v[index] = a->v[a->count - 1];                                              \
+        a->count--;                                                                    \
+    }                                                                                  \
+    header_function T Name##_pop(Name* a) {                                            \
+        return a->v[--a->count];                                                       \
+    }                                                                                  \
+    header_function void Name##_clear(Name* a) {                                       \
+        a->count = 0;                                                                  \
+    }                                                                                  \
+    header_function void Name##_destroy(Name* a) {                                     \
+        if (!a->arena && a->v) {                                                       \
+            BASE_FREE(a->v);                                                           \
+        }                                                                              \
+        a->v = NULL;                                                                   \
+        a->count = 0;                                                                  \
+        a->capacity = 0;                                                               \
+    }
+
+// NOTE(ryl1k): SOA_DEFINE(Name, FIELDS) generates a structure of arrays from
+// an X-macro field list, one array per field, each SOA_ALIGNMENT-aligned so
+// it can be fed straight to SIMD loops:
+//
+//     #define PARTICLE_FIELDS(X) X(F32, x) X(F32, y) X(F32, z) X(U32, id)
+//     SOA_DEFINE(Particles, PARTICLE_FIELDS)
+//
+// gives Particles { F32* x; F32* y; F32* z; U32* id; count; capacity; ... }
+// and ParticlesElement { F32 x; F32 y; F32 z; U32 id; } for push/get.
+// All fields share one block; growth moves every field.
+
+#define SOA_ALIGNMENT 64
+#define SOA_FIELD_SIZE(T, n) (((n) * sizeof(T) + SOA_ALIGNMENT - 1) & ~(uint64_t)(SOA_ALIGNMENT - 1))
+
+#define SOA_FIELD_DECL(T, name) T* name;
+#define SOA_FIELD_ELEMENT(T, name) T name;
+#define SOA_FIELD_BYTES(T, name) bytes += SOA_FIELD_SIZE(T, new_capacity);
+#define SOA_FIELD_MOVE(T, name)                                                        \
+    {                                                                                  \
+        T* field = (T*)at;                                                             \
+        if (a->count) {                                                                \
+            MemoryCopy(field, a->name, a->count * sizeof(T));                          \
+        }                                                                              \
+        a->name = field;                                                               \
+        at += SOA_FIELD_SIZE(T, new_capacity);                                         \
+    }
+#define SOA_FIELD_STORE(T, name) a->name[index] = element.name;
+#define SOA_FIELD_LOAD(T, name) r.name = a->name[index];
+#define SOA_FIELD_SHIFT_UP(T, name) MemoryCopy(a->name + index + 1, a->name + index, (a->count - index) * sizeof(T));
+#define SOA_FIELD_MOVE_LAST(T, name) a->name[index] = a->name[a->count - 1];
+#define SOA_FIELD_APPEND(T, name) a->name[a->count + i] = elements[i].name;
+
+#define SOA_DEFINE(Name, FIELDS)                                                       \
+    typedef struct {                                                                   \
+        FIELDS(SOA_FIELD_ELEMENT)                                                      \
+    } Name##Element;                                                                   \
+    typedef struct {                                                                   \
+        FIELDS(SOA_FIELD_DECL)                                                         \
+        uint64_t count;                                                                \
+        uint64_t capacity;                                                             \
+        void* memory;                                                                  \
+        Arena* arena;                                                                  \
+    } Name;                                                                            \
+    header_function int Name##_reserve(Name* a, uint64_t capacity) {                   \
+        if (capacity <= a->capacity) {                                                 \
+            return 1;                                                                  \
+        }                                                                              \
+        uint64_t new_capacity = a->capacity ? a->capacity * 2 : 16;                    \
+        while (new_capacity < capacity) {                                              \
+            new_capacity *= 2;                                                         \
+        }                                                                              \
+        uint64_t bytes = SOA_ALIGNMENT;                                                \
+        FIELDS(SOA_FIELD_BYTES)                                                        \
+        void* memory = a->arena ? arena_alloc(a->arena, bytes) : BASE_ALLOC(bytes);    \
+        if (!memory) {                                                                 \
+            return 0;                                                                  \
+        }                                                                              \
+        char* at = (char*)ALIGN_PTR(memory, SOA_ALIGNMENT);                            \
+        FIELDS(SOA_FIELD_MOVE)                                                         \
+        if (!a->arena && a->memory) {                                                  \
+            BASE_FREE(a->memory);                                                      \
+        }                                                                              \
+        a->memory = memory;                                                            \
+        a->capacity = new_capacity;                                                    \
+        return 1;                                                                      \
+    }                                                                                  \
+    header_function Name Name##_create(Arena* arena, uint64_t capacity) {              \
+        Name a;                                                                        \
+        MemoryZeroStruct(&a);                                                          \
+        a.arena = arena;                                                               \
+        Name##_reserve(&a, capacity);                                                  \
+        return a;                                                                      \
+    }                                                                                  \
+    header_function int Name##_push(Name* a, Name##Element element) {                  \
+        if (!Name##_reserve(a, a->count + 1)) {                                        \
+            return 0;                                                                  \
+        }                                                                              \
+        uint64_t index = a->count++;                                                   \
+        FIELDS(SOA_FIELD_STORE)                                                        \
+        return 1;                                                                      \
+    }                                                                                  \
+    header_function int Name##_append(Name* a, const Name##Element* elements,          \
+                                      uint64_t count) {                                \
+        if (!Name##_reserve(a, a->count + count)) {                                    \
+            return 0;                                                                  \
+        }                                                                              \
+        for (uint64_t i = 0; i < count; i++) {                                         \
+            FIELDS(SOA_FIELD_APPEND)                                                   \
+        }                                                                              \
+        a->count += count;                                                             \
+        return 1;                                                                      \
+    }                                                                                  \
+    header_function int Name##_insert(Name* a, uint64_t index,                         \
+                                      Name##Element element) {                         \
+        if (index > a->count || !Name##_reserve(a, a->count + 1)) {                    \
+            return 0;                                                                  \
+        }                                                                              \
+        FIELDS(SOA_FIELD_SHIFT_UP)                                                     \
+        FIELDS(SOA_FIELD_STORE)                                                        \
+        a->count++;                                                                    \
+        return 1;                                                                      \
+    }                                                                                  \
+    header_function Name##Element Name##_get(Name* a, uint64_t index) {                \
+        Name##Element r;                                                               \
+        FIELDS(SOA_FIELD_LOAD)                                                         \
+        return r;                                                                      \
+    }                                                                                  \
+    header_function void Name##_set(Name* a, uint64_t index, Name##Element element) {  \
+        FIELDS(SOA_FIELD_STORE)                                                        \
+    }                                                                                  \
+    header_function void Name##_swap_remove(Name* a, uint64_t index) {                 \
+        FIELDS(SOA_FIELD_MOVE_LAST)                                                    \
+        a->count--;                                                                    \
+    }                                                                                  \
+    header_function void Name##_clear(Name* a) {                                       \
+        a->count = 0;                                                                  \
+    }                                                                                  \
+    header_function void Name##_destroy(Name* a) {                                     \
+        if (!a->arena && a->memory) {                                                  \
+            BASE_FREE(a->memory);                                                      \
+        }                                                                              \
+        MemoryZeroStruct(a);                                                           \
+    }
+
 //////////////////////////////////////////////////////
 // NOTE(ryl1k): Linked List Macros
 
@@ -235,12 +500,7 @@ function String utf16_create_literal(const char* utf8);
 
 
 
-#define STACK_NODE(TYPE)    \
-    do{                     \
-        struct{             \
-            TYPE* next;     \
-        };                  \
-    } while (0)
+#define STACK_NODE(TYPE) TYPE* next
 
 #define STACK_INIT(stack) \
     do {                  \
@@ -472,6 +732,21 @@ typedef union{
     F32 v[4];
 } I2F32;
 
+// NOTE(ryl1k): Column-major: c[j] is column j and m[j][i] is row i of
+// column j, so v is the flat layout graphics APIs expect. M4F32 fills
+// exactly one cache line.
+typedef ALIGN_AS(16) union {
+    V3F32 c[3];
+    F32 m[3][3];
+    F32 v[9];
+} M3F32;
+
+typedef ALIGN_AS(64) union {
+    V4F32 c[4];
+    F32 m[4][4];
+    F32 v[16];
+} M4F32;
+
 //////////////////////////////////////////////////////
 // NOTE(ryl1k): Symbolic Constants Functions
 
@@ -487,90 +762,1916 @@ function F32 inf_F32(void);
 function F64 inf_F64(void);
 function F32 neg_inf_F32(void);
 function F64 neg_inf_F64(void);
+function F32 nan_F32(void);
+function F64 nan_F64(void);
 
 //////////////////////////////////////////////////////
 // NOTE(ryl1k): Math Functions
 
-function F32 abs_F32(F32 x);
-function F32 sqrt_F32(F32 x);
+function F32 rsqrt_fast_F32(F32 x);
 function F32 sin_F32(F32 x);
 function F32 cos_F32(F32 x);
 function F32 tan_F32(F32 x);
 function F32 ln_F32(F32 x);
+function F32 exp_F32(F32 x);
 
-
-function F64 abs_F64(F64 x);
-function F64 sqrt_F64(F64 x);
 function F64 sin_F64(F64 x);
 function F64 cos_F64(F64 x);
 function F64 tan_F64(F64 x);
 function F64 ln_F64(F64 x);
+function F64 exp_F64(F64 x);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Bit Functions
+
+function U32 clz_U64(U64 x);
+function U32 ctz_U64(U64 x);
+function U32 popcount_U64(U64 x);
+function U64 mul_U64_hi_lo(U64 a, U64 b, U64* lo);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): String Parsing
+
+// NOTE(ryl1k): Parsers read a number from the start of the string without
+// needing a NUL terminator and without looking at the C locale. Accepted
+// syntax is [+-]digits for integers and [+-]digits[.digits][(e|E)[+-]digits],
+// "inf", "infinity" and "nan" for floats. No whitespace is skipped.
+// consumed is the number of bytes read, 0 when error is ParseError_NoDigits.
+// On ParseError_Overflow the value is saturated (integers) or +-inf (floats).
+
+typedef enum {
+    ParseError_None,
+    ParseError_NoDigits,
+    ParseError_Overflow,
+} ParseError;
+
+typedef struct { S32 value; int consumed; ParseError error; } ParseS32;
+typedef struct { S64 value; int consumed; ParseError error; } ParseS64;
+typedef struct { U32 value; int consumed; ParseError error; } ParseU32;
+typedef struct { U64 value; int consumed; ParseError error; } ParseU64;
+typedef struct { F32 value; int consumed; ParseError error; } ParseF32;
+typedef struct { F64 value; int consumed; ParseError error; } ParseF64;
+
+function ParseS32 parse_S32(String s);
+function ParseS64 parse_S64(String s);
+function ParseU32 parse_U32(String s);
+function ParseU64 parse_U64(String s);
+function ParseF32 parse_F32(String s);
+function ParseF64 parse_F64(String s);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Hashtable
+
+// NOTE(ryl1k): Open-addressing (Swiss table) map over fixed-size keys and
+// values. Slots are copied by value; hash and equal receive a pointer to
+// the key. With an arena, growth leaves the old arrays in the arena.
+// Pointers returned by insert/lookup are valid until the next insert.
+
+typedef U64 HashFunc(const void* key);
+typedef B32 HashEqualFunc(const void* a, const void* b);
+
+typedef struct {
+    void* memory;
+    U8* ctrl;
+    U8* slots;
+    U64 capacity;
+    U64 count;
+    U64 growth_left;
+    U32 key_size;
+    U32 value_size;
+    U32 value_offset;
+    U32 slot_size;
+    HashFunc* hash;
+    HashEqualFunc* equal;
+    Arena* arena;
+} HashTable;
+
+function U64 hash_U64(U64 x);
+function U64 hash_bytes(const void* data, U64 size);
+
+function U64 hash_table_hash_U32(const void* key);
+function B32 hash_table_equal_U32(const void* a, const void* b);
+function U64 hash_table_hash_U64(const void* key);
+function B32 hash_table_equal_U64(const void* a, const void* b);
+function U64 hash_table_hash_String(const void* key);
+function B32 hash_table_equal_String(const void* a, const void* b);
+
+function HashTable hash_table_create(Arena* arena, U32 key_size, U32 value_size,
+                                     HashFunc* hash, HashEqualFunc* equal, U64 capacity);
+function B32 hash_table_reserve(HashTable* table, U64 count);
+function void* hash_table_insert(HashTable* table, const void* key, const void* value);
+function void* hash_table_lookup(HashTable* table, const void* key);
+function B32 hash_table_erase(HashTable* table, const void* key);
+function B32 hash_table_next(HashTable* table, U64* iterator, void** key, void** value);
+function void hash_table_clear(HashTable* table);
+function void hash_table_destroy(HashTable* table);
+
+#define HASH_TABLE_DEFINE(Name, K, V, hash_fn, equal_fn)                              \
+    typedef struct { HashTable table; } Name;                                         \
+    header_function Name Name##_create(Arena* arena, U64 capacity) {                         \
+        Name r;                                                                       \
+        r.table = hash_table_create(arena, sizeof(K), sizeof(V),                      \
+                                    (hash_fn), (equal_fn), capacity);                 \
+        return r;                                                                     \
+    }                                                                                 \
+    header_function V* Name##_insert(Name* t, K key, V value) {                              \
+        return (V*)hash_table_insert(&t->table, &key, &value);                        \
+    }                                                                                 \
+    header_function V* Name##_lookup(Name* t, K key) {                                       \
+        return (V*)hash_table_lookup(&t->table, &key);                                \
+    }                                                                                 \
+    header_function B32 Name##_erase(Name* t, K key) {                                       \
+        return hash_table_erase(&t->table, &key);                                     \
+    }                                                                                 \
+    header_function B32 Name##_reserve(Name* t, U64 count) {                                 \
+        return hash_table_reserve(&t->table, count);                                  \
+    }                                                                                 \
+    header_function B32 Name##_next(Name* t, U64* iterator, K** key, V** value) {            \
+        return hash_table_next(&t->table, iterator, (void**)key, (void**)value);      \
+    }                                                                                 \
+    header_function void Name##_destroy(Name* t) {                                           \
+        hash_table_destroy(&t->table);                                                \
+    }
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Unrolled List
+
+// NOTE(ryl1k): Doubly linked list of chunks, each a cache-line multiple
+// holding a run of fixed-size elements, so traversal misses once per chunk
+// instead of once per element. A full chunk is split in half on a middle
+// insert; a chunk under half full is merged with its successor on remove.
+// Emptied chunks go to a free list and are reused. Element pointers are
+// invalidated by insert and remove on the same chunk.
+
+#define UNROLLED_CHUNK_BYTES 512
+#define UNROLLED_CHUNK_HEADER 32
+
+typedef struct UnrolledChunk {
+    DLL_NODE(struct UnrolledChunk);
+    U64 count;
+} UnrolledChunk;
+
+typedef struct {
+    UnrolledChunk* first;
+    UnrolledChunk* last;
+    UnrolledChunk* free_chunks;
+    U64 count;
+    U32 element_size;
+    U32 chunk_capacity;
+    U64 chunk_bytes;
+    Arena* arena;
+} UnrolledList;
+
+// NOTE(ryl1k): Position of an element; chunk is NULL past the end.
+typedef struct {
+    UnrolledChunk* chunk;
+    U64 index;
+} UnrolledListIter;
+
+#define UNROLLED_CHUNK_DATA(chunk) ((U8*)(chunk) + UNROLLED_CHUNK_HEADER)
+
+function UnrolledList unrolled_list_create(Arena* arena, U32 element_size, U64 chunk_bytes);
+function void* unrolled_list_push_back(UnrolledList* list, const void* value);
+function void* unrolled_list_push_front(UnrolledList* list, const void* value);
+function B32 unrolled_list_pop_back(UnrolledList* list, void* out);
+function B32 unrolled_list_pop_front(UnrolledList* list, void* out);
+function void* unrolled_list_insert(UnrolledList* list, UnrolledListIter* at, const void* value);
+function void unrolled_list_remove(UnrolledList* list, UnrolledListIter* at);
+function UnrolledListIter unrolled_list_begin(UnrolledList* list);
+function UnrolledListIter unrolled_list_at(UnrolledList* list, U64 index);
+function void* unrolled_list_get(UnrolledList* list, UnrolledListIter it);
+function B32 unrolled_list_next(UnrolledList* list, UnrolledListIter* it);
+function void unrolled_list_clear(UnrolledList* list);
+function void unrolled_list_destroy(UnrolledList* list);
+
+#define UNROLLED_LIST_DEFINE(Name, T)                                                 \
+    typedef struct { UnrolledList list; } Name;                                       \
+    header_function Name Name##_create(Arena* arena) {                                \
+        Name r;                                                                       \
+        r.list = unrolled_list_create(arena, sizeof(T), 0);                           \
+        return r;                                                                     \
+    }                                                                                 \
+    header_function T* Name##_push_back(Name* l, T value) {                           \
+        return (T*)unrolled_list_push_back(&l->list, &value);                         \
+    }                                                                                 \
+    header_function T* Name##_push_front(Name* l, T value) {                          \
+        return (T*)unrolled_list_push_front(&l->list, &value);                        \
+    }                                                                                 \
+    header_function B32 Name##_pop_back(Name* l, T* out) {                            \
+        return unrolled_list_pop_back(&l->list, out);                                 \
+    }                                                                                 \
+    header_function B32 Name##_pop_front(Name* l, T* out) {                           \
+        return unrolled_list_pop_front(&l->list, out);                                \
+    }                                                                                 \
+    header_function T* Name##_insert(Name* l, UnrolledListIter* at, T value) {        \
+        return (T*)unrolled_list_insert(&l->list, at, &value);                        \
+    }                                                                                 \
+    header_function T* Name##_get(Name* l, UnrolledListIter it) {                     \
+        return (T*)unrolled_list_get(&l->list, it);                                   \
+    }                                                                                 \
+    header_function void Name##_destroy(Name* l) {                                    \
+        unrolled_list_destroy(&l->list);                                              \
+    }
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Atomic Functions
+
+// NOTE(ryl1k): Loads acquire, stores release, read-modify-writes are
+// sequentially consistent. cas writes the observed value to *expected on
+// failure.
+
+#define CACHE_LINE_SIZE 64
+
+typedef ALIGN_AS(16) struct {
+    U64 lo;
+    U64 hi;
+} U128;
+
+// NOTE(ryl1k): Double-width CAS (cmpxchg16b, ldaxp/stlxp) for ABA tags.
+#if UINTPTR_MAX > 0xFFFFFFFFu
+#define ATOMIC_HAS_CAS_U128 1
+#endif
+
+function U32 atomic_load_U32(volatile U32* p);
+function void atomic_store_U32(volatile U32* p, U32 v);
+function U32 atomic_fetch_add_U32(volatile U32* p, U32 v);
+
+function U64 atomic_load_U64(volatile U64* p);
+function void atomic_store_U64(volatile U64* p, U64 v);
+function U64 atomic_fetch_add_U64(volatile U64* p, U64 v);
+function U64 atomic_exchange_U64(volatile U64* p, U64 v);
+function B32 atomic_cas_U64(volatile U64* p, U64* expected, U64 desired);
+#if defined(ATOMIC_HAS_CAS_U128)
+function B32 atomic_cas_U128(volatile U128* p, U128* expected, U128 desired);
+#endif
+
+function void* atomic_load_ptr(void* volatile* p);
+function void atomic_store_ptr(void* volatile* p, void* v);
+function void* atomic_exchange_ptr(void* volatile* p, void* v);
+function B32 atomic_cas_ptr(void* volatile* p, void** expected, void* desired);
+
+function void atomic_fence(void);
+function void cpu_pause(void);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Thread Functions
+
+typedef void OSThreadFunc(void* param);
+
+typedef struct {
+    U64 handle;
+} OSThread;
+
+function OSThread os_thread_create(OSThreadFunc* func, void* param);
+function void os_thread_join(OSThread thread);
+function void os_thread_yield(void);
+
+// NOTE(ryl1k): os_thread_pin binds the calling thread to the cpu-th of the
+// CPUs this process may run on (0 if it cannot); os_cpu_count counts them.
+// os_futex_wait sleeps while *address == expected and may return early,
+// so callers recheck in a loop; os_futex_wake wakes one or all sleepers.
+// Both are futex on Linux and WaitOnAddress on Windows; elsewhere the wait
+// is a yield.
+
+function B32 os_thread_pin(U32 cpu);
+function U32 os_cpu_count(void);
+function void os_futex_wait(volatile U32* address, U32 expected);
+function void os_futex_wake(volatile U32* address, B32 all);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Lock-free Queues
+
+// NOTE(ryl1k): Bounded multi-producer/multi-consumer ring of pointers
+// (Vyukov). Every cell carries a sequence number that tells producers and
+// consumers whose turn it is, so each side only contends on its own index.
+// Use PtrFromInt/IntFromPtr to pass integers.
+
+typedef struct {
+    volatile U64 sequence;
+    void* data;
+} MPMCCell;
+
+typedef struct {
+    MPMCCell* cells;
+    U64 mask;
+    void* memory;
+    Arena* arena;
+    U8 pad0[CACHE_LINE_SIZE - sizeof(MPMCCell*) - sizeof(U64) - sizeof(void*) - sizeof(Arena*)];
+    volatile U64 enqueue_pos;
+    U8 pad1[CACHE_LINE_SIZE - sizeof(U64)];
+    volatile U64 dequeue_pos;
+    U8 pad2[CACHE_LINE_SIZE - sizeof(U64)];
+} MPMCQueue;
+
+function MPMCQueue* mpmc_queue_create(Arena* arena, U64 capacity);
+function void mpmc_queue_destroy(MPMCQueue* queue);
+function B32 mpmc_queue_enqueue(MPMCQueue* queue, void* data);
+function B32 mpmc_queue_dequeue(MPMCQueue* queue, void** data);
+function U64 mpmc_queue_enqueue_batch(MPMCQueue* queue, void** data, U64 count);
+function U64 mpmc_queue_dequeue_batch(MPMCQueue* queue, void** data, U64 count);
+
+// NOTE(ryl1k): Unbounded intrusive multi-producer/single-consumer queue
+// (Vyukov). Nodes are linked through their SLL_NODE next field, located by
+// link_offset = OffsetOfMember(TYPE, next). Push never blocks; pop may
+// return NULL while a push is half done. The queue must not move after
+// init since it holds its own stub node.
+
+typedef struct {
+    void* volatile head;
+    U8 pad0[CACHE_LINE_SIZE - sizeof(void*)];
+    void* tail;
+    void* volatile stub_next;
+    U64 link_offset;
+} MPSCQueue;
+
+function void mpsc_queue_init(MPSCQueue* queue, U64 link_offset);
+function void mpsc_queue_push(MPSCQueue* queue, void* node);
+function void mpsc_queue_push_list(MPSCQueue* queue, void* first, void* last);
+function void* mpsc_queue_pop(MPSCQueue* queue);
+
+// NOTE(ryl1k): Intrusive lock-free LIFO (Treiber) over STACK_NODE/SLL_NODE
+// links, located by link_offset = OffsetOfMember(TYPE, next). The head is
+// a {node, tag} pair swapped with a double-width CAS (a packed U64 on
+// 32-bit targets), and every change bumps the tag, so a node popped and
+// pushed back between another thread's read and CAS cannot be mistaken for
+// an unchanged head (ABA). Popped nodes may still be read by a racing pop,
+// so their memory must stay mapped, which holds for pool and arena free
+// lists. pop_all returns the whole chain, top first, NULL-terminated.
+
+typedef struct {
+    volatile U128 head;
+    U64 link_offset;
+} AtomicStack;
+
+function void atomic_stack_init(AtomicStack* stack, U64 link_offset);
+function void atomic_stack_push(AtomicStack* stack, void* node);
+function void atomic_stack_push_list(AtomicStack* stack, void* first, void* last);
+function void* atomic_stack_pop(AtomicStack* stack);
+function void* atomic_stack_pop_all(AtomicStack* stack);
+
+// NOTE(ryl1k): Wait-free single-producer/single-consumer ring of fixed-size
+// elements. head and tail are free-running counters on separate cache
+// lines; each side keeps a cached copy of the other's counter and only
+// reloads it when the cached one says full/empty. reserve/commit and
+// peek/consume hand out slots in place: without mirroring a run stops at
+// the end of the buffer, with mirroring (buffer mapped twice back to back)
+// any run of available slots is contiguous.
+
+typedef struct {
+    volatile U64 head;
+    U64 cached_tail;
+    U8 pad0[CACHE_LINE_SIZE - 2 * sizeof(U64)];
+    volatile U64 tail;
+    U64 cached_head;
+    U8 pad1[CACHE_LINE_SIZE - 2 * sizeof(U64)];
+    U8* buffer;
+    U64 capacity;
+    U64 mask;
+    U64 element_size;
+    B32 mirrored;
+    void* memory;
+    Arena* arena;
+} SPSCRing;
+
+function SPSCRing* spsc_ring_create(Arena* arena, U64 capacity, U64 element_size, B32 mirrored);
+function void spsc_ring_destroy(SPSCRing* ring);
+function B32 spsc_ring_push(SPSCRing* ring, const void* element);
+function B32 spsc_ring_pop(SPSCRing* ring, void* element);
+function U64 spsc_ring_push_batch(SPSCRing* ring, const void* elements, U64 count);
+function U64 spsc_ring_pop_batch(SPSCRing* ring, void* elements, U64 count);
+function void* spsc_ring_reserve(SPSCRing* ring, U64 count, U64* reserved);
+function void spsc_ring_commit(SPSCRing* ring, U64 count);
+function void* spsc_ring_peek(SPSCRing* ring, U64 count, U64* available);
+function void spsc_ring_consume(SPSCRing* ring, U64 count);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Sorting
+
+// NOTE(ryl1k): Ascending, stable LSD radix sorts. Signed and float keys are
+// mapped to order-preserving unsigned bits first, so -0 sorts before +0 and
+// NaNs sort by sign bit to the ends. Index sorts leave the keys untouched
+// and write the permutation to indices (indices[i] is the position of the
+// i-th smallest key). Scratch comes from the arena (released again before
+// returning) or from BASE_ALLOC when the arena is NULL; they return 0 with
+// nothing sorted if it cannot be allocated.
+
+function B32 radix_sort_U32(U32* keys, U64 count, Arena* scratch);
+function B32 radix_sort_U64(U64* keys, U64 count, Arena* scratch);
+function B32 radix_sort_S32(S32* keys, U64 count, Arena* scratch);
+function B32 radix_sort_S64(S64* keys, U64 count, Arena* scratch);
+function B32 radix_sort_F32(F32* keys, U64 count, Arena* scratch);
+function B32 radix_sort_F64(F64* keys, U64 count, Arena* scratch);
+
+function B32 radix_sort_index_U32(const U32* keys, U32 count, U32* indices, Arena* scratch);
+function B32 radix_sort_index_U64(const U64* keys, U32 count, U32* indices, Arena* scratch);
+function B32 radix_sort_index_S32(const S32* keys, U32 count, U32* indices, Arena* scratch);
+function B32 radix_sort_index_S64(const S64* keys, U32 count, U32* indices, Arena* scratch);
+function B32 radix_sort_index_F32(const F32* keys, U32 count, U32* indices, Arena* scratch);
+function B32 radix_sort_index_F64(const F64* keys, U32 count, U32* indices, Arena* scratch);
+
+// NOTE(ryl1k): Bytewise over length bytes, shorter first on a tie (MSD
+// radix on 8-byte prefixes).
+function B32 sort_index_String(const String* keys, U32 count, U32* indices, Arena* scratch);
+function B32 sort_String(String* keys, U32 count, Arena* scratch);
+
+// NOTE(ryl1k): One MSD pass on the highest differing bits splits the
+// array into 256 buckets, which worker threads then LSD sort on their
+// own. Falls back to the single-threaded sort for small arrays or
+// thread_count <= 1.
+function B32 radix_sort_parallel_U32(U32* keys, U64 count, U32 thread_count, Arena* scratch);
+function B32 radix_sort_parallel_U64(U64* keys, U64 count, U32 thread_count, Arena* scratch);
+function B32 radix_sort_parallel_S32(S32* keys, U64 count, U32 thread_count, Arena* scratch);
+function B32 radix_sort_parallel_S64(S64* keys, U64 count, U32 thread_count, Arena* scratch);
+function B32 radix_sort_parallel_F32(F32* keys, U64 count, U32 thread_count, Arena* scratch);
+function B32 radix_sort_parallel_F64(F64* keys, U64 count, U32 thread_count, Arena* scratch);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Bitset
+
+// NOTE(ryl1k): Fixed-size dense bitset. Words are padded to a cache line
+// and the padding is always zero, so whole-bitset operations run in SIMD
+// steps without tails. rank/select use a directory of set-bit counts per
+// 2048 bits, rebuilt on first use after a modification (so they are not
+// safe to call concurrently right after one). words is NULL if the
+// allocation failed.
+
+#define BITSET_RANK_WORDS 32
+
+typedef struct {
+    U64* words;
+    U64* rank;
+    U64 bit_count;
+    U64 word_count;
+    B32 rank_dirty;
+    void* memory;
+} Bitset;
+
+function Bitset bitset_create(Arena* arena, U64 bit_count);
+function Bitset bitset_create_arena64(Arena64* arena, U64 bit_count);
+function void bitset_destroy(Bitset* bitset);
+function void bitset_set(Bitset* bitset, U64 index);
+function void bitset_clear(Bitset* bitset, U64 index);
+function B32 bitset_test(const Bitset* bitset, U64 index);
+function void bitset_set_all(Bitset* bitset);
+function void bitset_clear_all(Bitset* bitset);
+function U64 bitset_popcount(const Bitset* bitset);
+function U64 bitset_rank(Bitset* bitset, U64 index);
+function U64 bitset_select(Bitset* bitset, U64 rank);
+function U64 bitset_next_set(const Bitset* bitset, U64 from);
+
+// NOTE(ryl1k): dst = a op b over the shortest of the three; dst may be a or b.
+function void bitset_and(Bitset* dst, const Bitset* a, const Bitset* b);
+function void bitset_or(Bitset* dst, const Bitset* a, const Bitset* b);
+function void bitset_xor(Bitset* dst, const Bitset* a, const Bitset* b);
+function void bitset_andnot(Bitset* dst, const Bitset* a, const Bitset* b);
+
+// NOTE(ryl1k): Compressed (Roaring) bitmap over U32 values for sparse sets.
+// Values are grouped by their high 16 bits into containers that hold the
+// low 16 bits either as a sorted U16 array (up to 4096 values) or as a
+// 65536-bit bitmap. With an arena, memory given up on growth or
+// conversion stays in the arena.
+
+#define ROARING_ARRAY_MAX 4096
+#define ROARING_BITMAP_WORDS 1024
+
+typedef enum {
+    RoaringContainer_Array,
+    RoaringContainer_Bitmap
+} RoaringContainerType;
+
+typedef struct {
+    U16 key;
+    U16 type;
+    U32 cardinality;
+    U32 capacity;
+    void* data;
+} RoaringContainer;
+
+typedef struct {
+    RoaringContainer* containers;
+    U32 count;
+    U32 capacity;
+    Arena* arena;
+} RoaringBitmap;
+
+function RoaringBitmap roaring_create(Arena* arena);
+function void roaring_destroy(RoaringBitmap* bitmap);
+function B32 roaring_add(RoaringBitmap* bitmap, U32 value);
+function B32 roaring_remove(RoaringBitmap* bitmap, U32 value);
+function B32 roaring_contains(const RoaringBitmap* bitmap, U32 value);
+function U64 roaring_cardinality(const RoaringBitmap* bitmap);
+function B32 roaring_next(const RoaringBitmap* bitmap, U32 from, U32* value);
+
+// NOTE(ryl1k): result must be empty (fresh from roaring_create); returns 0
+// if an allocation failed part way.
+function B32 roaring_and(RoaringBitmap* result, const RoaringBitmap* a, const RoaringBitmap* b);
+function B32 roaring_or(RoaringBitmap* result, const RoaringBitmap* a, const RoaringBitmap* b);
+function B32 roaring_xor(RoaringBitmap* result, const RoaringBitmap* a, const RoaringBitmap* b);
+function B32 roaring_andnot(RoaringBitmap* result, const RoaringBitmap* a, const RoaringBitmap* b);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Priority Queue
+
+// NOTE(ryl1k): Array-backed 4-ary min-heap on U64 keys. The four children
+// of an entry share one cache line. push returns a handle that stays
+// valid until the entry is popped or removed, for changing its key.
 
+#define HEAP_INVALID_HANDLE 0xFFFFFFFFu
+
+typedef struct {
+    U64 key;
+    U32 handle;
+    U32 unused;
+} HeapEntry;
+
+typedef struct {
+    U32 position;
+    U32 next_free;
+    void* value;
+} HeapHandle;
+
+typedef struct {
+    HeapEntry* entries;
+    HeapHandle* handles;
+    U32 count;
+    U32 capacity;
+    U32 handle_count;
+    U32 handle_capacity;
+    U32 free_handle;
+    void* memory;
+    Arena* arena;
+} Heap;
+
+function Heap heap_create(Arena* arena, U32 capacity);
+function void heap_destroy(Heap* heap);
+function U32 heap_push(Heap* heap, U64 key, void* value);
+function B32 heap_peek(Heap* heap, U64* key, void** value);
+function B32 heap_pop(Heap* heap, U64* key, void** value);
+function void heap_update(Heap* heap, U32 handle, U64 key);
+function void heap_remove(Heap* heap, U32 handle);
+function U64 heap_key(Heap* heap, U32 handle);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Timer Wheel
+
+// NOTE(ryl1k): Hierarchical timer wheel over integer ticks: four levels of
+// 256 slots, each slot a circular DLL_NODE list, so insert and cancel are
+// O(1). Level n holds timers due within 256^(n+1) ticks; its slots are
+// cascaded down as the wheel reaches them. Deadlines further out than
+// 2^32 ticks wait in the last level and are re-filed when it comes round.
+// TimerNode is intrusive; use ContainerOf to get back to the owner.
+
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_BITS 8
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+
+typedef struct TimerNode {
+    DLL_NODE(struct TimerNode);
+    U64 deadline;
+} TimerNode;
+
+typedef struct {
+    TimerNode slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    U64 occupied[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS / 64];
+    U64 next_tick;
+    void* memory;
+    Arena* arena;
+} TimerWheel;
+
+function void timer_list_init(TimerNode* list);
+function TimerNode* timer_list_pop(TimerNode* list);
+
+function TimerWheel* timer_wheel_create(Arena* arena, U64 now);
+function void timer_wheel_destroy(TimerWheel* wheel);
+function void timer_wheel_add(TimerWheel* wheel, TimerNode* node, U64 deadline);
+function void timer_wheel_cancel(TimerWheel* wheel, TimerNode* node);
+function B32 timer_wheel_pending(TimerNode* node);
+function void timer_wheel_advance(TimerWheel* wheel, U64 now, TimerNode* expired);
 
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Inline Functions
+
+// NOTE(ryl1k): Defined in the header so calls inline in every build mode,
+// BASE_LIBRARY without LTO included.
+
+inline_function F32 abs_F32(F32 x) {
+    union { F32 f; U32 u; } r;
+    r.f = x;
+    r.u &= 0x7fffffff;
+    return r.f;
+}
+
+inline_function F64 abs_F64(F64 x) {
+    union{F64 f; U64 u;} r;
+    r.f = x;
+    r.u &= 0x7fffffffffffffffllu;
+    return r.f;
+}
+
+inline_function F32 sqrt_F32(F32 x) {
+    return(sqrtf(x));
+}
+
+inline_function F64 sqrt_F64(F64 x) {
+    return(sqrt(x));
+}
+
+inline_function F32 lerp_F32(F32 a, F32 b, F32 t) {
+    return(a + t * (b - a));
+}
+
+inline_function F32 unlerp_F32(F32 a, F32 b, F32 x) {
+    return((x - a) / (b - a));
+}
+
+inline_function void* arena_alloc(Arena* arena, size_t alloc_size) {
+    if (arena->used + alloc_size > arena->size) {
+        return NULL; 
+    }
+    void* result = arena->base + arena->used;
+    arena->used += alloc_size;
+    return result;
+}
+
+inline_function void* arena64_alloc(Arena64* arena, uint64_t alloc_size) {
+    if (arena->used + alloc_size > arena->size) {
+        return NULL; 
+    }
+    void* result = arena->base + arena->used;
+    arena->used += alloc_size;
+    return result;
+}
+
+inline_function void* arena_alloc_aligned(Arena* arena, size_t alloc_size, size_t alignment) {
+    size_t padding = (alignment - ((uintptr_t)(arena->base + arena->used) & (alignment - 1))) & (alignment - 1);
+    if (arena->used + padding + alloc_size > arena->size) {
+        return NULL;
+    }
+    arena->used += padding;
+    return arena_alloc(arena, alloc_size);
+}
+
+inline_function void* arena64_alloc_aligned(Arena64* arena, uint64_t alloc_size, uint64_t alignment) {
+    uint64_t padding = (alignment - ((uintptr_t)(arena->base + arena->used) & (alignment - 1))) & (alignment - 1);
+    if (arena->used + padding + alloc_size > arena->size) {
+        return NULL;
+    }
+    arena->used += padding;
+    return arena64_alloc(arena, alloc_size);
+}
+
+inline_function V2S32 v2s32(S32 x, S32 y) {
+    V2S32 r = { x,y };
+    return (r);
+}
+
+inline_function V2F32 v2f32(F32 x, F32 y) {
+    V2F32 r = { x,y };
+    return (r);
+}
+
+inline_function V3F32 v3f32(F32 x, F32 y, F32 z) {
+    V3F32 r = { x,y,z };
+    return (r);
+}
+
+inline_function V4F32 v4f32(F32 x, F32 y, F32 z, F32 w) {
+    V4F32 r = { x,y,z,w };
+    return (r);
+}
+
+inline_function I1F32 i1f32(F32 min, F32 max) {
+    I1F32 r = { min, max };
+    if (max < min) {
+        r.min = max;
+        r.max = min;
+    }
+    return(r);
+}
+
+inline_function I1U64 i1u64(U64 min, U64 max) {
+    I1U64 r = {min, max};
+    if (max < min) {
+        r.min = max;
+        r.max = min;
+    }
+    return(r);
+}
+
+inline_function I2S32 i2s32(S32 x0, S32 y0, S32 x1, S32 y1) {
+    I2S32 r = { x0,y0,x1,y1 };
+    if (x1 < x0) {
+        r.x0 = x1;
+        r.x1 = x0;
+    }
+    if (y1 < y0) {
+        r.y1 = y0;
+        r.y0 = y1;
+    }
+    return(r);
+}
+
+inline_function I2S32 i2s32_vec(V2S32 min, V2S32 max) {
+    I2S32 r = i2s32(min.x, min.y, max.x, max.y);
+    return(r);
+}
+
+inline_function I2F32 i2f32(F32 x0, F32 y0, F32 x1, F32 y1) {
+    I2F32 r = { x0,y0,x1,y1 };
+    if (x1 < x0) {
+        r.x0 = x1;
+        r.x1 = x0;
+    }
+    if (y1 < y0) {
+        r.y1 = y0;
+        r.y0 = y1;
+    }
+    return(r);
+}
+
+inline_function I2F32 i2f32_vec(V2F32 min, V2F32 max) {
+    I2F32 r = i2f32(min.x, min.y, max.x, max.y);
+    return(r);
+}
+
+inline_function I2F32 i2f32_range(I1F32 x, I1F32 y) {
+    I2F32 r = i2f32(x.min, y.min, x.max, y.max);
+    return(r);
+}
+
+inline_function V2S32 add_V2S32(const V2S32 *a, const V2S32 *b) {
+    V2S32 r = { a->x + b->x, a->y + b->y };
+    return(r);
+}
+
+inline_function V2F32 add_V2F32(const V2F32 *a, const V2F32 *b) {
+    V2F32 r = { a->x + b->x, a->y + b->y };
+    return(r);
+}
+
+inline_function V3F32 add_V3F32(const V3F32 *a, const V3F32 *b) {
+    V3F32 r = { a->x + b->x, a->y + b->y, a->z + b->z };
+    return(r);
+}
+
+inline_function V4F32 add_V4F32(const V4F32 *a, const V4F32 *b) {
+    V4F32 r = { a->x + b->x, a->y + b->y, a->z + b->z, a->w + b->w };
+    return(r);
+}
+
+inline_function V2S32 subtract_V2S32(const V2S32 *a, const V2S32 *b) {
+    V2S32 r = { a->x - b->x, a->y - b->y };
+    return(r);
+}
+
+inline_function V2F32 subtract_V2F32(const V2F32 *a, const V2F32 *b) {
+    V2F32 r = { a->x - b->x, a->y - b->y };
+    return(r);
+}
+
+inline_function V3F32 subtract_V3F32(const V3F32 *a, const V3F32 *b) {
+    V3F32 r = { a->x - b->x, a->y - b->y, a->z - b->z };
+    return(r);
+}
+
+inline_function V4F32 subtract_V4F32(const V4F32 *a, const V4F32 *b) {
+    V4F32 r = { a->x - b->x, a->y - b->y, a->z - b->z, a->w - b->w };
+    return(r);
+}
+
+inline_function V2S32 multiply_V2S32(const V2S32 *v, const S32 *s) {
+    V2S32 r = { v->x * (*s), v->y * (*s) };
+    return(r);
+}
+
+inline_function V2F32 multiply_V2F32(const V2F32 *v, const F32 *s) {
+    V2F32 r = { v->x * (*s), v->y * (*s) };
+    return(r);
+}
+
+inline_function V3F32 multiply_V3F32(const V3F32 *v, const F32 *s) {
+    V3F32 r = { v->x * (*s), v->y * (*s), v->z * (*s) };
+    return(r);
+}
+
+inline_function V4F32 multiply_V4F32(const V4F32 *v, const F32 *s) {
+    V4F32 r = { v->x * (*s), v->y * (*s), v->z * (*s), v->w * (*s) };
+    return(r);
+}
+
+inline_function V2F32 V2F32_hadamard(V2F32 a, V2F32 b) {
+    V2F32 r = { a.x * b.x, a.y * b.y };
+    return (r);
+}
+
+inline_function V3F32 V3F32_hadamard(V3F32 a, V3F32 b) {
+    V3F32 r = { a.x * b.x, a.y * b.y, a.z * b.z };
+    return (r);
+}
+
+inline_function V4F32 V4F32_hadamard(V4F32 a, V4F32 b){
+    V4F32 r = { a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w };
+    return (r);
+}
+
+inline_function F32 V2F32_dot(V2F32 a, V2F32 b) {
+    return (a.x * b.x + a.y * b.y);
+}
+
+inline_function F32 V3F32_dot(V3F32 a, V3F32 b) {
+    return (a.x * b.x + a.y * b.y + a.z * b.z);
+}
+
+inline_function F32 V4F32_dot(V4F32 a, V4F32 b) {
+    return (a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w);
+}
+
+inline_function F32 V2F32_length_squared(V2F32 v) {
+    return (V2F32_dot(v, v));
+}
+
+inline_function F32 V3F32_length_squared(V3F32 v) {
+    return (V3F32_dot(v, v));
+}
+
+inline_function F32 V4F32_length_squared(V4F32 v) {
+    return (V4F32_dot(v, v));
+}
+
+inline_function F32 V2F32_length(V2F32 v) {
+    return (sqrt_F32(V2F32_dot(v, v)));
+}
+
+inline_function F32 V3F32_length(V3F32 v) {
+    return (sqrt_F32(V3F32_dot(v, v)));
+}
+
+inline_function F32 V4F32_length(V4F32 v) {
+    return (sqrt_F32(V4F32_dot(v, v)));
+}
+
+inline_function F32 V2F32_distance(V2F32 a, V2F32 b) {
+    return (V2F32_length(subtract_V2F32(&a, &b)));
+}
+
+inline_function F32 V3F32_distance(V3F32 a, V3F32 b) {
+    return (V3F32_length(subtract_V3F32(&a, &b)));
+}
+
+inline_function F32 V4F32_distance(V4F32 a, V4F32 b) {
+    return (V4F32_length(subtract_V4F32(&a, &b)));
+}
+
+inline_function V2F32 V2F32_normalize(V2F32 v) {
+    F32 length_squared = V2F32_dot(v, v);
+    F32 s = length_squared > 0.0f ? 1.0f / sqrt_F32(length_squared) : 0.0f;
+    return (multiply_V2F32(&v, &s));
+}
+
+inline_function V3F32 V3F32_normalize(V3F32 v) {
+    F32 length_squared = V3F32_dot(v, v);
+    F32 s = length_squared > 0.0f ? 1.0f / sqrt_F32(length_squared) : 0.0f;
+    return (multiply_V3F32(&v, &s));
+}
+
+inline_function V4F32 V4F32_normalize(V4F32 v) {
+    F32 length_squared = V4F32_dot(v, v);
+    F32 s = length_squared > 0.0f ? 1.0f / sqrt_F32(length_squared) : 0.0f;
+    return (multiply_V4F32(&v, &s));
+}
+
+inline_function V3F32 V3F32_cross(V3F32 a, V3F32 b) {
+    V3F32 r = {
+        a.y * b.z - a.z * b.y,
+        a.z * b.x - a.x * b.z,
+        a.x * b.y - a.y * b.x
+    };
+    return (r);
+}
+
+inline_function B32 I1F32_overlaps(I1F32 a, I1F32 b) {
+    B32 result = ( b.min < a.max && a.min < b.max );
+    return (result);
+}
+
+inline_function B32 I1F32_contains(I1F32 r, F32 x) {
+    B32 result = (r.min <= x && x < r.max);
+    return result;
+}
+
+inline_function B32 I2F32_contains(I2F32 r, V2F32 x) {
+    return (r.min.x <= x.x && x.x <= r.max.x &&
+        r.min.y <= x.y && x.y <= r.max.y); 
+}
+
+inline_function B32 I2F32_overlaps(I2F32 a, I2F32 b) {
+    return (b.min.x <= a.max.x && a.min.x <= b.max.x &&
+        b.min.y <= a.max.y && a.min.y <= b.max.y); 
+}
+
+inline_function B32 I2S32_overlaps(I2S32 a, I2S32 b) {
+    B32 result = (b.min.x < a.max.x && a.min.x < b.max.x &&
+                  b.min.y < a.max.y && a.min.y < b.max.y);
+    return result;
+}
+
+inline_function B32 I2S32_contains(I2S32 r, V2S32 x) {
+    B32 result = (r.min.x <= x.x && x.x < r.max.x &&
+                  r.min.y <= x.y && x.y < r.max.y);
+    return result;
+}
+
+inline_function I2S32 I2S32_intersection(I2S32 a, I2S32 b) {
+    I2S32 result;
+    result.x0 = Max(a.x0, b.x0);
+    result.y0 = Max(a.y0, b.y0);
+    result.x1 = Max(Min(a.x1, b.x1), result.x0);
+    result.y1 = Max(Min(a.y1, b.y1), result.y0);
+    return result;
+}
+
+inline_function I2S32 I2S32_union(I2S32 a, I2S32 b) {
+    I2S32 result;
+    result.x0 = Min(a.x0, b.x0);
+    result.y0 = Min(a.y0, b.y0);
+    result.x1 = Max(a.x1, b.x1);
+    result.y1 = Max(a.y1, b.y1);
+    return result;
+}
+
+inline_function F32 I1F32_dim(I1F32 r) {
+    if (r.max == FLT_MAX && r.min == -FLT_MAX) {
+        return FLT_MAX; 
+    }
+    return r.max - r.min;
+}
+
+inline_function U64 I1U64_dim(I1U64 r) {
+    U64 result = r.max - r.min;
+    return(result);
+}
+
+inline_function V2F32 I2F32_dim(I2F32 r) {
+    V2F32 result = { r.x1 - r.x0, r.y1 - r.y0 };
+    return(result);
+}
+
+inline_function V2S32 I2S32_dim(I2S32 r) {
+    V2S32 result = {r.x1 - r.x0, r.y1 - r.y0};
+    return(result);
+}
+
+inline_function F32 I1F32_center(I1F32 r) {
+    F32 result = (r.min + r.max) * 0.5f;
+    return(result);
+}
+
+inline_function V2F32 I2F32_center(I2F32 r) {
+    V2F32 result = {
+        .x = (r.min.x + r.max.x) * 0.5f,
+        .y = (r.min.y + r.max.y) * 0.5f
+    };
+    return result;
+}
 
-function F32 lerp_F32(F32 a, F32 b, F32 t);
-function F32 unlerp_F32(F32 a, F32 b, F32 x);
+inline_function I1F32 I1F32_axis(I2F32 r, Axis axis) {
+    I1F32 result = {
+        .min = r.min.v[axis],
+        .max = r.max.v[axis]
+    };
+    return result;
+}
 
 //////////////////////////////////////////////////////
 // NOTE(ryl1k): Compound Type Functions
 
-function V2S32 v2s32(S32 x, S32 y);
+// NOTE(ryl1k): A zero vector normalizes to zero. The _fast variants use
+// the hardware reciprocal square root plus one Newton step (~22 bits).
+function V2F32 V2F32_normalize_fast(V2F32 v);
+function V3F32 V3F32_normalize_fast(V3F32 v);
+function V4F32 V4F32_normalize_fast(V4F32 v);
+
+// NOTE(ryl1k): Matrices go by pointer (M4F32 is over-aligned, which some
+// ABIs cannot pass by value). M*F32_multiply(a, b) is the product a * b,
+// the transform that applies b first. m4f32_compose builds
+// translation * rotation * scale. The inverses return 0 and leave out
+// untouched when the determinant is exactly zero.
+function M3F32 m3f32_identity(void);
+function M4F32 m4f32_identity(void);
+function M3F32 m3f32_columns(V3F32 c0, V3F32 c1, V3F32 c2);
+function M4F32 m4f32_columns(V4F32 c0, V4F32 c1, V4F32 c2, V4F32 c3);
+function M4F32 m4f32_from_m3f32(const M3F32* m);
+function M3F32 m3f32_rotation(V3F32 axis, F32 radians);
+function M4F32 m4f32_translation(V3F32 t);
+function M4F32 m4f32_scale(V3F32 s);
+function M4F32 m4f32_compose(V3F32 translation, const M3F32* rotation, V3F32 scale);
+
+function M3F32 M3F32_multiply(const M3F32* a, const M3F32* b);
+function M4F32 M4F32_multiply(const M4F32* a, const M4F32* b);
+
+function M3F32 M3F32_transpose(const M3F32* m);
+function M4F32 M4F32_transpose(const M4F32* m);
+
+function F32 M3F32_determinant(const M3F32* m);
+function F32 M4F32_determinant(const M4F32* m);
+
+function B32 M3F32_inverse(const M3F32* m, M3F32* out);
+function B32 M4F32_inverse(const M4F32* m, M4F32* out);
+
+function V3F32 M3F32_multiply_V3F32(const M3F32* m, V3F32 v);
+function V4F32 M4F32_multiply_V4F32(const M4F32* m, V4F32 v);
+function V3F32 M4F32_transform_point(const M4F32* m, V3F32 p);
+function V3F32 M4F32_transform_direction(const M4F32* m, V3F32 d);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): CPU Features
+
+// NOTE(ryl1k): Instruction set flags and cache/core topology, detected on
+// the first query (any of the calls below) and cached for the process.
+// Flags are only set when the OS also saves the registers involved.
+// slow_pdep marks BMI2 parts where pdep/pext are microcoded (AMD before
+// Zen 3), so kernels should prefer the portable path there. Sizes are in
+// bytes and 0 when the OS does not report them; cache_line_size falls
+// back to CACHE_LINE_SIZE.
+
+typedef struct {
+    B32 sse2;
+    B32 sse41;
+    B32 sse42;
+    B32 popcnt;
+    B32 avx;
+    B32 avx2;
+    B32 fma;
+    B32 bmi1;
+    B32 bmi2;
+    B32 slow_pdep;
+    B32 avx512f;
+    B32 avx512cd;
+    B32 avx512dq;
+    B32 avx512bw;
+    B32 avx512vl;
+    B32 avx512vnni;
+    B32 neon;
+    B32 sve;
+} CPUFeatures;
+
+typedef struct {
+    U64 l1d_size;
+    U64 l1i_size;
+    U64 l2_size;
+    U64 l3_size;
+    U32 cache_line_size;
+    U32 core_count;
+    U32 thread_count;
+    U64 page_size;
+    U64 huge_page_size;
+} CPUTopology;
+
+typedef enum {
+    SIMDLevel_Scalar,
+    SIMDLevel_SSE2,
+    SIMDLevel_AVX2,
+    SIMDLevel_AVX512,
+    SIMDLevel_NEON
+} SIMDLevel;
+
+// NOTE(ryl1k): cpu_dispatch returns *slot, filling it on first use with
+// resolve(features), for kernels picked once per process:
+//     global void* volatile my_kernel_slot;
+//     ((MyKernel*)cpu_dispatch(&my_kernel_slot, my_kernel_resolve))(...);
+// A racing first call from two threads resolves twice to the same value.
+
+typedef void* CPUDispatchResolver(const CPUFeatures* features);
+
+function CPUFeatures cpu_features(void);
+function CPUTopology cpu_topology(void);
+function void* cpu_dispatch(void* volatile* slot, CPUDispatchResolver* resolve);
+function B32 simd_level_supported(SIMDLevel level);
+function SIMDLevel simd_level_best(void);
+function const char* simd_level_name(SIMDLevel level);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Vector Array Functions
+
+// NOTE(ryl1k): Elementwise kernels over count vectors, as AoS arrays of
+// V*F32, SoA component arrays, or plain F32 arrays. The widest SIMD level
+// the CPU supports is picked on first use; simd_select_level overrides it
+// (falling back to scalar if unsupported). fma/lerp fuse where the CPU can,
+// so results may differ from the scalar functions in the last bit. out
+// may alias the inputs.
+
+typedef union {
+    struct {
+        F32* x;
+        F32* y;
+    };
+    F32* v[2];
+} V2F32SoA;
+
+typedef union {
+    struct {
+        F32* x;
+        F32* y;
+        F32* z;
+    };
+    F32* v[3];
+} V3F32SoA;
+
+typedef union {
+    struct {
+        F32* x;
+        F32* y;
+        F32* z;
+        F32* w;
+    };
+    F32* v[4];
+} V4F32SoA;
+
+function SIMDLevel simd_select_level(SIMDLevel level);
+function SIMDLevel simd_current_level(void);
+
+function void add_F32_array(F32* out, const F32* a, const F32* b, U64 count);
+function void subtract_F32_array(F32* out, const F32* a, const F32* b, U64 count);
+function void scale_F32_array(F32* out, const F32* a, F32 s, U64 count);
+function void hadamard_F32_array(F32* out, const F32* a, const F32* b, U64 count);
+function void fma_F32_array(F32* out, const F32* a, const F32* b, const F32* c, U64 count);
+function void lerp_F32_array(F32* out, const F32* a, const F32* b, F32 t, U64 count);
+
+function void add_V2F32_array(V2F32* out, const V2F32* a, const V2F32* b, U64 count);
+function void add_V3F32_array(V3F32* out, const V3F32* a, const V3F32* b, U64 count);
+function void add_V4F32_array(V4F32* out, const V4F32* a, const V4F32* b, U64 count);
+
+function void subtract_V2F32_array(V2F32* out, const V2F32* a, const V2F32* b, U64 count);
+function void subtract_V3F32_array(V3F32* out, const V3F32* a, const V3F32* b, U64 count);
+function void subtract_V4F32_array(V4F32* out, const V4F32* a, const V4F32* b, U64 count);
+
+function void scale_V2F32_array(V2F32* out, const V2F32* a, F32 s, U64 count);
+function void scale_V3F32_array(V3F32* out, const V3F32* a, F32 s, U64 count);
+function void scale_V4F32_array(V4F32* out, const V4F32* a, F32 s, U64 count);
+
+function void hadamard_V2F32_array(V2F32* out, const V2F32* a, const V2F32* b, U64 count);
+function void hadamard_V3F32_array(V3F32* out, const V3F32* a, const V3F32* b, U64 count);
+function void hadamard_V4F32_array(V4F32* out, const V4F32* a, const V4F32* b, U64 count);
+
+function void fma_V2F32_array(V2F32* out, const V2F32* a, const V2F32* b, const V2F32* c, U64 count);
+function void fma_V3F32_array(V3F32* out, const V3F32* a, const V3F32* b, const V3F32* c, U64 count);
+function void fma_V4F32_array(V4F32* out, const V4F32* a, const V4F32* b, const V4F32* c, U64 count);
+
+function void lerp_V2F32_array(V2F32* out, const V2F32* a, const V2F32* b, F32 t, U64 count);
+function void lerp_V3F32_array(V3F32* out, const V3F32* a, const V3F32* b, F32 t, U64 count);
+function void lerp_V4F32_array(V4F32* out, const V4F32* a, const V4F32* b, F32 t, U64 count);
+
+function void add_V2F32_soa(V2F32SoA out, V2F32SoA a, V2F32SoA b, U64 count);
+function void add_V3F32_soa(V3F32SoA out, V3F32SoA a, V3F32SoA b, U64 count);
+function void add_V4F32_soa(V4F32SoA out, V4F32SoA a, V4F32SoA b, U64 count);
+
+function void subtract_V2F32_soa(V2F32SoA out, V2F32SoA a, V2F32SoA b, U64 count);
+function void subtract_V3F32_soa(V3F32SoA out, V3F32SoA a, V3F32SoA b, U64 count);
+function void subtract_V4F32_soa(V4F32SoA out, V4F32SoA a, V4F32SoA b, U64 count);
+
+function void scale_V2F32_soa(V2F32SoA out, V2F32SoA a, F32 s, U64 count);
+function void scale_V3F32_soa(V3F32SoA out, V3F32SoA a, F32 s, U64 count);
+function void scale_V4F32_soa(V4F32SoA out, V4F32SoA a, F32 s, U64 count);
+
+function void hadamard_V2F32_soa(V2F32SoA out, V2F32SoA a, V2F32SoA b, U64 count);
+function void hadamard_V3F32_soa(V3F32SoA out, V3F32SoA a, V3F32SoA b, U64 count);
+function void hadamard_V4F32_soa(V4F32SoA out, V4F32SoA a, V4F32SoA b, U64 count);
+
+function void fma_V2F32_soa(V2F32SoA out, V2F32SoA a, V2F32SoA b, V2F32SoA c, U64 count);
+function void fma_V3F32_soa(V3F32SoA out, V3F32SoA a, V3F32SoA b, V3F32SoA c, U64 count);
+function void fma_V4F32_soa(V4F32SoA out, V4F32SoA a, V4F32SoA b, V4F32SoA c, U64 count);
+
+function void lerp_V2F32_soa(V2F32SoA out, V2F32SoA a, V2F32SoA b, F32 t, U64 count);
+function void lerp_V3F32_soa(V3F32SoA out, V3F32SoA a, V3F32SoA b, F32 t, U64 count);
+function void lerp_V4F32_soa(V4F32SoA out, V4F32SoA a, V4F32SoA b, F32 t, U64 count);
+
+// NOTE(ryl1k): Reductions and many-to-one products. dot_F32_rows scores
+// row_count rows of dim floats against one query. Reductions of zero
+// elements give 0, +inf and -inf. Accumulation order differs by SIMD
+// level, so sums can differ in the last bits between levels.
+
+function F32 dot_F32_array(const F32* a, const F32* b, U64 count);
+function void dot_F32_rows(F32* out, const F32* rows, U64 row_count, U64 dim, const F32* query);
+
+function F32 sum_F32_array(const F32* a, U64 count);
+function F32 min_F32_array(const F32* a, U64 count);
+function F32 max_F32_array(const F32* a, U64 count);
+
+function void dot_V2F32_array(F32* out, const V2F32* a, V2F32 b, U64 count);
+function void dot_V3F32_array(F32* out, const V3F32* a, V3F32 b, U64 count);
+function void dot_V4F32_array(F32* out, const V4F32* a, V4F32 b, U64 count);
+
+function void normalize_V2F32_array(V2F32* out, const V2F32* a, U64 count);
+function void normalize_V3F32_array(V3F32* out, const V3F32* a, U64 count);
+function void normalize_V4F32_array(V4F32* out, const V4F32* a, U64 count);
+
+function void normalize_fast_V2F32_array(V2F32* out, const V2F32* a, U64 count);
+function void normalize_fast_V3F32_array(V3F32* out, const V3F32* a, U64 count);
+function void normalize_fast_V4F32_array(V4F32* out, const V4F32* a, U64 count);
+
+function V2F32 sum_V2F32_array(const V2F32* a, U64 count);
+function V3F32 sum_V3F32_array(const V3F32* a, U64 count);
+function V4F32 sum_V4F32_array(const V4F32* a, U64 count);
+
+function V2F32 min_V2F32_array(const V2F32* a, U64 count);
+function V3F32 min_V3F32_array(const V3F32* a, U64 count);
+function V4F32 min_V4F32_array(const V4F32* a, U64 count);
+
+function V2F32 max_V2F32_array(const V2F32* a, U64 count);
+function V3F32 max_V3F32_array(const V3F32* a, U64 count);
+function V4F32 max_V4F32_array(const V4F32* a, U64 count);
+
+function void dot_V2F32_soa(F32* out, V2F32SoA a, V2F32 b, U64 count);
+function void dot_V3F32_soa(F32* out, V3F32SoA a, V3F32 b, U64 count);
+function void dot_V4F32_soa(F32* out, V4F32SoA a, V4F32 b, U64 count);
+
+function void normalize_V2F32_soa(V2F32SoA out, V2F32SoA a, U64 count);
+function void normalize_V3F32_soa(V3F32SoA out, V3F32SoA a, U64 count);
+function void normalize_V4F32_soa(V4F32SoA out, V4F32SoA a, U64 count);
+
+function void normalize_fast_V2F32_soa(V2F32SoA out, V2F32SoA a, U64 count);
+function void normalize_fast_V3F32_soa(V3F32SoA out, V3F32SoA a, U64 count);
+function void normalize_fast_V4F32_soa(V4F32SoA out, V4F32SoA a, U64 count);
+
+function V2F32 sum_V2F32_soa(V2F32SoA a, U64 count);
+function V3F32 sum_V3F32_soa(V3F32SoA a, U64 count);
+function V4F32 sum_V4F32_soa(V4F32SoA a, U64 count);
+
+function V2F32 min_V2F32_soa(V2F32SoA a, U64 count);
+function V3F32 min_V3F32_soa(V3F32SoA a, U64 count);
+function V4F32 min_V4F32_soa(V4F32SoA a, U64 count);
+
+function V2F32 max_V2F32_soa(V2F32SoA a, U64 count);
+function V3F32 max_V3F32_soa(V3F32SoA a, U64 count);
+function V4F32 max_V4F32_soa(V4F32SoA a, U64 count);
+
+// NOTE(ryl1k): Batch transforms. transform_V3F32 applies a linear M3F32,
+// transform_points_V3F32 an affine M4F32 to points (w = 1, no divide), and
+// transform_V4F32 the full M4F32. StoreHint_Streaming writes the output
+// with non-temporal stores so that outputs larger than the cache do not
+// evict the input; the last few outputs may still go through the cache.
+// Only x86 has streaming stores; elsewhere the hint is ignored.
+
+typedef enum {
+    StoreHint_Cached,
+    StoreHint_Streaming
+} StoreHint;
+
+function void transform_V3F32_array(V3F32* out, const V3F32* a, const M3F32* m, U64 count, StoreHint hint);
+function void transform_points_V3F32_array(V3F32* out, const V3F32* a, const M4F32* m, U64 count, StoreHint hint);
+function void transform_V4F32_array(V4F32* out, const V4F32* a, const M4F32* m, U64 count, StoreHint hint);
+
+function void transform_V3F32_soa(V3F32SoA out, V3F32SoA a, const M3F32* m, U64 count, StoreHint hint);
+function void transform_points_V3F32_soa(V3F32SoA out, V3F32SoA a, const M4F32* m, U64 count, StoreHint hint);
+function void transform_V4F32_soa(V4F32SoA out, V4F32SoA a, const M4F32* m, U64 count, StoreHint hint);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Vector Math Functions
+
+// NOTE(ryl1k): Batch transcendental functions using the SIMD level picked
+// by simd_select_level. MathAccuracy_Full is within a couple of ULP of
+// libm over the whole range; MathAccuracy_Fast drops polynomial terms.
+// Max error against double-precision libm, F32 over every input (sin/cos
+// in [2^-20, 4096], exp in [-87, 88], log over positive normals), F64 from
+// bench.c, bench_vector_math; main.c checks the F32 fast worst cases:
+//   F32 full: sin/cos 2 ULP, exp 1 ULP, log 2 ULP, sqrt exact
+//   F32 fast: sin/cos 7 ULP, exp 39 ULP, log 3 ULP, sqrt 4 ULP
+//   F64 full: sin/cos 1 ULP, exp 1 ULP, log 2 ULP, sqrt exact
+//   F64 fast: about 4e-10 relative for sin/cos, exp and log; sqrt exact
+// Arguments the fast path cannot reduce exactly (|x| > 4096 (F32) or 1e6
+// (F64) for sin/cos, subnormal exp results, non-normal log inputs) are
+// computed with libm; exp saturates to 0 and inf. out may alias x.
+
+typedef enum {
+    MathAccuracy_Full,
+    MathAccuracy_Fast,
+    MathAccuracy_Count
+} MathAccuracy;
+
+function void sin_F32_array(F32* out, const F32* x, U64 count, MathAccuracy accuracy);
+function void cos_F32_array(F32* out, const F32* x, U64 count, MathAccuracy accuracy);
+function void sincos_F32_array(F32* out_sin, F32* out_cos, const F32* x, U64 count, MathAccuracy accuracy);
+function void exp_F32_array(F32* out, const F32* x, U64 count, MathAccuracy accuracy);
+function void log_F32_array(F32* out, const F32* x, U64 count, MathAccuracy accuracy);
+function void sqrt_F32_array(F32* out, const F32* x, U64 count, MathAccuracy accuracy);
+
+function void sin_F64_array(F64* out, const F64* x, U64 count, MathAccuracy accuracy);
+function void cos_F64_array(F64* out, const F64* x, U64 count, MathAccuracy accuracy);
+function void sincos_F64_array(F64* out_sin, F64* out_cos, const F64* x, U64 count, MathAccuracy accuracy);
+function void exp_F64_array(F64* out, const F64* x, U64 count, MathAccuracy accuracy);
+function void log_F64_array(F64* out, const F64* x, U64 count, MathAccuracy accuracy);
+function void sqrt_F64_array(F64* out, const F64* x, U64 count, MathAccuracy accuracy);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Box Array Functions
+
+// NOTE(ryl1k): Batch I2S32/V2S32 culling and clipping with the same
+// half-open rules as I2S32_overlaps/I2S32_contains. The _mask functions
+// write (count + 63) / 64 words, bit i % 64 of word i / 64 set for a hit;
+// the _indices functions write the hit indices in ascending order (out
+// needs room for count). Both return the hit count. intersect/union/clip
+// work elementwise and out may alias the inputs. Kernels follow
+// simd_select_level; the AVX-512 level uses the AVX2 kernels.
+// I2S32_intersection never inverts a box: empty results get max = min
+// on the empty axis. I2S32_union is the bounding box.
+
+typedef union {
+    struct {
+        S32* x;
+        S32* y;
+    };
+    S32* v[2];
+} V2S32SoA;
+
+typedef union {
+    struct {
+        S32* x0;
+        S32* y0;
+        S32* x1;
+        S32* y1;
+    };
+    S32* v[4];
+} I2S32SoA;
+
+function U64 overlaps_mask_I2S32_array(U64* out, const I2S32* boxes, I2S32 query, U64 count);
+function U64 overlaps_mask_I2S32_soa(U64* out, I2S32SoA boxes, I2S32 query, U64 count);
+function U64 overlaps_indices_I2S32_array(U32* out, const I2S32* boxes, I2S32 query, U64 count);
+function U64 overlaps_indices_I2S32_soa(U32* out, I2S32SoA boxes, I2S32 query, U64 count);
+
+function U64 contains_mask_V2S32_array(U64* out, const V2S32* points, I2S32 box, U64 count);
+function U64 contains_mask_V2S32_soa(U64* out, V2S32SoA points, I2S32 box, U64 count);
+function U64 contains_indices_V2S32_array(U32* out, const V2S32* points, I2S32 box, U64 count);
+function U64 contains_indices_V2S32_soa(U32* out, V2S32SoA points, I2S32 box, U64 count);
+
+function void intersect_I2S32_array(I2S32* out, const I2S32* a, const I2S32* b, U64 count);
+function void intersect_I2S32_soa(I2S32SoA out, I2S32SoA a, I2S32SoA b, U64 count);
+function void union_I2S32_array(I2S32* out, const I2S32* a, const I2S32* b, U64 count);
+function void union_I2S32_soa(I2S32SoA out, I2S32SoA a, I2S32SoA b, U64 count);
+function void clip_I2S32_array(I2S32* out, const I2S32* a, I2S32 clip, U64 count);
+function void clip_I2S32_soa(I2S32SoA out, I2S32SoA a, I2S32 clip, U64 count);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Spatial Index
+
+// NOTE(ryl1k): Indexes over an array of I2F32 or I2S32 boxes for overlap,
+// point and k-nearest queries. Hits follow I2F32_overlaps/I2F32_contains
+// (closed) or I2S32_overlaps/I2S32_contains (half-open) and are reported
+// as indices into the array given to build. Queries return the total hit
+// count and write at most max_out of them, in no particular order.
+// nearest writes up to k items sorted by squared distance from the point
+// to the box (0 inside) and returns how many it wrote.
+// Building again reuses the index's memory when the new boxes fit, so one
+// index can be rebuilt every frame; otherwise it allocates more, from the
+// arena (which keeps the old block) or with BASE_ALLOC. Build scratch is
+// taken from the arena and released before returning. build returns 0
+// and leaves an empty index if memory runs out.
+
+// NOTE(ryl1k): Bulk-loaded (Sort-Tile-Recursive) R-tree, 8 children per
+// node. Each node keeps its children's bounds as SoA F32 arrays so that
+// one node is tested in a few SIMD compares. I2S32 boxes are rounded
+// outward into the nodes and re-checked exactly at the leaves.
+
+#define RTREE_FANOUT 8
+#define RTREE_STACK 128
+
+typedef struct {
+    F32 x0[RTREE_FANOUT];
+    F32 y0[RTREE_FANOUT];
+    F32 x1[RTREE_FANOUT];
+    F32 y1[RTREE_FANOUT];
+    U32 child[RTREE_FANOUT];
+    U32 count;
+    B32 leaf;
+} RTreeNode;
+
+typedef struct {
+    RTreeNode* nodes;
+    I2S32* boxes_s32;
+    U32 node_count;
+    U32 node_capacity;
+    U32 item_count;
+    U32 box_capacity;
+    U32 root;
+    B32 is_s32;
+    void* memory;
+    Arena* arena;
+} RTree;
+
+function RTree rtree_create(Arena* arena);
+function void rtree_destroy(RTree* tree);
+function B32 rtree_build_I2F32(RTree* tree, const I2F32* boxes, U32 count);
+function B32 rtree_build_I2S32(RTree* tree, const I2S32* boxes, U32 count);
+function U32 rtree_query_I2F32(const RTree* tree, I2F32 box, U32* out, U32 max_out);
+function U32 rtree_query_I2S32(const RTree* tree, I2S32 box, U32* out, U32 max_out);
+function U32 rtree_query_point_V2F32(const RTree* tree, V2F32 point, U32* out, U32 max_out);
+function U32 rtree_query_point_V2S32(const RTree* tree, V2S32 point, U32* out, U32 max_out);
+function U32 rtree_nearest(const RTree* tree, V2F32 point, U32 k, U32* out, F32* out_distance_squared);
+
+// NOTE(ryl1k): Uniform grid over the bounds of the boxes, in compressed
+// rows: each box is listed in every cell it touches and an overlap query
+// reports it from one cell only. Best for boxes of similar size; with
+// cells_x or cells_y 0 the grid gets about one cell per box.
+
+#define SPATIAL_GRID_MAX_CELLS 1024
+
+typedef struct {
+    U32* cell_start;
+    U32* cell_items;
+    I2F32* bounds;
+    I2S32* boxes_s32;
+    F32 origin_x;
+    F32 origin_y;
+    F32 cell_width;
+    F32 cell_height;
+    U32 cells_x;
+    U32 cells_y;
+    U32 item_count;
+    U32 entry_count;
+    U32 cell_capacity;
+    U32 entry_capacity;
+    U32 item_capacity;
+    B32 is_s32;
+    Arena* arena;
+} SpatialGrid;
+
+function SpatialGrid spatial_grid_create(Arena* arena);
+function void spatial_grid_destroy(SpatialGrid* grid);
+function B32 spatial_grid_build_I2F32(SpatialGrid* grid, const I2F32* boxes, U32 count, U32 cells_x, U32 cells_y);
+function B32 spatial_grid_build_I2S32(SpatialGrid* grid, const I2S32* boxes, U32 count, U32 cells_x, U32 cells_y);
+function U32 spatial_grid_query_I2F32(const SpatialGrid* grid, I2F32 box, U32* out, U32 max_out);
+function U32 spatial_grid_query_I2S32(const SpatialGrid* grid, I2S32 box, U32* out, U32 max_out);
+function U32 spatial_grid_query_point_V2F32(const SpatialGrid* grid, V2F32 point, U32* out, U32 max_out);
+function U32 spatial_grid_query_point_V2S32(const SpatialGrid* grid, V2S32 point, U32* out, U32 max_out);
+function U32 spatial_grid_nearest(const SpatialGrid* grid, V2F32 point, U32 k, U32* out, F32* out_distance_squared);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Interval Index
+
+// NOTE(ryl1k): Interval tree over I1U64 or I1F32 ranges, half-open like
+// I1F32_overlaps/I1F32_contains: a range overlaps a query when
+// min < query.max && query.min < max, and contains x when min <= x < max,
+// so empty ranges never match. F32 ranges are stored as order-preserving
+// U64 keys (NaN is not supported). Build sorts the ranges by min into
+// flat arrays indexed as an implicit balanced tree, each node keeping the
+// largest max below it. insert goes to a small unsorted pending list and
+// remove marks a tombstone; both are merged into the sorted arrays once
+// the pending list outgrows sqrt(count) or half the entries are removed.
+// Queries return the total hit count and write at most max_out ids, in no
+// particular order. build uses the array index as the id; insert takes
+// one, and remove needs the same range and id to find the entry.
+
+typedef struct {
+    U64 min;
+    U64 max;
+    U64 max_end;
+    U32 id;
+    B32 removed;
+} IntervalEntry;
+
+typedef struct {
+    IntervalEntry* entries;
+    IntervalEntry* pending;
+    U32 count;
+    U32 capacity;
+    U32 pending_count;
+    U32 pending_capacity;
+    U32 removed_count;
+    U32 levels;
+    B32 is_f32;
+    Arena* arena;
+} IntervalTree;
+
+function IntervalTree interval_tree_create(Arena* arena);
+function void interval_tree_destroy(IntervalTree* tree);
+function B32 interval_tree_build_I1U64(IntervalTree* tree, const I1U64* ranges, U32 count);
+function B32 interval_tree_build_I1F32(IntervalTree* tree, const I1F32* ranges, U32 count);
+function B32 interval_tree_insert_I1U64(IntervalTree* tree, I1U64 range, U32 id);
+function B32 interval_tree_insert_I1F32(IntervalTree* tree, I1F32 range, U32 id);
+function B32 interval_tree_remove_I1U64(IntervalTree* tree, I1U64 range, U32 id);
+function B32 interval_tree_remove_I1F32(IntervalTree* tree, I1F32 range, U32 id);
+function U32 interval_tree_query_I1U64(const IntervalTree* tree, I1U64 range, U32* out, U32 max_out);
+function U32 interval_tree_query_I1F32(const IntervalTree* tree, I1F32 range, U32* out, U32 max_out);
+function U32 interval_tree_stab_U64(const IntervalTree* tree, U64 x, U32* out, U32 max_out);
+function U32 interval_tree_stab_F32(const IntervalTree* tree, F32 x, U32* out, U32 max_out);
+
+// NOTE(ryl1k): Set of U64 values kept as sorted, disjoint, non-adjacent,
+// non-empty I1U64 ranges in one flat array, so lookups are a binary
+// search and ranges[] can be walked directly. add/subtract/intersect
+// change the set in place by one range; union/difference/intersection
+// combine two sets into out, which must not be either input. Storage
+// grows like ARRAY_DEFINE arrays; calls that can grow return 0 and leave
+// the set unchanged when allocation fails. find returns the index of the
+// range containing x, or max_U64.
+
+typedef struct {
+    I1U64* ranges;
+    U64 count;
+    U64 capacity;
+    Arena* arena;
+} IntervalSet;
+
+function IntervalSet interval_set_create(Arena* arena);
+function void interval_set_destroy(IntervalSet* set);
+function void interval_set_clear(IntervalSet* set);
+function B32 interval_set_add(IntervalSet* set, I1U64 range);
+function B32 interval_set_subtract(IntervalSet* set, I1U64 range);
+function void interval_set_intersect(IntervalSet* set, I1U64 range);
+function B32 interval_set_union(IntervalSet* out, const IntervalSet* a, const IntervalSet* b);
+function B32 interval_set_difference(IntervalSet* out, const IntervalSet* a, const IntervalSet* b);
+function B32 interval_set_intersection(IntervalSet* out, const IntervalSet* a, const IntervalSet* b);
+function U64 interval_set_find(const IntervalSet* set, U64 x);
+function B32 interval_set_contains(const IntervalSet* set, U64 x);
+function B32 interval_set_overlaps(const IntervalSet* set, I1U64 range);
+function U64 interval_set_total(const IntervalSet* set);
 
-function V2F32 v2f32(F32 x, F32 y);
-function V3F32 v3f32(F32 x, F32 y, F32 z);
-function V4F32 v4f32(F32 x, F32 y, F32 z, F32 w);
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Random
 
-function I1F32 i1f32(F32 min, F32 max);
-function I1U64 i1u64(U64 min, U64 max);
+// NOTE(ryl1k): Small-state generators, not for cryptography. PCG32
+// (XSH-RR) gives U32s; each stream is a distinct sequence and advance
+// skips delta outputs in O(log delta). Xoshiro256 (xoshiro256**) gives
+// U64s and is seeded through splitmix64, so any seed works. jump moves it
+// 2^128 outputs ahead and long_jump 2^192; split returns the current
+// state and jumps rng, for non-overlapping per-thread streams. _bounded
+// is uniform in [0, bound) (0 for bound 0); _F32/_F64 are in [0, 1).
 
-function I2S32 i2s32(S32 x0, S32 y0, S32 x1, S32 y1);
-function I2S32 i2s32_vec(V2S32 min ,V2S32 max);
+typedef struct {
+    U64 state;
+    U64 inc;
+} PCG32;
 
-function I2F32 i2f32(F32 x0, F32 y0, F32 x1, F32 y1);
-function I2F32 i2f32_vec(V2F32 min, V2F32 max);
-function I2F32 i2f32_range(I1F32 x, I1F32 y);
+typedef struct {
+    U64 s[4];
+} Xoshiro256;
+
+function U64 splitmix64_next(U64* state);
+
+function PCG32 pcg32_seed(U64 seed, U64 stream);
+function U32 pcg32_next(PCG32* rng);
+function U32 pcg32_bounded(PCG32* rng, U32 bound);
+function F32 pcg32_F32(PCG32* rng);
+function void pcg32_advance(PCG32* rng, U64 delta);
+
+function Xoshiro256 xoshiro256_seed(U64 seed);
+function U64 xoshiro256_next(Xoshiro256* rng);
+function U64 xoshiro256_bounded(Xoshiro256* rng, U64 bound);
+function F32 xoshiro256_F32(Xoshiro256* rng);
+function F64 xoshiro256_F64(Xoshiro256* rng);
+function void xoshiro256_jump(Xoshiro256* rng);
+function void xoshiro256_long_jump(Xoshiro256* rng);
+function Xoshiro256 xoshiro256_split(Xoshiro256* rng);
+
+// NOTE(ryl1k): Bulk fills step RANDOM_LANES xoshiro256** streams side by
+// side (lane i is the source jumped i times, the source is left past the
+// last lane) with the SIMD level picked by simd_select_level. Integer
+// output is the same at every level; float output can differ in the last
+// bit where a level fuses the multiply-add. Each call uses whole steps,
+// dropping what is left of the last one. Floats are min + u * (max - min)
+// with u in [0, 1) from 24 (F32) or 52 (F64) random bits; rounding can
+// land on max, so every range is closed: [min, max]. Points are uniform in
+// the box and z lies in [z.min, z.max].
+
+#define RANDOM_LANES 8
 
-function V2S32 add_V2S32(const V2S32 *a, const V2S32 *b);
-function V2F32 add_V2F32(const V2F32 *a, const V2F32 *b);
-function V3F32 add_V3F32(const V3F32 *a, const V3F32 *b);
-function V4F32 add_V4F32(const V4F32 *a, const V4F32 *b);
+typedef struct {
+    U64 s[4][RANDOM_LANES];
+} RandomBulk;
 
-function V2S32 subtract_V2S32(const V2S32 *a, const V2S32 *b);
-function V2F32 subtract_V2F32(const V2F32 *a, const V2F32 *b);
-function V3F32 subtract_V3F32(const V3F32 *a, const V3F32 *b);
-function V4F32 subtract_V4F32(const V4F32 *a, const V4F32 *b);
+function RandomBulk random_bulk_seed(Xoshiro256* source);
+function void random_fill_U32(RandomBulk* rng, U32* out, U64 count);
+function void random_fill_U64(RandomBulk* rng, U64* out, U64 count);
+function void random_fill_F32(RandomBulk* rng, F32* out, U64 count, F32 min, F32 max);
+function void random_fill_F64(RandomBulk* rng, F64* out, U64 count, F64 min, F64 max);
+function void random_fill_V2F32(RandomBulk* rng, V2F32* out, U64 count, I2F32 box);
+function void random_fill_V3F32(RandomBulk* rng, V3F32* out, U64 count, I2F32 box, I1F32 z);
 
-function V2S32 multiply_V2S32(const V2S32 *v, const S32 *s);
-function V2F32 multiply_V2F32(const V2F32 *v, const F32 *s);
-function V3F32 multiply_V3F32(const V3F32 *v, const F32 *s);
-function V4F32 multiply_V4F32(const V4F32 *v, const F32 *s);
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Job System
+
+// NOTE(ryl1k): Fork-join work stealing. Each worker owns a Chase-Lev
+// deque: it pushes and pops its own jobs at the bottom, newest first while
+// they are cache-hot, and idle workers steal the oldest from the top.
+// unfinished counts the job itself plus its unfinished children; when it
+// reaches zero the job is done and its parent's count drops. Its top bit
+// marks a waiter asleep on the count. A job with a
+// parent is released when done; one without must be passed to job_wait
+// exactly once, which releases it. func may be NULL for a job that only
+// groups its children.
+//
+// Jobs come from a fixed pool (per-worker free lists that overflow into a
+// shared AtomicStack), so scheduling never allocates; when the pool is
+// empty job_create runs other jobs until one is released. A job that does
+// not fit its worker's deque runs inline. The creating thread is worker 0
+// and runs jobs only inside job_wait; other threads submit through a
+// shared MPMC queue and only sleep in job_wait. A system of one worker has
+// no thread to drain that queue, so it keeps a spare worker (the guest)
+// that one outside thread at a time borrows to run jobs in job_wait; the
+// others yield until it is free. Idle workers spin, yield, then sleep on a
+// futex until work is submitted. With pin_workers, worker i > 0 is pinned
+// to CPU i (os_thread_pin). worker_count 0 means one per CPU. Each job gets
+// its worker's scratch arena (scratch_size bytes), rewound when the job
+// returns, so nested jobs keep the caller's data.
+
+#define JOB_DEQUE_CAPACITY 4096
+#define JOB_POOL_PER_WORKER 4096
+#define JOB_FREE_LOCAL_MAX 64
+#define JOB_SPIN_COUNT 256
+#define JOB_YIELD_COUNT 16
+#define JOB_WAITING_BIT 0x80000000u
+
+typedef struct Job Job;
+typedef struct JobWorker JobWorker;
+typedef struct JobSystem JobSystem;
+
+typedef void JobFunc(JobWorker* worker, Job* job, void* data);
+
+struct Job {
+    JobFunc* func;
+    void* data;
+    Job* parent;
+    STACK_NODE(Job);
+    volatile U32 unfinished;
+    U8 pad[CACHE_LINE_SIZE - 4 * sizeof(void*) - sizeof(U32)];
+};
 
-function V2F32 V2F32_hadamard(V2F32 a, V2F32 b);
-function V3F32 V3F32_hadamard(V3F32 a, V3F32 b);
-function V4F32 V4F32_hadamard(V4F32 a, V4F32 b);
+typedef struct {
+    Job* volatile* slots;
+    U64 mask;
+    U8 pad0[CACHE_LINE_SIZE - sizeof(Job**) - sizeof(U64)];
+    volatile U64 top;
+    U8 pad1[CACHE_LINE_SIZE - sizeof(U64)];
+    volatile U64 bottom;
+    U8 pad2[CACHE_LINE_SIZE - sizeof(U64)];
+} JobDeque;
+
+struct JobWorker {
+    JobDeque deque;
+    JobSystem* system;
+    Arena scratch;
+    U32 index;
+    U32 free_count;
+    Job* free_jobs;
+    PCG32 rng;
+    OSThread thread;
+    U8 pad[2 * CACHE_LINE_SIZE - sizeof(JobSystem*) - sizeof(Arena) - 2 * sizeof(U32) -
+           sizeof(Job*) - sizeof(PCG32) - sizeof(OSThread)];
+};
+
+struct JobSystem {
+    JobWorker* workers;
+    U32 worker_count;
+    B32 pin_workers;
+    MPMCQueue* inbox;
+    AtomicStack free_jobs;
+    void* memory;
+    Arena* arena;
+    volatile U64 running;
+    volatile U64 sleepers;
+    volatile U64 guest_taken;
+    volatile U32 epoch;
+};
+
+function JobSystem* job_system_create(Arena* arena, U32 worker_count, U64 scratch_size, B32 pin_workers);
+function void job_system_destroy(JobSystem* system);
+function Job* job_create(JobSystem* system, Job* parent, JobFunc* func, void* data);
+function void job_submit(JobSystem* system, Job* job);
+function void job_wait(JobSystem* system, Job* job);
+function B32 job_is_done(Job* job);
 
-function V2F32 V2F32_dot(V2F32 a, V2F32 b);
-function V3F32 V3F32_dot(V3F32 a, V3F32 b);
-function V4F32 V4F32_dot(V4F32 a, V4F32 b);
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Parallel Loops
+
+// NOTE(ryl1k): Split [0, count) into chunks of grain indices and run them
+// on a job system. grain 0 picks count / PARALLEL_MAX_CHUNKS, at least
+// PARALLEL_MIN_GRAIN, rounded up to PARALLEL_GRAIN_ALIGN so chunks of a
+// cache-line-aligned array start on a cache line. Chunk boundaries depend
+// only on count and grain, never on the worker count or timing.
+//
+// The chunks form a fixed binary tree, split at the middle chunk. A range
+// forks its upper half into a job only while the running worker's deque is
+// empty, i.e. when there may be a thief to take it; otherwise it recurses
+// in place. Busy workers pay a call per chunk and idle ones still find
+// work. parallel_reduce has func write each chunk's partial and combine
+// fold the upper half into the lower at every node of that tree, so the
+// association order, and with it any float result, is the same on every
+// run. combine then folds the total into result, which holds the identity
+// on entry. Partials are at most PARALLEL_PARTIAL_MAX bytes and live on the
+// stack. Callable from any thread, including from inside a job.
+
+#define PARALLEL_MAX_CHUNKS 4096
+#define PARALLEL_MIN_GRAIN 256
+#define PARALLEL_GRAIN_ALIGN 64
+#define PARALLEL_PARTIAL_MAX 256
+
+typedef void ParallelForFunc(JobWorker* worker, U64 begin, U64 end, void* data);
+typedef void ParallelReduceFunc(JobWorker* worker, U64 begin, U64 end, void* data, void* partial);
+typedef void ParallelCombineFunc(void* into, const void* from, void* data);
+
+function U64 parallel_grain(U64 count, U64 grain);
+function void parallel_for(JobSystem* system, U64 count, U64 grain, ParallelForFunc* func, void* data);
+function void parallel_reduce(JobSystem* system, U64 count, U64 grain, U64 partial_size,
+                              ParallelReduceFunc* func, ParallelCombineFunc* combine, void* data, void* result);
 
-function B32 I1F32_overlaps(I1F32 a, I1F32 b);
-function B32 I1F32_contains(I1F32 r, F32 x);
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Timer
+
+// NOTE(ryl1k): timer_ticks reads the cheapest monotonic counter: the TSC
+// on x86 (assumed invariant, as on every x86 since about 2008), cntvct_el0
+// on ARM64, otherwise timer_ns. timer_frequency is ticks per second, read
+// from cntfrq_el0 or calibrated once against timer_ns (about
+// TIMER_CALIBRATION_NS of spinning on the first call). timer_ns is
+// CLOCK_MONOTONIC (QueryPerformanceCounter on Windows) in nanoseconds.
+
+#define TIMER_CALIBRATION_NS 10000000
+
+function U64 timer_ns(void);
+function U64 timer_frequency(void);
+function F64 timer_seconds(U64 ticks);
+function U64 timer_ticks_to_ns(U64 ticks);
+
+inline_function U64 timer_ticks(void) {
+#if defined(_MSC_VER) && (defined(_M_AMD64) || defined(_M_IX86))
+    return __rdtsc();
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    return (U64)_ReadStatusReg(ARM64_CNTVCT);
+#elif defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    U64 ticks;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return timer_ns();
+#endif
+}
 
-function B32 I2F32_overlaps(I2F32 a, I2F32 b);
-function B32 I2F32_contains(I2F32 r, V2F32 x);
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Profiler
+
+// NOTE(ryl1k): Zones are recorded only with BASE_PROFILE defined; without
+// it the macros expand to nothing and the profile_ functions do not exist.
+// Each thread records into its own buffer of PROFILE_EVENTS_PER_THREAD
+// complete zones, allocated on its first zone and kept after the thread
+// exits. A zone costs two timer reads and a store; zones past the buffer
+// or nested deeper than PROFILE_MAX_DEPTH are counted as dropped. Names
+// must outlive the profile (string literals, __func__).
+//
+// PROFILE_SCOPE(name) { ... } profiles a block that is left only at its
+// end; BEGIN/END pairs are for code with early exits. The export is the
+// Chrome trace event JSON that chrome://tracing and Perfetto load, with
+// timestamps from the earliest recorded zone. reset and export must not
+// race with zones being recorded.
+
+#define PROFILE_EVENTS_PER_THREAD (1 << 16)
+#define PROFILE_MAX_DEPTH 64
+
+#if defined(BASE_PROFILE)
 
-function B32 I2S32_overlaps(I2S32 a, I2S32 b);
-function B32 I2S32_contains(I2S32 r, V2S32 x);
+typedef struct {
+    const char* name;
+    U64 begin;
+    U64 end;
+} ProfileEvent;
+
+typedef struct ProfileThread ProfileThread;
+struct ProfileThread {
+    SLL_NODE(ProfileThread);
+    ProfileEvent* events;
+    volatile U64 count;
+    U64 dropped;
+    U32 id;
+    U32 depth;
+    char name[32];
+    ProfileEvent open[PROFILE_MAX_DEPTH];
+};
+
+function void profile_begin(const char* name);
+function void profile_end(void);
+function void profile_thread_name(const char* name);
+function U64 profile_dropped(void);
+function void profile_reset(void);
+function B32 profile_write_chrome_trace(const char* path);
+
+#define PROFILE_BEGIN(name) profile_begin(name)
+#define PROFILE_END() profile_end()
+#define PROFILE_FUNCTION_BEGIN() profile_begin(__func__)
+#define PROFILE_SCOPE(name) \
+    for (int profile_scope_ = (profile_begin(name), 0); !profile_scope_; profile_scope_ = (profile_end(), 1))
+#define PROFILE_THREAD_NAME(name) profile_thread_name(name)
 
-function F32 I1F32_dim(I1F32 r);
-function U64 I1U64_dim(I1U64 r);
-function V2F32 I2F32_dim(I2F32 r);
-function V2S32 I2S32_dim(I2S32 r);
+#else
 
-function F32 I1F32_center(I1F32 r);
-function V2F32 I2F32_center(I2F32 r);
+#define PROFILE_BEGIN(name)
+#define PROFILE_END()
+#define PROFILE_FUNCTION_BEGIN()
+#define PROFILE_SCOPE(name)
+#define PROFILE_THREAD_NAME(name)
 
-function I1F32 I1F32_axis(I2F32 r, Axis axis);
+#endif
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Benchmark Harness
+
+// NOTE(ryl1k): bench_run times func(data, iterations), which must repeat
+// its operation iterations times. The iteration count doubles until one
+// call takes at least sample_ns, which doubles as warm-up, then
+// BENCH_WARMUP_SAMPLES more calls are discarded and samples calls are
+// timed. Results are per op (ops operations and bytes bytes per
+// iteration): min, median, p99 and mean nanoseconds, and median timer
+// ticks per op and per byte. Ticks are reference cycles of the TSC on x86,
+// not core clocks, so turbo and throttling show up as ns but not cycles.
+// Only names containing filter run (all when NULL); bench_run returns
+// NULL for skipped ones and when it runs out of memory.
+//
+// DoNotOptimize(v) makes the compiler assume the lvalue v is read, so code
+// computing it is kept; ClobberMemory() assumes all memory is read and
+// written, so stores before it are kept.
+
+#define BENCH_SAMPLES 101
+#define BENCH_WARMUP_SAMPLES 3
+#define BENCH_SAMPLE_NS 2000000
+
+#if defined(_MSC_VER)
+#define DoNotOptimize(v) bench_escape((void*)&(v))
+#define ClobberMemory() _ReadWriteBarrier()
+#else
+#define DoNotOptimize(v) __asm__ __volatile__("" : : "r"(&(v)) : "memory")
+#define ClobberMemory() __asm__ __volatile__("" : : : "memory")
+#endif
+
+typedef void BenchFunc(void* data, U64 iterations);
+
+typedef struct {
+    const char* name;
+    U64 iterations;
+    U64 samples;
+    U64 ops;
+    U64 bytes;
+    F64 min_ns;
+    F64 median_ns;
+    F64 p99_ns;
+    F64 mean_ns;
+    F64 cycles_per_op;
+    F64 cycles_per_byte;
+} BenchResult;
+
+typedef struct {
+    BenchResult* results;
+    U64 count;
+    U64 capacity;
+    U64 samples;
+    U64 sample_ns;
+    const char* filter;
+} BenchSuite;
+
+function void bench_escape(void* p);
+function BenchSuite bench_suite_create(void);
+function void bench_suite_destroy(BenchSuite* suite);
+function BenchResult* bench_run(BenchSuite* suite, const char* name, BenchFunc* func, void* data, U64 ops, U64 bytes);
+function void bench_print_header(void);
+function void bench_print(const BenchResult* result);
+function B32 bench_write_json(const BenchSuite* suite, const char* path);
+function B32 bench_write_csv(const BenchSuite* suite, const char* path);
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Clock
+
+// NOTE(ryl1k): clock_snapshot returns the local calendar time for the
+// current second from a cache, refreshed (one localtime call) only when
+// the coarse wall clock moves to a new second, so per-call cost is one
+// coarse clock read and a copy. Refreshed snapshots are written to a ring
+// of CLOCK_SNAPSHOT_SLOTS and published with an atomic pointer; while one
+// thread refreshes, others keep returning the previous second. month is
+// 1-12, day 1-31, day_of_week 0-6 from Sunday, day_of_year 0-365,
+// utc_offset is in seconds east of UTC, and timestamp is ISO 8601
+// ("2024-05-17T09:30:00+02:00").
+//
+// The coarse readers return nanoseconds with the kernel tick resolution
+// (about 1-4 ms) for the cost of a memory read: CLOCK_REALTIME_COARSE /
+// CLOCK_MONOTONIC_COARSE on Linux, GetSystemTimeAsFileTime / GetTickCount64
+// on Windows, the precise clocks elsewhere.
+
+#define CLOCK_SNAPSHOT_SLOTS 16
+#define CLOCK_TIMESTAMP_SIZE 32
+
+typedef struct {
+    S64 epoch_seconds;
+    S32 utc_offset;
+    S32 year;
+    U8 month;
+    U8 day;
+    U8 hour;
+    U8 minute;
+    U8 second;
+    U8 day_of_week;
+    U16 day_of_year;
+    U32 timestamp_length;
+    char timestamp[CLOCK_TIMESTAMP_SIZE];
+} ClockSnapshot;
+
+function ClockSnapshot clock_snapshot(void);
+function U64 clock_realtime_coarse_ns(void);
+function U64 clock_monotonic_coarse_ns(void);
 
 #endif // BASE_H
 
@@ -0,0 +1,1668 @@
+#include "base.h"
+#if !defined(BASE_LIBRARY)
+#include "base.c"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#include <pthread.h>
+#endif
+
+F64 bench_seconds(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (F64)counter.QuadPart / (F64)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (F64)ts.tv_sec + (F64)ts.tv_nsec * 1e-9;
+#endif
+}
+
+U64 bench_rng_state = 0x9E3779B97F4A7C15llu;
+
+U64 bench_random(void) {
+    bench_rng_state ^= bench_rng_state << 13;
+    bench_rng_state ^= bench_rng_state >> 7;
+    bench_rng_state ^= bench_rng_state << 17;
+    return bench_rng_state;
+}
+
+void bench_report(const char* name, F64 seconds, U64 ops) {
+    printf("%-40s %8.2f ns/op\n", name, seconds * 1e9 / (F64)ops);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Hashtable vs chained DLL_NODE map
+
+typedef struct ChainNode {
+    DLL_NODE(struct ChainNode);
+    U64 key;
+    U64 value;
+} ChainNode;
+
+typedef struct {
+    ChainNode** buckets;
+    U64 bucket_mask;
+    Arena* arena;
+} ChainMap;
+
+ChainNode* chain_map_lookup(ChainMap* map, U64 key) {
+    ChainNode* node = map->buckets[hash_U64(key) & map->bucket_mask];
+    while (node && node->key != key) {
+        node = node->next;
+    }
+    return node;
+}
+
+void chain_map_insert(ChainMap* map, U64 key, U64 value) {
+    ChainNode* node = chain_map_lookup(map, key);
+    if (!node) {
+        ChainNode** head = &map->buckets[hash_U64(key) & map->bucket_mask];
+        node = arena_alloc(map->arena, sizeof(ChainNode));
+        DLL_INIT(node);
+        node->key = key;
+        node->next = *head;
+        if (*head) {
+            (*head)->prev = node;
+        }
+        *head = node;
+    }
+    node->value = value;
+}
+
+HASH_TABLE_DEFINE(BenchMap, U64, U64, hash_table_hash_U64, hash_table_equal_U64)
+
+void bench_hash_table(U64 count) {
+    Arena arena = arena_create(count * (sizeof(ChainNode) + 64) + (1 << 20));
+    U64* keys = BASE_ALLOC(count * sizeof(U64));
+    U64* hits = BASE_ALLOC(count * sizeof(U64));
+    U64* misses = BASE_ALLOC(count * sizeof(U64));
+    for (U64 i = 0; i < count; i++) {
+        keys[i] = bench_random();
+        hits[i] = keys[i];
+        misses[i] = bench_random();
+    }
+    // NOTE(ryl1k): Look keys up in a different order than they were
+    // inserted, otherwise the chained nodes are walked in arena order.
+    for (U64 i = count - 1; i > 0; i--) {
+        U64 j = bench_random() % (i + 1);
+        U64 t = hits[i];
+        hits[i] = hits[j];
+        hits[j] = t;
+    }
+    printf("\n--- Hashtable, %llu U64 keys ---\n", (unsigned long long)count);
+
+    ChainMap chain;
+    chain.arena = &arena;
+    chain.bucket_mask = 1;
+    while (chain.bucket_mask < count) {
+        chain.bucket_mask <<= 1;
+    }
+    chain.buckets = arena_alloc(&arena, chain.bucket_mask * sizeof(ChainNode*));
+    MemoryZero(chain.buckets, chain.bucket_mask * sizeof(ChainNode*));
+    chain.bucket_mask -= 1;
+
+    U64 sink = 0;
+    F64 t0 = bench_seconds();
+    for (U64 i = 0; i < count; i++) {
+        chain_map_insert(&chain, keys[i], i);
+    }
+    F64 t1 = bench_seconds();
+    for (U64 i = 0; i < count; i++) {
+        sink += chain_map_lookup(&chain, hits[i])->value;
+    }
+    F64 t2 = bench_seconds();
+    for (U64 i = 0; i < count; i++) {
+        sink += chain_map_lookup(&chain, misses[i]) != NULL;
+    }
+    F64 t3 = bench_seconds();
+    bench_report("chained insert", t1 - t0, count);
+    bench_report("chained lookup hit", t2 - t1, count);
+    bench_report("chained lookup miss", t3 - t2, count);
+
+    BenchMap map = BenchMap_create(NULL, 0);
+    t0 = bench_seconds();
+    for (U64 i = 0; i < count; i++) {
+        BenchMap_insert(&map, keys[i], i);
+    }
+    t1 = bench_seconds();
+    for (U64 i = 0; i < count; i++) {
+        sink += *BenchMap_lookup(&map, hits[i]);
+    }
+    t2 = bench_seconds();
+    for (U64 i = 0; i < count; i++) {
+        sink += BenchMap_lookup(&map, misses[i]) != NULL;
+    }
+    t3 = bench_seconds();
+    bench_report("hash_table insert (growing)", t1 - t0, count);
+    bench_report("hash_table lookup hit", t2 - t1, count);
+    bench_report("hash_table lookup miss", t3 - t2, count);
+    BenchMap_destroy(&map);
+
+    map = BenchMap_create(NULL, count);
+    t0 = bench_seconds();
+    for (U64 i = 0; i < count; i++) {
+        BenchMap_insert(&map, keys[i], i);
+    }
+    t1 = bench_seconds();
+    for (U64 i = 0; i < count; i++) {
+        BenchMap_erase(&map, keys[i]);
+    }
+    t2 = bench_seconds();
+    bench_report("hash_table insert (reserved)", t1 - t0, count);
+    bench_report("hash_table erase", t2 - t1, count);
+    BenchMap_destroy(&map);
+
+    printf("(checksum %llu)\n", (unsigned long long)sink);
+    BASE_FREE(keys);
+    BASE_FREE(hits);
+    BASE_FREE(misses);
+    arena_destroy(&arena);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Unrolled list vs DLL_NODE traversal
+
+typedef struct ListNode {
+    DLL_NODE(struct ListNode);
+    U64 value;
+} ListNode;
+
+U64 bench_sum_dll(ListNode* first) {
+    U64 sum = 0;
+    for (ListNode* node = first; node; node = node->next) {
+        sum += node->value;
+    }
+    return sum;
+}
+
+U64 bench_sum_unrolled(UnrolledList* list) {
+    U64 sum = 0;
+    for (UnrolledChunk* chunk = list->first; chunk; chunk = chunk->next) {
+        U64* values = (U64*)UNROLLED_CHUNK_DATA(chunk);
+        for (U64 i = 0; i < chunk->count; i++) {
+            sum += values[i];
+        }
+    }
+    return sum;
+}
+
+void bench_unrolled_list(U64 count, U64 passes) {
+    printf("\n--- List traversal, %llu U64 elements ---\n", (unsigned long long)count);
+    Arena arena = arena_create(count * sizeof(ListNode) + 2 * count * sizeof(U64) + (1 << 20));
+    ListNode* nodes = arena_alloc(&arena, count * sizeof(ListNode));
+
+    // NOTE(ryl1k): A list built up over time is linked in an order
+    // unrelated to where its nodes sit in memory; shuffle to model that.
+    U64* order = BASE_ALLOC(count * sizeof(U64));
+    for (U64 i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    for (U64 i = count - 1; i > 0; i--) {
+        U64 j = bench_random() % (i + 1);
+        U64 t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+    for (U64 i = 0; i < count; i++) {
+        ListNode* node = &nodes[order[i]];
+        node->value = i;
+        node->prev = i ? &nodes[order[i - 1]] : NULL;
+        node->next = (i + 1 < count) ? &nodes[order[i + 1]] : NULL;
+    }
+    ListNode* shuffled = &nodes[order[0]];
+
+    UnrolledList list = unrolled_list_create(&arena, sizeof(U64), 0);
+    for (U64 i = 0; i < count; i++) {
+        unrolled_list_push_back(&list, &i);
+    }
+
+    U64 sink = 0;
+    F64 t0 = bench_seconds();
+    for (U64 pass = 0; pass < passes; pass++) {
+        sink += bench_sum_dll(shuffled);
+    }
+    F64 t1 = bench_seconds();
+    for (U64 i = 0; i < count; i++) {
+        nodes[i].value = i;
+        nodes[i].prev = i ? &nodes[i - 1] : NULL;
+        nodes[i].next = (i + 1 < count) ? &nodes[i + 1] : NULL;
+    }
+    F64 t2 = bench_seconds();
+    for (U64 pass = 0; pass < passes; pass++) {
+        sink += bench_sum_dll(nodes);
+    }
+    F64 t3 = bench_seconds();
+    for (U64 pass = 0; pass < passes; pass++) {
+        sink += bench_sum_unrolled(&list);
+    }
+    F64 t4 = bench_seconds();
+    bench_report("DLL_NODE traversal (shuffled nodes)", t1 - t0, count * passes);
+    bench_report("DLL_NODE traversal (sequential nodes)", t3 - t2, count * passes);
+    bench_report("unrolled list traversal", t4 - t3, count * passes);
+
+    printf("(checksum %llu)\n", (unsigned long long)sink);
+    BASE_FREE(order);
+    arena_destroy(&arena);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Radix sort vs qsort
+
+int bench_compare_U32(const void* a, const void* b) {
+    U32 x = *(const U32*)a;
+    U32 y = *(const U32*)b;
+    return (x > y) - (x < y);
+}
+
+int bench_compare_U64(const void* a, const void* b) {
+    U64 x = *(const U64*)a;
+    U64 y = *(const U64*)b;
+    return (x > y) - (x < y);
+}
+
+int bench_compare_F32(const void* a, const void* b) {
+    F32 x = *(const F32*)a;
+    F32 y = *(const F32*)b;
+    return (x > y) - (x < y);
+}
+
+int bench_compare_String(const void* a, const void* b) {
+    const String* x = a;
+    const String* y = b;
+    int c = memcmp(x->data, y->data, (size_t)Min(x->length, y->length));
+    return c ? c : x->length - y->length;
+}
+
+void bench_sort(U64 count) {
+    printf("\n--- Sorting, %llu keys ---\n", (unsigned long long)count);
+    Arena scratch = arena_create(count * 48 + (1 << 20));
+    U64* source = BASE_ALLOC(count * sizeof(U64));
+    U64* keys = BASE_ALLOC(count * sizeof(U64));
+    for (U64 i = 0; i < count; i++) {
+        source[i] = bench_random();
+    }
+
+    U32* keys32 = (U32*)keys;
+    F32* keysf = (F32*)keys;
+    F64 t0, t1;
+    for (U64 i = 0; i < count; i++) {
+        keys32[i] = (U32)source[i];
+    }
+    t0 = bench_seconds();
+    qsort(keys32, count, sizeof(U32), bench_compare_U32);
+    t1 = bench_seconds();
+    bench_report("qsort U32", t1 - t0, count);
+    for (U64 i = 0; i < count; i++) {
+        keys32[i] = (U32)source[i];
+    }
+    t0 = bench_seconds();
+    radix_sort_U32(keys32, count, &scratch);
+    t1 = bench_seconds();
+    bench_report("radix_sort_U32", t1 - t0, count);
+
+    MemoryCopy(keys, source, count * sizeof(U64));
+    t0 = bench_seconds();
+    qsort(keys, count, sizeof(U64), bench_compare_U64);
+    t1 = bench_seconds();
+    bench_report("qsort U64", t1 - t0, count);
+    MemoryCopy(keys, source, count * sizeof(U64));
+    t0 = bench_seconds();
+    radix_sort_U64(keys, count, &scratch);
+    t1 = bench_seconds();
+    bench_report("radix_sort_U64", t1 - t0, count);
+
+    for (U64 i = 0; i < count; i++) {
+        keysf[i] = (F32)((S64)source[i] >> 40);
+    }
+    t0 = bench_seconds();
+    qsort(keysf, count, sizeof(F32), bench_compare_F32);
+    t1 = bench_seconds();
+    bench_report("qsort F32", t1 - t0, count);
+    for (U64 i = 0; i < count; i++) {
+        keysf[i] = (F32)((S64)source[i] >> 40);
+    }
+    t0 = bench_seconds();
+    radix_sort_F32(keysf, count, &scratch);
+    t1 = bench_seconds();
+    bench_report("radix_sort_F32", t1 - t0, count);
+
+    // NOTE(ryl1k): 16 random lowercase letters per string.
+    char* text = BASE_ALLOC(count * 16);
+    String* strings = BASE_ALLOC(count * sizeof(String));
+    for (U64 i = 0; i < count * 16; i++) {
+        text[i] = (char)('a' + bench_random() % 26);
+    }
+    for (U64 i = 0; i < count; i++) {
+        strings[i].data = text + i * 16;
+        strings[i].length = 16;
+        strings[i].encoding = Encoding_UTF8;
+    }
+    t0 = bench_seconds();
+    qsort(strings, count, sizeof(String), bench_compare_String);
+    t1 = bench_seconds();
+    bench_report("qsort String", t1 - t0, count);
+    for (U64 i = 0; i < count; i++) {
+        strings[i].data = text + i * 16;
+    }
+    t0 = bench_seconds();
+    sort_String(strings, (U32)count, &scratch);
+    t1 = bench_seconds();
+    bench_report("sort_String", t1 - t0, count);
+
+    for (U32 thread_count = 1; thread_count <= 8; thread_count *= 2) {
+        char name[64];
+        MemoryCopy(keys, source, count * sizeof(U64));
+        t0 = bench_seconds();
+        radix_sort_parallel_U64(keys, count, thread_count, &scratch);
+        t1 = bench_seconds();
+        snprintf(name, sizeof(name), "radix_sort_parallel_U64 (%u threads)", thread_count);
+        bench_report(name, t1 - t0, count);
+    }
+
+    BASE_FREE(text);
+    BASE_FREE(strings);
+    BASE_FREE(source);
+    BASE_FREE(keys);
+    arena_destroy(&scratch);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Timers: sorted DLL_NODE list vs heap vs timer wheel
+
+typedef struct BenchTimer {
+    DLL_NODE(struct BenchTimer);
+    TimerNode timer;
+    U64 deadline;
+    U32 handle;
+} BenchTimer;
+
+void bench_timers(U64 count, U64 horizon) {
+    printf("\n--- Timers, %llu pending over %llu ticks ---\n", (unsigned long long)count, (unsigned long long)horizon);
+    BenchTimer* timers = BASE_ALLOC(count * sizeof(BenchTimer));
+    MemoryZero(timers, count * sizeof(BenchTimer));
+    for (U64 i = 0; i < count; i++) {
+        timers[i].deadline = 1 + bench_random() % horizon;
+    }
+    U64 sink = 0;
+
+    // NOTE(ryl1k): The sorted list is built in order and then measured on a
+    // few random inserts, since filling it one insert at a time is O(n^2).
+    U64* sorted = BASE_ALLOC(count * sizeof(U64));
+    for (U64 i = 0; i < count; i++) {
+        sorted[i] = timers[i].deadline;
+    }
+    radix_sort_U64(sorted, count, NULL);
+    BenchTimer* nodes = BASE_ALLOC(count * sizeof(BenchTimer));
+    for (U64 i = 0; i < count; i++) {
+        nodes[i].deadline = sorted[i];
+        nodes[i].prev = i ? &nodes[i - 1] : NULL;
+        nodes[i].next = (i + 1 < count) ? &nodes[i + 1] : NULL;
+    }
+    BenchTimer extra[256];
+    F64 t0 = bench_seconds();
+    for (U64 i = 0; i < ArrayCount(extra); i++) {
+        BenchTimer* node = &extra[i];
+        node->deadline = 1 + bench_random() % horizon;
+        BenchTimer* at = &nodes[0];
+        while (at->next && at->next->deadline <= node->deadline) {
+            at = at->next;
+        }
+        DLL_INSERT_AFTER(at, node);
+    }
+    F64 t1 = bench_seconds();
+    bench_report("sorted DLL_NODE insert", t1 - t0, ArrayCount(extra));
+    BASE_FREE(nodes);
+    BASE_FREE(sorted);
+
+    Heap heap = heap_create(NULL, 0);
+    t0 = bench_seconds();
+    for (U64 i = 0; i < count; i++) {
+        timers[i].handle = heap_push(&heap, timers[i].deadline, &timers[i]);
+    }
+    t1 = bench_seconds();
+    for (U64 i = 0; i < count; i += 10) {
+        heap_remove(&heap, timers[i].handle);
+    }
+    F64 t2 = bench_seconds();
+    U64 popped = 0;
+    U64 key;
+    while (heap_pop(&heap, &key, NULL)) {
+        sink += key;
+        popped++;
+    }
+    F64 t3 = bench_seconds();
+    bench_report("heap push", t1 - t0, count);
+    bench_report("heap remove (10%)", t2 - t1, count / 10);
+    bench_report("heap pop", t3 - t2, popped);
+    heap_destroy(&heap);
+
+    TimerWheel* wheel = timer_wheel_create(NULL, 0);
+    t0 = bench_seconds();
+    for (U64 i = 0; i < count; i++) {
+        timer_wheel_add(wheel, &timers[i].timer, timers[i].deadline);
+    }
+    t1 = bench_seconds();
+    for (U64 i = 0; i < count; i += 10) {
+        timer_wheel_cancel(wheel, &timers[i].timer);
+    }
+    t2 = bench_seconds();
+    U64 expired_count = 0;
+    TimerNode expired;
+    timer_list_init(&expired);
+    for (U64 now = 0; now <= horizon; now += 1000) {
+        timer_wheel_advance(wheel, now, &expired);
+        TimerNode* node;
+        while ((node = timer_list_pop(&expired))) {
+            sink += ContainerOf(node, BenchTimer, timer)->deadline;
+            expired_count++;
+        }
+    }
+    t3 = bench_seconds();
+    bench_report("timer wheel add", t1 - t0, count);
+    bench_report("timer wheel cancel (10%)", t2 - t1, count / 10);
+    bench_report("timer wheel expire", t3 - t2, expired_count);
+    timer_wheel_destroy(wheel);
+
+    printf("(checksum %llu)\n", (unsigned long long)sink);
+    BASE_FREE(timers);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Batch V3F32 kernels vs per-element functions
+
+void bench_vector_kernels(U64 count, U64 passes) {
+    printf("\n--- V3F32 kernels, %llu vectors x %llu passes ---\n", (unsigned long long)count, (unsigned long long)passes);
+    V3F32* a = BASE_ALLOC(count * sizeof(V3F32));
+    V3F32* b = BASE_ALLOC(count * sizeof(V3F32));
+    V3F32* c = BASE_ALLOC(count * sizeof(V3F32));
+    V3F32* out = BASE_ALLOC(count * sizeof(V3F32));
+    F32* soa = BASE_ALLOC(count * 3 * 4 * sizeof(F32));
+    V3F32SoA sa = {{soa, soa + count, soa + 2 * count}};
+    V3F32SoA sb = {{soa + 3 * count, soa + 4 * count, soa + 5 * count}};
+    V3F32SoA sc = {{soa + 6 * count, soa + 7 * count, soa + 8 * count}};
+    V3F32SoA sout = {{soa + 9 * count, soa + 10 * count, soa + 11 * count}};
+    for (U64 i = 0; i < count; i++) {
+        for (U32 k = 0; k < 3; k++) {
+            a[i].v[k] = sa.v[k][i] = (F32)(bench_random() % 1000) * 0.01f;
+            b[i].v[k] = sb.v[k][i] = (F32)(bench_random() % 1000) * 0.01f;
+            c[i].v[k] = sc.v[k][i] = (F32)(bench_random() % 1000) * 0.01f;
+        }
+    }
+    F64 sink = 0;
+    U64 ops = count * passes;
+
+    F64 t0 = bench_seconds();
+    for (U64 p = 0; p < passes; p++) {
+        for (U64 i = 0; i < count; i++) {
+            out[i] = add_V3F32(&a[i], &b[i]);
+        }
+        sink += out[p % count].x;
+    }
+    F64 t1 = bench_seconds();
+    for (U64 p = 0; p < passes; p++) {
+        for (U64 i = 0; i < count; i++) {
+            V3F32 ab = V3F32_hadamard(a[i], b[i]);
+            out[i] = add_V3F32(&ab, &c[i]);
+        }
+        sink += out[p % count].x;
+    }
+    F64 t2 = bench_seconds();
+    for (U64 p = 0; p < passes; p++) {
+        for (U64 i = 0; i < count; i++) {
+            out[i] = v3f32(lerp_F32(a[i].x, b[i].x, 0.25f), lerp_F32(a[i].y, b[i].y, 0.25f), lerp_F32(a[i].z, b[i].z, 0.25f));
+        }
+        sink += out[p % count].x;
+    }
+    F64 t3 = bench_seconds();
+    bench_report("per-element add_V3F32", t1 - t0, ops);
+    bench_report("per-element hadamard + add", t2 - t1, ops);
+    bench_report("per-element lerp_F32", t3 - t2, ops);
+
+    SIMDLevel levels[] = {SIMDLevel_Scalar, SIMDLevel_SSE2, SIMDLevel_AVX2, SIMDLevel_AVX512, SIMDLevel_NEON};
+    for (U32 l = 0; l < ArrayCount(levels); l++) {
+        if (!simd_level_supported(levels[l])) {
+            continue;
+        }
+        simd_select_level(levels[l]);
+        char name[64];
+
+        t0 = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            add_V3F32_array(out, a, b, count);
+            sink += out[p % count].x;
+        }
+        t1 = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            fma_V3F32_array(out, a, b, c, count);
+            sink += out[p % count].x;
+        }
+        t2 = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            lerp_V3F32_array(out, a, b, 0.25f, count);
+            sink += out[p % count].x;
+        }
+        t3 = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            fma_V3F32_soa(sout, sa, sb, sc, count);
+            sink += sout.x[p % count];
+        }
+        F64 t4 = bench_seconds();
+        snprintf(name, sizeof(name), "add_V3F32_array (%s)", simd_level_name(levels[l]));
+        bench_report(name, t1 - t0, ops);
+        snprintf(name, sizeof(name), "fma_V3F32_array (%s)", simd_level_name(levels[l]));
+        bench_report(name, t2 - t1, ops);
+        snprintf(name, sizeof(name), "lerp_V3F32_array (%s)", simd_level_name(levels[l]));
+        bench_report(name, t3 - t2, ops);
+        snprintf(name, sizeof(name), "fma_V3F32_soa (%s)", simd_level_name(levels[l]));
+        bench_report(name, t4 - t3, ops);
+    }
+    simd_select_level(simd_level_best());
+
+    printf("(checksum %f)\n", sink);
+    BASE_FREE(soa);
+    BASE_FREE(out);
+    BASE_FREE(c);
+    BASE_FREE(b);
+    BASE_FREE(a);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Batch V3F32 dot/normalize/reductions vs per-element functions
+
+void bench_vector_reductions(U64 count, U64 passes) {
+    printf("\n--- V3F32 reductions, %llu vectors x %llu passes ---\n", (unsigned long long)count, (unsigned long long)passes);
+    V3F32* a = BASE_ALLOC(count * sizeof(V3F32));
+    V3F32* out = BASE_ALLOC(count * sizeof(V3F32));
+    F32* dots = BASE_ALLOC(count * sizeof(F32));
+    F32* soa = BASE_ALLOC(count * 3 * sizeof(F32));
+    V3F32SoA sa = {{soa, soa + count, soa + 2 * count}};
+    for (U64 i = 0; i < count; i++) {
+        for (U32 k = 0; k < 3; k++) {
+            a[i].v[k] = sa.v[k][i] = (F32)(bench_random() % 1000) * 0.01f - 5.0f;
+        }
+    }
+    V3F32 query = v3f32(0.25f, -0.5f, 0.75f);
+    F64 sink = 0;
+    U64 ops = count * passes;
+
+    F64 t0 = bench_seconds();
+    for (U64 p = 0; p < passes; p++) {
+        for (U64 i = 0; i < count; i++) {
+            dots[i] = V3F32_dot(a[i], query);
+        }
+        sink += dots[p % count];
+    }
+    F64 t1 = bench_seconds();
+    for (U64 p = 0; p < passes; p++) {
+        for (U64 i = 0; i < count; i++) {
+            out[i] = V3F32_normalize(a[i]);
+        }
+        sink += out[p % count].x;
+    }
+    F64 t2 = bench_seconds();
+    for (U64 p = 0; p < passes; p++) {
+        V3F32 sum = {0};
+        for (U64 i = 0; i < count; i++) {
+            sum = add_V3F32(&sum, &a[i]);
+        }
+        sink += sum.x;
+    }
+    F64 t3 = bench_seconds();
+    bench_report("per-element V3F32_dot", t1 - t0, ops);
+    bench_report("per-element V3F32_normalize", t2 - t1, ops);
+    bench_report("per-element add_V3F32 sum", t3 - t2, ops);
+
+    SIMDLevel levels[] = {SIMDLevel_Scalar, SIMDLevel_SSE2, SIMDLevel_AVX2, SIMDLevel_AVX512, SIMDLevel_NEON};
+    for (U32 l = 0; l < ArrayCount(levels); l++) {
+        if (!simd_level_supported(levels[l])) {
+            continue;
+        }
+        simd_select_level(levels[l]);
+        const char* level = simd_level_name(levels[l]);
+        char name[64];
+        F64 t[8];
+        t[0] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            dot_V3F32_array(dots, a, query, count);
+            sink += dots[p % count];
+        }
+        t[1] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            dot_V3F32_soa(dots, sa, query, count);
+            sink += dots[p % count];
+        }
+        t[2] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            normalize_V3F32_array(out, a, count);
+            sink += out[p % count].x;
+        }
+        t[3] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            normalize_fast_V3F32_array(out, a, count);
+            sink += out[p % count].x;
+        }
+        t[4] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            sink += sum_V3F32_array(a, count).x;
+        }
+        t[5] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            sink += max_V3F32_soa(sa, count).z;
+        }
+        t[6] = bench_seconds();
+        const char* names[] = {"dot_V3F32_array", "dot_V3F32_soa", "normalize_V3F32_array",
+                               "normalize_fast_V3F32_array", "sum_V3F32_array", "max_V3F32_soa"};
+        for (U32 i = 0; i < ArrayCount(names); i++) {
+            snprintf(name, sizeof(name), "%s (%s)", names[i], level);
+            bench_report(name, t[i + 1] - t[i], ops);
+        }
+    }
+
+    // NOTE(ryl1k): Similarity scoring: count / 128 rows of 128-float embeddings.
+    U64 dim = 128;
+    U64 rows = count * 3 / dim;
+    F32 embedding_query[128];
+    for (U64 i = 0; i < dim; i++) {
+        embedding_query[i] = (F32)(bench_random() % 1000) * 0.001f;
+    }
+    simd_select_level(SIMDLevel_Scalar);
+    t0 = bench_seconds();
+    for (U64 p = 0; p < passes; p++) {
+        dot_F32_rows(dots, soa, rows, dim, embedding_query);
+        sink += dots[p % rows];
+    }
+    t1 = bench_seconds();
+    simd_select_level(simd_level_best());
+    for (U64 p = 0; p < passes; p++) {
+        dot_F32_rows(dots, soa, rows, dim, embedding_query);
+        sink += dots[p % rows];
+    }
+    t2 = bench_seconds();
+    char name_rows[64];
+    snprintf(name_rows, sizeof(name_rows), "dot_F32_rows dim 128 (%s)", simd_level_name(simd_current_level()));
+    bench_report("dot_F32_rows dim 128 (scalar)", t1 - t0, rows * passes);
+    bench_report(name_rows, t2 - t1, rows * passes);
+
+    printf("(checksum %f)\n", sink);
+    BASE_FREE(soa);
+    BASE_FREE(dots);
+    BASE_FREE(out);
+    BASE_FREE(a);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Batch point transforms (AoS/SoA, cached vs streaming stores)
+
+void bench_transforms(U64 count, U64 passes) {
+    printf("\n--- M4F32 point transforms, %llu points x %llu passes ---\n", (unsigned long long)count, (unsigned long long)passes);
+    V3F32* a = BASE_ALLOC(count * sizeof(V3F32));
+    V3F32* out = BASE_ALLOC(count * sizeof(V3F32));
+    F32* soa = BASE_ALLOC(count * 3 * sizeof(F32));
+    F32* soa_out = BASE_ALLOC(count * 3 * sizeof(F32));
+    V3F32SoA sa = {{soa, soa + count, soa + 2 * count}};
+    V3F32SoA so = {{soa_out, soa_out + count, soa_out + 2 * count}};
+    for (U64 i = 0; i < count; i++) {
+        for (U32 k = 0; k < 3; k++) {
+            a[i].v[k] = sa.v[k][i] = (F32)(bench_random() % 1000) * 0.01f - 5.0f;
+        }
+    }
+    M3F32 rotation = m3f32_rotation(v3f32(1.0f, 2.0f, 3.0f), 0.5f);
+    M4F32 m = m4f32_compose(v3f32(10.0f, -3.0f, 2.5f), &rotation, v3f32(2.0f, 2.0f, 2.0f));
+    F64 sink = 0;
+    U64 ops = count * passes;
+
+    F64 t0 = bench_seconds();
+    for (U64 p = 0; p < passes; p++) {
+        for (U64 i = 0; i < count; i++) {
+            out[i] = M4F32_transform_point(&m, a[i]);
+        }
+        sink += out[p % count].x;
+    }
+    F64 t1 = bench_seconds();
+    bench_report("per-element M4F32_transform_point", t1 - t0, ops);
+
+    SIMDLevel levels[] = {SIMDLevel_Scalar, SIMDLevel_SSE2, SIMDLevel_AVX2, SIMDLevel_AVX512, SIMDLevel_NEON};
+    for (U32 l = 0; l < ArrayCount(levels); l++) {
+        if (!simd_level_supported(levels[l])) {
+            continue;
+        }
+        simd_select_level(levels[l]);
+        const char* level = simd_level_name(levels[l]);
+        char name[64];
+        F64 t[5];
+        t[0] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            transform_points_V3F32_array(out, a, &m, count, StoreHint_Cached);
+            sink += out[p % count].x;
+        }
+        t[1] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            transform_points_V3F32_array(out, a, &m, count, StoreHint_Streaming);
+            sink += out[p % count].x;
+        }
+        t[2] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            transform_points_V3F32_soa(so, sa, &m, count, StoreHint_Cached);
+            sink += so.x[p % count];
+        }
+        t[3] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            transform_points_V3F32_soa(so, sa, &m, count, StoreHint_Streaming);
+            sink += so.x[p % count];
+        }
+        t[4] = bench_seconds();
+        snprintf(name, sizeof(name), "transform AoS cached (%s)", level);
+        bench_report(name, t[1] - t[0], ops);
+        snprintf(name, sizeof(name), "transform AoS streaming (%s)", level);
+        bench_report(name, t[2] - t[1], ops);
+        snprintf(name, sizeof(name), "transform SoA cached (%s)", level);
+        bench_report(name, t[3] - t[2], ops);
+        snprintf(name, sizeof(name), "transform SoA streaming (%s)", level);
+        bench_report(name, t[4] - t[3], ops);
+    }
+    simd_select_level(simd_level_best());
+
+    printf("(checksum %f)\n", sink);
+    BASE_FREE(soa_out);
+    BASE_FREE(soa);
+    BASE_FREE(out);
+    BASE_FREE(a);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Batch transcendental math vs libm (accuracy and throughput)
+
+U64 bench_ulp_F32(F32 a, F32 b) {
+    if (a != a || b != b) {
+        return (a != a && b != b) ? 0 : ~0llu;
+    }
+    union { F32 f; S32 i; } ua = {a}, ub = {b};
+    S64 ia = ua.i < 0 ? (S64)(S32)0x80000000 - ua.i : ua.i;
+    S64 ib = ub.i < 0 ? (S64)(S32)0x80000000 - ub.i : ub.i;
+    return (U64)(ia > ib ? ia - ib : ib - ia);
+}
+
+U64 bench_ulp_F64(F64 a, F64 b) {
+    if (a != a || b != b) {
+        return (a != a && b != b) ? 0 : ~0llu;
+    }
+    union { F64 f; S64 i; } ua = {a}, ub = {b};
+    S64 ia = ua.i < 0 ? (S64)0x8000000000000000llu - ua.i : ua.i;
+    S64 ib = ub.i < 0 ? (S64)0x8000000000000000llu - ub.i : ub.i;
+    return ia > ib ? (U64)(ia - ib) : (U64)(ib - ia);
+}
+
+typedef enum { BenchMath_Sin, BenchMath_Cos, BenchMath_Exp, BenchMath_Log, BenchMath_Sqrt, BenchMath_Count } BenchMath;
+
+const char* bench_math_names[BenchMath_Count] = { "sin", "cos", "exp", "log", "sqrt" };
+
+// NOTE(ryl1k): Inputs per function: sin/cos in [-100, 100] with a few huge
+// arguments, exp over its normal-result range, log log-uniform over many
+// decades, sqrt in [0, 1e6]. Special values are appended at the end.
+F64 bench_math_input(BenchMath f, B32 f32, U64 i) {
+    F64 u = (F64)(bench_random() >> 11) * (1.0 / 9007199254740992.0);
+    if (i % 997 == 0) {
+        F64 special[] = { 0.0, -0.0, 1.0, 1e30, -1e30, 1e-320, 1e300 };
+        return special[(i / 997) % ArrayCount(special)];
+    }
+    switch (f) {
+        case BenchMath_Sin:
+        case BenchMath_Cos: return (i % 101 == 0) ? (u - 0.5) * 1e8 : (u - 0.5) * 200.0;
+        case BenchMath_Exp: return f32 ? (u - 0.5) * 170.0 : (u - 0.5) * 1400.0;
+        case BenchMath_Log: return f32 ? pow(10.0, (u - 0.5) * 76.0) : pow(10.0, (u - 0.5) * 600.0);
+        case BenchMath_Sqrt: return u * 1e6;
+        default: return 0.0;
+    }
+}
+
+void bench_math_run_F32(BenchMath f, F32* out, const F32* x, U64 count, MathAccuracy accuracy) {
+    switch (f) {
+        case BenchMath_Sin: sin_F32_array(out, x, count, accuracy); break;
+        case BenchMath_Cos: cos_F32_array(out, x, count, accuracy); break;
+        case BenchMath_Exp: exp_F32_array(out, x, count, accuracy); break;
+        case BenchMath_Log: log_F32_array(out, x, count, accuracy); break;
+        case BenchMath_Sqrt: sqrt_F32_array(out, x, count, accuracy); break;
+        default: break;
+    }
+}
+
+void bench_math_run_F64(BenchMath f, F64* out, const F64* x, U64 count, MathAccuracy accuracy) {
+    switch (f) {
+        case BenchMath_Sin: sin_F64_array(out, x, count, accuracy); break;
+        case BenchMath_Cos: cos_F64_array(out, x, count, accuracy); break;
+        case BenchMath_Exp: exp_F64_array(out, x, count, accuracy); break;
+        case BenchMath_Log: log_F64_array(out, x, count, accuracy); break;
+        case BenchMath_Sqrt: sqrt_F64_array(out, x, count, accuracy); break;
+        default: break;
+    }
+}
+
+F64 bench_math_libm(BenchMath f, F64 x) {
+    switch (f) {
+        case BenchMath_Sin: return sin(x);
+        case BenchMath_Cos: return cos(x);
+        case BenchMath_Exp: return exp(x);
+        case BenchMath_Log: return log(x);
+        case BenchMath_Sqrt: return sqrt(x);
+        default: return 0.0;
+    }
+}
+
+F32 bench_math_libm_F32(BenchMath f, F32 x) {
+    switch (f) {
+        case BenchMath_Sin: return sinf(x);
+        case BenchMath_Cos: return cosf(x);
+        case BenchMath_Exp: return expf(x);
+        case BenchMath_Log: return logf(x);
+        case BenchMath_Sqrt: return sqrtf(x);
+        default: return 0.0f;
+    }
+}
+
+void bench_vector_math(U64 count, U64 passes) {
+    printf("\n--- Vector math, %llu elements x %llu passes (max ULP vs libm) ---\n", (unsigned long long)count, (unsigned long long)passes);
+    F32* x32 = BASE_ALLOC(count * sizeof(F32));
+    F32* out32 = BASE_ALLOC(count * sizeof(F32));
+    F32* ref32 = BASE_ALLOC(count * sizeof(F32));
+    F64* x64 = BASE_ALLOC(count * sizeof(F64));
+    F64* out64 = BASE_ALLOC(count * sizeof(F64));
+    F64* ref64 = BASE_ALLOC(count * sizeof(F64));
+    F64 sink = 0;
+    char name[64];
+
+    for (U32 f = 0; f < BenchMath_Count; f++) {
+        for (U64 i = 0; i < count; i++) {
+            x32[i] = (F32)bench_math_input((BenchMath)f, 1, i);
+            x64[i] = bench_math_input((BenchMath)f, 0, i);
+        }
+
+        // NOTE(ryl1k): F32 reference is the F64 libm result rounded, which is
+        // the correctly rounded value except in rare double-rounding cases.
+        F64 t0 = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            for (U64 i = 0; i < count; i++) {
+                out32[i] = bench_math_libm_F32((BenchMath)f, x32[i]);
+            }
+            sink += out32[p % count];
+        }
+        F64 t1 = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            for (U64 i = 0; i < count; i++) {
+                out64[i] = bench_math_libm((BenchMath)f, x64[i]);
+            }
+            sink += out64[p % count];
+        }
+        F64 t2 = bench_seconds();
+        snprintf(name, sizeof(name), "libm %sf", bench_math_names[f]);
+        bench_report(name, t1 - t0, count * passes);
+        snprintf(name, sizeof(name), "libm %s", bench_math_names[f]);
+        bench_report(name, t2 - t1, count * passes);
+        for (U64 i = 0; i < count; i++) {
+            ref32[i] = (F32)bench_math_libm((BenchMath)f, (F64)x32[i]);
+            ref64[i] = out64[i];
+        }
+
+        SIMDLevel levels[] = {SIMDLevel_SSE2, SIMDLevel_AVX2, SIMDLevel_NEON};
+        for (U32 l = 0; l < ArrayCount(levels); l++) {
+            if (!simd_level_supported(levels[l])) {
+                continue;
+            }
+            simd_select_level(levels[l]);
+            for (U32 a = 0; a < MathAccuracy_Count; a++) {
+                const char* tier = a == MathAccuracy_Full ? "full" : "fast";
+                t0 = bench_seconds();
+                for (U64 p = 0; p < passes; p++) {
+                    bench_math_run_F32((BenchMath)f, out32, x32, count, (MathAccuracy)a);
+                    sink += out32[p % count];
+                }
+                t1 = bench_seconds();
+                U64 max_ulp32 = 0;
+                for (U64 i = 0; i < count; i++) {
+                    max_ulp32 = Max(max_ulp32, bench_ulp_F32(out32[i], ref32[i]));
+                }
+                t2 = bench_seconds();
+                for (U64 p = 0; p < passes; p++) {
+                    bench_math_run_F64((BenchMath)f, out64, x64, count, (MathAccuracy)a);
+                    sink += out64[p % count];
+                }
+                F64 t3 = bench_seconds();
+                U64 max_ulp64 = 0;
+                for (U64 i = 0; i < count; i++) {
+                    max_ulp64 = Max(max_ulp64, bench_ulp_F64(out64[i], ref64[i]));
+                }
+                snprintf(name, sizeof(name), "%s_F32_array %s (%s)", bench_math_names[f], tier, simd_level_name(levels[l]));
+                bench_report(name, t1 - t0, count * passes);
+                printf("    max error: %llu ULP\n", (unsigned long long)max_ulp32);
+                snprintf(name, sizeof(name), "%s_F64_array %s (%s)", bench_math_names[f], tier, simd_level_name(levels[l]));
+                bench_report(name, t3 - t2, count * passes);
+                printf("    max error: %llu ULP\n", (unsigned long long)max_ulp64);
+            }
+        }
+        simd_select_level(simd_level_best());
+    }
+
+    printf("(checksum %f)\n", sink);
+    BASE_FREE(ref64);
+    BASE_FREE(out64);
+    BASE_FREE(x64);
+    BASE_FREE(ref32);
+    BASE_FREE(out32);
+    BASE_FREE(x32);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): R-tree and uniform grid vs linear scan
+
+void bench_spatial(U32 count, U32 queries) {
+    printf("\n--- spatial index, %u boxes x %u queries ---\n", count, queries);
+    I2F32* boxes = BASE_ALLOC(count * sizeof(I2F32));
+    I2F32* query = BASE_ALLOC(queries * sizeof(I2F32));
+    U32* out = BASE_ALLOC(count * sizeof(U32));
+    F32 distance[8];
+    F32 world = 10000.0f;
+    for (U32 i = 0; i < count; i++) {
+        F32 x = (F32)(bench_random() % 1000000) * world * 1e-6f;
+        F32 y = (F32)(bench_random() % 1000000) * world * 1e-6f;
+        boxes[i] = i2f32(x, y, x + (F32)(bench_random() % 2000) * 0.01f, y + (F32)(bench_random() % 2000) * 0.01f);
+    }
+    for (U32 q = 0; q < queries; q++) {
+        F32 x = (F32)(bench_random() % 1000000) * world * 1e-6f;
+        F32 y = (F32)(bench_random() % 1000000) * world * 1e-6f;
+        query[q] = i2f32(x, y, x + 100.0f, y + 100.0f);
+    }
+    U64 sink = 0;
+
+    F64 t0 = bench_seconds();
+    for (U32 q = 0; q < queries; q++) {
+        for (U32 i = 0; i < count; i++) {
+            sink += I2F32_overlaps(boxes[i], query[q]);
+        }
+    }
+    F64 t1 = bench_seconds();
+    for (U32 q = 0; q < queries; q++) {
+        V2F32 p = v2f32(query[q].x0, query[q].y0);
+        U32 found = 0;
+        for (U32 i = 0; i < count; i++) {
+            F32 dx = Max(Max(boxes[i].x0 - p.x, p.x - boxes[i].x1), 0.0f);
+            F32 dy = Max(Max(boxes[i].y0 - p.y, p.y - boxes[i].y1), 0.0f);
+            F32 d = dx * dx + dy * dy;
+            if (found < 8 || d < distance[7]) {
+                U32 at = (found < 8) ? found++ : 7;
+                while (at > 0 && distance[at - 1] > d) {
+                    distance[at] = distance[at - 1];
+                    at--;
+                }
+                distance[at] = d;
+            }
+        }
+        sink += found;
+    }
+    F64 t2 = bench_seconds();
+    bench_report("linear scan overlap query", t1 - t0, queries);
+    bench_report("linear scan 8-nearest", t2 - t1, queries);
+
+    RTree tree = rtree_create(0);
+    t0 = bench_seconds();
+    rtree_build_I2F32(&tree, boxes, count);
+    t1 = bench_seconds();
+    rtree_build_I2F32(&tree, boxes, count);
+    t2 = bench_seconds();
+    for (U32 q = 0; q < queries; q++) {
+        sink += rtree_query_I2F32(&tree, query[q], out, count);
+    }
+    F64 t3 = bench_seconds();
+    for (U32 q = 0; q < queries; q++) {
+        sink += rtree_query_point_V2F32(&tree, v2f32(query[q].x0, query[q].y0), out, count);
+    }
+    F64 t4 = bench_seconds();
+    for (U32 q = 0; q < queries; q++) {
+        sink += rtree_nearest(&tree, v2f32(query[q].x0, query[q].y0), 8, out, distance);
+    }
+    F64 t5 = bench_seconds();
+    bench_report("rtree build (per box)", t1 - t0, count);
+    bench_report("rtree rebuild in place (per box)", t2 - t1, count);
+    bench_report("rtree overlap query", t3 - t2, queries);
+    bench_report("rtree point query", t4 - t3, queries);
+    bench_report("rtree 8-nearest", t5 - t4, queries);
+    rtree_destroy(&tree);
+
+    SpatialGrid grid = spatial_grid_create(0);
+    t0 = bench_seconds();
+    spatial_grid_build_I2F32(&grid, boxes, count, 0, 0);
+    t1 = bench_seconds();
+    spatial_grid_build_I2F32(&grid, boxes, count, 0, 0);
+    t2 = bench_seconds();
+    for (U32 q = 0; q < queries; q++) {
+        sink += spatial_grid_query_I2F32(&grid, query[q], out, count);
+    }
+    t3 = bench_seconds();
+    for (U32 q = 0; q < queries; q++) {
+        sink += spatial_grid_query_point_V2F32(&grid, v2f32(query[q].x0, query[q].y0), out, count);
+    }
+    t4 = bench_seconds();
+    for (U32 q = 0; q < queries; q++) {
+        sink += spatial_grid_nearest(&grid, v2f32(query[q].x0, query[q].y0), 8, out, distance);
+    }
+    t5 = bench_seconds();
+    bench_report("grid build (per box)", t1 - t0, count);
+    bench_report("grid rebuild in place (per box)", t2 - t1, count);
+    bench_report("grid overlap query", t3 - t2, queries);
+    bench_report("grid point query", t4 - t3, queries);
+    bench_report("grid 8-nearest", t5 - t4, queries);
+    spatial_grid_destroy(&grid);
+
+    printf("(checksum %llu)\n", (unsigned long long)sink);
+    BASE_FREE(out);
+    BASE_FREE(query);
+    BASE_FREE(boxes);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Interval tree and interval set vs linear scan
+
+void bench_intervals(U32 count, U32 queries) {
+    printf("\n--- interval index, %u ranges x %u queries ---\n", count, queries);
+    I1U64* ranges = BASE_ALLOC(count * sizeof(I1U64));
+    U64* points = BASE_ALLOC(queries * sizeof(U64));
+    U32* out = BASE_ALLOC(count * sizeof(U32));
+    U64 space = (U64)count * 1024;
+    for (U32 i = 0; i < count; i++) {
+        U64 first = bench_random() % space;
+        ranges[i] = i1u64(first, first + 1 + bench_random() % 4096);
+    }
+    for (U32 q = 0; q < queries; q++) {
+        points[q] = bench_random() % space;
+    }
+    U64 sink = 0;
+
+    F64 t0 = bench_seconds();
+    for (U32 q = 0; q < queries; q++) {
+        for (U32 i = 0; i < count; i++) {
+            sink += ranges[i].first <= points[q] && points[q] < ranges[i].opl;
+        }
+    }
+    F64 t1 = bench_seconds();
+    for (U32 q = 0; q < queries; q++) {
+        for (U32 i = 0; i < count; i++) {
+            sink += ranges[i].first < points[q] + 65536 && points[q] < ranges[i].opl;
+        }
+    }
+    F64 t2 = bench_seconds();
+    bench_report("linear scan stab", t1 - t0, queries);
+    bench_report("linear scan overlap (64K wide)", t2 - t1, queries);
+
+    IntervalTree tree = interval_tree_create(0);
+    t0 = bench_seconds();
+    interval_tree_build_I1U64(&tree, ranges, count);
+    t1 = bench_seconds();
+    for (U32 q = 0; q < queries; q++) {
+        sink += interval_tree_stab_U64(&tree, points[q], out, count);
+    }
+    t2 = bench_seconds();
+    for (U32 q = 0; q < queries; q++) {
+        sink += interval_tree_query_I1U64(&tree, i1u64(points[q], points[q] + 65536), out, count);
+    }
+    F64 t3 = bench_seconds();
+    U32 changes = Min(count, 100000);
+    for (U32 i = 0; i < changes; i++) {
+        sink += interval_tree_remove_I1U64(&tree, ranges[i], i);
+        sink += interval_tree_insert_I1U64(&tree, ranges[i], i);
+    }
+    F64 t4 = bench_seconds();
+    bench_report("interval tree build (per range)", t1 - t0, count);
+    bench_report("interval tree stab", t2 - t1, queries);
+    bench_report("interval tree overlap (64K wide)", t3 - t2, queries);
+    bench_report("interval tree remove + insert", t4 - t3, changes);
+    interval_tree_destroy(&tree);
+
+    // NOTE(ryl1k): Coalescing set: adds in random order shift the flat array,
+    // so the large sets are filled in sorted order (appends) and random adds
+    // are timed on a prefix. Membership is a binary search vs scanning the
+    // merged ranges.
+    IntervalSet a = interval_set_create(0);
+    IntervalSet b = interval_set_create(0);
+    IntervalSet c = interval_set_create(0);
+    U64* firsts = BASE_ALLOC(count * sizeof(U64));
+    U32* order = BASE_ALLOC(count * sizeof(U32));
+    for (U32 i = 0; i < count; i++) {
+        firsts[i] = ranges[i].first;
+    }
+    radix_sort_index_U64(firsts, count, order, 0);
+    U32 random_adds = Min(count, 20000);
+    t0 = bench_seconds();
+    for (U32 i = 0; i < random_adds; i++) {
+        interval_set_add(&c, ranges[i]);
+    }
+    F64 t_random = bench_seconds();
+    for (U32 i = 0; i < count; i++) {
+        interval_set_add(i % 2 ? &b : &a, ranges[order[i]]);
+    }
+    t1 = bench_seconds();
+    for (U32 q = 0; q < queries; q++) {
+        sink += interval_set_contains(&a, points[q]);
+    }
+    t2 = bench_seconds();
+    for (U32 q = 0; q < queries; q++) {
+        for (U64 i = 0; i < a.count; i++) {
+            if (a.ranges[i].first <= points[q] && points[q] < a.ranges[i].opl) {
+                sink++;
+                break;
+            }
+        }
+    }
+    t3 = bench_seconds();
+    interval_set_union(&c, &a, &b);
+    sink += c.count;
+    t4 = bench_seconds();
+    interval_set_intersection(&c, &a, &b);
+    sink += c.count;
+    F64 t5 = bench_seconds();
+    bench_report("interval set add (random order)", t_random - t0, random_adds);
+    bench_report("interval set add (sorted order)", t1 - t_random, count);
+    bench_report("interval set contains", t2 - t1, queries);
+    bench_report("linear scan set contains", t3 - t2, queries);
+    bench_report("interval set union (per range)", t4 - t3, a.count + b.count);
+    bench_report("interval set intersection (per range)", t5 - t4, a.count + b.count);
+    interval_set_destroy(&c);
+    interval_set_destroy(&b);
+    interval_set_destroy(&a);
+    BASE_FREE(order);
+    BASE_FREE(firsts);
+
+    printf("(checksum %llu)\n", (unsigned long long)sink);
+    BASE_FREE(out);
+    BASE_FREE(points);
+    BASE_FREE(ranges);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Batch I2S32/V2S32 culling and clipping vs per-element calls
+
+void bench_box_kernels(U64 count, U64 passes) {
+    printf("\n--- I2S32 box kernels, %llu boxes x %llu passes ---\n", (unsigned long long)count, (unsigned long long)passes);
+    I2S32* boxes = BASE_ALLOC(count * sizeof(I2S32));
+    I2S32* out = BASE_ALLOC(count * sizeof(I2S32));
+    V2S32* points = BASE_ALLOC(count * sizeof(V2S32));
+    S32* soa = BASE_ALLOC(count * 4 * sizeof(S32));
+    S32* soa_out = BASE_ALLOC(count * 4 * sizeof(S32));
+    U64* mask = BASE_ALLOC(((count + 63) / 64) * sizeof(U64));
+    U32* indices = BASE_ALLOC(count * sizeof(U32));
+    I2S32SoA sa = {{soa, soa + count, soa + 2 * count, soa + 3 * count}};
+    I2S32SoA so = {{soa_out, soa_out + count, soa_out + 2 * count, soa_out + 3 * count}};
+    V2S32SoA sp = {{soa, soa + count}};
+    for (U64 i = 0; i < count; i++) {
+        S32 x = (S32)(bench_random() % 4096);
+        S32 y = (S32)(bench_random() % 4096);
+        boxes[i] = i2s32(x, y, x + (S32)(bench_random() % 64), y + (S32)(bench_random() % 64));
+        points[i] = v2s32(x, y);
+        for (U32 k = 0; k < 4; k++) {
+            sa.v[k][i] = boxes[i].v[k];
+        }
+    }
+    I2S32 view = i2s32(1024, 1024, 2048, 3072);
+    U64 sink = 0;
+    U64 ops = count * passes;
+
+    F64 t0 = bench_seconds();
+    for (U64 p = 0; p < passes; p++) {
+        U64 hits = 0;
+        for (U64 i = 0; i < count; i++) {
+            if (I2S32_overlaps(boxes[i], view)) {
+                indices[hits++] = (U32)i;
+            }
+        }
+        sink += hits;
+    }
+    F64 t1 = bench_seconds();
+    for (U64 p = 0; p < passes; p++) {
+        for (U64 i = 0; i < count; i++) {
+            out[i] = I2S32_intersection(boxes[i], view);
+        }
+        sink += out[p % count].x1;
+    }
+    F64 t2 = bench_seconds();
+    bench_report("per-element I2S32_overlaps", t1 - t0, ops);
+    bench_report("per-element I2S32_intersection", t2 - t1, ops);
+
+    SIMDLevel levels[] = {SIMDLevel_Scalar, SIMDLevel_SSE2, SIMDLevel_AVX2, SIMDLevel_NEON};
+    for (U32 l = 0; l < ArrayCount(levels); l++) {
+        if (!simd_level_supported(levels[l])) {
+            continue;
+        }
+        simd_select_level(levels[l]);
+        const char* level = simd_level_name(levels[l]);
+        char name[64];
+        F64 t[7];
+        t[0] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            sink += overlaps_mask_I2S32_array(mask, boxes, view, count);
+        }
+        t[1] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            sink += overlaps_mask_I2S32_soa(mask, sa, view, count);
+        }
+        t[2] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            sink += overlaps_indices_I2S32_soa(indices, sa, view, count);
+        }
+        t[3] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            sink += contains_mask_V2S32_array(mask, points, view, count);
+        }
+        t[4] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            sink += contains_indices_V2S32_soa(indices, sp, view, count);
+        }
+        t[5] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            clip_I2S32_array(out, boxes, view, count);
+            sink += out[p % count].x1;
+        }
+        t[6] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            clip_I2S32_soa(so, sa, view, count);
+            sink += so.x1[p % count];
+        }
+        F64 t7 = bench_seconds();
+        snprintf(name, sizeof(name), "overlaps mask AoS (%s)", level);
+        bench_report(name, t[1] - t[0], ops);
+        snprintf(name, sizeof(name), "overlaps mask SoA (%s)", level);
+        bench_report(name, t[2] - t[1], ops);
+        snprintf(name, sizeof(name), "overlaps indices SoA (%s)", level);
+        bench_report(name, t[3] - t[2], ops);
+        snprintf(name, sizeof(name), "contains mask AoS (%s)", level);
+        bench_report(name, t[4] - t[3], ops);
+        snprintf(name, sizeof(name), "contains indices SoA (%s)", level);
+        bench_report(name, t[5] - t[4], ops);
+        snprintf(name, sizeof(name), "clip AoS (%s)", level);
+        bench_report(name, t[6] - t[5], ops);
+        snprintf(name, sizeof(name), "clip SoA (%s)", level);
+        bench_report(name, t7 - t[6], ops);
+    }
+    simd_select_level(simd_level_best());
+
+    printf("(checksum %llu)\n", (unsigned long long)sink);
+    BASE_FREE(indices);
+    BASE_FREE(mask);
+    BASE_FREE(soa_out);
+    BASE_FREE(soa);
+    BASE_FREE(points);
+    BASE_FREE(out);
+    BASE_FREE(boxes);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): Random generators and bulk fills vs rand()
+
+void bench_random_fill(U64 count, U64 passes) {
+    printf("\n--- Random, %llu values x %llu passes ---\n", (unsigned long long)count, (unsigned long long)passes);
+    U64* out = BASE_ALLOC(count * sizeof(U64));
+    V2F32* points = BASE_ALLOC(count * sizeof(V2F32));
+    U32* out32 = (U32*)out;
+    F32* outf = (F32*)out;
+    F64* outd = (F64*)out;
+    U64 sink = 0;
+    U64 ops = count * passes;
+    PCG32 pcg = pcg32_seed(42, 54);
+    Xoshiro256 xoshiro = xoshiro256_seed(42);
+
+    F64 t0 = bench_seconds();
+    for (U64 p = 0; p < passes; p++) {
+        for (U64 i = 0; i < count; i++) {
+            out32[i] = (U32)rand();
+        }
+        sink += out32[p % count];
+    }
+    F64 t1 = bench_seconds();
+    for (U64 p = 0; p < passes; p++) {
+        for (U64 i = 0; i < count; i++) {
+            out32[i] = pcg32_next(&pcg);
+        }
+        sink += out32[p % count];
+    }
+    F64 t2 = bench_seconds();
+    for (U64 p = 0; p < passes; p++) {
+        for (U64 i = 0; i < count; i++) {
+            out[i] = xoshiro256_next(&xoshiro);
+        }
+        sink += out[p % count];
+    }
+    F64 t3 = bench_seconds();
+    bench_report("rand()", t1 - t0, ops);
+    bench_report("pcg32_next", t2 - t1, ops);
+    bench_report("xoshiro256_next", t3 - t2, ops);
+
+    RandomBulk bulk = random_bulk_seed(&xoshiro);
+    I2F32 box = i2f32(-10.0f, -10.0f, 10.0f, 10.0f);
+    SIMDLevel levels[] = {SIMDLevel_Scalar, SIMDLevel_SSE2, SIMDLevel_AVX2, SIMDLevel_NEON};
+    for (U32 l = 0; l < ArrayCount(levels); l++) {
+        if (!simd_level_supported(levels[l])) {
+            continue;
+        }
+        simd_select_level(levels[l]);
+        const char* level = simd_level_name(levels[l]);
+        char name[64];
+        F64 t[5];
+        t[0] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            random_fill_U32(&bulk, out32, count);
+            sink += out32[p % count];
+        }
+        t[1] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            random_fill_U64(&bulk, out, count);
+            sink += out[p % count];
+        }
+        t[2] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            random_fill_F32(&bulk, outf, count, 0.0f, 1.0f);
+            sink += (U64)(outf[p % count] * 1000.0f);
+        }
+        t[3] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            random_fill_F64(&bulk, outd, count, 0.0, 1.0);
+            sink += (U64)(outd[p % count] * 1000.0);
+        }
+        t[4] = bench_seconds();
+        for (U64 p = 0; p < passes; p++) {
+            random_fill_V2F32(&bulk, points, count, box);
+            sink += (U64)(points[p % count].x + 10.0f);
+        }
+        F64 t5 = bench_seconds();
+        snprintf(name, sizeof(name), "random_fill_U32 (%s)", level);
+        bench_report(name, t[1] - t[0], ops);
+        snprintf(name, sizeof(name), "random_fill_U64 (%s)", level);
+        bench_report(name, t[2] - t[1], ops);
+        snprintf(name, sizeof(name), "random_fill_F32 (%s)", level);
+        bench_report(name, t[3] - t[2], ops);
+        snprintf(name, sizeof(name), "random_fill_F64 (%s)", level);
+        bench_report(name, t[4] - t[3], ops);
+        snprintf(name, sizeof(name), "random_fill_V2F32 (%s)", level);
+        bench_report(name, t5 - t[4], ops);
+    }
+    simd_select_level(simd_level_best());
+
+    printf("(checksum %llu)\n", (unsigned long long)sink);
+    BASE_FREE(points);
+    BASE_FREE(out);
+}
+
+//////////////////////////////////////////////////////
+// NOTE(ryl1k): MPMC queue vs mutex + QUEUE_ macros
+
+#if defined(_WIN32)
+typedef SRWLOCK BenchMutex;
+#define bench_mutex_init(m) InitializeSRWLock(m)
+#define bench_mutex_lock(m) AcquireSRWLockExclusive(m)
+#define bench_mutex_unlock(m) ReleaseSRWLockExclusive(m)
+#else
+typedef pthread_mutex_t BenchMutex;
+#define bench_mutex_init(m) pthread_mutex_init((m), NULL)
+#define bench_mutex_lock(m) pthread_mutex_lock(m)
+#define bench_mutex_unlock(m) pthread_mutex_unlock(m)
+#endif
+
+typedef struct QueueNode {
+    SLL_NODE(struct QueueNode);
+    U64 value;
+} QueueNode;
+
+typedef struct {
+    QueueNode* front;
+    QueueNode* rear;
+    BenchMutex mutex;
+} LockedQueue;
+
+typedef struct {
+    MPMCQueue* mpmc;
+    LockedQueue* locked;
+    QueueNode* nodes;
+    U64 pairs;
+    U64 batch;
+    U64 sink;
+} QueueBenchThread;
+
+// NOTE(ryl1k): Every thread enqueues then dequeues, so the queue never
+// runs dry for long. Failed attempts yield because the suite also runs
+// more threads than cores.
+void queue_bench_mpmc(void* param) {
+    QueueBenchThread* t = param;
+    void* items[16];
+    for (U64 i = 0; i < t->pairs; i += t->batch) {
+        for (U64 j = 0; j < t->batch; j++) {
+            items[j] = PtrFromInt(i + j + 1);
+        }
+        U64 pushed = 0;
+        while (pushed < t->batch) {
+            U64 n = mpmc_queue_enqueue_batch(t->mpmc, items + pushed, t->batch - pushed);
+            pushed += n;
+            if (!n) {
+                os_thread_yield();
+            }
+        }
+        U64 popped = 0;
+        while (popped < t->batch) {
+            U64 n = mpmc_queue_dequeue_batch(t->mpmc, items, t->batch - popped);
+            for (U64 j = 0; j < n; j++) {
+                t->sink += IntFromPtr(items[j]);
+            }
+            popped += n;
+            if (!n) {
+                os_thread_yield();
+            }
+        }
+    }
+}
+
+void queue_bench_locked(void* param) {
+    QueueBenchThread* t = param;
+    for (U64 i = 0; i < t->pairs; i++) {
+        QueueNode* node = &t->nodes[i];
+        node->next = NULL;
+        node->value = i + 1;
+        bench_mutex_lock(&t->locked->mutex);
+        QUEUE_ENQUEUE(*t->locked, node);
+        bench_mutex_unlock(&t->locked->mutex);
+
+        bench_mutex_lock(&t->locked->mutex);
+        QUEUE_DEQUEUE(*t->locked, node);
+        bench_mutex_unlock(&t->locked->mutex);
+        t->sink += node->value;
+    }
+}
+
+void bench_queues(U64 total_pairs) {
+    printf("\n--- MPMC queue, %llu enqueue/dequeue pairs ---\n", (unsigned long long)total_pairs);
+    printf("%-8s %16s %16s %16s\n", "threads", "mutex ns/pair", "mpmc ns/pair", "mpmc x8 ns/pair");
+
+    QueueBenchThread threads[64];
+    OSThread handles[64];
+    QueueNode* nodes = BASE_ALLOC(total_pairs * sizeof(QueueNode));
+    for (U64 thread_count = 1; thread_count <= 64; thread_count *= 2) {
+        U64 pairs = (total_pairs / thread_count) & ~7llu;
+        F64 results[3];
+        for (U64 mode = 0; mode < 3; mode++) {
+            LockedQueue locked;
+            QUEUE_INIT(locked);
+            bench_mutex_init(&locked.mutex);
+            MPMCQueue* mpmc = mpmc_queue_create(NULL, 1024);
+            for (U64 i = 0; i < thread_count; i++) {
+                threads[i].mpmc = mpmc;
+                threads[i].locked = &locked;
+                threads[i].nodes = nodes + i * pairs;
+                threads[i].pairs = pairs;
+                threads[i].batch = (mode == 2) ? 8 : 1;
+                threads[i].sink = 0;
+            }
+            F64 t0 = bench_seconds();
+            for (U64 i = 0; i < thread_count; i++) {
+                handles[i] = os_thread_create(mode == 0 ? queue_bench_locked : queue_bench_mpmc, &threads[i]);
+            }
+            for (U64 i = 0; i < thread_count; i++) {
+                os_thread_join(handles[i]);
+            }
+            F64 t1 = bench_seconds();
+            results[mode] = (t1 - t0) * 1e9 / (F64)(pairs * thread_count);
+            mpmc_queue_destroy(mpmc);
+        }
+        printf("%-8llu %16.2f %16.2f %16.2f\n", (unsigned long long)thread_count,
+               results[0], results[1], results[2]);
+    }
+    BASE_FREE(nodes);
+}
+
+typedef struct {
+    U64 begin;
+    U64 end;
+} JobBenchRange;
+
+void job_bench_empty(JobWorker* worker, Job* job, void* data) {
+}
+
+// NOTE(ryl1k): Splits down to single items, so nearly all the time is
+// scheduling: every split creates three jobs (a group and two halves).
+void job_bench_split(JobWorker* worker, Job* job, void* data) {
+    JobBenchRange* range = data;
+    if (range->end - range->begin < 2) {
+        return;
+    }
+    JobBenchRange* halves = arena_alloc(&worker->scratch, 2 * sizeof(JobBenchRange));
+    U64 mid = range->begin + (range->end - range->begin) / 2;
+    halves[0].begin = range->begin;
+    halves[0].end = mid;
+    halves[1].begin = mid;
+    halves[1].end = range->end;
+    Job* group = job_create(worker->system, NULL, NULL, NULL);
+    job_submit(worker->system, job_create(worker->system, group, job_bench_split, &halves[0]));
+    job_submit(worker->system, job_create(worker->system, group, job_bench_split, &halves[1]));
+    job_submit(worker->system, group);
+    job_wait(worker->system, group);
+}
+
+void bench_jobs(U64 job_count) {
+    printf("\n--- Job system, %llu jobs ---\n", (unsigned long long)job_count);
+    printf("%-8s %16s %16s\n", "workers", "flat ns/job", "fork-join ns/job");
+    for (U32 worker_count = 1; worker_count <= 16; worker_count *= 2) {
+        JobSystem* system = job_system_create(NULL, worker_count, 1 << 20, 1);
+
+        F64 t0 = bench_seconds();
+        Job* root = job_create(system, NULL, NULL, NULL);
+        for (U64 i = 0; i < job_count; i++) {
+            job_submit(system, job_create(system, root, job_bench_empty, NULL));
+        }
+        job_submit(system, root);
+        job_wait(system, root);
+        F64 t1 = bench_seconds();
+
+        JobBenchRange range = { 0, job_count / 3 };
+        root = job_create(system, NULL, job_bench_split, &range);
+        job_submit(system, root);
+        job_wait(system, root);
+        F64 t2 = bench_seconds();
+
+        printf("%-8u %16.2f %16.2f\n", worker_count,
+               (t1 - t0) * 1e9 / (F64)job_count, (t2 - t1) * 1e9 / (F64)job_count);
+        job_system_destroy(system);
+    }
+}
+
+void parallel_bench_normalize(JobWorker* worker, U64 begin, U64 end, void* data) {
+    V3F32* points = data;
+    for (U64 i = begin; i < end; i++) {
+        points[i] = V3F32_normalize(points[i]);
+    }
+}
+
+void parallel_bench_length(JobWorker* worker, U64 begin, U64 end, void* data, void* partial) {
+    const V3F32* points = data;
+    F32 sum = 0.0f;
+    for (U64 i = begin; i < end; i++) {
+        sum += V3F32_length(points[i]);
+    }
+    *(F32*)partial = sum;
+}
+
+void parallel_bench_add(void* into, const void* from, void* data) {
+    *(F32*)into += *(const F32*)from;
+}
+
+// NOTE(ryl1k): Worker counts double up to the CPU count, which always gets
+// a row; speedups are against one worker.
+void bench_parallel(U64 count, U64 iterations) {
+    U32 cpu_count = os_cpu_count();
+    printf("\n--- Parallel loops, %llu V3F32, %u CPUs ---\n", (unsigned long long)count, cpu_count);
+    printf("%-8s %14s %10s %14s %10s\n", "workers", "for ms", "speedup", "reduce ms", "speedup");
+
+    V3F32* points = BASE_ALLOC(count * sizeof(V3F32));
+    F64 base_for = 0.0;
+    F64 base_reduce = 0.0;
+    for (U32 worker_count = 1;; worker_count = Min(2 * worker_count, cpu_count)) {
+        JobSystem* system = job_system_create(NULL, worker_count, 0, 1);
+        for (U64 i = 0; i < count; i++) {
+            points[i] = v3f32((F32)(i % 17) + 1.0f, (F32)(i % 5), (F32)(i % 3));
+        }
+        F64 t0 = bench_seconds();
+        for (U64 it = 0; it < iterations; it++) {
+            parallel_for(system, count, 0, parallel_bench_normalize, points);
+        }
+        F64 t1 = bench_seconds();
+        F32 sum = 0.0f;
+        for (U64 it = 0; it < iterations; it++) {
+            parallel_reduce(system, count, 0, sizeof(F32), parallel_bench_length, parallel_bench_add, points, &sum);
+        }
+        F64 t2 = bench_seconds();
+        job_system_destroy(system);
+
+        F64 for_ms = (t1 - t0) * 1e3 / (F64)iterations;
+        F64 reduce_ms = (t2 - t1) * 1e3 / (F64)iterations;
+        if (worker_count == 1) {
+            base_for = for_ms;
+            base_reduce = reduce_ms;
+        }
+        printf("%-8u %14.3f %9.2fx %14.3f %9.2fx\n", worker_count,
+               for_ms, base_for / for_ms, reduce_ms, base_reduce / reduce_ms);
+        if (worker_count == cpu_count) {
+            break;
+        }
+    }
+    BASE_FREE(points);
+}
+
+int main() {
+    bench_hash_table(1000);
+    bench_hash_table(1000000);
+    bench_unrolled_list(1000, 1000);
+    bench_unrolled_list(1000000, 10);
+    bench_sort(1000);
+    bench_sort(10000000);
+    bench_timers(1000000, 1000000);
+    bench_timers(1000000, 100000000);
+    bench_vector_kernels(1000, 10000);
+    bench_vector_kernels(1000000, 20);
+    bench_vector_reductions(1000, 10000);
+    bench_vector_reductions(1000000, 20);
+    bench_vector_math(1000000, 5);
+    bench_transforms(1000, 10000);
+    bench_transforms(10000000, 5);
+    bench_spatial(1000, 10000);
+    bench_spatial(1000000, 200);
+    bench_intervals(1000, 10000);
+    bench_intervals(1000000, 200);
+    bench_box_kernels(1000, 10000);
+    bench_box_kernels(1000000, 20);
+    bench_random_fill(4096, 10000);
+    bench_random_fill(16000000, 5);
+    bench_queues(1 << 20);
+    bench_jobs(1 << 20);
+    bench_parallel(1000000, 50);
+    bench_parallel(16000000, 5);
+    return 0;
+}
@@ -0,0 +1,312 @@
+#include "base.h"
+#if !defined(BASE_LIBRARY)
+#include "base.c"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <locale.h>
+#include <fcntl.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#define suite_dup _dup
+#define suite_dup2 _dup2
+#define suite_close _close
+#define suite_open_null() _open("NUL", _O_WRONLY)
+#else
+#include <unistd.h>
+#define suite_dup dup
+#define suite_dup2 dup2
+#define suite_close close
+#define suite_open_null() open("/dev/null", O_WRONLY)
+#endif
+
+// NOTE(ryl1k): Regression suite on the benchmark harness. Every benchmark
+// repeats a fixed batch, so numbers stay comparable between releases:
+//   bench_suite [--filter text] [--samples n] [--quick] [--json path] [--csv path]
+
+#define SUITE_BATCH 1024
+#define SUITE_TEXT_BYTES 4096
+
+typedef struct {
+    Arena arena;
+    void* blocks[SUITE_BATCH];
+    U64 size;
+} SuiteAlloc;
+
+void suite_arena_alloc(void* data, U64 iterations) {
+    SuiteAlloc* s = data;
+    for (U64 it = 0; it < iterations; it++) {
+        for (U64 i = 0; i < SUITE_BATCH; i++) {
+            s->blocks[i] = arena_alloc(&s->arena, s->size);
+        }
+        DoNotOptimize(s->blocks);
+        arena_reset(&s->arena);
+    }
+}
+
+void suite_malloc(void* data, U64 iterations) {
+    SuiteAlloc* s = data;
+    for (U64 it = 0; it < iterations; it++) {
+        for (U64 i = 0; i < SUITE_BATCH; i++) {
+            s->blocks[i] = malloc(s->size);
+        }
+        DoNotOptimize(s->blocks);
+        for (U64 i = 0; i < SUITE_BATCH; i++) {
+            free(s->blocks[i]);
+        }
+    }
+}
+
+typedef struct {
+    char* utf8;
+    wchar_t* utf16;
+} SuiteText;
+
+void suite_utf8_strlen(void* data, U64 iterations) {
+    SuiteText* s = data;
+    for (U64 it = 0; it < iterations; it++) {
+        int length = utf8_strlen(s->utf8);
+        DoNotOptimize(length);
+    }
+}
+
+void suite_utf8_to_utf16(void* data, U64 iterations) {
+    SuiteText* s = data;
+    for (U64 it = 0; it < iterations; it++) {
+        char* utf16 = utf8_to_utf16(s->utf8);
+        DoNotOptimize(utf16);
+        free(utf16);
+    }
+}
+
+void suite_utf16_to_utf8(void* data, U64 iterations) {
+    SuiteText* s = data;
+    for (U64 it = 0; it < iterations; it++) {
+        char* utf8 = utf16_to_utf8(s->utf16);
+        DoNotOptimize(utf8);
+        free(utf8);
+    }
+}
+
+void suite_myprintf(void* data, U64 iterations) {
+    for (U64 it = 0; it < iterations; it++) {
+        myprintf("value %d, char %c, name %s\n", (int)it, 'x', "suite");
+    }
+}
+
+void suite_printf(void* data, U64 iterations) {
+    for (U64 it = 0; it < iterations; it++) {
+        printf("value %d, char %c, name %s\n", (int)it, 'x', "suite");
+    }
+}
+
+typedef struct {
+    V3F32 a[SUITE_BATCH];
+    V3F32 b[SUITE_BATCH];
+    V3F32 out[SUITE_BATCH];
+    F32 scalars[SUITE_BATCH];
+    I2F32 boxes[SUITE_BATCH];
+    I2F32 other[SUITE_BATCH];
+    V2F32 points[SUITE_BATCH];
+    I2S32 ibox[SUITE_BATCH];
+    I2S32 iother[SUITE_BATCH];
+    I2S32 iout[SUITE_BATCH];
+    B32 flags[SUITE_BATCH];
+} SuiteVectors;
+
+void suite_V3F32_normalize(void* data, U64 iterations) {
+    SuiteVectors* s = data;
+    for (U64 it = 0; it < iterations; it++) {
+        for (U64 i = 0; i < SUITE_BATCH; i++) {
+            s->out[i] = V3F32_normalize(s->a[i]);
+        }
+        ClobberMemory();
+    }
+}
+
+void suite_V3F32_dot(void* data, U64 iterations) {
+    SuiteVectors* s = data;
+    for (U64 it = 0; it < iterations; it++) {
+        for (U64 i = 0; i < SUITE_BATCH; i++) {
+            s->scalars[i] = V3F32_dot(s->a[i], s->b[i]);
+        }
+        ClobberMemory();
+    }
+}
+
+void suite_V3F32_cross(void* data, U64 iterations) {
+    SuiteVectors* s = data;
+    for (U64 it = 0; it < iterations; it++) {
+        for (U64 i = 0; i < SUITE_BATCH; i++) {
+            s->out[i] = V3F32_cross(s->a[i], s->b[i]);
+        }
+        ClobberMemory();
+    }
+}
+
+void suite_V3F32_length(void* data, U64 iterations) {
+    SuiteVectors* s = data;
+    for (U64 it = 0; it < iterations; it++) {
+        for (U64 i = 0; i < SUITE_BATCH; i++) {
+            s->scalars[i] = V3F32_length(s->a[i]);
+        }
+        ClobberMemory();
+    }
+}
+
+void suite_I2F32_overlaps(void* data, U64 iterations) {
+    SuiteVectors* s = data;
+    for (U64 it = 0; it < iterations; it++) {
+        for (U64 i = 0; i < SUITE_BATCH; i++) {
+            s->flags[i] = I2F32_overlaps(s->boxes[i], s->other[i]);
+        }
+        ClobberMemory();
+    }
+}
+
+void suite_I2F32_contains(void* data, U64 iterations) {
+    SuiteVectors* s = data;
+    for (U64 it = 0; it < iterations; it++) {
+        for (U64 i = 0; i < SUITE_BATCH; i++) {
+            s->flags[i] = I2F32_contains(s->boxes[i], s->points[i]);
+        }
+        ClobberMemory();
+    }
+}
+
+void suite_I2S32_intersection(void* data, U64 iterations) {
+    SuiteVectors* s = data;
+    for (U64 it = 0; it < iterations; it++) {
+        for (U64 i = 0; i < SUITE_BATCH; i++) {
+            s->iout[i] = I2S32_intersection(s->ibox[i], s->iother[i]);
+        }
+        ClobberMemory();
+    }
+}
+
+// NOTE(ryl1k): printf and myprintf write to stdout, which is pointed at the
+// null device while they run so the terminal does not dominate.
+int suite_stdout_silence(void) {
+    fflush(stdout);
+    int saved = suite_dup(fileno(stdout));
+    int null = suite_open_null();
+    if (saved >= 0 && null >= 0) {
+        suite_dup2(null, fileno(stdout));
+    }
+    if (null >= 0) {
+        suite_close(null);
+    }
+    return saved;
+}
+
+void suite_stdout_restore(int saved) {
+    fflush(stdout);
+    if (saved >= 0) {
+        suite_dup2(saved, fileno(stdout));
+        suite_close(saved);
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchSuite suite = bench_suite_create();
+    const char* json_path = NULL;
+    const char* csv_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+            suite.filter = argv[++i];
+        } else if (!strcmp(argv[i], "--samples") && i + 1 < argc) {
+            suite.samples = strtoull(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "--quick")) {
+            suite.samples = 5;
+            suite.sample_ns = 100000;
+        } else if (!strcmp(argv[i], "--json") && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (!strcmp(argv[i], "--csv") && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--filter text] [--samples n] [--quick] [--json path] [--csv path]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (!setlocale(LC_ALL, "en_US.UTF-8")) {
+        setlocale(LC_ALL, "C.UTF-8");
+    }
+    printf("timer: %llu ticks/s, simd: %s\n", (unsigned long long)timer_frequency(),
+           simd_level_name(simd_level_best()));
+    bench_print_header();
+
+    SuiteAlloc* alloc = BASE_ALLOC(sizeof(SuiteAlloc));
+    alloc->arena = arena_create(SUITE_BATCH * 256);
+    U64 sizes[2] = { 16, 256 };
+    const char* arena_names[2] = { "arena_alloc 16B", "arena_alloc 256B" };
+    const char* malloc_names[2] = { "malloc/free 16B", "malloc/free 256B" };
+    for (int i = 0; i < 2; i++) {
+        alloc->size = sizes[i];
+        bench_print(bench_run(&suite, arena_names[i], suite_arena_alloc, alloc, SUITE_BATCH, 0));
+        bench_print(bench_run(&suite, malloc_names[i], suite_malloc, alloc, SUITE_BATCH, 0));
+    }
+    arena_destroy(&alloc->arena);
+    BASE_FREE(alloc);
+
+    // Mixed text: ASCII with two- and three-byte sequences
+    SuiteText text;
+    text.utf8 = BASE_ALLOC(SUITE_TEXT_BYTES + 1);
+    const char* pattern = "ascii text, caf\xC3\xA9, \xE2\x82\xAC" "42; ";
+    U64 pattern_bytes = strlen(pattern);
+    for (U64 i = 0; i < SUITE_TEXT_BYTES; i += pattern_bytes) {
+        MemoryCopy(text.utf8 + i, pattern, Min(pattern_bytes, SUITE_TEXT_BYTES - i));
+    }
+    U64 text_bytes = SUITE_TEXT_BYTES - SUITE_TEXT_BYTES % pattern_bytes;
+    text.utf8[text_bytes] = 0;
+    text.utf16 = (wchar_t*)utf8_to_utf16(text.utf8);
+    bench_print(bench_run(&suite, "utf8_strlen 4KB", suite_utf8_strlen, &text, 1, text_bytes));
+    bench_print(bench_run(&suite, "utf8_to_utf16 4KB", suite_utf8_to_utf16, &text, 1, text_bytes));
+    bench_print(bench_run(&suite, "utf16_to_utf8 4KB", suite_utf16_to_utf8, &text, 1, text_bytes));
+    free(text.utf16);
+    BASE_FREE(text.utf8);
+
+    int saved = suite_stdout_silence();
+    BenchResult* formatted[2];
+    formatted[0] = bench_run(&suite, "myprintf", suite_myprintf, NULL, 1, 0);
+    formatted[1] = bench_run(&suite, "printf", suite_printf, NULL, 1, 0);
+    suite_stdout_restore(saved);
+    bench_print(formatted[0]);
+    bench_print(formatted[1]);
+
+    SuiteVectors* v = BASE_ALLOC(sizeof(SuiteVectors));
+    Xoshiro256 rng = xoshiro256_seed(1);
+    for (U64 i = 0; i < SUITE_BATCH; i++) {
+        F32 r[8];
+        for (int j = 0; j < 8; j++) {
+            r[j] = xoshiro256_F32(&rng) * 100.0f;
+        }
+        v->a[i] = v3f32(r[0] - 50.0f, r[1] - 50.0f, r[2] + 1.0f);
+        v->b[i] = v3f32(r[3], r[4], r[5]);
+        v->boxes[i] = i2f32(r[0], r[1], r[0] + r[2], r[1] + r[3]);
+        v->other[i] = i2f32(r[4], r[5], r[4] + r[6], r[5] + r[7]);
+        v->points[i] = v2f32(r[6], r[7]);
+        v->ibox[i] = i2s32((S32)r[0], (S32)r[1], (S32)(r[0] + r[2]), (S32)(r[1] + r[3]));
+        v->iother[i] = i2s32((S32)r[4], (S32)r[5], (S32)(r[4] + r[6]), (S32)(r[5] + r[7]));
+    }
+    bench_print(bench_run(&suite, "V3F32_normalize", suite_V3F32_normalize, v, SUITE_BATCH, 0));
+    bench_print(bench_run(&suite, "V3F32_dot", suite_V3F32_dot, v, SUITE_BATCH, 0));
+    bench_print(bench_run(&suite, "V3F32_cross", suite_V3F32_cross, v, SUITE_BATCH, 0));
+    bench_print(bench_run(&suite, "V3F32_length", suite_V3F32_length, v, SUITE_BATCH, 0));
+    bench_print(bench_run(&suite, "I2F32_overlaps", suite_I2F32_overlaps, v, SUITE_BATCH, 0));
+    bench_print(bench_run(&suite, "I2F32_contains", suite_I2F32_contains, v, SUITE_BATCH, 0));
+    bench_print(bench_run(&suite, "I2S32_intersection", suite_I2S32_intersection, v, SUITE_BATCH, 0));
+    BASE_FREE(v);
+
+    int status = EXIT_SUCCESS;
+    if (json_path && !bench_write_json(&suite, json_path)) {
+        fprintf(stderr, "Failed to write %s\n", json_path);
+        status = EXIT_FAILURE;
+    }
+    if (csv_path && !bench_write_csv(&suite, csv_path)) {
+        fprintf(stderr, "Failed to write %s\n", csv_path);
+        status = EXIT_FAILURE;
+    }
+    bench_suite_destroy(&suite);
+    return status;
+}
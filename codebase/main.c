@@ -1,8 +1,11 @@
 ﻿#include "base.h"
+#if !defined(BASE_LIBRARY)
 #include "base.c"
+#endif
 #include <float.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 void test_math_operations_edge_cases() {
     // Test add_V2F32
@@ -150,6 +153,63 @@ void test_string_functions_edge_cases() {
 
 
 
+void test_string_parsing_edge_cases() {
+    // Test parse_S32 / parse_U64 overflow and partial input
+    ParseS32 s32 = parse_S32(string("-2147483649"));
+    printf("parse_S32 (overflow): %d, consumed: %d, error: %d\n", s32.value, s32.consumed, s32.error);
+
+    ParseU64 u64 = parse_U64(string("18446744073709551615,next"));
+    printf("parse_U64 (max, trailing): %llu, consumed: %d\n", (unsigned long long)u64.value, u64.consumed);
+
+    ParseS64 s64 = parse_S64(string("abc"));
+    printf("parse_S64 (no digits): consumed: %d, error: %d\n", s64.consumed, s64.error);
+
+    // Test parse_F64 / parse_F32 rounding and range
+    ParseF64 f64 = parse_F64(string("2.2250738585072011e-308"));
+    printf("parse_F64 (subnormal boundary): %.17g\n", f64.value);
+
+    f64 = parse_F64(string("1e400"));
+    printf("parse_F64 (overflow): %f, error: %d\n", f64.value, f64.error);
+
+    ParseF32 f32 = parse_F32(string("-.5e-3"));
+    printf("parse_F32 (leading dot): %.9g, consumed: %d\n", f32.value, f32.consumed);
+}
+
+void test_hashtable_edge_cases() {
+    // Test insert/overwrite/erase on a U64 -> U64 table
+    HashTable table = hash_table_create(NULL, sizeof(U64), sizeof(U64), hash_table_hash_U64, hash_table_equal_U64, 0);
+    for (U64 i = 0; i < 100; i++) {
+        U64 value = i * i;
+        hash_table_insert(&table, &i, &value);
+    }
+    U64 key = 7, value = 0;
+    hash_table_insert(&table, &key, &value);
+    printf("hash_table_insert (overwrite): %llu, count: %llu\n",
+           (unsigned long long)*(U64*)hash_table_lookup(&table, &key), (unsigned long long)table.count);
+
+    B32 erased = hash_table_erase(&table, &key);
+    printf("hash_table_erase: %d, lookup after erase: %p\n", erased, hash_table_lookup(&table, &key));
+
+    key = 1000;
+    printf("hash_table_lookup (missing): %p\n", hash_table_lookup(&table, &key));
+
+    U64 iterator = 0, visited = 0;
+    while (hash_table_next(&table, &iterator, NULL, NULL)) {
+        visited++;
+    }
+    printf("hash_table_next (visited): %llu\n", (unsigned long long)visited);
+    hash_table_destroy(&table);
+
+    // Test String keys
+    HashTable strings = hash_table_create(NULL, sizeof(String), sizeof(int), hash_table_hash_String, hash_table_equal_String, 0);
+    String name = string("key");
+    int id = 42;
+    hash_table_insert(&strings, &name, &id);
+    String other = string("key");
+    printf("hash_table_lookup (String): %d\n", *(int*)hash_table_lookup(&strings, &other));
+    hash_table_destroy(&strings);
+}
+
 void test_linked_list_macros_edge_cases() {
     typedef struct Node {
         DLL_NODE(struct Node);
@@ -201,6 +261,1009 @@ void test_stack_and_queue_macros_edge_cases() {
 }
 
 
+void test_lockfree_queue_edge_cases() {
+    // Test MPMC queue full/empty boundaries
+    MPMCQueue* queue = mpmc_queue_create(NULL, 4);
+    void* items[8] = { PtrFromInt(1), PtrFromInt(2), PtrFromInt(3), PtrFromInt(4), PtrFromInt(5) };
+    U64 pushed = mpmc_queue_enqueue_batch(queue, items, 5);
+    printf("mpmc_queue_enqueue_batch (5 into 4): %llu\n", (unsigned long long)pushed);
+
+    B32 ok = mpmc_queue_enqueue(queue, PtrFromInt(6));
+    printf("mpmc_queue_enqueue (full): %d\n", ok);
+
+    U64 popped = mpmc_queue_dequeue_batch(queue, items, 8);
+    printf("mpmc_queue_dequeue_batch: %llu, first: %llu\n", (unsigned long long)popped, (unsigned long long)IntFromPtr(items[0]));
+
+    void* item = NULL;
+    ok = mpmc_queue_dequeue(queue, &item);
+    printf("mpmc_queue_dequeue (empty): %d\n", ok);
+    mpmc_queue_destroy(queue);
+
+    // Test intrusive MPSC queue on SLL_NODE links
+    typedef struct Node {
+        SLL_NODE(struct Node);
+        int value;
+    } Node;
+
+    Node node1, node2;
+    node1.value = 1;
+    node2.value = 2;
+    MPSCQueue mpsc;
+    mpsc_queue_init(&mpsc, OffsetOfMember(Node, next));
+    mpsc_queue_push(&mpsc, &node1);
+    mpsc_queue_push(&mpsc, &node2);
+    Node* first = mpsc_queue_pop(&mpsc);
+    Node* second = mpsc_queue_pop(&mpsc);
+    printf("mpsc_queue_pop: %d, %d, then %p\n", first->value, second->value, mpsc_queue_pop(&mpsc));
+}
+
+void test_atomic_stack_edge_cases() {
+    typedef struct Node {
+        STACK_NODE(struct Node);
+        int value;
+    } Node;
+
+    Node nodes[3];
+    AtomicStack stack;
+    atomic_stack_init(&stack, OffsetOfMember(Node, next));
+    printf("atomic_stack_pop (empty): %p\n", atomic_stack_pop(&stack));
+
+    for (int i = 0; i < 3; i++) {
+        nodes[i].value = i + 1;
+        atomic_stack_push(&stack, &nodes[i]);
+    }
+    Node* top = atomic_stack_pop(&stack);
+    printf("atomic_stack_pop: %d\n", top->value);
+
+    // Push the popped node back as a one-node list
+    top->next = NULL;
+    atomic_stack_push_list(&stack, top, top);
+    printf("atomic_stack_pop_all:");
+    for (Node* node = atomic_stack_pop_all(&stack); node; node = node->next) {
+        printf(" %d", node->value);
+    }
+    printf(", then %p\n", atomic_stack_pop(&stack));
+}
+
+void test_spsc_ring_edge_cases() {
+    // Test batch push into a ring smaller than the batch
+    SPSCRing* ring = spsc_ring_create(NULL, 4, sizeof(int), 0);
+    int values[6] = { 1, 2, 3, 4, 5, 6 };
+    U64 pushed = spsc_ring_push_batch(ring, values, 6);
+    printf("spsc_ring_push_batch (6 into 4): %llu\n", (unsigned long long)pushed);
+
+    // Test that reserve stops at the end of an unmirrored buffer
+    int out[4];
+    spsc_ring_pop_batch(ring, out, 4);
+    spsc_ring_push_batch(ring, values, 3);
+    spsc_ring_pop_batch(ring, out, 3);
+    U64 reserved = 0;
+    spsc_ring_reserve(ring, 3, &reserved);
+    printf("spsc_ring_reserve (at wrap, unmirrored): %llu\n", (unsigned long long)reserved);
+    spsc_ring_destroy(ring);
+
+    // Test that a mirrored ring hands out runs across the wrap
+    ring = spsc_ring_create(NULL, 4, sizeof(int), 1);
+    if (ring) {
+        U64 capacity = ring->capacity;
+        for (U64 i = 0; i < capacity - 1; i++) {
+            int v = (int)i;
+            spsc_ring_push(ring, &v);
+        }
+        int v = 0;
+        for (U64 i = 0; i < capacity - 1; i++) {
+            spsc_ring_pop(ring, &v);
+        }
+        int* slots = spsc_ring_reserve(ring, 3, &reserved);
+        slots[0] = 10;
+        slots[1] = 11;
+        slots[2] = 12;
+        spsc_ring_commit(ring, reserved);
+        U64 available = 0;
+        int* run = spsc_ring_peek(ring, 3, &available);
+        printf("spsc_ring_peek (across wrap, mirrored): %llu, last: %d\n", (unsigned long long)available, run[2]);
+        spsc_ring_destroy(ring);
+    }
+}
+
+ARRAY_DEFINE(IntArray, int)
+
+#define TEST_PARTICLE_FIELDS(X) X(V3F32, position) X(U32, id)
+SOA_DEFINE(TestParticles, TEST_PARTICLE_FIELDS)
+
+void test_dynamic_array_edge_cases() {
+    // Test that an arena-backed array keeps growing in place
+    Arena arena = arena_create(4096);
+    IntArray array = IntArray_create(&arena, 0);
+    for (int i = 0; i < 100; i++) {
+        IntArray_push(&array, i);
+    }
+    printf("IntArray_push (100, arena): count: %llu, arena used: %zu\n", (unsigned long long)array.count, arena.used);
+
+    // Test insert at the end, insert at the front, and out of range
+    IntArray_insert(&array, array.count, -1);
+    IntArray_insert(&array, 0, -2);
+    int* bad = IntArray_insert(&array, array.count + 1, 0);
+    printf("IntArray_insert: first: %d, last: %d, out of range: %p\n", array.v[0], array.v[array.count - 1], (void*)bad);
+
+    // Test swap-remove of the last element
+    IntArray_swap_remove(&array, array.count - 1);
+    printf("IntArray_swap_remove (last): count: %llu, last: %d\n", (unsigned long long)array.count, array.v[array.count - 1]);
+
+    // Test that the arena running out fails the push without losing data
+    int values[1024] = { 0 };
+    int* appended = IntArray_append(&array, values, 1024);
+    printf("IntArray_append (arena exhausted): %p, count: %llu\n", (void*)appended, (unsigned long long)array.count);
+    arena_destroy(&arena);
+
+    // Test structure-of-arrays alignment and round trip
+    TestParticles particles = TestParticles_create(NULL, 0);
+    for (U32 i = 0; i < 20; i++) {
+        TestParticlesElement e = { { (F32)i, 0.0f, 0.0f }, i };
+        TestParticles_push(&particles, e);
+    }
+    TestParticles_swap_remove(&particles, 0);
+    TestParticlesElement e = TestParticles_get(&particles, 0);
+    printf("TestParticles: count: %llu, aligned: %d %d, first id: %u\n", (unsigned long long)particles.count,
+           IS_ALIGNED(particles.position, SOA_ALIGNMENT) != 0, IS_ALIGNED(particles.id, SOA_ALIGNMENT) != 0, e.id);
+    TestParticles_destroy(&particles);
+}
+
+void test_unrolled_list_edge_cases() {
+    // Test popping from an empty list
+    UnrolledList list = unrolled_list_create(NULL, sizeof(int), 0);
+    int out = 0;
+    B32 popped = unrolled_list_pop_front(&list, &out);
+    printf("unrolled_list_pop_front (empty): %d\n", popped);
+
+    // Test that a middle insert into a full chunk splits it
+    for (int i = 0; i < (int)list.chunk_capacity; i++) {
+        unrolled_list_push_back(&list, &i);
+    }
+    UnrolledListIter it = unrolled_list_at(&list, 3);
+    int value = -1;
+    unrolled_list_insert(&list, &it, &value);
+    printf("unrolled_list_insert (full chunk): first chunk: %llu, second chunk: %llu, at: %d\n",
+           (unsigned long long)list.first->count, (unsigned long long)list.last->count, *(int*)unrolled_list_get(&list, it));
+
+    // Test that removing down to half merges the chunks back
+    it = unrolled_list_begin(&list);
+    for (U64 i = 0, n = list.chunk_capacity / 2; i < n; i++) {
+        unrolled_list_remove(&list, &it);
+    }
+    printf("unrolled_list_remove (merge): chunks: %d, count: %llu, front: %d\n",
+           list.first == list.last ? 1 : 2, (unsigned long long)list.count, *(int*)unrolled_list_get(&list, it));
+
+    // Test that removing the last element leaves the iterator at the end
+    it = unrolled_list_at(&list, list.count - 1);
+    unrolled_list_remove(&list, &it);
+    printf("unrolled_list_remove (last): at end: %d\n", it.chunk == NULL);
+    printf("unrolled_list_next (at end): %d\n", unrolled_list_next(&list, &it));
+    unrolled_list_destroy(&list);
+}
+
+void test_sorting_edge_cases() {
+    // Test float keys with signed zeros and infinities
+    F32 floats[6] = { 1.0f, -0.0f, inf_F32(), 0.0f, neg_inf_F32(), -2.5f };
+    radix_sort_F32(floats, 6, NULL);
+    printf("radix_sort_F32: %g %g %g %g %g %g\n", floats[0], floats[1], floats[2], floats[3], floats[4], floats[5]);
+
+    // Test that the index sort is stable and leaves the keys alone
+    S32 keys[5] = { 3, -1, 3, -7, -1 };
+    U32 indices[5];
+    radix_sort_index_S32(keys, 5, indices, NULL);
+    printf("radix_sort_index_S32: %u %u %u %u %u, keys[0]: %d\n", indices[0], indices[1], indices[2], indices[3], indices[4], keys[0]);
+
+    // Test strings that share a prefix longer than 8 bytes
+    String strings[3] = { string("prefix-long-b"), string("prefix-long"), string("prefix-long-a") };
+    sort_String(strings, 3, NULL);
+    printf("sort_String: %.*s, %.*s, %.*s\n", strings[0].length, strings[0].data,
+           strings[1].length, strings[1].data, strings[2].length, strings[2].data);
+
+    // Test that a too small scratch arena fails without sorting
+    Arena arena = arena_create(16);
+    U64 values[4] = { 4, 3, 2, 1 };
+    B32 sorted = radix_sort_U64(values, 4, &arena);
+    printf("radix_sort_U64 (arena too small): %d, first: %llu\n", sorted, (unsigned long long)values[0]);
+    arena_destroy(&arena);
+}
+
+void test_bitset_edge_cases() {
+    // Test a bitset whose size is not a multiple of 64
+    Bitset bitset = bitset_create(NULL, 100);
+    bitset_set_all(&bitset);
+    printf("bitset_set_all (100 bits): popcount: %llu\n", (unsigned long long)bitset_popcount(&bitset));
+
+    // Test rank/select after clearing, and past the end
+    bitset_clear_all(&bitset);
+    bitset_set(&bitset, 3);
+    bitset_set(&bitset, 99);
+    printf("bitset_rank (100): %llu, bitset_select (1): %llu, bitset_select (2): %llu\n",
+           (unsigned long long)bitset_rank(&bitset, 100), (unsigned long long)bitset_select(&bitset, 1),
+           (unsigned long long)bitset_select(&bitset, 2));
+
+    // Test next set past the last set bit
+    printf("bitset_next_set (from 4): %llu, (from 100): %llu\n", (unsigned long long)bitset_next_set(&bitset, 4),
+           (unsigned long long)bitset_next_set(&bitset, 100));
+    bitset_destroy(&bitset);
+
+    // Test that a Roaring container turns into a bitmap past 4096 values and back
+    RoaringBitmap roaring = roaring_create(NULL);
+    for (U32 i = 0; i <= ROARING_ARRAY_MAX; i++) {
+        roaring_add(&roaring, 0x10000 + i * 2);
+    }
+    U16 type_full = roaring.containers[0].type;
+    roaring_remove(&roaring, 0x10000);
+    printf("roaring (4097 values): bitmap: %d, after remove: array: %d\n",
+           type_full == RoaringContainer_Bitmap, roaring.containers[0].type == RoaringContainer_Array);
+
+    // Test adding a duplicate and finding the next value across containers
+    B32 added = roaring_add(&roaring, 0x10002);
+    U32 next = 0;
+    roaring_add(&roaring, 0x50000);
+    B32 found = roaring_next(&roaring, 0x10000 + ROARING_ARRAY_MAX * 2 + 1, &next);
+    printf("roaring_add (duplicate): %d, roaring_next: %d 0x%x\n", added, found, next);
+    roaring_destroy(&roaring);
+}
+
+void test_priority_queue_edge_cases() {
+    // Test popping an empty heap
+    Heap heap = heap_create(NULL, 0);
+    B32 popped = heap_pop(&heap, NULL, NULL);
+    printf("heap_pop (empty): %d\n", popped);
+
+    // Test decrease-key moving an entry to the top, and removing it
+    U32 handles[20];
+    for (U32 i = 0; i < 20; i++) {
+        handles[i] = heap_push(&heap, 100 + i, NULL);
+    }
+    heap_update(&heap, handles[19], 1);
+    U64 key = 0;
+    heap_peek(&heap, &key, NULL);
+    printf("heap_update (decrease): top: %llu\n", (unsigned long long)key);
+    heap_remove(&heap, handles[19]);
+    heap_update(&heap, handles[0], 500);
+    heap_peek(&heap, &key, NULL);
+    printf("heap_remove + heap_update (increase): top: %llu, count: %u\n", (unsigned long long)key, heap.count);
+    heap_destroy(&heap);
+
+    // Test a timer added in the past, one far out, and a cancelled one
+    TimerWheel* wheel = timer_wheel_create(NULL, 1000);
+    TimerNode late = { 0 };
+    TimerNode far = { 0 };
+    TimerNode cancelled = { 0 };
+    timer_wheel_add(wheel, &late, 10);
+    timer_wheel_add(wheel, &far, 1000 + 100000);
+    timer_wheel_add(wheel, &cancelled, 1001);
+    timer_wheel_cancel(wheel, &cancelled);
+    TimerNode expired;
+    timer_list_init(&expired);
+    timer_wheel_advance(wheel, 1001, &expired);
+    printf("timer_wheel_advance (1001): late: %d, cancelled: %d\n", timer_list_pop(&expired) == &late, timer_wheel_pending(&cancelled));
+    timer_wheel_advance(wheel, 1000 + 99999, &expired);
+    printf("timer_wheel_advance (one tick early): far pending: %d\n", timer_wheel_pending(&far) && expired.next == &expired);
+    timer_wheel_advance(wheel, 1000 + 100000, &expired);
+    printf("timer_wheel_advance (deadline): far: %d\n", timer_list_pop(&expired) == &far);
+    timer_wheel_destroy(wheel);
+}
+
+void test_vector_kernels_edge_cases() {
+    printf("simd_level_best: %s\n", simd_level_name(simd_level_best()));
+
+    // Test odd counts (scalar tails) and every supported level against scalar
+    V3F32 a[37], b[37], c[37], expected[37], out[37];
+    for (U32 i = 0; i < 37; i++) {
+        a[i] = v3f32((F32)i, (F32)i * 0.5f, -(F32)i);
+        b[i] = v3f32(1.0f, 2.0f, (F32)(i % 5));
+        c[i] = v3f32(0.25f, -1.0f, 3.0f);
+    }
+    simd_select_level(SIMDLevel_Scalar);
+    fma_V3F32_array(expected, a, b, c, 37);
+    SIMDLevel levels[] = {SIMDLevel_SSE2, SIMDLevel_AVX2, SIMDLevel_AVX512, SIMDLevel_NEON};
+    for (U32 l = 0; l < ArrayCount(levels); l++) {
+        SIMDLevel level = simd_select_level(levels[l]);
+        fma_V3F32_array(out, a, b, c, 37);
+        B32 same = 1;
+        for (U32 i = 0; i < 37; i++) {
+            for (U32 k = 0; k < 3; k++) {
+                same &= abs_F32(out[i].v[k] - expected[i].v[k]) <= 1e-5f;
+            }
+        }
+        printf("fma_V3F32_array (%s requested, %s used): matches scalar: %d\n", simd_level_name(levels[l]), simd_level_name(level), same);
+    }
+    simd_select_level(simd_level_best());
+
+    // Test in-place aliasing and zero count
+    add_V3F32_array(a, a, b, 37);
+    lerp_V3F32_array(a, a, a, 0.5f, 0);
+    printf("add_V3F32_array (in place): a[36]: %f %f %f\n", a[36].x, a[36].y, a[36].z);
+
+    // Test SoA components
+    F32 x[5] = {1, 2, 3, 4, 5}, y[5] = {0}, z[5] = {-1, -1, -1, -1, -1};
+    V2F32SoA soa = {{x, y}};
+    V2F32SoA soa_z = {{z, z}};
+    lerp_V2F32_soa(soa, soa, soa_z, 0.5f, 5);
+    printf("lerp_V2F32_soa: x[4]: %f, y[4]: %f\n", x[4], y[4]);
+
+    // Test dot, cross, length and normalizing a zero vector
+    V3F32 i_hat = v3f32(1, 0, 0), j_hat = v3f32(0, 1, 0);
+    V3F32 k_hat = V3F32_cross(i_hat, j_hat);
+    printf("V3F32_cross: %f %f %f, V3F32_dot: %f\n", k_hat.x, k_hat.y, k_hat.z, V3F32_dot(i_hat, j_hat));
+    printf("V3F32_length: %f, V3F32_distance: %f\n", V3F32_length(v3f32(3, 4, 0)), V3F32_distance(i_hat, j_hat));
+    V2F32 zero = V2F32_normalize(v2f32(0, 0));
+    V3F32 unit = V3F32_normalize_fast(v3f32(3, 4, 0));
+    printf("V2F32_normalize (zero): %f %f, V3F32_normalize_fast: %f %f\n", zero.x, zero.y, unit.x, unit.y);
+
+    // Test batch dot/normalize with a zero vector and tails, and empty reductions
+    V3F32 vs[11];
+    F32 dots[11];
+    for (U32 i = 0; i < 11; i++) {
+        vs[i] = v3f32((F32)i, 1.0f, -2.0f);
+    }
+    dot_V3F32_array(dots, vs, v3f32(1, 1, 1), 11);
+    normalize_V3F32_array(vs, vs, 11);
+    printf("dot_V3F32_array: dots[10]: %f, normalize_V3F32_array: |vs[10]|: %f\n", dots[10], V3F32_length(vs[10]));
+    V3F32 top = max_V3F32_array(vs, 11);
+    printf("max_V3F32_array: %f %f %f\n", top.x, top.y, top.z);
+    printf("sum_F32_array (empty): %f, min_F32_array (empty): %f\n", sum_F32_array(dots, 0), min_F32_array(dots, 0));
+}
+
+void test_matrix_edge_cases() {
+    // Test inverse round trip, singular matrices and compose order
+    M3F32 rotation = m3f32_rotation(v3f32(0.0f, 0.0f, 1.0f), 1.57079633f);
+    M4F32 m = m4f32_compose(v3f32(1.0f, 2.0f, 3.0f), &rotation, v3f32(2.0f, 2.0f, 2.0f));
+    M4F32 inverse;
+    B32 ok = M4F32_inverse(&m, &inverse);
+    M4F32 product = M4F32_multiply(&m, &inverse);
+    printf("M4F32_inverse: ok: %d, determinant: %f, m * inverse diagonal: %f %f %f %f\n", ok, M4F32_determinant(&m),
+           product.m[0][0], product.m[1][1], product.m[2][2], product.m[3][3]);
+    M4F32 singular = m4f32_scale(v3f32(1.0f, 0.0f, 1.0f));
+    printf("M4F32_inverse (singular): %d\n", M4F32_inverse(&singular, &inverse));
+    V3F32 p = M4F32_transform_point(&m, v3f32(1.0f, 0.0f, 0.0f));
+    V3F32 d = M4F32_transform_direction(&m, v3f32(1.0f, 0.0f, 0.0f));
+    printf("M4F32_transform_point: %f %f %f, direction: %f %f %f\n", p.x, p.y, p.z, d.x, d.y, d.z);
+    M3F32 t = M3F32_transpose(&rotation);
+    M3F32 identity = M3F32_multiply(&t, &rotation);
+    printf("M3F32 transpose * rotation diagonal: %f %f %f\n", identity.m[0][0], identity.m[1][1], identity.m[2][2]);
+
+    // Test batch transforms: tails, in place, SoA and streaming on an unaligned output
+    V3F32 points[11];
+    V3F32 expected[11];
+    for (U32 i = 0; i < 11; i++) {
+        points[i] = v3f32((F32)i, -(F32)i, 0.5f);
+        expected[i] = M4F32_transform_point(&m, points[i]);
+    }
+    transform_points_V3F32_array(points + 1, points + 1, &m, 10, StoreHint_Streaming);
+    transform_points_V3F32_array(points, points, &m, 1, StoreHint_Cached);
+    B32 same = 1;
+    for (U32 i = 0; i < 11; i++) {
+        same &= abs_F32(points[i].x - expected[i].x) + abs_F32(points[i].y - expected[i].y) <= 1e-4f;
+    }
+    printf("transform_points_V3F32_array (in place, streaming): matches: %d\n", same);
+    F32 xs[5] = {1, 2, 3, 4, 5}, ys[5] = {0}, zs[5] = {0}, ws[5] = {1, 1, 1, 1, 0};
+    V4F32SoA soa = {{xs, ys, zs, ws}};
+    transform_V4F32_soa(soa, soa, &m, 5, StoreHint_Streaming);
+    printf("transform_V4F32_soa: x[3]: %f, y[3]: %f, x[4] (w = 0): %f\n", xs[3], ys[3], xs[4]);
+}
+
+typedef void TestMathF32Func(F32* out, const F32* x, U64 count, MathAccuracy accuracy);
+
+// Distance in representable F32 values between a and the F32 nearest to expected
+U32 test_ulp_distance_F32(F32 a, F64 expected) {
+    F32 b = (F32)expected;
+    U32 ua, ub;
+    memcpy(&ua, &a, sizeof(ua));
+    memcpy(&ub, &b, sizeof(ub));
+    ua = (ua >> 31) ? 0x80000000u - (ua & 0x7fffffffu) : ua + 0x80000000u;
+    ub = (ub >> 31) ? 0x80000000u - (ub & 0x7fffffffu) : ub + 0x80000000u;
+    return ua > ub ? ua - ub : ub - ua;
+}
+
+void test_vector_math_edge_cases() {
+    // Test special values, tails and in-place use at every supported level
+    F32 x[7] = {0.0f, -0.0f, 1.0f, 1e30f, -200.0f, INFINITY, NAN};
+    F32 out[7];
+    SIMDLevel levels[] = {SIMDLevel_Scalar, SIMDLevel_SSE2, SIMDLevel_AVX2, SIMDLevel_NEON};
+    for (U32 l = 0; l < ArrayCount(levels); l++) {
+        if (!simd_level_supported(levels[l])) {
+            continue;
+        }
+        simd_select_level(levels[l]);
+        exp_F32_array(out, x, 7, MathAccuracy_Full);
+        printf("exp_F32_array (%s): %g %g %g %g %g %g %g\n", simd_level_name(levels[l]), out[0], out[1], out[2], out[3], out[4], out[5], out[6]);
+        log_F32_array(out, x, 7, MathAccuracy_Full);
+        printf("log_F32_array (%s): %g %g %g %g %g %g %g\n", simd_level_name(levels[l]), out[0], out[1], out[2], out[3], out[4], out[5], out[6]);
+        sin_F32_array(out, x, 7, MathAccuracy_Fast);
+        printf("sin_F32_array fast (%s): %g %g %g %g %g %g %g\n", simd_level_name(levels[l]), out[0], out[1], out[2], out[3], out[4], out[5], out[6]);
+    }
+    simd_select_level(simd_level_best());
+
+    // Test the documented fast-tier bounds at the worst inputs found by an
+    // exhaustive scan, through both the SIMD body and the scalar tail
+    struct {
+        const char* name;
+        TestMathF32Func* func;
+        F64 (*reference)(F64);
+        F32 x;
+        U32 bound;
+    } worst[] = {
+        {"sin", sin_F32_array, sin, 54.192131f, 7},
+        {"sin", sin_F32_array, sin, 54.1922455f, 7},
+        {"cos", cos_F32_array, cos, 57.3343964f, 7},
+        {"cos", cos_F32_array, cos, 266.249695f, 7},
+        {"exp", exp_F32_array, exp, -86.9899597f, 39},
+        {"exp", exp_F32_array, exp, -82.1379242f, 39},
+        {"log", log_F32_array, log, 0.703988016f, 3},
+        {"log", log_F32_array, log, 0.706963003f, 3},
+    };
+    for (U32 l = 0; l < ArrayCount(levels); l++) {
+        if (!simd_level_supported(levels[l])) {
+            continue;
+        }
+        simd_select_level(levels[l]);
+        B32 within = 1;
+        for (U32 w = 0; w < ArrayCount(worst); w++) {
+            F32 in[17];
+            F32 result[17];
+            for (U32 i = 0; i < ArrayCount(in); i++) {
+                in[i] = worst[w].x;
+            }
+            worst[w].func(result, in, ArrayCount(in), MathAccuracy_Fast);
+            F64 expected = worst[w].reference(worst[w].x);
+            for (U32 i = 0; i < ArrayCount(in); i++) {
+                if (test_ulp_distance_F32(result[i], expected) > worst[w].bound) {
+                    printf("%s_F32_array fast (%s): %.9g is %u ULP off\n", worst[w].name, simd_level_name(levels[l]),
+                           worst[w].x, test_ulp_distance_F32(result[i], expected));
+                    within = 0;
+                    break;
+                }
+            }
+        }
+        printf("fast F32 worst cases (%s): within documented bounds: %d\n", simd_level_name(levels[l]), within);
+    }
+    simd_select_level(simd_level_best());
+
+    // Test sincos with one output and F64 in place against libm
+    F64 d[5] = {-1e-310, 0.5, 3.0, 700.0, 1e7};
+    F64 c[5];
+    sincos_F64_array(0, c, d, 5, MathAccuracy_Full);
+    printf("sincos_F64_array cos(3.0): %.17g (libm %.17g)\n", c[2], cos(3.0));
+    sqrt_F64_array(d, d, 5, MathAccuracy_Fast);
+    printf("sqrt_F64_array (in place): %g %g %g %g %g\n", d[0], d[1], d[2], d[3], d[4]);
+    printf("exp_F64(1): %.17g, sqrt_F64(2): %.17g, abs_F64(-2.5): %f\n", exp_F64(1.0), sqrt_F64(2.0), abs_F64(-2.5));
+}
+
+void test_box_kernels_edge_cases() {
+    // Test half-open edges, INT32 extremes and tails at every supported level
+    I2S32 boxes[11];
+    V2S32 points[11];
+    for (S32 i = 0; i < 11; i++) {
+        boxes[i] = i2s32(i * 10, 0, i * 10 + 10, 10);
+        points[i] = v2s32(i * 10, 5);
+    }
+    boxes[9] = i2s32(min_S32, min_S32, max_S32, max_S32);
+    points[10] = v2s32(max_S32, 5);
+    I2S32 query = i2s32(20, 0, 50, 10);
+    U64 mask[1];
+    U32 indices[11];
+    SIMDLevel levels[] = {SIMDLevel_Scalar, SIMDLevel_SSE2, SIMDLevel_AVX2, SIMDLevel_NEON};
+    for (U32 l = 0; l < ArrayCount(levels); l++) {
+        if (!simd_level_supported(levels[l])) {
+            continue;
+        }
+        simd_select_level(levels[l]);
+        U64 hits = overlaps_mask_I2S32_array(mask, boxes, query, 11);
+        printf("overlaps_mask_I2S32_array (%s): %llu hits, mask: 0x%llx\n", simd_level_name(levels[l]), (unsigned long long)hits, (unsigned long long)mask[0]);
+        hits = contains_indices_V2S32_array(indices, points, i2s32(20, 0, max_S32, 10), 11);
+        printf("contains_indices_V2S32_array (%s): %llu hits, first: %u, last: %u\n", simd_level_name(levels[l]), (unsigned long long)hits, indices[0], indices[hits - 1]);
+    }
+    simd_select_level(simd_level_best());
+
+    // Test SoA layout, in-place clip and intersections that would invert
+    S32 x0[5] = {0, 5, 40, -100, min_S32};
+    S32 y0[5] = {0, 5, 40, -100, min_S32};
+    S32 x1[5] = {10, 15, 50, -50, max_S32};
+    S32 y1[5] = {10, 15, 50, -50, max_S32};
+    I2S32SoA soa = {{x0, y0, x1, y1}};
+    U64 hits = overlaps_indices_I2S32_soa(indices, soa, i2s32(10, 10, 20, 20), 5);
+    printf("overlaps_indices_I2S32_soa: %llu hits, first: %u, second: %u\n", (unsigned long long)hits, indices[0], indices[1]);
+    clip_I2S32_soa(soa, soa, i2s32(0, 0, 20, 20), 5);
+    printf("clip_I2S32_soa (in place): [%d %d %d %d], [%d %d %d %d], [%d %d %d %d]\n", x0[1], y0[1], x1[1], y1[1],
+           x0[2], y0[2], x1[2], y1[2], x0[4], y0[4], x1[4], y1[4]);
+    I2S32 a[2] = {i2s32(0, 0, 10, 10), i2s32(0, 0, 10, 10)};
+    I2S32 b[2] = {i2s32(5, 20, 15, 30), i2s32(min_S32, 5, max_S32, 6)};
+    I2S32 r[2];
+    intersect_I2S32_array(r, a, b, 2);
+    printf("intersect_I2S32_array: [%d %d %d %d], [%d %d %d %d]\n", r[0].x0, r[0].y0, r[0].x1, r[0].y1, r[1].x0, r[1].y0, r[1].x1, r[1].y1);
+    union_I2S32_array(r, a, b, 2);
+    printf("union_I2S32_array: [%d %d %d %d], [%d %d %d %d]\n", r[0].x0, r[0].y0, r[0].x1, r[0].y1, r[1].x0, r[1].y0, r[1].x1, r[1].y1);
+}
+
+void test_spatial_index_edge_cases() {
+    // Test empty indexes, touching boxes (closed I2F32) and half-open I2S32 edges
+    U32 out[32];
+    F32 distance[32];
+    RTree tree = rtree_create(0);
+    SpatialGrid grid = spatial_grid_create(0);
+    rtree_build_I2F32(&tree, 0, 0);
+    spatial_grid_build_I2F32(&grid, 0, 0, 0, 0);
+    printf("rtree (empty): query: %u, nearest: %u\n", rtree_query_I2F32(&tree, i2f32(0, 0, 1, 1), out, 8),
+           rtree_nearest(&tree, v2f32(0, 0), 4, out, distance));
+    printf("spatial_grid (empty): query: %u, nearest: %u\n", spatial_grid_query_I2F32(&grid, i2f32(0, 0, 1, 1), out, 8),
+           spatial_grid_nearest(&grid, v2f32(0, 0), 4, out, distance));
+
+    I2F32 boxes[20];
+    for (U32 i = 0; i < 20; i++) {
+        boxes[i] = i2f32((F32)i, 0.0f, (F32)i + 1.0f, 1.0f);
+    }
+    rtree_build_I2F32(&tree, boxes, 20);
+    spatial_grid_build_I2F32(&grid, boxes, 20, 4, 1);
+    printf("rtree_query_point_V2F32 (shared edge x = 5): %u, grid: %u\n", rtree_query_point_V2F32(&tree, v2f32(5.0f, 0.5f), out, 8),
+           spatial_grid_query_point_V2F32(&grid, v2f32(5.0f, 0.5f), out, 8));
+    printf("rtree_query_I2F32 (total with max_out 2): %u, grid: %u\n", rtree_query_I2F32(&tree, i2f32(2.5f, 0, 7.5f, 1), out, 2),
+           spatial_grid_query_I2F32(&grid, i2f32(2.5f, 0, 7.5f, 1), out, 2));
+    U32 found = rtree_nearest(&tree, v2f32(30.0f, 0.5f), 3, out, distance);
+    printf("rtree_nearest (3): %u: %u %u %u, distances: %f %f %f\n", found, out[0], out[1], out[2], distance[0], distance[1], distance[2]);
+    found = spatial_grid_nearest(&grid, v2f32(-3.0f, 0.5f), 30, out, distance);
+    printf("spatial_grid_nearest (k > count): %u, first: %u %f\n", found, out[0], distance[0]);
+
+    // Test rebuilding in place with fewer I2S32 boxes beyond F32 precision
+    I2S32 ints[3] = {i2s32(0, 0, 10, 10), i2s32(10, 0, 20, 10), i2s32(16777217, 0, 16777219, 1)};
+    rtree_build_I2S32(&tree, ints, 3);
+    spatial_grid_build_I2S32(&grid, ints, 3, 0, 0);
+    U32 hits = rtree_query_point_V2S32(&tree, v2s32(10, 5), out, 8);
+    printf("rtree_query_point_V2S32 (10, 5): %u (item %u), grid: %u\n", hits, out[0], spatial_grid_query_point_V2S32(&grid, v2s32(10, 5), out, 8));
+    printf("rtree_query_I2S32 (16777216..16777217): %u, grid: %u\n", rtree_query_I2S32(&tree, i2s32(16777216, 0, 16777217, 1), out, 8),
+           spatial_grid_query_I2S32(&grid, i2s32(16777216, 0, 16777217, 1), out, 8));
+    rtree_destroy(&tree);
+    spatial_grid_destroy(&grid);
+}
+
+void test_interval_edge_cases() {
+    // Test half-open ends, empty ranges, F32 signed zero and pending inserts
+    U32 out[8];
+    IntervalTree tree = interval_tree_create(0);
+    printf("interval_tree_stab_U64 (empty): %u\n", interval_tree_stab_U64(&tree, 5, out, 8));
+    I1U64 ranges[4] = {i1u64(0, 10), i1u64(10, 20), i1u64(15, 15), i1u64(max_U64 - 1, max_U64)};
+    interval_tree_build_I1U64(&tree, ranges, 4);
+    U32 hits = interval_tree_stab_U64(&tree, 10, out, 8);
+    printf("interval_tree_stab_U64 (10): %u (id %u), (15, empty range): %u, (max_U64 - 1): %u, (max_U64): %u\n", hits, out[0],
+           interval_tree_stab_U64(&tree, 15, out, 8), interval_tree_stab_U64(&tree, max_U64 - 1, out, 8),
+           interval_tree_stab_U64(&tree, max_U64, out, 8));
+    interval_tree_insert_I1U64(&tree, i1u64(5, 12), 7);
+    printf("interval_tree_query_I1U64 ([9, 11) with a pending insert): %u\n", interval_tree_query_I1U64(&tree, i1u64(9, 11), out, 8));
+    B32 removed = interval_tree_remove_I1U64(&tree, i1u64(0, 10), 0);
+    printf("interval_tree_remove_I1U64: %d, again: %d, wrong id: %d\n", removed, interval_tree_remove_I1U64(&tree, i1u64(0, 10), 0),
+           interval_tree_remove_I1U64(&tree, i1u64(10, 20), 3));
+    I1F32 times[2] = {i1f32(-1.0f, -0.0f), i1f32(0.0f, 1.0f)};
+    interval_tree_build_I1F32(&tree, times, 2);
+    hits = interval_tree_stab_F32(&tree, -0.0f, out, 8);
+    printf("interval_tree_stab_F32 (-0.0): %u (id %u)\n", hits, out[0]);
+    interval_tree_destroy(&tree);
+
+    // Test coalescing adjacent ranges, splitting on subtract and set operations
+    IntervalSet a = interval_set_create(0);
+    IntervalSet b = interval_set_create(0);
+    IntervalSet c = interval_set_create(0);
+    interval_set_add(&a, i1u64(0, 10));
+    interval_set_add(&a, i1u64(10, 20));
+    interval_set_add(&a, i1u64(30, 40));
+    printf("interval_set_add (adjacent): count: %llu, total: %llu\n", (unsigned long long)a.count, (unsigned long long)interval_set_total(&a));
+    interval_set_subtract(&a, i1u64(5, 8));
+    printf("interval_set_subtract (split): count: %llu, contains 5: %d, contains 8: %d\n", (unsigned long long)a.count,
+           interval_set_contains(&a, 5), interval_set_contains(&a, 8));
+    interval_set_add(&b, i1u64(15, 35));
+    interval_set_union(&c, &a, &b);
+    printf("interval_set_union: count: %llu, total: %llu\n", (unsigned long long)c.count, (unsigned long long)interval_set_total(&c));
+    interval_set_intersection(&c, &a, &b);
+    printf("interval_set_intersection: count: %llu, total: %llu\n", (unsigned long long)c.count, (unsigned long long)interval_set_total(&c));
+    interval_set_difference(&c, &a, &b);
+    printf("interval_set_difference: count: %llu, find 36: %llu\n", (unsigned long long)c.count, (unsigned long long)interval_set_find(&c, 36));
+    interval_set_intersect(&a, i1u64(3, 3));
+    printf("interval_set_intersect (empty range): count: %llu, overlaps: %d\n", (unsigned long long)a.count, interval_set_overlaps(&a, i1u64(0, 100)));
+    interval_set_destroy(&c);
+    interval_set_destroy(&b);
+    interval_set_destroy(&a);
+}
+
+void test_random_edge_cases() {
+    // Test the reference PCG32 sequence, advance, bounds and stream splitting
+    PCG32 pcg = pcg32_seed(42, 54);
+    U32 first = pcg32_next(&pcg);
+    printf("pcg32_seed(42, 54): 0x%08x 0x%08x (reference 0xa15c02b7 0x7b47f409)\n", first, pcg32_next(&pcg));
+    PCG32 stepped = pcg32_seed(1, 2);
+    PCG32 advanced = stepped;
+    for (U32 i = 0; i < 1000; i++) {
+        pcg32_next(&stepped);
+    }
+    pcg32_advance(&advanced, 1000);
+    printf("pcg32_advance (1000): matches stepping: %d\n", stepped.state == advanced.state);
+    Xoshiro256 xoshiro = xoshiro256_seed(0);
+    U64 b0 = xoshiro256_bounded(&xoshiro, 0);
+    U64 b1 = xoshiro256_bounded(&xoshiro, 1);
+    printf("xoshiro256_bounded (0): %llu, (1): %llu, pcg32_bounded (1): %u\n", (unsigned long long)b0, (unsigned long long)b1, pcg32_bounded(&pcg, 1));
+    Xoshiro256 parent = xoshiro256_seed(7);
+    Xoshiro256 child = xoshiro256_split(&parent);
+    U64 c = xoshiro256_next(&child);
+    printf("xoshiro256_split: child %llx, parent %llx\n", (unsigned long long)c, (unsigned long long)xoshiro256_next(&parent));
+
+    // Test bulk tails (values left in a step are dropped) at every supported level
+    Xoshiro256 source = xoshiro256_seed(42);
+    RandomBulk seeded = random_bulk_seed(&source);
+    SIMDLevel levels[] = {SIMDLevel_Scalar, SIMDLevel_SSE2, SIMDLevel_AVX2, SIMDLevel_NEON};
+    for (U32 l = 0; l < ArrayCount(levels); l++) {
+        if (!simd_level_supported(levels[l])) {
+            continue;
+        }
+        simd_select_level(levels[l]);
+        RandomBulk bulk = seeded;
+        U64 values[11];
+        random_fill_U64(&bulk, values, 3);
+        random_fill_U64(&bulk, values + 3, 8);
+        U32 small[3];
+        random_fill_U32(&bulk, small, 3);
+        printf("random_fill_U64 (%s): %llx %llx %llx, random_fill_U32: %08x\n", simd_level_name(levels[l]), (unsigned long long)values[0],
+               (unsigned long long)values[3], (unsigned long long)values[10], small[2]);
+    }
+    simd_select_level(simd_level_best());
+
+    // Test float ranges, empty ranges and points inside a box
+    RandomBulk bulk = seeded;
+    F32 f[33];
+    F64 d[9];
+    random_fill_F32(&bulk, f, 33, -1.0f, 1.0f);
+    random_fill_F64(&bulk, d, 9, 5.0, 5.0);
+    F32 lo = f[0];
+    F32 hi = f[0];
+    for (U32 i = 0; i < 33; i++) {
+        lo = Min(lo, f[i]);
+        hi = Max(hi, f[i]);
+    }
+    printf("random_fill_F32 [-1, 1): min %d, max %d, random_fill_F64 [5, 5): %f\n", lo >= -1.0f, hi < 1.0f, d[8]);
+    V3F32 points[1500];
+    random_fill_V3F32(&bulk, points, 1500, i2f32(-4.0f, 2.0f, 4.0f, 3.0f), i1f32(-1.0f, 0.0f));
+    U32 inside = 0;
+    for (U32 i = 0; i < 1500; i++) {
+        inside += points[i].x >= -4.0f && points[i].x < 4.0f && points[i].y >= 2.0f && points[i].y < 3.0f && points[i].z >= -1.0f && points[i].z < 0.0f;
+    }
+    printf("random_fill_V3F32: %u of 1500 inside\n", inside);
+}
+
+typedef struct {
+    U64 begin;
+    U64 end;
+    volatile U64* sum;
+} TestJobRange;
+
+// Splits the range in halves until it is small, summing the leaves
+void test_job_sum(JobWorker* worker, Job* job, void* data) {
+    TestJobRange* range = data;
+    if (range->end - range->begin <= 64) {
+        U64* scratch = arena_alloc(&worker->scratch, 64 * sizeof(U64));
+        U64 sum = 0;
+        for (U64 i = range->begin; i < range->end; i++) {
+            scratch[i - range->begin] = i;
+            sum += scratch[i - range->begin];
+        }
+        atomic_fetch_add_U64(range->sum, sum);
+        return;
+    }
+    TestJobRange* halves = arena_alloc(&worker->scratch, 2 * sizeof(TestJobRange));
+    U64 mid = range->begin + (range->end - range->begin) / 2;
+    halves[0] = (TestJobRange){ range->begin, mid, range->sum };
+    halves[1] = (TestJobRange){ mid, range->end, range->sum };
+    // The halves live in this job's scratch, so wait on them before returning
+    Job* group = job_create(worker->system, NULL, NULL, NULL);
+    job_submit(worker->system, job_create(worker->system, group, test_job_sum, &halves[0]));
+    job_submit(worker->system, job_create(worker->system, group, test_job_sum, &halves[1]));
+    job_submit(worker->system, group);
+    job_wait(worker->system, group);
+}
+
+void test_job_count(JobWorker* worker, Job* job, void* data) {
+    atomic_fetch_add_U64(data, 1);
+}
+
+typedef struct {
+    JobSystem* system;
+    volatile U64 count;
+} TestJobSubmitter;
+
+void test_job_submitter(void* param) {
+    TestJobSubmitter* t = param;
+    Job* root = job_create(t->system, NULL, NULL, NULL);
+    for (int i = 0; i < 100; i++) {
+        job_submit(t->system, job_create(t->system, root, test_job_count, (void*)&t->count));
+    }
+    job_submit(t->system, root);
+    job_wait(t->system, root);
+}
+
+void test_job_system_edge_cases() {
+    // Test a recursive fork-join sum with and without extra workers
+    U32 worker_counts[2] = { 1, 4 };
+    for (int k = 0; k < 2; k++) {
+        JobSystem* system = job_system_create(NULL, worker_counts[k], 1 << 16, 0);
+        volatile U64 sum = 0;
+        TestJobRange range = { 0, 100000, &sum };
+        Job* root = job_create(system, NULL, test_job_sum, &range);
+        job_submit(system, root);
+        job_wait(system, root);
+        U64 used = 0;
+        for (U32 i = 0; i < system->worker_count; i++) {
+            used += system->workers[i].scratch.used;
+        }
+        printf("job fork-join sum (%u workers): %llu, scratch left: %llu\n", worker_counts[k],
+               (unsigned long long)sum, (unsigned long long)used);
+        job_system_destroy(system);
+    }
+
+    // Test more children than the deque and the job pool hold
+    JobSystem* system = job_system_create(NULL, 2, 0, 1);
+    volatile U64 count = 0;
+    Job* root = job_create(system, NULL, NULL, NULL);
+    for (int i = 0; i < 3 * JOB_POOL_PER_WORKER; i++) {
+        job_submit(system, job_create(system, root, test_job_count, (void*)&count));
+    }
+    printf("job_is_done (before submit): %d\n", job_is_done(root));
+    job_submit(system, root);
+    job_wait(system, root);
+    printf("job children past pool size: %llu\n", (unsigned long long)count);
+
+    // Test submitting and waiting from a thread that is not a worker
+    TestJobSubmitter submitter = { system, 0 };
+    OSThread thread = os_thread_create(test_job_submitter, &submitter);
+    os_thread_join(thread);
+    printf("job from outside thread: %llu\n", (unsigned long long)submitter.count);
+    job_system_destroy(system);
+    printf("os_cpu_count > 0: %d\n", os_cpu_count() > 0);
+}
+
+void test_parallel_scale(JobWorker* worker, U64 begin, U64 end, void* data) {
+    V3F32* points = data;
+    for (U64 i = begin; i < end; i++) {
+        points[i] = v3f32((F32)i, 2.0f * (F32)i, 0.0f);
+    }
+}
+
+void test_parallel_sum(JobWorker* worker, U64 begin, U64 end, void* data, void* partial) {
+    const F32* values = data;
+    F32 sum = 0.0f;
+    for (U64 i = begin; i < end; i++) {
+        sum += values[i];
+    }
+    *(F32*)partial = sum;
+}
+
+void test_parallel_add(void* into, const void* from, void* data) {
+    *(F32*)into += *(const F32*)from;
+}
+
+typedef struct {
+    JobSystem* system;
+    V3F32* points;
+    U64 count;
+} TestParallelCaller;
+
+void test_parallel_caller(void* param) {
+    TestParallelCaller* t = param;
+    parallel_for(t->system, t->count, 0, test_parallel_scale, t->points);
+}
+
+void test_parallel_edge_cases() {
+    // Test grain selection
+    printf("parallel_grain (10, 0): %llu, (1e7, 0): %llu, (1e7, 100): %llu\n",
+           (unsigned long long)parallel_grain(10, 0), (unsigned long long)parallel_grain(10000000, 0),
+           (unsigned long long)parallel_grain(10000000, 100));
+
+    // Test that every index is visited once, including a partial last chunk
+    JobSystem* system = job_system_create(NULL, 4, 1 << 12, 0);
+    U64 count = 100003;
+    V3F32* points = BASE_ALLOC(count * sizeof(V3F32));
+    MemoryZeroTyped(points, count);
+    parallel_for(system, count, 0, test_parallel_scale, points);
+    U64 wrong = 0;
+    for (U64 i = 0; i < count; i++) {
+        wrong += points[i].x != (F32)i || points[i].y != 2.0f * (F32)i;
+    }
+    printf("parallel_for (%llu points): wrong: %llu\n", (unsigned long long)count, (unsigned long long)wrong);
+
+    // Test that a float sum is bit-identical across worker counts and runs
+    F32* values = BASE_ALLOC(count * sizeof(F32));
+    Xoshiro256 rng = xoshiro256_seed(7);
+    for (U64 i = 0; i < count; i++) {
+        values[i] = xoshiro256_F32(&rng) * 1000.0f - 300.0f;
+    }
+    F32 sums[3] = { 0.0f, 0.0f, 0.0f };
+    parallel_reduce(system, count, 0, sizeof(F32), test_parallel_sum, test_parallel_add, values, &sums[0]);
+    parallel_reduce(system, count, 0, sizeof(F32), test_parallel_sum, test_parallel_add, values, &sums[1]);
+    job_system_destroy(system);
+    system = job_system_create(NULL, 1, 0, 0);
+    parallel_reduce(system, count, 0, sizeof(F32), test_parallel_sum, test_parallel_add, values, &sums[2]);
+    printf("parallel_reduce (4, 4, 1 workers): identical: %d\n",
+           MemoryCompare(&sums[0], &sums[1], sizeof(F32)) && MemoryCompare(&sums[0], &sums[2], sizeof(F32)));
+
+    // Test that an empty range leaves the identity in result
+    F32 empty = 5.0f;
+    parallel_reduce(system, 0, 0, sizeof(F32), test_parallel_sum, test_parallel_add, values, &empty);
+    printf("parallel_reduce (empty): %.1f\n", empty);
+
+    // Test parallel_for from a thread other than the creator of a 1-worker system
+    MemoryZeroTyped(points, count);
+    TestParallelCaller caller = { system, points, count };
+    OSThread thread = os_thread_create(test_parallel_caller, &caller);
+    os_thread_join(thread);
+    wrong = 0;
+    for (U64 i = 0; i < count; i++) {
+        wrong += points[i].x != (F32)i || points[i].y != 2.0f * (F32)i;
+    }
+    printf("parallel_for (outside thread, 1 worker): wrong: %llu\n", (unsigned long long)wrong);
+    job_system_destroy(system);
+    BASE_FREE(values);
+    BASE_FREE(points);
+}
+
+void test_profiler_edge_cases() {
+    // Test that the timer is monotonic and its frequency converts back
+    U64 frequency = timer_frequency();
+    U64 t0 = timer_ticks();
+    U64 ns0 = timer_ns();
+    U64 t1 = timer_ticks();
+    U64 ns1 = timer_ns();
+    printf("timer_ticks/timer_ns monotonic: %d, %d\n", t1 >= t0, ns1 >= ns0);
+    printf("timer_seconds (frequency ticks): %.1f\n", timer_seconds(frequency));
+
+    // Test that a scope runs its block once whether or not zones are recorded
+    int runs = 0;
+    PROFILE_SCOPE("test scope") {
+        runs++;
+    }
+    printf("PROFILE_SCOPE runs: %d\n", runs);
+
+#if defined(BASE_PROFILE)
+    // Test nesting past the depth limit, a named thread and the trace export
+    profile_reset();
+    PROFILE_THREAD_NAME("main \"thread\"");
+    for (int i = 0; i < PROFILE_MAX_DEPTH + 6; i++) {
+        PROFILE_BEGIN("nested");
+    }
+    for (int i = 0; i < PROFILE_MAX_DEPTH + 6; i++) {
+        PROFILE_END();
+    }
+    PROFILE_END();
+    printf("profile_dropped (depth %d): %llu\n", PROFILE_MAX_DEPTH + 6, (unsigned long long)profile_dropped());
+
+    JobSystem* system = job_system_create(NULL, 2, 0, 0);
+    Job* root = job_create(system, NULL, NULL, NULL);
+    for (int i = 0; i < 8; i++) {
+        job_submit(system, job_create(system, root, NULL, NULL));
+    }
+    job_submit(system, root);
+    job_wait(system, root);
+    string_create_literal("zone");
+    job_system_destroy(system);
+
+    const char* path = "profile_test.json";
+    B32 written = profile_write_chrome_trace(path);
+    char text[1 << 14] = { 0 };
+    FILE* file = fopen(path, "rb");
+    size_t size = file ? fread(text, 1, sizeof(text) - 1, file) : 0;
+    if (file) {
+        fclose(file);
+    }
+    remove(path);
+    printf("profile_write_chrome_trace: %d, has zone: %d, escaped name: %d, closed: %d\n", written,
+           strstr(text, "\"name\":\"string_create_literal\",\"ph\":\"X\"") != NULL,
+           strstr(text, "main \\\"thread\\\"") != NULL, size > 4 && strcmp(text + size - 4, "\n]}\n") == 0);
+#endif
+}
+
+void test_bench_sum(void* data, U64 iterations) {
+    U64* values = data;
+    for (U64 it = 0; it < iterations; it++) {
+        U64 sum = 0;
+        for (U64 i = 0; i < 64; i++) {
+            sum += values[i];
+        }
+        DoNotOptimize(sum);
+    }
+}
+
+void test_bench_harness_edge_cases() {
+    // Test a short run, the statistics order and the name filter
+    U64 values[64];
+    for (U64 i = 0; i < 64; i++) {
+        values[i] = i;
+    }
+    BenchSuite suite = bench_suite_create();
+    suite.samples = 7;
+    suite.sample_ns = 10000;
+    BenchResult* result = bench_run(&suite, "sum 64", test_bench_sum, values, 64, 64 * sizeof(U64));
+    printf("bench_run: samples: %llu, min <= median <= p99: %d, cycles/byte > 0: %d\n",
+           (unsigned long long)result->samples, result->min_ns <= result->median_ns && result->median_ns <= result->p99_ns,
+           result->cycles_per_byte > 0.0);
+    suite.filter = "other";
+    printf("bench_run (filtered out): %p, results: %llu\n",
+           (void*)bench_run(&suite, "sum 64", test_bench_sum, values, 64, 0), (unsigned long long)suite.count);
+    bench_suite_destroy(&suite);
+}
+
+U32 test_dispatch_resolves;
+
+U64 test_dispatch_double(U64 x) {
+    return 2 * x;
+}
+
+void* test_dispatch_resolve(const CPUFeatures* features) {
+    (void)features;
+    test_dispatch_resolves++;
+    return (void*)test_dispatch_double;
+}
+
+void test_cpu_features_edge_cases() {
+    // Test that flags imply their prerequisites and the topology is sane
+    CPUFeatures f = cpu_features();
+    printf("cpu_features: avx2 implies avx: %d, avx512 subsets imply avx512f: %d, slow_pdep implies bmi2: %d\n",
+           !f.avx2 || f.avx, !(f.avx512dq || f.avx512bw || f.avx512vl || f.avx512cd || f.avx512vnni) || f.avx512f,
+           !f.slow_pdep || f.bmi2);
+    CPUTopology t = cpu_topology();
+    printf("cpu_topology: line size power of two: %d, threads >= cores >= 1: %d, page size power of two: %d\n",
+           t.cache_line_size && !(t.cache_line_size & (t.cache_line_size - 1)), t.thread_count >= t.core_count && t.core_count >= 1,
+           t.page_size && !(t.page_size & (t.page_size - 1)));
+    printf("cpu_topology: cache sizes ordered: %d\n", (!t.l2_size || t.l1d_size <= t.l2_size) && (!t.l3_size || t.l2_size <= t.l3_size));
+
+    // Test that the dispatch slot is resolved once
+    void* volatile slot = NULL;
+    U64 sum = 0;
+    for (U64 i = 0; i < 4; i++) {
+        typedef U64 DoubleFunc(U64);
+        sum += ((DoubleFunc*)cpu_dispatch(&slot, test_dispatch_resolve))(i);
+    }
+    printf("cpu_dispatch: sum: %llu, resolves: %u\n", (unsigned long long)sum, test_dispatch_resolves);
+
+    // Test the dispatched bitset select within and across words
+    Arena arena = arena_create(1 << 12);
+    Bitset bitset = bitset_create(&arena, 128);
+    bitset_set(&bitset, 3);
+    bitset_set(&bitset, 5);
+    bitset_set(&bitset, 64);
+    bitset_set(&bitset, 127);
+    printf("bitset_select: %llu %llu %llu %llu\n", (unsigned long long)bitset_select(&bitset, 0),
+           (unsigned long long)bitset_select(&bitset, 1), (unsigned long long)bitset_select(&bitset, 2),
+           (unsigned long long)bitset_select(&bitset, 3));
+    arena_destroy(&arena);
+}
+
+void test_clock_edge_cases() {
+    // Test the snapshot against localtime for the same second
+    ClockSnapshot snapshot = clock_snapshot();
+    time_t seconds = (time_t)snapshot.epoch_seconds;
+    struct tm expected = *localtime(&seconds);
+    char prefix[CLOCK_TIMESTAMP_SIZE];
+    strftime(prefix, sizeof(prefix), "%Y-%m-%dT%H:%M:%S", &expected);
+    printf("clock_snapshot: fields match localtime: %d, timestamp prefix matches: %d, length: %u\n",
+           snapshot.year == expected.tm_year + 1900 && snapshot.month == expected.tm_mon + 1 &&
+           snapshot.day == expected.tm_mday && snapshot.hour == expected.tm_hour &&
+           snapshot.minute == expected.tm_min && snapshot.second == expected.tm_sec &&
+           snapshot.day_of_week == expected.tm_wday && snapshot.day_of_year == expected.tm_yday,
+           strncmp(snapshot.timestamp, prefix, strlen(prefix)) == 0, snapshot.timestamp_length);
+    printf("clock_snapshot: offset within a day: %d, month matches get_current_month: %d\n",
+           snapshot.utc_offset > -86400 && snapshot.utc_offset < 86400,
+           (S32)get_current_month() == (S32)clock_snapshot().month - 1 || clock_snapshot().epoch_seconds != snapshot.epoch_seconds);
+
+    // Test that repeated reads in one second reuse the snapshot and never go back
+    ClockSnapshot again = clock_snapshot();
+    printf("clock_snapshot (again): not earlier: %d\n", again.epoch_seconds >= snapshot.epoch_seconds);
+
+    // Test the coarse readers against time() and each other
+    U64 wall = clock_realtime_coarse_ns();
+    S64 now = (S64)time(NULL);
+    U64 mono0 = clock_monotonic_coarse_ns();
+    U64 mono1 = clock_monotonic_coarse_ns();
+    printf("clock_realtime_coarse_ns: within a second of time(): %d\n", (S64)(wall / 1000000000ull) >= now - 1 && (S64)(wall / 1000000000ull) <= now + 1);
+    printf("clock_monotonic_coarse_ns: monotonic: %d\n", mono1 >= mono0 && mono0 > 0);
+}
+
 void test_arena_operations_edge_cases() {
     Arena arena = arena_create(128);
     void* ptr1 = arena_alloc(&arena, 64);
@@ -266,12 +1329,81 @@ int main() {
     printf("\n--- Testing String Functions Edge Cases ---\n");
     test_string_functions_edge_cases();
 
+    printf("\n--- Testing String Parsing Edge Cases ---\n");
+    test_string_parsing_edge_cases();
+
+    printf("\n--- Testing Hashtable Edge Cases ---\n");
+    test_hashtable_edge_cases();
+
     printf("\n--- Testing Linked List Macros Edge Cases ---\n");
     test_linked_list_macros_edge_cases();
 
     printf("\n--- Testing Stack and Queue Macros Edge Cases ---\n");
     test_stack_and_queue_macros_edge_cases();
 
+    printf("\n--- Testing Lock-free Queue Edge Cases ---\n");
+    test_lockfree_queue_edge_cases();
+
+    printf("\n--- Testing Atomic Stack Edge Cases ---\n");
+    test_atomic_stack_edge_cases();
+
+    printf("\n--- Testing SPSC Ring Edge Cases ---\n");
+    test_spsc_ring_edge_cases();
+
+    printf("\n--- Testing Dynamic Array Edge Cases ---\n");
+    test_dynamic_array_edge_cases();
+
+    printf("\n--- Testing Unrolled List Edge Cases ---\n");
+    test_unrolled_list_edge_cases();
+
+    printf("\n--- Testing Sorting Edge Cases ---\n");
+    test_sorting_edge_cases();
+
+    printf("\n--- Testing Bitset Edge Cases ---\n");
+    test_bitset_edge_cases();
+
+    printf("\n--- Testing Priority Queue Edge Cases ---\n");
+    test_priority_queue_edge_cases();
+
+    printf("\n--- Testing Vector Kernels Edge Cases ---\n");
+    test_vector_kernels_edge_cases();
+
+    printf("\n--- Testing Matrix Edge Cases ---\n");
+    test_matrix_edge_cases();
+
+    printf("\n--- Testing Vector Math Edge Cases ---\n");
+    test_vector_math_edge_cases();
+
+    printf("\n--- Testing Box Kernels Edge Cases ---\n");
+    test_box_kernels_edge_cases();
+
+    printf("\n--- Testing Spatial Index Edge Cases ---\n");
+    test_spatial_index_edge_cases();
+
+    printf("\n--- Testing Interval Edge Cases ---\n");
+    test_interval_edge_cases();
+
+    printf("\n--- Testing Random Edge Cases ---\n");
+    test_random_edge_cases();
+
+    printf("\n--- Testing Job System Edge Cases ---\n");
+    test_job_system_edge_cases();
+
+    printf("\n--- Testing Parallel Loop Edge Cases ---\n");
+    test_parallel_edge_cases();
+
+    printf("\n--- Testing Profiler Edge Cases ---\n");
+    test_profiler_edge_cases();
+
+    printf("\n--- Testing Benchmark Harness Edge Cases ---\n");
+    test_bench_harness_edge_cases();
+
+    printf("\n--- Testing CPU Features Edge Cases ---\n");
+    test_cpu_features_edge_cases();
+
+    printf("\n--- Testing Clock Edge Cases ---\n");
+    test_clock_edge_cases();
+
     printf("\n--- Testing Arena Operations Edge Cases ---\n");
     test_arena_operations_edge_cases();
 